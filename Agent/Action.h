@@ -0,0 +1,329 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace KoKeKoKo
+{
+	namespace Agent
+	{
+		//The actions that model service can ask the agent to execute, parsed once when the message arrives
+		//The values are also what action plugins return, so a new action is only ever added before COUNT
+		enum class Action : uint8_t
+		{
+			NONE,
+			BUILD_REFINERY,
+			BUILD_COMMANDCENTER,
+			MORPH_ORBITALCOMMAND,
+			EFFECT_CALLDOWNMULE,
+			MORPH_PLANETARYFORTRESS,
+			TRAIN_SCV,
+			BUILD_SUPPLYDEPOT,
+			BUILD_BARRACKS,
+			TRAIN_MARINE,
+			TRAIN_REAPER,
+			TRAIN_MARAUDER,
+			TRAIN_GHOST,
+			BUILD_BARRACKSTECHLAB,
+			RESEARCH_COMBATSHIELD,
+			RESEARCH_STIMPACK,
+			RESEARCH_CONCUSSIVESHELLS,
+			BUILD_BARRACKSREACTOR,
+			BUILD_FACTORY,
+			TRAIN_HELLION,
+			MORPH_HELLBAT,
+			TRAIN_WIDOWMINE,
+			TRAIN_SIEGETANK,
+			MORPH_SIEGEMODE,
+			MORPH_UNSIEGE,
+			TRAIN_CYCLONE,
+			TRAIN_HELLBAT,
+			MORPH_HELLION,
+			TRAIN_THOR,
+			BUILD_FACTORYTECHLAB,
+			RESEARCH_INFERNALPREIGNITER,
+			RESEARCH_MAGFIELDLAUNCHERS,
+			RESEARCH_DRILLINGCLAWS,
+			BUILD_FACTORYREACTOR,
+			BUILD_STARPORT,
+			TRAIN_VIKINGFIGHTER,
+			MORPH_VIKINGFIGHTERMODE,
+			MORPH_VIKINGASSAULTMODE,
+			TRAIN_MEDIVAC,
+			TRAIN_LIBERATOR,
+			MORPH_LIBERATORAGMODE,
+			MORPH_LIBERATORAAMODE,
+			TRAIN_RAVEN,
+			EFFECT_AUTOTURRET,
+			TRAIN_BANSHEE,
+			TRAIN_BATTLECRUISER,
+			BUILD_STARPORTREACTOR,
+			BUILD_STARPORTTECHLAB,
+			RESEARCH_HIGHCAPACITYFUELTANKS,
+			RESEARCH_RAVENCORVIDREACTOR,
+			RESEARCH_BANSHEECLOAKINGFIELD,
+			RESEARCH_BANSHEEHYPERFLIGHTROTORS,
+			RESEARCH_ADVANCEDBALLISTICS,
+			BUILD_FUSIONCORE,
+			RESEARCH_BATTLECRUISERWEAPONREFIT,
+			BUILD_ARMORY,
+			RESEARCH_TERRANVEHICLEWEAPONS,
+			RESEARCH_TERRANSHIPWEAPONS,
+			RESEARCH_TERRANVEHICLEANDSHIPPLATING,
+			BUILD_BUNKER,
+			BUILD_ENGINEERINGBAY,
+			RESEARCH_TERRANINFANTRYWEAPONS,
+			RESEARCH_TERRANINFANTRYARMOR,
+			BUILD_GHOSTACADEMY,
+			RESEARCH_PERSONALCLOAKING,
+			BUILD_NUKE,
+			BUILD_MISSILETURRET,
+			BUILD_SENSORTOWER,
+			SURRENDER,
+			//The number of actions, not an action
+			COUNT
+		};
+
+		//The number of actions including NONE
+		const size_t ACTION_COUNT = static_cast<size_t>(Action::COUNT);
+
+		//A name of an action as it is sent by model service
+		struct ActionName
+		{
+			const char* name;
+			Action action;
+		};
+
+		//The names of the actions, the first ACTION_COUNT names are in the same order as Action
+		//The rest are the names used by the replays in CommandsRepository.csv for the same actions
+		constexpr ActionName ACTION_NAMES[] =
+		{
+			{ "", Action::NONE },
+			{ "BUILD_REFINERY", Action::BUILD_REFINERY },
+			{ "BUILD_COMMANDCENTER", Action::BUILD_COMMANDCENTER },
+			{ "MORPH_ORBITALCOMMAND", Action::MORPH_ORBITALCOMMAND },
+			{ "EFFECT_CALLDOWNMULE", Action::EFFECT_CALLDOWNMULE },
+			{ "MORPH_PLANETARYFORTRESS", Action::MORPH_PLANETARYFORTRESS },
+			{ "TRAIN_SCV", Action::TRAIN_SCV },
+			{ "BUILD_SUPPLYDEPOT", Action::BUILD_SUPPLYDEPOT },
+			{ "BUILD_BARRACKS", Action::BUILD_BARRACKS },
+			{ "TRAIN_MARINE", Action::TRAIN_MARINE },
+			{ "TRAIN_REAPER", Action::TRAIN_REAPER },
+			{ "TRAIN_MARAUDER", Action::TRAIN_MARAUDER },
+			{ "TRAIN_GHOST", Action::TRAIN_GHOST },
+			{ "BUILD_BARRACKSTECHLAB", Action::BUILD_BARRACKSTECHLAB },
+			{ "RESEARCH_COMBATSHIELD", Action::RESEARCH_COMBATSHIELD },
+			{ "RESEARCH_STIMPACK", Action::RESEARCH_STIMPACK },
+			{ "RESEARCH_CONCUSSIVESHELLS", Action::RESEARCH_CONCUSSIVESHELLS },
+			{ "BUILD_BARRACKSREACTOR", Action::BUILD_BARRACKSREACTOR },
+			{ "BUILD_FACTORY", Action::BUILD_FACTORY },
+			{ "TRAIN_HELLION", Action::TRAIN_HELLION },
+			{ "MORPH_HELLBAT", Action::MORPH_HELLBAT },
+			{ "TRAIN_WIDOWMINE", Action::TRAIN_WIDOWMINE },
+			{ "TRAIN_SIEGETANK", Action::TRAIN_SIEGETANK },
+			{ "MORPH_SIEGEMODE", Action::MORPH_SIEGEMODE },
+			{ "MORPH_UNSIEGE", Action::MORPH_UNSIEGE },
+			{ "TRAIN_CYCLONE", Action::TRAIN_CYCLONE },
+			{ "TRAIN_HELLBAT", Action::TRAIN_HELLBAT },
+			{ "MORPH_HELLION", Action::MORPH_HELLION },
+			{ "TRAIN_THOR", Action::TRAIN_THOR },
+			{ "BUILD_FACTORYTECHLAB", Action::BUILD_FACTORYTECHLAB },
+			{ "RESEARCH_INFERNALPREIGNITER", Action::RESEARCH_INFERNALPREIGNITER },
+			{ "RESEARCH_MAGFIELDLAUNCHERS", Action::RESEARCH_MAGFIELDLAUNCHERS },
+			{ "RESEARCH_DRILLINGCLAWS", Action::RESEARCH_DRILLINGCLAWS },
+			{ "BUILD_FACTORYREACTOR", Action::BUILD_FACTORYREACTOR },
+			{ "BUILD_STARPORT", Action::BUILD_STARPORT },
+			{ "TRAIN_VIKINGFIGHTER", Action::TRAIN_VIKINGFIGHTER },
+			{ "MORPH_VIKINGFIGHTERMODE", Action::MORPH_VIKINGFIGHTERMODE },
+			{ "MORPH_VIKINGASSAULTMODE", Action::MORPH_VIKINGASSAULTMODE },
+			{ "TRAIN_MEDIVAC", Action::TRAIN_MEDIVAC },
+			{ "TRAIN_LIBERATOR", Action::TRAIN_LIBERATOR },
+			{ "MORPH_LIBERATORAGMODE", Action::MORPH_LIBERATORAGMODE },
+			{ "MORPH_LIBERATORAAMODE", Action::MORPH_LIBERATORAAMODE },
+			{ "TRAIN_RAVEN", Action::TRAIN_RAVEN },
+			{ "EFFECT_AUTOTURRET", Action::EFFECT_AUTOTURRET },
+			{ "TRAIN_BANSHEE", Action::TRAIN_BANSHEE },
+			{ "TRAIN_BATTLECRUISER", Action::TRAIN_BATTLECRUISER },
+			{ "BUILD_STARPORTREACTOR", Action::BUILD_STARPORTREACTOR },
+			{ "BUILD_STARPORTTECHLAB", Action::BUILD_STARPORTTECHLAB },
+			{ "RESEARCH_HIGHCAPACITYFUELTANKS", Action::RESEARCH_HIGHCAPACITYFUELTANKS },
+			{ "RESEARCH_RAVENCORVIDREACTOR", Action::RESEARCH_RAVENCORVIDREACTOR },
+			{ "RESEARCH_BANSHEECLOAKINGFIELD", Action::RESEARCH_BANSHEECLOAKINGFIELD },
+			{ "RESEARCH_BANSHEEHYPERFLIGHTROTORS", Action::RESEARCH_BANSHEEHYPERFLIGHTROTORS },
+			{ "RESEARCH_ADVANCEDBALLISTICS", Action::RESEARCH_ADVANCEDBALLISTICS },
+			{ "BUILD_FUSIONCORE", Action::BUILD_FUSIONCORE },
+			{ "RESEARCH_BATTLECRUISERWEAPONREFIT", Action::RESEARCH_BATTLECRUISERWEAPONREFIT },
+			{ "BUILD_ARMORY", Action::BUILD_ARMORY },
+			{ "RESEARCH_TERRANVEHICLEWEAPONS", Action::RESEARCH_TERRANVEHICLEWEAPONS },
+			{ "RESEARCH_TERRANSHIPWEAPONS", Action::RESEARCH_TERRANSHIPWEAPONS },
+			{ "RESEARCH_TERRANVEHICLEANDSHIPPLATING", Action::RESEARCH_TERRANVEHICLEANDSHIPPLATING },
+			{ "BUILD_BUNKER", Action::BUILD_BUNKER },
+			{ "BUILD_ENGINEERINGBAY", Action::BUILD_ENGINEERINGBAY },
+			{ "RESEARCH_TERRANINFANTRYWEAPONS", Action::RESEARCH_TERRANINFANTRYWEAPONS },
+			{ "RESEARCH_TERRANINFANTRYARMOR", Action::RESEARCH_TERRANINFANTRYARMOR },
+			{ "BUILD_GHOSTACADEMY", Action::BUILD_GHOSTACADEMY },
+			{ "RESEARCH_PERSONALCLOAKING", Action::RESEARCH_PERSONALCLOAKING },
+			{ "BUILD_NUKE", Action::BUILD_NUKE },
+			{ "BUILD_MISSILETURRET", Action::BUILD_MISSILETURRET },
+			{ "BUILD_SENSORTOWER", Action::BUILD_SENSORTOWER },
+			{ "SURRENDER", Action::SURRENDER },
+			//Addons are named after the addon first in the replays
+			{ "BUILD_TECHLAB_BARRACKS", Action::BUILD_BARRACKSTECHLAB },
+			{ "BUILD_REACTOR_BARRACKS", Action::BUILD_BARRACKSREACTOR },
+			{ "BUILD_TECHLAB_FACTORY", Action::BUILD_FACTORYTECHLAB },
+			{ "BUILD_REACTOR_FACTORY", Action::BUILD_FACTORYREACTOR },
+			{ "BUILD_TECHLAB_STARPORT", Action::BUILD_STARPORTTECHLAB },
+			{ "BUILD_REACTOR_STARPORT", Action::BUILD_STARPORTREACTOR },
+			{ "TRAIN_VWIDOWMINE", Action::TRAIN_WIDOWMINE },
+			{ "Train HellionTank", Action::TRAIN_HELLBAT },
+			{ "Train AutoTurret", Action::EFFECT_AUTOTURRET },
+			{ "Build Armory", Action::BUILD_ARMORY },
+			//Upgrades have their level in the replays, the agent researches the next level
+			{ "RESEARCH_TERRANINFANTRYWEAPONSLEVEL1", Action::RESEARCH_TERRANINFANTRYWEAPONS },
+			{ "RESEARCH_TERRANINFANTRYWEAPONSLEVEL2", Action::RESEARCH_TERRANINFANTRYWEAPONS },
+			{ "RESEARCH_TERRANINFANTRYWEAPONSLEVEL3", Action::RESEARCH_TERRANINFANTRYWEAPONS },
+			{ "RESEARCH_TERRANINFANTRYARMORLEVEL1", Action::RESEARCH_TERRANINFANTRYARMOR },
+			{ "RESEARCH_TERRANINFANTRYARMORLEVEL2", Action::RESEARCH_TERRANINFANTRYARMOR },
+			{ "RESEARCH_TERRANINFANTRYARMORLEVEL3", Action::RESEARCH_TERRANINFANTRYARMOR },
+			{ "RESEARCH_TERRANVEHICLEWEAPONSLEVEL1", Action::RESEARCH_TERRANVEHICLEWEAPONS },
+			{ "RESEARCH_TERRANVEHICLEWEAPONSLEVEL2", Action::RESEARCH_TERRANVEHICLEWEAPONS },
+			{ "RESEARCH_TERRANVEHICLEWEAPONSLEVEL3", Action::RESEARCH_TERRANVEHICLEWEAPONS },
+			{ "RESEARCH_TERRANSHIPWEAPONSLEVEL1", Action::RESEARCH_TERRANSHIPWEAPONS },
+			{ "RESEARCH_TERRANSHIPWEAPONSLEVEL2", Action::RESEARCH_TERRANSHIPWEAPONS },
+			{ "RESEARCH_TERRANSHIPWEAPONSLEVEL3", Action::RESEARCH_TERRANSHIPWEAPONS },
+			{ "RESEARCH_TERRANVEHICLEANDSHIPPLATINGLEVEL1", Action::RESEARCH_TERRANVEHICLEANDSHIPPLATING },
+			{ "RESEARCH_TERRANVEHICLEANDSHIPPLATINGLEVEL2", Action::RESEARCH_TERRANVEHICLEANDSHIPPLATING },
+			{ "RESEARCH_TERRANVEHICLEANDSHIPPLATINGLEVEL3", Action::RESEARCH_TERRANVEHICLEANDSHIPPLATING }
+		};
+
+		//The number of names including the names used by the replays
+		constexpr size_t ACTION_NAMECOUNT = (sizeof(ACTION_NAMES) / sizeof(ACTION_NAMES[0]));
+		//The number of slots in the hash table of the names, a power of two
+		constexpr size_t ACTION_HASHSLOTS = 512;
+		//The seed of the hash that puts every name in its own slot, search for a new seed with FindActionHashSeed when the names change
+		constexpr uint32_t ACTION_HASHSEED = 278;
+
+		//Returns the length of a name
+		constexpr size_t GetActionNameLength(const char* name)
+		{
+			size_t length = 0;
+
+			while (name[length] != '\0')
+				length++;
+
+			return length;
+		}
+
+		//Returns the slot of a name, the hash is a seeded FNV-1a
+		constexpr size_t GetActionHashSlot(uint32_t seed, const char* name, size_t length)
+		{
+			uint32_t hash = (2166136261u ^ seed);
+
+			for (size_t index = 0; index < length; index++)
+			{
+				hash ^= static_cast<uint8_t>(name[index]);
+				hash *= 16777619u;
+			}
+
+			return ((hash ^ (hash >> 15)) & (ACTION_HASHSLOTS - 1));
+		}
+
+		//Returns true if every name has its own slot with the seed
+		constexpr bool IsPerfectActionHash(uint32_t seed)
+		{
+			bool isused[ACTION_HASHSLOTS] = {};
+
+			for (size_t index = 0; index < ACTION_NAMECOUNT; index++)
+			{
+				size_t slot = GetActionHashSlot(seed, ACTION_NAMES[index].name, GetActionNameLength(ACTION_NAMES[index].name));
+				if (isused[slot])
+					return false;
+				isused[slot] = true;
+			}
+
+			return true;
+		}
+
+		//Returns the first seed that is not less than the start and puts every name in its own slot
+		//It is too slow for some compilers to run at compile time, so the result is kept in ACTION_HASHSEED
+		constexpr uint32_t FindActionHashSeed(uint32_t start = 0)
+		{
+			while (!IsPerfectActionHash(start))
+				start++;
+
+			return start;
+		}
+
+		//Returns true if the names of the actions are in the same order as Action
+		constexpr bool IsActionNameOrdered()
+		{
+			for (size_t index = 0; index < ACTION_COUNT; index++)
+			{
+				if (static_cast<size_t>(ACTION_NAMES[index].action) != index)
+					return false;
+			}
+
+			return true;
+		}
+
+		static_assert(IsActionNameOrdered(), "The first names of the actions must be in the same order as Action");
+		static_assert(ACTION_NAMECOUNT < 0xFF, "The hash table of the names uses 0xFF for an empty slot");
+		static_assert(IsPerfectActionHash(ACTION_HASHSEED), "Two names of the actions share a slot, set ACTION_HASHSEED to FindActionHashSeed()");
+
+		//The hash table of the names where each slot has the index of a name, or 0xFF if it is empty
+		struct ActionHashTable
+		{
+			uint8_t slots[ACTION_HASHSLOTS];
+		};
+
+		//Builds the hash table of the names at compile time
+		constexpr ActionHashTable BuildActionHashTable()
+		{
+			ActionHashTable table = {};
+
+			for (size_t slot = 0; slot < ACTION_HASHSLOTS; slot++)
+				table.slots[slot] = 0xFF;
+			for (size_t index = 0; index < ACTION_NAMECOUNT; index++)
+				table.slots[GetActionHashSlot(ACTION_HASHSEED, ACTION_NAMES[index].name, GetActionNameLength(ACTION_NAMES[index].name))] = static_cast<uint8_t>(index);
+
+			return table;
+		}
+
+		constexpr ActionHashTable ACTION_HASHTABLE = BuildActionHashTable();
+
+		//Returns the action of a name with a single hash and comparison, or NONE if the name is unknown
+		//Spaces and line breaks around the name are ignored
+		inline Action ParseAction(const char* name, size_t length)
+		{
+			uint8_t index = 0xFF;
+
+			while (length > 0 && (name[0] == ' ' || name[0] == '\r' || name[0] == '\n' || name[0] == '\t'))
+			{
+				name++;
+				length--;
+			}
+			while (length > 0 && (name[length - 1] == ' ' || name[length - 1] == '\r' || name[length - 1] == '\n' || name[length - 1] == '\t' || name[length - 1] == '\0'))
+				length--;
+
+			index = ACTION_HASHTABLE.slots[GetActionHashSlot(ACTION_HASHSEED, name, length)];
+			if (index == 0xFF)
+				return Action::NONE;
+
+			for (size_t position = 0; position < length; position++)
+			{
+				if (ACTION_NAMES[index].name[position] != name[position] || ACTION_NAMES[index].name[position] == '\0')
+					return Action::NONE;
+			}
+			if (ACTION_NAMES[index].name[length] != '\0')
+				return Action::NONE;
+
+			return ACTION_NAMES[index].action;
+		}
+
+		//Returns the name of an action, or an empty name for NONE
+		inline const char* GetActionName(Action action)
+		{
+			return ((static_cast<size_t>(action) < ACTION_COUNT) ? ACTION_NAMES[static_cast<size_t>(action)].name : "");
+		}
+	}
+}
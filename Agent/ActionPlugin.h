@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdint.h>
+
+//The C interface of a native action plugin, a shared library that decides the actions of the agent in the same process
+//A plugin includes this header and exports both functions below, it is loaded with the --plugin argument of the agent
+//The interface only uses C types, so a plugin can be built with any compiler and does not share the C++ runtime of the agent
+
+//The version of the interface, a plugin with another version is refused
+#define KOKEKOKO_ACTIONPLUGIN_VERSION 1
+
+#ifdef _WIN32
+	#define KOKEKOKO_ACTIONPLUGIN_EXPORT __declspec(dllexport)
+#else
+	#define KOKEKOKO_ACTIONPLUGIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+	//A unit in a snapshot, it has the same layout as the units that the agent captures so they are passed without copying
+	typedef struct KoKeKoKoUnit
+	{
+		uint64_t tag;
+		uint32_t type;
+		uint32_t alliance;
+		float x;
+		float y;
+	} KoKeKoKoUnit;
+
+	//The state of the game that a plugin decides on, every pointer is only valid during the call
+	typedef struct KoKeKoKoSnapshot
+	{
+		uint32_t gameloop;
+		uint32_t playerid;
+		int32_t minerals;
+		int32_t vespene;
+		int32_t foodused;
+		int32_t workers;
+		const KoKeKoKoUnit* selfunits;
+		uint32_t selfcount;
+		const KoKeKoKoUnit* enemyunits;
+		uint32_t enemycount;
+		const uint32_t* upgrades;
+		uint32_t upgradecount;
+	} KoKeKoKoSnapshot;
+
+	//Returns KOKEKOKO_ACTIONPLUGIN_VERSION, exported as "KoKeKoKoGetActionPluginVersion"
+	typedef uint32_t (*KoKeKoKoGetActionPluginVersionFunction)(void);
+	//Decides on a snapshot and writes up to the capacity of actions into the caller-provided buffer, then returns the number written
+	//An action is the value of the action in Agent/Action.h, exported as "KoKeKoKoDecide"
+	typedef uint32_t (*KoKeKoKoDecideFunction)(const KoKeKoKoSnapshot* snapshot, uint8_t* actions, uint32_t capacity);
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include "../Types/SpscQueue.h"
+#include "Action.h"
+#include "DecisionTrace.h"
+#include "ObservationSnapshot.h"
+
+namespace KoKeKoKo
+{
+	namespace Agent
+	{
+		//Decides the actions of the agent from the snapshots that the game thread publishes
+		//The snapshots are handed over by the thread that sends updates, and the decided actions are collected by the thread that queues them
+		class ActionProvider
+		{
+			public:
+				virtual ~ActionProvider() {}
+
+				//Returns the name of the provider for the logs
+				virtual const char* GetName() const = 0;
+				//Returns how long to wait after a decision has been requested before requesting the next one
+				virtual std::chrono::milliseconds GetDecisionInterval() const = 0;
+				//Hands over a snapshot to decide on and returns false if the decision could not be requested
+				//The snapshot is only valid during the call
+				virtual bool RequestDecision(const ObservationSnapshot& snapshot) = 0;
+				//Waits until actions have been decided or the timeout has passed, then writes up to the capacity of them into the caller-provided buffer
+				//Every action carries the stamp of the snapshot that it was decided on, with when it was decided
+				//Returns the number of actions that were written
+				virtual size_t GetDecidedActions(DecidedAction* actions, size_t capacity, std::chrono::milliseconds timeout) = 0;
+				//Wakes up any thread that is waiting for decided actions
+				virtual void NotifyWaiters() = 0;
+				//Stops deciding at the end of the game and reports what the provider has done
+				virtual void Stop() = 0;
+		};
+
+		//A provider that decides in the same process, the thread that requests the decisions pushes the actions and the thread that collects them waits for them
+		class QueuedActionProvider : public ActionProvider
+		{
+			private:
+				//The decided actions, pushed by the thread that requests decisions and popped by the thread that collects them
+				Types::SpscQueue<DecidedAction> _decidedactions;
+				//Lock and condition for waking up the thread that collects the actions
+				std::mutex _decisionlock;
+				std::condition_variable _decisioncondition;
+				//The number of times the decision condition has been signalled, guarded by the decision lock
+				uint64_t _wakeups;
+
+				QueuedActionProvider(const QueuedActionProvider&);
+				QueuedActionProvider& operator=(const QueuedActionProvider&);
+
+			protected:
+				//Queues a decided action with the stamp of the snapshot that it was decided on, it is dropped if too many actions are waiting to be collected
+				//Must only be called by the thread that requests decisions, which calls NotifyWaiters() once it has pushed the actions of a decision
+				void PushDecidedAction(Action action, const DecisionStamp& stamp)
+				{
+					DecidedAction decidedaction;
+
+					decidedaction.action = action;
+					decidedaction.stamp = stamp;
+					decidedaction.stamp.decided = std::chrono::steady_clock::now();
+					_decidedactions.Push(decidedaction);
+				}
+
+				uint64_t GetDroppedCount() const
+				{
+					return _decidedactions.GetDroppedCount();
+				}
+
+			public:
+				QueuedActionProvider(size_t capacity) : _decidedactions(capacity, Types::OverflowPolicy::DropNewest)
+				{
+					_wakeups = 0;
+				}
+
+				virtual size_t GetDecidedActions(DecidedAction* actions, size_t capacity, std::chrono::milliseconds timeout) override
+				{
+					size_t count = 0;
+
+					if (_decidedactions.IsEmpty())
+					{
+						std::unique_lock<std::mutex> lock(_decisionlock);
+						uint64_t wakeups = _wakeups;
+
+						_decisioncondition.wait_for(lock, timeout, [this, wakeups]() { return (_wakeups != wakeups || !_decidedactions.IsEmpty()); });
+					}
+
+					while (count < capacity && _decidedactions.TryPop(actions[count]))
+						count++;
+
+					return count;
+				}
+
+				virtual void NotifyWaiters() override
+				{
+					_decisionlock.lock();
+					_wakeups++;
+					_decisionlock.unlock();
+					_decisioncondition.notify_all();
+				}
+		};
+	}
+}
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include "Action.h"
+#include "MacroState.h"
+#include "ResourceBudget.h"
+#include "TerranData.h"
+
+namespace KoKeKoKo
+{
+	namespace Agent
+	{
+		//The production structures that an addon can be swapped between
+		const MacroUnit BUILDORDER_ADDONPRODUCERS[] = { MacroUnit::BARRACKS, MacroUnit::FACTORY, MacroUnit::STARPORT };
+
+		//A build order to simulate, its actions are executed in order and each one waits until it can start
+		struct BuildOrder
+		{
+			const Action* actions;
+			uint32_t count;
+			//The game time that each action starts at, or negative if it never does, written if it is not nullptr
+			float* starttimes;
+		};
+
+		//What a build order has done by the end of a simulation
+		struct BuildOrderResult
+		{
+			//The game time that the last action has started at, or infinity if the build order has not finished before the horizon
+			float finishtime;
+			//The actions that have started, and the ones that were skipped since what they need is never built
+			uint32_t started;
+			uint32_t skipped;
+			//The state at the horizon, the army counts as soon as it has started
+			float minerals;
+			float vespene;
+			int32_t workers;
+			int32_t supplyused;
+			int32_t supplycap;
+			float armyvalue;
+		};
+
+		//Simulates many build orders from the same MacroState, each one is executed with a copy of the state one action at a time
+		//A build order can keep a reserve of resources unspent and swap the addons of its production structures, the way players do, so it can be compared with real games
+		//The agent spends as soon as it can and never swaps, which is what the simulator does without a reserve if the build orders need no swaps
+		class BuildOrderSimulator
+		{
+			private:
+				float _mineralreserve;
+				float _vespenereserve;
+				//The number of build orders that have been simulated, and the addons that they have swapped
+				uint64_t _simulated;
+				uint64_t _swapped;
+
+				BuildOrderSimulator(const BuildOrderSimulator&);
+				BuildOrderSimulator& operator=(const BuildOrderSimulator&);
+
+				//Swaps an addon onto the production structure that the action needs it on, returns false if no production structure has one to give
+				//A new addon is built because the one that was there has been given away, so the other kind is given away first
+				bool SwapAddon(MacroState& state, const MacroActionData& data)
+				{
+					if (data.kind == MacroKind::Addon)
+					{
+						for (const auto& istechlab : { data.product != MacroState::GetAddon(data.producer, true), data.product == MacroState::GetAddon(data.producer, true) })
+							for (const auto& producer : BUILDORDER_ADDONPRODUCERS)
+								if (state.SwapAddon(MacroState::GetAddon(data.producer, istechlab), producer))
+								{
+									_swapped++;
+									return true;
+								}
+					}
+					else if (MacroState::GetAddonProducer(data.producer) != MacroUnit::NONE)
+					{
+						for (const auto& owner : BUILDORDER_ADDONPRODUCERS)
+							if (state.SwapAddon(MacroState::GetAddon(owner, true), MacroState::GetAddonProducer(data.producer)))
+							{
+								_swapped++;
+								return true;
+							}
+					}
+
+					return false;
+				}
+
+				//Waits for what is in progress to finish until an addon can be swapped for the action, the way a player waits for the structure that lands
+				//Returns false and leaves the state as it was if the action is still not legal once everything has finished or at the horizon
+				bool WaitForSwap(MacroState& state, Action action, const MacroActionData& data, float horizon)
+				{
+					if (data.kind != MacroKind::Addon && MacroState::GetAddonProducer(data.producer) == MacroUnit::NONE)
+						return false;
+
+					MacroState waited = state;
+					while (waited.GetNextFinishTime() <= horizon)
+					{
+						waited.AdvanceTo(waited.GetNextFinishTime());
+						if (waited.IsLegal(action) || (SwapAddon(waited, data) && waited.IsLegal(action)))
+						{
+							state = waited;
+							return true;
+						}
+					}
+
+					return false;
+				}
+
+				//Executes a build order with a copy of the state, an action that is not legal even with a swap is skipped and the ones after the horizon never start
+				void SimulateOrder(const MacroState& initial, const BuildOrder& order, float horizon, BuildOrderResult& result)
+				{
+					MacroState state = initial;
+					float armyvalue = state.GetArmyValue(), laststart = state.GetTime();
+					uint32_t next = 0, skipped = 0;
+
+					for (; next < order.count; next++)
+					{
+						const Action action = order.actions[next];
+						const MacroActionData& data = GetMacroActionData(action);
+
+						if (!state.IsLegal(action) && !(SwapAddon(state, data) && state.IsLegal(action)) && !WaitForSwap(state, action, data, horizon))
+						{
+							if (order.starttimes != nullptr)
+								order.starttimes[next] = -1;
+							skipped++;
+							continue;
+						}
+						if (!state.Apply(action, horizon, _mineralreserve, _vespenereserve))
+							break;
+						if (data.product == MacroUnit::ARMY)
+							armyvalue += static_cast<float>(GetActionCost(action).minerals + GetActionCost(action).vespene);
+						if (order.starttimes != nullptr)
+							order.starttimes[next] = state.GetTime();
+						laststart = state.GetTime();
+					}
+					state.AdvanceTo(horizon);
+
+					if (order.starttimes != nullptr)
+						for (uint32_t index = next; index < order.count; index++)
+							order.starttimes[index] = -1;
+					result.finishtime = (next >= order.count) ? laststart : std::numeric_limits<float>::infinity();
+					result.skipped = skipped;
+					result.started = next - skipped;
+					result.minerals = state.GetMinerals();
+					result.vespene = state.GetVespene();
+					result.workers = state.GetCount(MacroUnit::SCV);
+					result.supplyused = state.GetSupplyUsed();
+					result.supplycap = state.GetSupplyCap();
+					result.armyvalue = armyvalue;
+					_simulated++;
+				}
+
+			public:
+				BuildOrderSimulator()
+				{
+					_mineralreserve = 0;
+					_vespenereserve = 0;
+					_simulated = 0;
+					_swapped = 0;
+				}
+
+				//Sets the resources that the build orders leave unspent, the vespene only holds up the actions that cost vespene
+				void SetReserve(float minerals, float vespene)
+				{
+					_mineralreserve = minerals;
+					_vespenereserve = vespene;
+				}
+
+				//Simulates every build order from the state until the horizon, and writes what each has done into the caller-provided results
+				void Simulate(const MacroState& state, const BuildOrder* orders, size_t count, float horizon, BuildOrderResult* results)
+				{
+					for (size_t index = 0; index < count; index++)
+						SimulateOrder(state, orders[index], horizon, results[index]);
+				}
+
+				uint64_t GetSimulatedCount() const
+				{
+					return _simulated;
+				}
+
+				uint64_t GetSwappedCount() const
+				{
+					return _swapped;
+				}
+		};
+	}
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include "../Types/Histogram.h"
+#include "../Types/Logger.h"
+#include "Action.h"
+
+namespace KoKeKoKo
+{
+	namespace Agent
+	{
+		//When a decision has passed each stage from the snapshot that it was decided on to the queue of the game thread, and the game loop of its snapshot
+		//A stage that has not been passed is left at the epoch of the clock, such as every stage of a message that model service sent on its own
+		struct DecisionStamp
+		{
+			uint32_t gameloop;
+			//When the game thread captured the snapshot
+			std::chrono::steady_clock::time_point captured;
+			//When the thread that sends updates handed the snapshot to the provider
+			std::chrono::steady_clock::time_point requested;
+			//When the provider had decided the actions, for model service when its reply was collected
+			std::chrono::steady_clock::time_point decided;
+			//When the thread that collects the actions queued them for the game thread
+			std::chrono::steady_clock::time_point queued;
+			//When the game thread took the action from the queue, it may wait there until it can be paid for
+			std::chrono::steady_clock::time_point dequeued;
+		};
+
+		//An action and the stamp of the decision that it comes from
+		struct DecidedAction
+		{
+			Action action;
+			DecisionStamp stamp;
+		};
+
+		//The stages of a decision that the trace measures, the last one is the whole way from the snapshot to the command
+		enum class DecisionStage
+		{
+			Request,
+			Decision,
+			Queue,
+			Dequeue,
+			Command,
+			EndToEnd,
+			COUNT
+		};
+
+		const size_t DECISIONTRACE_STAGECOUNT = static_cast<size_t>(DecisionStage::COUNT);
+		//The names of the stages in the same order as DecisionStage
+		constexpr const char* DECISIONTRACE_STAGENAMES[] = { "snapshot to request", "request to decision", "decision to queue", "queue to game thread", "game thread to command", "snapshot to command" };
+
+		//Measures how old the state that an action was decided on is once its command has been issued, in a histogram for each stage of the decision
+		//The microseconds of every stage and the game loops that passed are recorded by the game thread when it issues the command, so the histograms are never shared
+		class DecisionTrace
+		{
+			private:
+				Types::Histogram _stages[DECISIONTRACE_STAGECOUNT];
+				Types::Histogram _gameloops;
+				//The commands of actions that have not been decided on a snapshot, such as the messages that model service sent on its own
+				uint64_t _untraced;
+
+				DecisionTrace(const DecisionTrace&);
+				DecisionTrace& operator=(const DecisionTrace&);
+
+				static uint64_t GetMicroseconds(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+				{
+					return ((end > start) ? static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()) : 0);
+				}
+
+			public:
+				DecisionTrace()
+				{
+					_untraced = 0;
+				}
+
+				//Records the stages of an action whose command has just been issued on the game loop
+				//Must only be called by the game thread
+				void Record(const DecisionStamp& stamp, uint32_t gameloop)
+				{
+					auto commanded = std::chrono::steady_clock::now();
+
+					if (stamp.captured == std::chrono::steady_clock::time_point())
+					{
+						_untraced++;
+						return;
+					}
+
+					_stages[static_cast<size_t>(DecisionStage::Request)].Record(GetMicroseconds(stamp.captured, stamp.requested));
+					_stages[static_cast<size_t>(DecisionStage::Decision)].Record(GetMicroseconds(stamp.requested, stamp.decided));
+					_stages[static_cast<size_t>(DecisionStage::Queue)].Record(GetMicroseconds(stamp.decided, stamp.queued));
+					_stages[static_cast<size_t>(DecisionStage::Dequeue)].Record(GetMicroseconds(stamp.queued, stamp.dequeued));
+					_stages[static_cast<size_t>(DecisionStage::Command)].Record(GetMicroseconds(stamp.dequeued, commanded));
+					_stages[static_cast<size_t>(DecisionStage::EndToEnd)].Record(GetMicroseconds(stamp.captured, commanded));
+					_gameloops.Record((gameloop > stamp.gameloop) ? (gameloop - stamp.gameloop) : 0);
+				}
+
+				//Adds what another trace has recorded, such as the trace of another game
+				void Add(const DecisionTrace& trace)
+				{
+					for (size_t stage = 0; stage < DECISIONTRACE_STAGECOUNT; stage++)
+						_stages[stage].Add(trace._stages[stage]);
+					_gameloops.Add(trace._gameloops);
+					_untraced += trace._untraced;
+				}
+
+				const Types::Histogram& GetHistogram(DecisionStage stage) const
+				{
+					return _stages[static_cast<size_t>(stage)];
+				}
+
+				//Writes the percentiles of every stage in milliseconds, and of the game loops that passed
+				void Write(std::ostream& output) const
+				{
+					const double percentiles[] = { 50, 90, 99, 99.9 };
+
+					output << "Latency: " << _gameloops.GetCount() << " traced commands, " << _untraced << " untraced" << std::endl;
+					for (size_t stage = 0; stage < DECISIONTRACE_STAGECOUNT; stage++)
+					{
+						output << "Latency of " << DECISIONTRACE_STAGENAMES[stage] << ":";
+						for (const auto& percentile : percentiles)
+							output << " p" << percentile << " " << (_stages[stage].GetValueAtPercentile(percentile) / 1000.0) << " ms,";
+						output << " max " << (_stages[stage].GetMaximum() / 1000.0) << " ms, mean " << (_stages[stage].GetMean() / 1000.0) << " ms" << std::endl;
+					}
+					output << "Latency in game loops:";
+					for (const auto& percentile : percentiles)
+						output << " p" << percentile << " " << _gameloops.GetValueAtPercentile(percentile) << ",";
+					output << " max " << _gameloops.GetMaximum() << std::endl;
+				}
+
+				//Logs what Write writes, with the percentiles that Write uses, such as when a game ends
+				void Log() const
+				{
+					KOKEKOKO_LOG_INFO("Latency: {} traced commands, {} untraced", _gameloops.GetCount(), _untraced);
+					for (size_t stage = 0; stage < DECISIONTRACE_STAGECOUNT; stage++)
+						KOKEKOKO_LOG_INFO("Latency of {}: p50 {} ms, p90 {} ms, p99 {} ms, p99.9 {} ms, max {} ms, mean {} ms", DECISIONTRACE_STAGENAMES[stage], _stages[stage].GetValueAtPercentile(50) / 1000.0, _stages[stage].GetValueAtPercentile(90) / 1000.0, _stages[stage].GetValueAtPercentile(99) / 1000.0, _stages[stage].GetValueAtPercentile(99.9) / 1000.0, _stages[stage].GetMaximum() / 1000.0, _stages[stage].GetMean() / 1000.0);
+					KOKEKOKO_LOG_INFO("Latency in game loops: p50 {}, p90 {}, p99 {}, p99.9 {}, max {}", _gameloops.GetValueAtPercentile(50), _gameloops.GetValueAtPercentile(90), _gameloops.GetValueAtPercentile(99), _gameloops.GetValueAtPercentile(99.9), _gameloops.GetMaximum());
+				}
+		};
+	}
+}
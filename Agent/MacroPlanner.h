@@ -0,0 +1,355 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "../Types/Arena.h"
+#include "../Types/WorkStealingPool.h"
+#include "Action.h"
+#include "MacroState.h"
+
+namespace KoKeKoKo
+{
+	namespace Agent
+	{
+		//The number of trees that are searched independently and merged at the end, each tree is searched by several threads
+		const size_t PLANNER_TREES = 4;
+		//The number of nodes that each tree can have, a tree that has run out keeps simulating without growing
+		const size_t PLANNER_MAXIMUMNODES = 1 << 17;
+		//The number of iterations that a task runs before it checks the time, and resubmits itself if there is time left
+		const size_t PLANNER_BATCHITERATIONS = 32;
+		//The visits that a node needs before its children are added
+		const uint32_t PLANNER_EXPANSIONVISITS = 4;
+		//The seconds of game time after the state that a plan is valued at
+		const float PLANNER_HORIZONSECONDS = 180.0f;
+		//The value of a state where the reward is one half, the reward of every state is between zero and one
+		const float PLANNER_REWARDSCALE = 4000.0f;
+		//How much the search explores the children that have been visited less
+		const float PLANNER_EXPLORATION = 1.41f;
+		//The rewards are summed as fixed point numbers with this many steps for a reward of one
+		const double PLANNER_REWARDSTEPS = 1048576.0;
+
+		//A node of a search tree, the children of a node are next to each other in the arena of its tree
+		//The statistics are updated by every thread that searches the tree without locking
+		struct MacroNode
+		{
+			//The action that leads from the parent to this node
+			Action action;
+			//The state of the children, 0 while there are none, 1 while a thread adds them, and 2 once they can be read
+			std::atomic<uint8_t> expansion;
+			uint32_t childcount;
+			MacroNode* children;
+			std::atomic<uint32_t> visits;
+			//The threads that are simulating below this node right now, counted as visits with no reward so other threads pick other paths
+			std::atomic<uint32_t> virtualloss;
+			std::atomic<uint64_t> rewardsum;
+
+			void Reset(Action nodeaction)
+			{
+				action = nodeaction;
+				childcount = 0;
+				children = nullptr;
+				visits.store(0, std::memory_order_relaxed);
+				virtualloss.store(0, std::memory_order_relaxed);
+				rewardsum.store(0, std::memory_order_relaxed);
+				expansion.store(0, std::memory_order_release);
+			}
+		};
+
+		//Plans the next macro actions of the agent with a Monte Carlo tree search over MacroState
+		//The trees are searched in parallel by the threads of a work-stealing pool until the time of the decision has passed, then the visits of their roots are summed
+		class MacroPlanner
+		{
+			private:
+				//A tree that is searched by several threads at the same time
+				struct MacroTree
+				{
+					Types::Arena<MacroNode> nodes;
+					MacroNode* root;
+
+					MacroTree() : nodes(PLANNER_MAXIMUMNODES)
+					{
+						root = nullptr;
+					}
+				};
+
+				Types::WorkStealingPool _pool;
+				std::vector<std::unique_ptr<MacroTree>> _trees;
+				//The state of the decision, only written while no task is running
+				MacroState _rootstate;
+				float _horizon;
+				std::chrono::steady_clock::time_point _deadline;
+				//The iterations of the last decision, and of every decision
+				std::atomic<uint64_t> _iterations;
+				uint64_t _totaliterations;
+				//The nodes that were added during the last decision
+				size_t _nodecount;
+
+				MacroPlanner(const MacroPlanner&);
+				MacroPlanner& operator=(const MacroPlanner&);
+
+				static uint64_t GetNextRandom(uint64_t& random)
+				{
+					random ^= random << 13;
+					random ^= random >> 7;
+					random ^= random << 17;
+					return random;
+				}
+
+				static float GetReward(const MacroState& state)
+				{
+					float value = state.GetValue();
+
+					return value / (value + PLANNER_REWARDSCALE);
+				}
+
+				//Returns the child with the best upper confidence bound, where the threads below a child count as visits that were lost
+				static MacroNode* SelectChild(MacroNode* node, uint64_t& random)
+				{
+					uint32_t parentvisits = node->visits.load(std::memory_order_relaxed) + node->virtualloss.load(std::memory_order_relaxed);
+					float logvisits = std::log(static_cast<float>(std::max<uint32_t>(parentvisits, 1)));
+					MacroNode* best = node->children;
+					float bestscore = -1;
+
+					//The unvisited children are tried first, starting from a random one so the threads spread out
+					uint32_t offset = static_cast<uint32_t>(GetNextRandom(random) % node->childcount);
+					for (uint32_t index = 0; index < node->childcount; index++)
+					{
+						MacroNode* child = &node->children[(index + offset) % node->childcount];
+						uint32_t visits = child->visits.load(std::memory_order_relaxed) + child->virtualloss.load(std::memory_order_relaxed);
+
+						if (visits == 0)
+							return child;
+
+						float mean = static_cast<float>(static_cast<double>(child->rewardsum.load(std::memory_order_relaxed)) / PLANNER_REWARDSTEPS) / visits;
+						float score = mean + PLANNER_EXPLORATION * std::sqrt(logvisits / visits);
+						if (score > bestscore)
+						{
+							best = child;
+							bestscore = score;
+						}
+					}
+
+					return best;
+				}
+
+				//Adds a child for every legal action of the state, returns false if another thread is adding them or the arena has run out
+				static bool Expand(MacroTree& tree, MacroNode* node, const MacroState& state)
+				{
+					Action actions[ACTION_COUNT];
+					uint8_t expected = 0;
+					size_t count = 0;
+
+					if (!node->expansion.compare_exchange_strong(expected, 1, std::memory_order_acq_rel))
+						return false;
+
+					count = state.GetLegalActions(actions);
+					MacroNode* children = (count > 0) ? tree.nodes.Allocate(count) : nullptr;
+					if (children == nullptr)
+					{
+						//A node without legal actions is simulated from as a leaf, and so is every node once the arena has run out
+						node->expansion.store(0, std::memory_order_release);
+						return false;
+					}
+
+					for (size_t index = 0; index < count; index++)
+						children[index].Reset(actions[index]);
+					node->children = children;
+					node->childcount = static_cast<uint32_t>(count);
+					node->expansion.store(2, std::memory_order_release);
+
+					return true;
+				}
+
+				//Executes random legal actions until the horizon and returns the reward of where it ends
+				float Simulate(MacroState& state, uint64_t& random) const
+				{
+					Action actions[ACTION_COUNT];
+
+					while (state.GetTime() < _horizon)
+					{
+						size_t count = state.GetLegalActions(actions);
+
+						if (count == 0 || !state.Apply(actions[GetNextRandom(random) % count], _horizon))
+							break;
+					}
+					state.AdvanceTo(_horizon);
+
+					return GetReward(state);
+				}
+
+				//Selects a path down the tree, adds the children of where it ends, simulates from there, and adds the reward to every node on the path
+				void Iterate(MacroTree& tree, uint64_t& random)
+				{
+					MacroNode* path[ACTION_COUNT * 4];
+					size_t depth = 0;
+					MacroState state = _rootstate;
+					MacroNode* node = tree.root;
+					bool isapplied = true;
+
+					path[depth++] = node;
+					node->virtualloss.fetch_add(1, std::memory_order_relaxed);
+					while (isapplied && depth < (sizeof(path) / sizeof(path[0])))
+					{
+						if (node->expansion.load(std::memory_order_acquire) != 2)
+						{
+							if (node->visits.load(std::memory_order_relaxed) < PLANNER_EXPANSIONVISITS && node != tree.root)
+								break;
+							if (!Expand(tree, node, state))
+								break;
+						}
+
+						node = SelectChild(node, random);
+						node->virtualloss.fetch_add(1, std::memory_order_relaxed);
+						path[depth++] = node;
+						isapplied = state.Apply(node->action, _horizon);
+					}
+
+					uint64_t reward = static_cast<uint64_t>(((isapplied) ? Simulate(state, random) : GetReward(state)) * PLANNER_REWARDSTEPS);
+					for (size_t index = 0; index < depth; index++)
+					{
+						path[index]->rewardsum.fetch_add(reward, std::memory_order_relaxed);
+						path[index]->visits.fetch_add(1, std::memory_order_relaxed);
+						path[index]->virtualloss.fetch_sub(1, std::memory_order_relaxed);
+					}
+				}
+
+				//Runs a batch of iterations on a tree, then gives the thread back to the pool and comes back later if there is time left
+				void RunBatch(size_t treeindex, uint64_t random)
+				{
+					MacroTree& tree = *_trees[treeindex];
+
+					for (size_t iteration = 0; iteration < PLANNER_BATCHITERATIONS; iteration++)
+						Iterate(tree, random);
+					_iterations.fetch_add(PLANNER_BATCHITERATIONS, std::memory_order_relaxed);
+
+					if (std::chrono::steady_clock::now() < _deadline)
+						_pool.Submit([this, treeindex, random]() { RunBatch(treeindex, random); });
+				}
+
+			public:
+				//Starts the threads of the search, one for each core if no number is given
+				MacroPlanner(size_t threads = 0, size_t trees = PLANNER_TREES) : _pool(threads)
+				{
+					trees = std::max<size_t>(1, std::min(trees, _pool.GetThreadCount()));
+					for (size_t index = 0; index < trees; index++)
+						_trees.emplace_back(new MacroTree());
+					_horizon = 0;
+					_iterations = 0;
+					_totaliterations = 0;
+					_nodecount = 0;
+				}
+
+				//Searches from the state until the time budget has passed and writes the most visited line of actions into the caller-provided buffer
+				//Returns the number of actions that were written, none if no action is legal
+				size_t Plan(const MacroState& state, std::chrono::milliseconds budget, Action* plan, size_t capacity)
+				{
+					uint32_t visits[ACTION_COUNT] = { 0 };
+					size_t count = 0;
+					Action best = Action::NONE;
+
+					_rootstate = state;
+					_horizon = state.GetTime() + PLANNER_HORIZONSECONDS;
+					_iterations = 0;
+					for (auto& tree : _trees)
+					{
+						tree->nodes.Reset();
+						tree->root = tree->nodes.Allocate(1);
+						tree->root->Reset(Action::NONE);
+					}
+
+					//Two tasks for each thread, so a thread that finishes its batch early always finds another one to steal
+					_deadline = std::chrono::steady_clock::now() + budget;
+					for (size_t index = 0; index < (_pool.GetThreadCount() * 2); index++)
+						_pool.Submit([this, index]() { RunBatch(index % _trees.size(), 0x9E3779B97F4A7C15ull * (index + 1)); });
+					_pool.WaitForIdle();
+					_totaliterations += _iterations;
+
+					//The visits of the same action are summed over the roots, and the line continues in the tree that has visited it the most
+					_nodecount = 0;
+					for (size_t treeindex = 0; treeindex < _trees.size(); treeindex++)
+					{
+						MacroNode* root = _trees[treeindex]->root;
+
+						_nodecount += _trees[treeindex]->nodes.GetAllocatedCount();
+						if (root->expansion.load(std::memory_order_acquire) == 2)
+							for (uint32_t index = 0; index < root->childcount; index++)
+								visits[static_cast<size_t>(root->children[index].action)] += root->children[index].visits.load(std::memory_order_relaxed);
+					}
+					for (size_t index = 1; index < ACTION_COUNT; index++)
+						if (visits[index] > visits[static_cast<size_t>(best)])
+							best = static_cast<Action>(index);
+					if (best == Action::NONE || capacity == 0)
+						return 0;
+
+					plan[count++] = best;
+					MacroNode* node = nullptr;
+					uint32_t mostvisits = 0;
+					for (size_t treeindex = 0; treeindex < _trees.size(); treeindex++)
+					{
+						MacroNode* root = _trees[treeindex]->root;
+
+						if (root->expansion.load(std::memory_order_acquire) == 2)
+							for (uint32_t index = 0; index < root->childcount; index++)
+								if (root->children[index].action == best && root->children[index].visits > mostvisits)
+								{
+									node = &root->children[index];
+									mostvisits = node->visits;
+								}
+					}
+					while (node != nullptr && count < capacity && node->expansion.load(std::memory_order_acquire) == 2)
+					{
+						MacroNode* next = nullptr;
+
+						for (uint32_t index = 0; index < node->childcount; index++)
+							if (next == nullptr || node->children[index].visits > next->visits)
+								next = &node->children[index];
+						if (next == nullptr || next->visits == 0)
+							break;
+
+						plan[count++] = next->action;
+						node = next;
+					}
+
+					return count;
+				}
+
+				size_t GetThreadCount() const
+				{
+					return _pool.GetThreadCount();
+				}
+
+				size_t GetTreeCount() const
+				{
+					return _trees.size();
+				}
+
+				//Returns the iterations of the last decision, each iteration ends with one simulation to the horizon
+				uint64_t GetIterationCount() const
+				{
+					return _iterations;
+				}
+
+				uint64_t GetTotalIterationCount() const
+				{
+					return _totaliterations;
+				}
+
+				//Returns the nodes of every tree after the last decision
+				size_t GetNodeCount() const
+				{
+					return _nodecount;
+				}
+
+				uint64_t GetStealCount() const
+				{
+					return _pool.GetStealCount();
+				}
+		};
+	}
+}
@@ -0,0 +1,524 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include "Action.h"
+#include "ResourceBudget.h"
+#include "TerranData.h"
+
+namespace KoKeKoKo
+{
+	namespace Agent
+	{
+		//The number of actions that can be in progress at the same time
+		const size_t MACROSTATE_MAXIMUMPENDING = 32;
+		//The minerals and vespene that a worker gathers per second of game time
+		const float MINERALS_PERWORKERSECOND = 0.92f;
+		const float VESPENE_PERWORKERSECOND = 0.89f;
+		//The minerals that the mules of an orbital command gather per second, a mule is called down whenever there is energy for it
+		const float MULE_MINERALSPERSECOND = 3.5f;
+		//The workers that a base and a refinery can keep busy
+		const int32_t WORKERS_PERBASE = 16;
+		const int32_t WORKERS_PERREFINERY = 3;
+		//The refineries that a base has geysers for
+		const int32_t REFINERIES_PERBASE = 2;
+		//The supply that a base and a supply depot provide, and the most supply there can be
+		const int32_t SUPPLY_PERBASE = 15;
+		const int32_t SUPPLY_PERDEPOT = 8;
+		const int32_t SUPPLY_MAXIMUM = 200;
+		//How many seconds of income the value of a state counts, so a stronger economy is worth as much as the army it will pay for
+		const float VALUE_INCOMESECONDS = 60.0f;
+
+		//An action that is in progress
+		struct MacroPending
+		{
+			//The game time when the action finishes
+			float finish;
+			//What exists when the action has finished
+			MacroUnit product;
+			//The production structure that is busy until then, or NONE
+			MacroUnit producer;
+			Action action;
+		};
+
+		//A deterministic model of the macro of the agent, every action is executed as soon as its resources, producer and supply are there
+		//It is small and has no pointers, so a search copies it for every path that it simulates
+		class MacroState
+		{
+			private:
+				//The game time in seconds
+				float _time;
+				float _minerals;
+				float _vespene;
+				int32_t _supplyused;
+				//The finished units and structures, the ones in progress, and the production structures that are busy
+				uint16_t _counts[MACROUNIT_COUNT];
+				uint16_t _pendingcounts[MACROUNIT_COUNT];
+				uint16_t _busycounts[MACROUNIT_COUNT];
+				//The researches that have finished or are in progress, a bit for each action
+				uint64_t _researched[(ACTION_COUNT + 63) / 64];
+				//The resources that have been spent on the finished army units and researches
+				float _armyvalue;
+				float _researchvalue;
+				MacroPending _pending[MACROSTATE_MAXIMUMPENDING];
+				uint32_t _pendingcount;
+
+				uint32_t GetTotal(MacroUnit unit) const
+				{
+					return static_cast<uint32_t>(_counts[static_cast<size_t>(unit)]) + _pendingcounts[static_cast<size_t>(unit)];
+				}
+
+				//Returns the production structures that can execute an action of the producer at the same time, a reactor adds one
+				int32_t GetProducerSlots(MacroUnit producer) const
+				{
+					switch (producer)
+					{
+						case MacroUnit::COMMANDCENTER:
+							return GetCount(MacroUnit::COMMANDCENTER) + GetCount(MacroUnit::ORBITALCOMMAND) + GetCount(MacroUnit::PLANETARYFORTRESS);
+						case MacroUnit::BARRACKS:
+							return GetCount(MacroUnit::BARRACKS) + GetCount(MacroUnit::BARRACKSREACTOR);
+						case MacroUnit::FACTORY:
+							return GetCount(MacroUnit::FACTORY) + GetCount(MacroUnit::FACTORYREACTOR);
+						case MacroUnit::STARPORT:
+							return GetCount(MacroUnit::STARPORT) + GetCount(MacroUnit::STARPORTREACTOR);
+						default:
+							return GetCount(producer);
+					}
+				}
+
+				//Returns the production structures of the producer that have neither an addon nor one in progress, only the finished ones if asked
+				int32_t GetFreeAddonSlots(MacroUnit producer, bool isfinishedonly) const
+				{
+					MacroUnit techlab = GetAddon(producer, true), reactor = GetAddon(producer, false);
+
+					if (techlab == MacroUnit::NONE)
+						return 0;
+
+					return ((isfinishedonly) ? GetCount(producer) : static_cast<int32_t>(GetTotal(producer))) - static_cast<int32_t>(GetTotal(techlab) + GetTotal(reactor));
+				}
+
+				//Returns the supply cap once everything that is in progress has finished
+				int32_t GetPotentialSupplyCap() const
+				{
+					int32_t bases = static_cast<int32_t>(GetTotal(MacroUnit::COMMANDCENTER) + GetTotal(MacroUnit::ORBITALCOMMAND) + GetTotal(MacroUnit::PLANETARYFORTRESS));
+
+					return std::min(SUPPLY_MAXIMUM, bases * SUPPLY_PERBASE + static_cast<int32_t>(GetTotal(MacroUnit::SUPPLYDEPOT)) * SUPPLY_PERDEPOT);
+				}
+
+				//Returns true if everything but the resources is there to start the action now
+				bool IsReady(const MacroActionData& data, const ActionCost& cost) const
+				{
+					if (data.requirement != MacroUnit::NONE && GetCount(data.requirement) == 0)
+						return false;
+					if (cost.supply > 0 && (_supplyused + cost.supply) > GetSupplyCap())
+						return false;
+
+					switch (data.kind)
+					{
+						case MacroKind::Build:
+							return (GetCount(MacroUnit::SCV) > _busycounts[static_cast<size_t>(MacroUnit::SCV)]);
+						case MacroKind::Morph:
+							return (GetCount(MacroUnit::COMMANDCENTER) > _busycounts[static_cast<size_t>(MacroUnit::COMMANDCENTER)] && GetProducerSlots(MacroUnit::COMMANDCENTER) > _busycounts[static_cast<size_t>(MacroUnit::COMMANDCENTER)]);
+						case MacroKind::Addon:
+							return (GetFreeAddonSlots(data.producer, true) > 0 && GetProducerSlots(data.producer) > _busycounts[static_cast<size_t>(data.producer)]);
+						default:
+							return (GetProducerSlots(data.producer) > _busycounts[static_cast<size_t>(data.producer)]);
+					}
+				}
+
+				//The reserve is what has to be left over after the cost is paid
+				bool CanAfford(const ActionCost& cost, float mineralreserve, float vespenereserve) const
+				{
+					//A little is forgiven, so the rounding of the income does not wait for another fraction of a second
+					return ((_minerals + 0.001f) >= (cost.minerals + mineralreserve) && (_vespene + 0.001f) >= (cost.vespene + ((cost.vespene > 0) ? vespenereserve : 0)));
+				}
+
+				//Returns the index of the pending action that finishes first, or MACROSTATE_MAXIMUMPENDING if nothing is in progress
+				size_t GetNextPending() const
+				{
+					size_t next = MACROSTATE_MAXIMUMPENDING;
+
+					for (size_t index = 0; index < _pendingcount; index++)
+						if (next == MACROSTATE_MAXIMUMPENDING || _pending[index].finish < _pending[next].finish)
+							next = index;
+
+					return next;
+				}
+
+				void Gather(float seconds)
+				{
+					_minerals += GetMineralIncome() * seconds;
+					_vespene += GetVespeneIncome() * seconds;
+				}
+
+				void Finish(size_t index)
+				{
+					const MacroPending pending = _pending[index];
+					const ActionCost& cost = GetActionCost(pending.action);
+
+					_pending[index] = _pending[--_pendingcount];
+					if (pending.producer != MacroUnit::NONE)
+						_busycounts[static_cast<size_t>(pending.producer)]--;
+					if (pending.product != MacroUnit::NONE)
+					{
+						_pendingcounts[static_cast<size_t>(pending.product)]--;
+						_counts[static_cast<size_t>(pending.product)]++;
+					}
+					if (pending.product == MacroUnit::ARMY)
+						_armyvalue += static_cast<float>(cost.minerals + cost.vespene);
+					else if (GetMacroActionData(pending.action).kind == MacroKind::Research)
+						_researchvalue += static_cast<float>(cost.minerals + cost.vespene);
+				}
+
+			public:
+				//Returns the techlab or the reactor of a production structure, or NONE if it has no addons
+				static MacroUnit GetAddon(MacroUnit producer, bool istechlab)
+				{
+					switch (producer)
+					{
+						case MacroUnit::BARRACKS:
+							return (istechlab) ? MacroUnit::BARRACKSTECHLAB : MacroUnit::BARRACKSREACTOR;
+						case MacroUnit::FACTORY:
+							return (istechlab) ? MacroUnit::FACTORYTECHLAB : MacroUnit::FACTORYREACTOR;
+						case MacroUnit::STARPORT:
+							return (istechlab) ? MacroUnit::STARPORTTECHLAB : MacroUnit::STARPORTREACTOR;
+						default:
+							return MacroUnit::NONE;
+					}
+				}
+
+				//Returns the production structure that an addon belongs to, or NONE if it is not an addon
+				static MacroUnit GetAddonProducer(MacroUnit addon)
+				{
+					switch (addon)
+					{
+						case MacroUnit::BARRACKSTECHLAB:
+						case MacroUnit::BARRACKSREACTOR:
+							return MacroUnit::BARRACKS;
+						case MacroUnit::FACTORYTECHLAB:
+						case MacroUnit::FACTORYREACTOR:
+							return MacroUnit::FACTORY;
+						case MacroUnit::STARPORTTECHLAB:
+						case MacroUnit::STARPORTREACTOR:
+							return MacroUnit::STARPORT;
+						default:
+							return MacroUnit::NONE;
+					}
+				}
+
+				MacroState()
+				{
+					_time = 0;
+					_minerals = 0;
+					_vespene = 0;
+					_supplyused = 0;
+					std::fill(_counts, _counts + MACROUNIT_COUNT, static_cast<uint16_t>(0));
+					std::fill(_pendingcounts, _pendingcounts + MACROUNIT_COUNT, static_cast<uint16_t>(0));
+					std::fill(_busycounts, _busycounts + MACROUNIT_COUNT, static_cast<uint16_t>(0));
+					std::fill(_researched, _researched + ((ACTION_COUNT + 63) / 64), static_cast<uint64_t>(0));
+					_armyvalue = 0;
+					_researchvalue = 0;
+					_pendingcount = 0;
+				}
+
+				//Returns the state that every game starts with, a command center with twelve workers and fifty minerals
+				static MacroState CreateGameStart()
+				{
+					MacroState state;
+
+					state.SetResources(50, 0);
+					state.AddUnits(MacroUnit::COMMANDCENTER, 1);
+					state.AddUnits(MacroUnit::SCV, 12);
+					state.SetSupplyUsed(12);
+
+					return state;
+				}
+
+				void SetTime(float time)
+				{
+					_time = time;
+				}
+
+				void SetResources(float minerals, float vespene)
+				{
+					_minerals = minerals;
+					_vespene = vespene;
+				}
+
+				void SetSupplyUsed(int32_t supplyused)
+				{
+					_supplyused = supplyused;
+				}
+
+				//Adds finished units and structures, the army units are added by their value instead
+				void AddUnits(MacroUnit unit, uint32_t count)
+				{
+					_counts[static_cast<size_t>(unit)] = static_cast<uint16_t>(std::min<uint32_t>(_counts[static_cast<size_t>(unit)] + count, UINT16_MAX));
+				}
+
+				void AddArmyValue(float value)
+				{
+					_armyvalue += value;
+				}
+
+				//Marks a research as finished so it is not planned again
+				void SetResearched(Action action)
+				{
+					if (!IsResearched(action))
+					{
+						_researched[static_cast<size_t>(action) / 64] |= (static_cast<uint64_t>(1) << (static_cast<size_t>(action) % 64));
+						_researchvalue += static_cast<float>(GetActionCost(action).minerals + GetActionCost(action).vespene);
+					}
+				}
+
+				//Returns true if the research has finished or is in progress
+				bool IsResearched(Action action) const
+				{
+					return ((_researched[static_cast<size_t>(action) / 64] >> (static_cast<size_t>(action) % 64)) & 1) != 0;
+				}
+
+				float GetTime() const
+				{
+					return _time;
+				}
+
+				float GetMinerals() const
+				{
+					return _minerals;
+				}
+
+				float GetVespene() const
+				{
+					return _vespene;
+				}
+
+				int32_t GetSupplyUsed() const
+				{
+					return _supplyused;
+				}
+
+				int32_t GetCount(MacroUnit unit) const
+				{
+					return static_cast<int32_t>(_counts[static_cast<size_t>(unit)]);
+				}
+
+				float GetArmyValue() const
+				{
+					return _armyvalue;
+				}
+
+				float GetResearchValue() const
+				{
+					return _researchvalue;
+				}
+
+				//Returns the number of actions that are in progress
+				size_t GetPendingCount() const
+				{
+					return _pendingcount;
+				}
+
+				//Returns the game time that the next action in progress finishes at, or infinity if nothing is in progress
+				float GetNextFinishTime() const
+				{
+					size_t next = GetNextPending();
+
+					return (next < MACROSTATE_MAXIMUMPENDING) ? _pending[next].finish : std::numeric_limits<float>::infinity();
+				}
+
+				//Returns the finished bases, the ones that are turning into another base are counted too since they keep gathering
+				int32_t GetBaseCount() const
+				{
+					return GetCount(MacroUnit::COMMANDCENTER) + GetCount(MacroUnit::ORBITALCOMMAND) + GetCount(MacroUnit::PLANETARYFORTRESS) + _busycounts[static_cast<size_t>(MacroUnit::ORBITALCOMMAND)] + _busycounts[static_cast<size_t>(MacroUnit::PLANETARYFORTRESS)];
+				}
+
+				int32_t GetSupplyCap() const
+				{
+					return std::min(SUPPLY_MAXIMUM, GetBaseCount() * SUPPLY_PERBASE + GetCount(MacroUnit::SUPPLYDEPOT) * SUPPLY_PERDEPOT);
+				}
+
+				//Returns the workers that gather, the ones that are building a structure do not
+				int32_t GetGatheringWorkers() const
+				{
+					return GetCount(MacroUnit::SCV) - _busycounts[static_cast<size_t>(MacroUnit::SCV)];
+				}
+
+				//Returns the workers in the refineries, they are filled before the minerals
+				int32_t GetVespeneWorkers() const
+				{
+					return std::min(GetGatheringWorkers(), GetCount(MacroUnit::REFINERY) * WORKERS_PERREFINERY);
+				}
+
+				float GetMineralIncome() const
+				{
+					int32_t workers = std::min(GetGatheringWorkers() - GetVespeneWorkers(), GetBaseCount() * WORKERS_PERBASE);
+
+					return (static_cast<float>(workers) * MINERALS_PERWORKERSECOND) + (static_cast<float>(GetCount(MacroUnit::ORBITALCOMMAND)) * MULE_MINERALSPERSECOND);
+				}
+
+				float GetVespeneIncome() const
+				{
+					return static_cast<float>(GetVespeneWorkers()) * VESPENE_PERWORKERSECOND;
+				}
+
+				//Returns true if the action can be executed from this state at some time, if not right away then once what is in progress has finished
+				bool IsLegal(Action action) const
+				{
+					const MacroActionData& data = GetMacroActionData(action);
+					const ActionCost& cost = GetActionCost(action);
+
+					if (data.kind == MacroKind::Tactical || _pendingcount >= MACROSTATE_MAXIMUMPENDING)
+						return false;
+					if (data.requirement != MacroUnit::NONE && GetTotal(data.requirement) == 0)
+						return false;
+					if (cost.supply > 0 && (_supplyused + cost.supply) > GetPotentialSupplyCap())
+						return false;
+					if (_minerals < cost.minerals && GetMineralIncome() <= 0 && GetTotal(MacroUnit::SCV) == 0)
+						return false;
+					if (_vespene < cost.vespene && GetTotal(MacroUnit::REFINERY) == 0)
+						return false;
+
+					switch (data.kind)
+					{
+						case MacroKind::Build:
+							if (data.product == MacroUnit::REFINERY)
+								return (static_cast<int32_t>(GetTotal(MacroUnit::REFINERY)) < (GetBaseCount() + static_cast<int32_t>(_pendingcounts[static_cast<size_t>(MacroUnit::COMMANDCENTER)])) * REFINERIES_PERBASE);
+							if (data.product == MacroUnit::SUPPLYDEPOT)
+								return (GetPotentialSupplyCap() < SUPPLY_MAXIMUM);
+							return (GetTotal(MacroUnit::SCV) > 0);
+						case MacroKind::Morph:
+							return (GetTotal(MacroUnit::COMMANDCENTER) > 0);
+						case MacroKind::Addon:
+							return (GetFreeAddonSlots(data.producer, false) > 0);
+						case MacroKind::Research:
+							return (!IsResearched(action) && GetTotal(data.producer) > 0);
+						default:
+							if (data.producer == MacroUnit::COMMANDCENTER)
+								return (GetTotal(MacroUnit::COMMANDCENTER) + GetTotal(MacroUnit::ORBITALCOMMAND) + GetTotal(MacroUnit::PLANETARYFORTRESS)) > 0;
+							return (GetTotal(data.producer) > 0);
+					}
+				}
+
+				//Writes the legal actions into the caller-provided buffer, which has room for ACTION_COUNT actions, and returns the number written
+				size_t GetLegalActions(Action* actions) const
+				{
+					size_t count = 0;
+
+					for (size_t index = 1; index < ACTION_COUNT; index++)
+						if (IsLegal(static_cast<Action>(index)))
+							actions[count++] = static_cast<Action>(index);
+
+					return count;
+				}
+
+				//Lets the game time pass, the income is gathered and the actions that finish until then are finished in order
+				void AdvanceTo(float time)
+				{
+					for (size_t next = GetNextPending(); next < MACROSTATE_MAXIMUMPENDING && _pending[next].finish <= time; next = GetNextPending())
+					{
+						Gather(_pending[next].finish - _time);
+						_time = _pending[next].finish;
+						Finish(next);
+					}
+					if (time > _time)
+					{
+						Gather(time - _time);
+						_time = time;
+					}
+				}
+
+				//Waits until the action can be started and starts it, returns false without starting it if that would be after the horizon or never
+				//The reserve is left unspent, the way a player keeps a bank, the vespene one only for the actions that cost vespene
+				bool Apply(Action action, float horizon, float mineralreserve = 0, float vespenereserve = 0)
+				{
+					const MacroActionData& data = GetMacroActionData(action);
+					const ActionCost& cost = GetActionCost(action);
+
+					if (!IsLegal(action))
+						return false;
+
+					while (!IsReady(data, cost) || !CanAfford(cost, mineralreserve, vespenereserve))
+					{
+						size_t next = GetNextPending();
+						float time = (next < MACROSTATE_MAXIMUMPENDING) ? _pending[next].finish : horizon + 1;
+
+						//Only the resources are missing, so wait for the income unless something finishes before that
+						if (IsReady(data, cost))
+						{
+							float mineralincome = GetMineralIncome(), vespeneincome = GetVespeneIncome(), wait = 0;
+							float minerals = cost.minerals + mineralreserve, vespene = cost.vespene + ((cost.vespene > 0) ? vespenereserve : 0);
+
+							if (_minerals < minerals)
+								wait = (mineralincome > 0) ? std::max(wait, (minerals - _minerals) / mineralincome) : horizon + 1;
+							if (_vespene < vespene)
+								wait = (vespeneincome > 0) ? std::max(wait, (vespene - _vespene) / vespeneincome) : horizon + 1;
+							//The game time is a float, so a wait that is too short to change it still moves it by the smallest step
+							time = std::min(time, std::max(_time + wait, std::nextafter(_time, horizon + 1)));
+						}
+						if (time > horizon)
+						{
+							AdvanceTo(horizon);
+							return false;
+						}
+						AdvanceTo(time);
+					}
+
+					_minerals = std::max(0.0f, _minerals - cost.minerals);
+					_vespene = std::max(0.0f, _vespene - cost.vespene);
+					_supplyused += cost.supply;
+					if (data.kind == MacroKind::Research)
+						_researched[static_cast<size_t>(action) / 64] |= (static_cast<uint64_t>(1) << (static_cast<size_t>(action) % 64));
+
+					MacroPending& pending = _pending[_pendingcount++];
+					pending.finish = _time + data.buildseconds;
+					pending.product = data.product;
+					pending.action = action;
+					//A morphing command center is busy as the base that it turns into, so it keeps gathering but trains nothing
+					//The SCV of a structure is busy too, it stops gathering until the structure is finished
+					if (data.kind == MacroKind::Morph)
+					{
+						_counts[static_cast<size_t>(MacroUnit::COMMANDCENTER)]--;
+						pending.producer = data.product;
+					}
+					else
+						pending.producer = data.producer;
+					if (pending.producer != MacroUnit::NONE)
+						_busycounts[static_cast<size_t>(pending.producer)]++;
+					if (pending.product != MacroUnit::NONE)
+						_pendingcounts[static_cast<size_t>(pending.product)]++;
+
+					return true;
+				}
+
+				//Lands a finished production structure without an addon on an idle addon of another kind of production structure, the way players swap them
+				//The structure that the addon was built for is left without it, the seconds that the structures fly are left out
+				bool SwapAddon(MacroUnit addon, MacroUnit producer)
+				{
+					const MacroUnit owner = GetAddonProducer(addon);
+					const bool istechlab = (GetAddon(owner, true) == addon);
+
+					if (owner == MacroUnit::NONE || owner == producer || GetAddon(producer, istechlab) == MacroUnit::NONE || GetFreeAddonSlots(producer, true) <= 0 || GetCount(addon) == 0)
+						return false;
+					//A techlab is idle when it researches nothing and trains nothing, a reactor when its structure can do without the second slot
+					if (istechlab && _busycounts[static_cast<size_t>(addon)] >= _counts[static_cast<size_t>(addon)])
+						return false;
+					if (!istechlab && (GetProducerSlots(owner) - 1) < _busycounts[static_cast<size_t>(owner)])
+						return false;
+
+					_counts[static_cast<size_t>(addon)]--;
+					_counts[static_cast<size_t>(GetAddon(producer, istechlab))]++;
+
+					return true;
+				}
+
+				//Returns what the state is worth, the resources in the army and half of those in the researches, and a minute of income
+				float GetValue() const
+				{
+					return _armyvalue + (_researchvalue * 0.5f) + ((GetMineralIncome() + GetVespeneIncome()) * VALUE_INCOMESECONDS);
+				}
+		};
+	}
+}
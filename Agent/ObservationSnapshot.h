@@ -0,0 +1,160 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <sc2api/sc2_api.h>
+#include <vector>
+#include "DecisionTrace.h"
+#include "UnitIndex.h"
+
+namespace KoKeKoKo
+{
+	namespace Agent
+	{
+		using namespace sc2;
+
+		//A copy of what the model service needs from the observation of a game loop, captured by the game thread and read by the other threads
+		//The arrays are kept between captures, so a capture does not allocate once the armies stop growing
+		class ObservationSnapshot
+		{
+			private:
+				//The alive units of our own and of the enemy, sorted by unit type like the unit index
+				std::vector<ObservedUnit> _selfunits;
+				std::vector<ObservedUnit> _enemyunits;
+				//The upgrades that have been researched
+				std::vector<uint32_t> _upgrades;
+				uint32_t _gameloop;
+				uint32_t _playerid;
+				int32_t _minerals;
+				int32_t _vespene;
+				int32_t _foodused;
+				int32_t _workers;
+				//When the snapshot was captured and handed over to the provider, which stamps the actions decided on it
+				DecisionStamp _stamp;
+
+				static void AddUnit(std::vector<ObservedUnit>& units, const Unit* unit)
+				{
+					ObservedUnit observedunit;
+
+					observedunit.tag = unit->tag;
+					observedunit.type = static_cast<uint32_t>(unit->unit_type.ToType());
+					observedunit.alliance = static_cast<uint32_t>(unit->alliance);
+					observedunit.x = unit->pos.x;
+					observedunit.y = unit->pos.y;
+					units.push_back(observedunit);
+				}
+
+			public:
+				ObservationSnapshot()
+				{
+					_gameloop = 0;
+					_playerid = 0;
+					_minerals = 0;
+					_vespene = 0;
+					_foodused = 0;
+					_workers = 0;
+					_stamp = DecisionStamp();
+				}
+
+				//Copies the observation of the game loop, the unit index must already have been updated for it
+				//The units are copied in one pass from the copies that the unit index has made, only a game loop with a dead unit reads them again to leave it out
+				//Must only be called by the game thread
+				void Capture(const ObservationInterface* observation, const UnitIndex& unitindex)
+				{
+					auto self_units = unitindex.GetObservedUnits(Unit::Alliance::Self), enemy_units = unitindex.GetObservedUnits(Unit::Alliance::Enemy);
+
+					if (unitindex.CountDead() == 0)
+					{
+						_selfunits.assign(self_units.begin(), self_units.end());
+						_enemyunits.assign(enemy_units.begin(), enemy_units.end());
+					}
+					else
+					{
+						_selfunits.clear();
+						_enemyunits.clear();
+						for (const auto& unit : unitindex.GetAllUnits())
+						{
+							if (!unit->is_alive)
+								continue;
+
+							if (unit->alliance == Unit::Alliance::Self)
+								AddUnit(_selfunits, unit);
+							else if (unit->alliance == Unit::Alliance::Enemy)
+								AddUnit(_enemyunits, unit);
+						}
+					}
+
+					_upgrades.clear();
+					for (const auto& upgrade : observation->GetUpgrades())
+						_upgrades.push_back(static_cast<uint32_t>(upgrade.ToType()));
+
+					_gameloop = observation->GetGameLoop();
+					_playerid = observation->GetPlayerID();
+					_minerals = observation->GetMinerals();
+					_vespene = observation->GetVespene();
+					_foodused = observation->GetFoodUsed();
+					_workers = static_cast<int32_t>(unitindex.CountOf(UNIT_TYPEID::TERRAN_SCV));
+					_stamp = DecisionStamp();
+					_stamp.gameloop = _gameloop;
+					_stamp.captured = std::chrono::steady_clock::now();
+				}
+
+				//Stamps when the snapshot is handed over to the provider
+				//Must only be called by the thread that sends updates, which owns the snapshot once it has acquired it
+				void StampRequest()
+				{
+					_stamp.requested = std::chrono::steady_clock::now();
+				}
+
+				UnitIndexRange<ObservedUnit> GetSelfUnits() const
+				{
+					return UnitIndexRange<ObservedUnit>(_selfunits.data(), _selfunits.data() + _selfunits.size());
+				}
+
+				UnitIndexRange<ObservedUnit> GetEnemyUnits() const
+				{
+					return UnitIndexRange<ObservedUnit>(_enemyunits.data(), _enemyunits.data() + _enemyunits.size());
+				}
+
+				const std::vector<uint32_t>& GetUpgrades() const
+				{
+					return _upgrades;
+				}
+
+				uint32_t GetGameLoop() const
+				{
+					return _gameloop;
+				}
+
+				const DecisionStamp& GetStamp() const
+				{
+					return _stamp;
+				}
+
+				uint32_t GetPlayerID() const
+				{
+					return _playerid;
+				}
+
+				int32_t GetMinerals() const
+				{
+					return _minerals;
+				}
+
+				int32_t GetVespene() const
+				{
+					return _vespene;
+				}
+
+				int32_t GetFoodUsed() const
+				{
+					return _foodused;
+				}
+
+				int32_t GetWorkers() const
+				{
+					return _workers;
+				}
+		};
+	}
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Action.h"
+
+//Generated by Documents/Scripts/Opening_Generator.py from Documents/Testing/CommandsRepository.csv, do not edit
+namespace KoKeKoKo
+{
+	namespace Agent
+	{
+		//The build order that the agent follows until model service has sent its first actions
+		//Each action is the most common next action of the 326 openings that have been recorded, among the ones that have followed it so far
+		constexpr Action OPENING_ACTIONS[] =
+		{
+			Action::TRAIN_SCV, //312 games
+			Action::BUILD_SUPPLYDEPOT, //306 games
+			Action::TRAIN_SCV, //296 games
+			Action::BUILD_REFINERY, //189 games
+			Action::TRAIN_SCV, //178 games
+			Action::BUILD_BARRACKS, //174 games
+			Action::TRAIN_SCV, //171 games
+			Action::BUILD_REFINERY, //82 games
+			Action::TRAIN_SCV, //82 games
+			Action::TRAIN_SCV, //81 games
+			Action::TRAIN_SCV, //79 games
+			Action::BUILD_FACTORY, //77 games
+			Action::BUILD_SUPPLYDEPOT, //67 games
+			Action::EFFECT_CALLDOWNMULE, //67 games
+			Action::TRAIN_REAPER, //61 games
+			Action::TRAIN_SCV, //60 games
+			Action::TRAIN_SCV, //42 games
+			Action::BUILD_COMMANDCENTER, //29 games
+			Action::TRAIN_SCV, //22 games
+			Action::TRAIN_REAPER //16 games
+		};
+
+		//The number of actions in the opening
+		const size_t OPENING_ACTIONCOUNT = sizeof(OPENING_ACTIONS) / sizeof(OPENING_ACTIONS[0]);
+	}
+}
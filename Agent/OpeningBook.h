@@ -0,0 +1,382 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../Repository/ColumnarRepository.h"
+#include "../Repository/RepositoryCache.h"
+#include "../Types/MappedFile.h"
+#include "Action.h"
+
+namespace KoKeKoKo
+{
+	namespace Agent
+	{
+		//The first bytes of an opening book, and the version of its layout that is written and read
+		const char OPENINGBOOK_MAGIC[8] = { 'K', 'O', 'K', 'E', 'B', 'O', 'O', 'K' };
+		const uint32_t OPENINGBOOK_VERSION = 1;
+		//Every section starts on a cache line
+		const size_t OPENINGBOOK_ALIGNMENT = 64;
+		//Only the commands within the first minutes of a game are part of an opening, the same as Opening_Generator.py
+		const uint32_t OPENINGBOOK_SECONDS = 300;
+		//The most actions of an opening that the book keeps
+		const size_t OPENINGBOOK_MAXIMUMDEPTH = 32;
+		//The rank that counts the openings of every rank, the ranks of the repository come after it
+		const uint32_t OPENINGBOOK_ALLRANKS = 0;
+		//The node of a sequence of actions that no recorded opening has started with
+		const uint32_t OPENINGBOOK_NONODE = std::numeric_limits<uint32_t>::max();
+		//The longest name of a rank, with the terminating zero
+		const size_t OPENINGBOOK_RANKNAMELENGTH = 28;
+
+		static_assert(ACTION_COUNT <= std::numeric_limits<uint8_t>::max(), "The children of a node of the opening book are counted in a byte");
+
+		//The start of an opening book, the sections are the ranks, the nodes, and the games of every node for every rank
+		struct OpeningBookHeader
+		{
+			char magic[8];
+			uint32_t version;
+			uint32_t rankcount;
+			uint32_t nodecount;
+			uint32_t depth;
+			uint64_t size;
+			//The checksum of everything after the header
+			uint64_t checksum;
+			uint64_t ranksoffset;
+			uint64_t nodesoffset;
+			uint64_t gamesoffset;
+		};
+
+		struct OpeningBookRank
+		{
+			char name[OPENINGBOOK_RANKNAMELENGTH];
+			uint32_t openings;
+		};
+
+		//A node of the trie is a sequence of actions that an opening has started with, the node of the empty sequence is the first one
+		//The nodes are stored in breadth-first order, so the children of a node are next to each other and sorted by their action
+		struct OpeningBookNode
+		{
+			uint32_t firstchild;
+			uint8_t childcount;
+			Action action;
+			uint8_t depth;
+			uint8_t padding;
+		};
+
+		//An action that has followed a node, and the number of openings of a rank that have followed it with that action
+		struct OpeningBookSuccessor
+		{
+			Action action;
+			uint32_t node;
+			uint32_t games;
+		};
+
+		//The openings of CommandsRepository.csv as a trie of the actions that the agent knows, with the number of openings of each rank that went through every node
+		//The book is written once from the repository and mapped by the agent, a lookup walks down from the first node one action at a time
+		class OpeningBook
+		{
+			private:
+				//A node of the trie while it is built, its children are found by their action
+				struct BuildNode
+				{
+					Action action;
+					std::vector<std::pair<Action, uint32_t>> children;
+					std::vector<uint32_t> games;
+				};
+
+				std::unique_ptr<Types::MappedFile> _file;
+				const OpeningBookRank* _ranks;
+				const OpeningBookNode* _nodes;
+				//The games of a node for each rank, one row of ranks for each node
+				const uint32_t* _games;
+				uint32_t _rankcount;
+				uint32_t _nodecount;
+				uint32_t _depth;
+
+				OpeningBook(const OpeningBook&);
+				OpeningBook& operator=(const OpeningBook&);
+
+				static size_t Align(size_t size)
+				{
+					return (size + OPENINGBOOK_ALIGNMENT - 1) & ~(OPENINGBOOK_ALIGNMENT - 1);
+				}
+
+				//Returns the openings of every player of every replay, the actions in the order of their seconds
+				static std::vector<std::pair<uint32_t, std::vector<Action>>> GetOpenings(const Repository::CommandsRepository& commands, const std::vector<uint32_t>& rankofreplayrank, uint32_t seconds, size_t depth)
+				{
+					const Repository::RepositoryDictionary& names = commands.GetDictionary(Repository::CommandsColumns::COMMANDS);
+					const Repository::CommandsColumns& columns = commands.GetColumns();
+					std::vector<Action> actions;
+					std::vector<std::pair<uint32_t, std::vector<Action>>> openings;
+
+					for (size_t name = 0; name < names.GetCount(); name++)
+					{
+						const std::string& command = names.GetName(static_cast<uint16_t>(name));
+
+						actions.push_back(ParseAction(command.data(), command.size()));
+					}
+					for (const auto& replay : commands.GetReplays())
+					{
+						std::map<uint16_t, std::vector<std::pair<uint32_t, Action>>> players;
+
+						for (uint32_t row = replay.firstrow; row < (replay.firstrow + replay.rowcount); row++)
+							if (columns.seconds[row] <= seconds && actions[columns.commands[row]] != Action::NONE)
+								players[columns.players[row]].emplace_back(columns.seconds[row], actions[columns.commands[row]]);
+						for (auto& player : players)
+						{
+							std::vector<Action> opening;
+
+							std::stable_sort(player.second.begin(), player.second.end(), [](const std::pair<uint32_t, Action>& command, const std::pair<uint32_t, Action>& other) { return command.first < other.first; });
+							for (size_t index = 0; index < player.second.size() && index < depth; index++)
+								opening.push_back(player.second[index].second);
+							openings.emplace_back(rankofreplayrank[replay.rank], std::move(opening));
+						}
+					}
+
+					return openings;
+				}
+
+			public:
+				OpeningBook() : _ranks(nullptr), _nodes(nullptr), _games(nullptr), _rankcount(0), _nodecount(0), _depth(0)
+				{
+
+				}
+
+				//Builds the book from the openings of the repository and writes it, the file is replaced
+				static void Write(const std::string& path, const Repository::CommandsRepository& commands, uint32_t seconds = OPENINGBOOK_SECONDS, size_t depth = OPENINGBOOK_MAXIMUMDEPTH)
+				{
+					std::vector<OpeningBookRank> ranks(1, OpeningBookRank());
+					std::vector<uint32_t> rankofreplayrank;
+					std::vector<BuildNode> trie(1);
+
+					if (depth > std::numeric_limits<uint8_t>::max())
+						throw std::runtime_error("Error Occurred! The openings of an opening book are too long...");
+					//A rank can have more than one part in the repository, they are counted as one
+					for (const auto& rank : commands.GetRanks())
+					{
+						size_t index = 1;
+
+						while (index < ranks.size() && rank.name != ranks[index].name)
+							index++;
+						if (index == ranks.size())
+						{
+							if (rank.name.size() >= OPENINGBOOK_RANKNAMELENGTH)
+								throw std::runtime_error("Error Occurred! The rank " + rank.name + " is too long for an opening book...");
+							ranks.push_back(OpeningBookRank());
+							std::memcpy(ranks.back().name, rank.name.data(), rank.name.size());
+						}
+						rankofreplayrank.push_back(static_cast<uint32_t>(index));
+					}
+
+					trie[0].action = Action::NONE;
+					trie[0].games.assign(ranks.size(), 0);
+					for (const auto& opening : GetOpenings(commands, rankofreplayrank, seconds, depth))
+					{
+						uint32_t node = 0;
+
+						ranks[OPENINGBOOK_ALLRANKS].openings++;
+						ranks[opening.first].openings++;
+						trie[0].games[OPENINGBOOK_ALLRANKS]++;
+						trie[0].games[opening.first]++;
+						for (Action action : opening.second)
+						{
+							auto child = std::find_if(trie[node].children.begin(), trie[node].children.end(), [action](const std::pair<Action, uint32_t>& entry) { return entry.first == action; });
+
+							if (child == trie[node].children.end())
+							{
+								trie[node].children.emplace_back(action, static_cast<uint32_t>(trie.size()));
+								trie.push_back({ action, std::vector<std::pair<Action, uint32_t>>(), std::vector<uint32_t>(ranks.size(), 0) });
+								node = static_cast<uint32_t>(trie.size() - 1);
+							}
+							else
+								node = child->second;
+							trie[node].games[OPENINGBOOK_ALLRANKS]++;
+							trie[node].games[opening.first]++;
+						}
+					}
+
+					//Lay the trie out breadth-first, the children of a node get the next indexes in the order of their action
+					std::vector<uint32_t> order(1, 0);
+					std::vector<OpeningBookNode> nodes;
+					std::vector<uint32_t> games;
+					uint32_t maximumdepth = 0;
+					nodes.push_back({ 0, 0, Action::NONE, 0, 0 });
+					for (size_t index = 0; index < order.size(); index++)
+					{
+						BuildNode& node = trie[order[index]];
+
+						std::sort(node.children.begin(), node.children.end());
+						nodes[index].firstchild = static_cast<uint32_t>(order.size());
+						nodes[index].childcount = static_cast<uint8_t>(node.children.size());
+						for (const auto& child : node.children)
+						{
+							order.push_back(child.second);
+							nodes.push_back({ 0, 0, child.first, static_cast<uint8_t>(nodes[index].depth + 1), 0 });
+							maximumdepth = std::max<uint32_t>(maximumdepth, nodes[index].depth + 1u);
+						}
+						games.insert(games.end(), node.games.begin(), node.games.end());
+					}
+
+					OpeningBookHeader header;
+					std::memcpy(header.magic, OPENINGBOOK_MAGIC, sizeof(header.magic));
+					header.version = OPENINGBOOK_VERSION;
+					header.rankcount = static_cast<uint32_t>(ranks.size());
+					header.nodecount = static_cast<uint32_t>(nodes.size());
+					header.depth = maximumdepth;
+					header.ranksoffset = Align(sizeof(OpeningBookHeader));
+					header.nodesoffset = Align(header.ranksoffset + (ranks.size() * sizeof(OpeningBookRank)));
+					header.gamesoffset = Align(header.nodesoffset + (nodes.size() * sizeof(OpeningBookNode)));
+					header.size = header.gamesoffset + (games.size() * sizeof(uint32_t));
+
+					std::vector<char> file(static_cast<size_t>(header.size), 0);
+					std::memcpy(file.data() + header.ranksoffset, ranks.data(), ranks.size() * sizeof(OpeningBookRank));
+					std::memcpy(file.data() + header.nodesoffset, nodes.data(), nodes.size() * sizeof(OpeningBookNode));
+					std::memcpy(file.data() + header.gamesoffset, games.data(), games.size() * sizeof(uint32_t));
+					header.checksum = Repository::RepositoryCache::GetChecksum(file.data() + sizeof(OpeningBookHeader), file.size() - sizeof(OpeningBookHeader));
+					std::memcpy(file.data(), &header, sizeof(header));
+
+					std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+					if (!stream.write(file.data(), static_cast<std::streamsize>(file.size())) || !stream.flush())
+						throw std::runtime_error("Error Occurred! Failed to write the opening book to " + path + "...");
+				}
+
+				//Maps the book and checks every node once, so a lookup never leaves the file
+				void Open(const std::string& path, bool ischecked = true)
+				{
+					OpeningBookHeader header;
+
+					_file.reset(new Types::MappedFile(path));
+					if (_file->GetSize() < sizeof(OpeningBookHeader))
+						throw std::runtime_error("Error Occurred! " + path + " is too small to be an opening book...");
+					std::memcpy(&header, _file->GetData(), sizeof(header));
+					if (std::memcmp(header.magic, OPENINGBOOK_MAGIC, sizeof(header.magic)) != 0)
+						throw std::runtime_error("Error Occurred! " + path + " is not an opening book...");
+					if (header.version != OPENINGBOOK_VERSION)
+						throw std::runtime_error("Error Occurred! " + path + " is an opening book of another version...");
+					if (header.size != _file->GetSize() || header.rankcount == 0 || header.nodecount == 0 || header.ranksoffset < sizeof(OpeningBookHeader) || (header.ranksoffset % OPENINGBOOK_ALIGNMENT) != 0 || (header.nodesoffset % OPENINGBOOK_ALIGNMENT) != 0 || (header.gamesoffset % OPENINGBOOK_ALIGNMENT) != 0
+						|| header.nodesoffset < (header.ranksoffset + (static_cast<uint64_t>(header.rankcount) * sizeof(OpeningBookRank))) || header.gamesoffset < (header.nodesoffset + (static_cast<uint64_t>(header.nodecount) * sizeof(OpeningBookNode)))
+						|| header.gamesoffset > header.size || (static_cast<uint64_t>(header.nodecount) * header.rankcount) > ((header.size - header.gamesoffset) / sizeof(uint32_t)))
+						throw std::runtime_error("Error Occurred! The sections of " + path + " do not fit the file...");
+					if (ischecked && header.checksum != Repository::RepositoryCache::GetChecksum(_file->GetData() + sizeof(OpeningBookHeader), _file->GetSize() - sizeof(OpeningBookHeader)))
+						throw std::runtime_error("Error Occurred! The checksum of " + path + " does not match...");
+
+					const OpeningBookNode* nodes = reinterpret_cast<const OpeningBookNode*>(_file->GetData() + header.nodesoffset);
+					for (uint32_t node = 0; node < header.nodecount; node++)
+					{
+						if (nodes[node].childcount > 0 && (nodes[node].firstchild <= node || nodes[node].firstchild > header.nodecount || nodes[node].childcount > (header.nodecount - nodes[node].firstchild)))
+							throw std::runtime_error("Error Occurred! A node of " + path + " has children outside of the book...");
+						for (uint32_t child = 0; child < nodes[node].childcount; child++)
+							if (static_cast<size_t>(nodes[nodes[node].firstchild + child].action) >= ACTION_COUNT || (child > 0 && nodes[nodes[node].firstchild + child].action <= nodes[nodes[node].firstchild + child - 1].action))
+								throw std::runtime_error("Error Occurred! The children of a node of " + path + " are not sorted by their action...");
+					}
+					_ranks = reinterpret_cast<const OpeningBookRank*>(_file->GetData() + header.ranksoffset);
+					_nodes = nodes;
+					_games = reinterpret_cast<const uint32_t*>(_file->GetData() + header.gamesoffset);
+					_rankcount = header.rankcount;
+					_nodecount = header.nodecount;
+					_depth = header.depth;
+				}
+
+				//Returns the node that follows a node with an action, or no node if no opening has done that
+				uint32_t GetChild(uint32_t node, Action action) const
+				{
+					if (node >= _nodecount)
+						return OPENINGBOOK_NONODE;
+
+					const OpeningBookNode* first = _nodes + _nodes[node].firstchild;
+					const OpeningBookNode* last = first + _nodes[node].childcount;
+					const OpeningBookNode* child = std::lower_bound(first, last, action, [](const OpeningBookNode& entry, Action value) { return entry.action < value; });
+
+					return (child != last && child->action == action) ? static_cast<uint32_t>(child - _nodes) : OPENINGBOOK_NONODE;
+				}
+
+				//Returns the node of the actions that the agent has executed so far, one step down the trie for each action
+				uint32_t Find(const Action* actions, size_t count) const
+				{
+					uint32_t node = (_nodecount > 0) ? 0 : OPENINGBOOK_NONODE;
+
+					for (size_t index = 0; index < count && node != OPENINGBOOK_NONODE; index++)
+						node = GetChild(node, actions[index]);
+
+					return node;
+				}
+
+				//Writes the most likely next actions of a node for a rank into the caller-provided buffer, the most played first, and returns the number of them
+				size_t GetSuccessors(uint32_t node, uint32_t rank, OpeningBookSuccessor* successors, size_t capacity) const
+				{
+					size_t count = 0;
+
+					if (node >= _nodecount || rank >= _rankcount)
+						return 0;
+					for (uint32_t child = _nodes[node].firstchild; child < (_nodes[node].firstchild + _nodes[node].childcount); child++)
+					{
+						OpeningBookSuccessor successor = { _nodes[child].action, child, _games[(static_cast<size_t>(child) * _rankcount) + rank] };
+						size_t position = count;
+
+						if (successor.games == 0 || (count == capacity && (count == 0 || successors[count - 1].games >= successor.games)))
+							continue;
+						if (count < capacity)
+							count++;
+						for (; position > 0 && successors[position - 1].games < successor.games; position--)
+							if (position < capacity)
+								successors[position] = successors[position - 1];
+						if (position < capacity)
+							successors[position] = successor;
+					}
+
+					return count;
+				}
+
+				//Returns the number of openings of a rank that have gone through a node
+				uint32_t GetGames(uint32_t node, uint32_t rank) const
+				{
+					return (node < _nodecount && rank < _rankcount) ? _games[(static_cast<size_t>(node) * _rankcount) + rank] : 0;
+				}
+
+				//Returns the rank of a name, or every rank if the book has no openings of it
+				uint32_t FindRank(const std::string& name) const
+				{
+					for (uint32_t rank = 1; rank < _rankcount; rank++)
+						if (name == GetRankName(rank))
+							return rank;
+
+					return OPENINGBOOK_ALLRANKS;
+				}
+
+				std::string GetRankName(uint32_t rank) const
+				{
+					return (rank < _rankcount) ? std::string(_ranks[rank].name, strnlen(_ranks[rank].name, OPENINGBOOK_RANKNAMELENGTH)) : std::string();
+				}
+
+				uint32_t GetRankCount() const
+				{
+					return _rankcount;
+				}
+
+				uint32_t GetNodeCount() const
+				{
+					return _nodecount;
+				}
+
+				//Returns the most actions of an opening in the book
+				uint32_t GetDepth() const
+				{
+					return _depth;
+				}
+
+				bool IsOpen() const
+				{
+					return _nodecount > 0;
+				}
+		};
+	}
+}
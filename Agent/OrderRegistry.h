@@ -0,0 +1,200 @@
+#pragma once
+
+#include <cstdint>
+#include <sc2api/sc2_api.h>
+#include <vector>
+
+namespace KoKeKoKo
+{
+	namespace Agent
+	{
+		using namespace sc2;
+		//The number of abilities that have their own counter, the rest share the last counter
+		const size_t ORDERREGISTRY_ABILITIES = 8192;
+		//The number of game loops that an issued order is kept while it has not appeared in the orders of its unit
+		const uint32_t ORDERREGISTRY_PENDINGLOOPS = 32;
+
+		//Keeps the number of orders of our units for each ability, so that a duplicate order is found without scanning the units
+		//The orders are recounted once per game loop, and the orders issued since then are kept as pending until they are observed
+		class OrderRegistry
+		{
+			private:
+				//An order that has been issued but has not appeared in the orders of its unit yet
+				struct PendingOrder
+				{
+					Tag unit;
+					ABILITY_ID ability;
+					uint32_t gameloop;
+				};
+
+				//The number of observed orders of each ability
+				std::vector<uint32_t> _observedcounts;
+				//The number of pending orders of each ability
+				std::vector<uint32_t> _pendingcounts;
+				//The abilities that have observed orders, only these are cleared on the next recount
+				std::vector<uint32_t> _usedabilities;
+				//The orders that have been issued but not observed
+				std::vector<PendingOrder> _pendingorders;
+				//The game loop of the last recount
+				uint32_t _gameloop;
+				//The number of orders that have been issued
+				uint64_t _issued;
+				//The number of issued orders that were never observed
+				uint64_t _expired;
+
+				static size_t GetCounter(ABILITY_ID ability)
+				{
+					size_t counter = static_cast<size_t>(ability);
+
+					return ((counter < ORDERREGISTRY_ABILITIES) ? counter : (ORDERREGISTRY_ABILITIES - 1));
+				}
+
+				//Forgets the pending orders that match the predicate
+				template<typename Predicate>
+				void ForgetPendingOrders(Predicate predicate)
+				{
+					for (size_t index = 0; index < _pendingorders.size();)
+					{
+						if (predicate(_pendingorders[index]))
+						{
+							_pendingcounts[GetCounter(_pendingorders[index].ability)]--;
+							_pendingorders[index] = _pendingorders.back();
+							_pendingorders.pop_back();
+						}
+						else
+							index++;
+					}
+				}
+
+				//Returns true if the unit has an order of the ability
+				static bool HasOrder(const Unit* unit, ABILITY_ID ability)
+				{
+					for (const auto& order : unit->orders)
+					{
+						if (order.ability_id == ability)
+							return true;
+					}
+
+					return false;
+				}
+
+			public:
+				OrderRegistry()
+				{
+					_observedcounts = std::vector<uint32_t>(ORDERREGISTRY_ABILITIES, 0);
+					_pendingcounts = std::vector<uint32_t>(ORDERREGISTRY_ABILITIES, 0);
+					_gameloop = 0;
+					_issued = 0;
+					_expired = 0;
+				}
+
+				//Recounts the orders of our units, and forgets the pending orders that have been observed or have expired
+				void Update(const ObservationInterface* observation, const Units& units)
+				{
+					for (const auto& ability : _usedabilities)
+						_observedcounts[ability] = 0;
+					_usedabilities.clear();
+
+					for (const auto& unit : units)
+					{
+						if (unit->alliance != Unit::Alliance::Self)
+							continue;
+
+						for (const auto& order : unit->orders)
+						{
+							size_t counter = GetCounter(order.ability_id);
+							if (_observedcounts[counter]++ == 0)
+								_usedabilities.push_back(static_cast<uint32_t>(counter));
+						}
+					}
+
+					_gameloop = observation->GetGameLoop();
+					ForgetPendingOrders([this, observation](const PendingOrder& pendingorder)
+					{
+						const Unit* unit = observation->GetUnit(pendingorder.unit);
+
+						if (unit != nullptr && HasOrder(unit, pendingorder.ability))
+							return true;
+						if ((_gameloop - pendingorder.gameloop) > ORDERREGISTRY_PENDINGLOOPS)
+						{
+							_expired++;
+							return true;
+						}
+
+						return false;
+					});
+				}
+
+				//Keeps an order that has just been issued, so it is in flight before it appears in the observation
+				void Issue(const Unit* unit, ABILITY_ID ability)
+				{
+					PendingOrder pendingorder;
+
+					pendingorder.unit = unit->tag;
+					pendingorder.ability = ability;
+					pendingorder.gameloop = _gameloop;
+					_pendingorders.push_back(pendingorder);
+					_pendingcounts[GetCounter(ability)]++;
+					_issued++;
+				}
+
+				//An idle unit is not carrying out any of the orders issued to it
+				void OnUnitIdle(const Unit* unit)
+				{
+					Tag tag = unit->tag;
+					ForgetPendingOrders([tag](const PendingOrder& pendingorder) { return (pendingorder.unit == tag); });
+				}
+
+				//A destroyed unit will never carry out the orders issued to it
+				void OnUnitDestroyed(const Unit* unit)
+				{
+					OnUnitIdle(unit);
+				}
+
+				//A created unit fulfills one pending order of the ability that produces it
+				void OnUnitCreated(ABILITY_ID ability)
+				{
+					for (size_t index = 0; index < _pendingorders.size(); index++)
+					{
+						if (_pendingorders[index].ability == ability)
+						{
+							_pendingcounts[GetCounter(ability)]--;
+							_pendingorders[index] = _pendingorders.back();
+							_pendingorders.pop_back();
+							break;
+						}
+					}
+				}
+
+				//Returns true if any of our units has or has just been issued an order of the ability
+				bool IsInFlight(ABILITY_ID ability) const
+				{
+					size_t counter = GetCounter(ability);
+					return ((_observedcounts[counter] + _pendingcounts[counter]) > 0);
+				}
+
+				//Returns the number of orders of the ability that our units have or have just been issued
+				size_t CountInFlight(ABILITY_ID ability) const
+				{
+					size_t counter = GetCounter(ability);
+					return (_observedcounts[counter] + _pendingcounts[counter]);
+				}
+
+				//Returns the number of orders of the ability that have been issued but not observed yet
+				size_t CountPending(ABILITY_ID ability) const
+				{
+					return _pendingcounts[GetCounter(ability)];
+				}
+
+				uint64_t GetIssuedCount() const
+				{
+					return _issued;
+				}
+
+				uint64_t GetExpiredCount() const
+				{
+					return _expired;
+				}
+		};
+	}
+}
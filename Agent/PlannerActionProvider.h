@@ -0,0 +1,249 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <sc2api/sc2_api.h>
+#include "../Types/Logger.h"
+#include "ActionProvider.h"
+#include "MacroPlanner.h"
+#include "MacroState.h"
+#include "ResourceBudget.h"
+#include "TerranData.h"
+
+namespace KoKeKoKo
+{
+	namespace Agent
+	{
+		using namespace sc2;
+
+		//The time that the planner searches for a decision, and how long to wait before the next one
+		const std::chrono::milliseconds PLANNER_DECISIONBUDGET = std::chrono::milliseconds(100);
+		const std::chrono::milliseconds PLANNER_DECISIONINTERVAL = std::chrono::milliseconds(500);
+		//The number of decided actions that can wait to be collected, newer actions are dropped when it is full
+		const size_t PLANNER_MAXIMUMQUEUEDACTIONS = 64;
+		//The game loops in a second of game time on the faster speed
+		const float GAMELOOPS_PERSECOND = 22.4f;
+
+		//Decides the actions in the same process with a Monte Carlo tree search over the macro of the agent
+		//Only the first action of each plan is queued, the next decision plans again from what the agent has done by then
+		class PlannerActionProvider : public QueuedActionProvider
+		{
+			private:
+				MacroPlanner _planner;
+				//The number of decisions, the time that they have taken, and the iterations of the search
+				std::atomic<uint64_t> _decisions;
+				std::atomic<uint64_t> _decisionnanoseconds;
+				std::atomic<uint64_t> _iterations;
+
+				PlannerActionProvider(const PlannerActionProvider&);
+				PlannerActionProvider& operator=(const PlannerActionProvider&);
+
+				//Returns the macro unit of a unit type, or NONE if it is not part of the macro or is an army unit
+				static MacroUnit GetMacroUnit(UNIT_TYPEID type)
+				{
+					switch (type)
+					{
+						case UNIT_TYPEID::TERRAN_SCV:
+							return MacroUnit::SCV;
+						case UNIT_TYPEID::TERRAN_COMMANDCENTER:
+						case UNIT_TYPEID::TERRAN_COMMANDCENTERFLYING:
+							return MacroUnit::COMMANDCENTER;
+						case UNIT_TYPEID::TERRAN_ORBITALCOMMAND:
+						case UNIT_TYPEID::TERRAN_ORBITALCOMMANDFLYING:
+							return MacroUnit::ORBITALCOMMAND;
+						case UNIT_TYPEID::TERRAN_PLANETARYFORTRESS:
+							return MacroUnit::PLANETARYFORTRESS;
+						case UNIT_TYPEID::TERRAN_SUPPLYDEPOT:
+						case UNIT_TYPEID::TERRAN_SUPPLYDEPOTLOWERED:
+							return MacroUnit::SUPPLYDEPOT;
+						case UNIT_TYPEID::TERRAN_REFINERY:
+							return MacroUnit::REFINERY;
+						case UNIT_TYPEID::TERRAN_BARRACKS:
+						case UNIT_TYPEID::TERRAN_BARRACKSFLYING:
+							return MacroUnit::BARRACKS;
+						case UNIT_TYPEID::TERRAN_BARRACKSTECHLAB:
+							return MacroUnit::BARRACKSTECHLAB;
+						case UNIT_TYPEID::TERRAN_BARRACKSREACTOR:
+							return MacroUnit::BARRACKSREACTOR;
+						case UNIT_TYPEID::TERRAN_FACTORY:
+						case UNIT_TYPEID::TERRAN_FACTORYFLYING:
+							return MacroUnit::FACTORY;
+						case UNIT_TYPEID::TERRAN_FACTORYTECHLAB:
+							return MacroUnit::FACTORYTECHLAB;
+						case UNIT_TYPEID::TERRAN_FACTORYREACTOR:
+							return MacroUnit::FACTORYREACTOR;
+						case UNIT_TYPEID::TERRAN_STARPORT:
+						case UNIT_TYPEID::TERRAN_STARPORTFLYING:
+							return MacroUnit::STARPORT;
+						case UNIT_TYPEID::TERRAN_STARPORTTECHLAB:
+							return MacroUnit::STARPORTTECHLAB;
+						case UNIT_TYPEID::TERRAN_STARPORTREACTOR:
+							return MacroUnit::STARPORTREACTOR;
+						case UNIT_TYPEID::TERRAN_ENGINEERINGBAY:
+							return MacroUnit::ENGINEERINGBAY;
+						case UNIT_TYPEID::TERRAN_ARMORY:
+							return MacroUnit::ARMORY;
+						case UNIT_TYPEID::TERRAN_FUSIONCORE:
+							return MacroUnit::FUSIONCORE;
+						case UNIT_TYPEID::TERRAN_GHOSTACADEMY:
+							return MacroUnit::GHOSTACADEMY;
+						case UNIT_TYPEID::TERRAN_BUNKER:
+							return MacroUnit::BUNKER;
+						case UNIT_TYPEID::TERRAN_MISSILETURRET:
+							return MacroUnit::MISSILETURRET;
+						case UNIT_TYPEID::TERRAN_SENSORTOWER:
+							return MacroUnit::SENSORTOWER;
+						default:
+							return MacroUnit::NONE;
+					}
+				}
+
+				//Returns the action that trains an army unit, or NONE if the unit type is not an army unit
+				static Action GetTrainAction(UNIT_TYPEID type)
+				{
+					switch (type)
+					{
+						case UNIT_TYPEID::TERRAN_MARINE:
+							return Action::TRAIN_MARINE;
+						case UNIT_TYPEID::TERRAN_REAPER:
+							return Action::TRAIN_REAPER;
+						case UNIT_TYPEID::TERRAN_MARAUDER:
+							return Action::TRAIN_MARAUDER;
+						case UNIT_TYPEID::TERRAN_GHOST:
+							return Action::TRAIN_GHOST;
+						case UNIT_TYPEID::TERRAN_HELLION:
+							return Action::TRAIN_HELLION;
+						case UNIT_TYPEID::TERRAN_HELLIONTANK:
+							return Action::TRAIN_HELLBAT;
+						case UNIT_TYPEID::TERRAN_WIDOWMINE:
+							return Action::TRAIN_WIDOWMINE;
+						case UNIT_TYPEID::TERRAN_SIEGETANK:
+						case UNIT_TYPEID::TERRAN_SIEGETANKSIEGED:
+							return Action::TRAIN_SIEGETANK;
+						case UNIT_TYPEID::TERRAN_CYCLONE:
+							return Action::TRAIN_CYCLONE;
+						case UNIT_TYPEID::TERRAN_THOR:
+							return Action::TRAIN_THOR;
+						case UNIT_TYPEID::TERRAN_VIKINGFIGHTER:
+						case UNIT_TYPEID::TERRAN_VIKINGASSAULT:
+							return Action::TRAIN_VIKINGFIGHTER;
+						case UNIT_TYPEID::TERRAN_MEDIVAC:
+							return Action::TRAIN_MEDIVAC;
+						case UNIT_TYPEID::TERRAN_LIBERATOR:
+						case UNIT_TYPEID::TERRAN_LIBERATORAG:
+							return Action::TRAIN_LIBERATOR;
+						case UNIT_TYPEID::TERRAN_RAVEN:
+							return Action::TRAIN_RAVEN;
+						case UNIT_TYPEID::TERRAN_BANSHEE:
+							return Action::TRAIN_BANSHEE;
+						case UNIT_TYPEID::TERRAN_BATTLECRUISER:
+							return Action::TRAIN_BATTLECRUISER;
+						default:
+							return Action::NONE;
+					}
+				}
+
+				//Returns the action that researches an upgrade, or NONE if the agent does not research it, the levels after the first are not planned
+				static Action GetResearchAction(UPGRADE_ID upgrade)
+				{
+					switch (upgrade)
+					{
+						case UPGRADE_ID::STIMPACK:
+							return Action::RESEARCH_STIMPACK;
+						case UPGRADE_ID::SHIELDWALL:
+							return Action::RESEARCH_COMBATSHIELD;
+						case UPGRADE_ID::PUNISHERGRENADES:
+							return Action::RESEARCH_CONCUSSIVESHELLS;
+						case UPGRADE_ID::TERRANINFANTRYWEAPONSLEVEL1:
+							return Action::RESEARCH_TERRANINFANTRYWEAPONS;
+						case UPGRADE_ID::TERRANINFANTRYARMORSLEVEL1:
+							return Action::RESEARCH_TERRANINFANTRYARMOR;
+						case UPGRADE_ID::TERRANVEHICLEWEAPONSLEVEL1:
+							return Action::RESEARCH_TERRANVEHICLEWEAPONS;
+						case UPGRADE_ID::TERRANSHIPWEAPONSLEVEL1:
+							return Action::RESEARCH_TERRANSHIPWEAPONS;
+						case UPGRADE_ID::TERRANVEHICLEANDSHIPARMORSLEVEL1:
+							return Action::RESEARCH_TERRANVEHICLEANDSHIPPLATING;
+						default:
+							return Action::NONE;
+					}
+				}
+
+			public:
+				//Starts the threads of the search, one for each core
+				PlannerActionProvider() : QueuedActionProvider(PLANNER_MAXIMUMQUEUEDACTIONS)
+				{
+					_decisions = 0;
+					_decisionnanoseconds = 0;
+					_iterations = 0;
+				}
+
+				//Returns the macro of a snapshot, the structures that are still being built are counted as finished
+				static MacroState GetMacroState(const ObservationSnapshot& snapshot)
+				{
+					MacroState state;
+
+					state.SetTime(snapshot.GetGameLoop() / GAMELOOPS_PERSECOND);
+					state.SetResources(static_cast<float>(snapshot.GetMinerals()), static_cast<float>(snapshot.GetVespene()));
+					state.SetSupplyUsed(snapshot.GetFoodUsed());
+					for (const auto& unit : snapshot.GetSelfUnits())
+					{
+						UNIT_TYPEID type = static_cast<UNIT_TYPEID>(unit.type);
+						MacroUnit macrounit = GetMacroUnit(type);
+						Action trainaction = GetTrainAction(type);
+
+						if (macrounit != MacroUnit::NONE)
+							state.AddUnits(macrounit, 1);
+						else if (trainaction != Action::NONE)
+							state.AddArmyValue(static_cast<float>(GetActionCost(trainaction).minerals + GetActionCost(trainaction).vespene));
+					}
+					for (const auto& upgrade : snapshot.GetUpgrades())
+					{
+						Action researchaction = GetResearchAction(static_cast<UPGRADE_ID>(upgrade));
+
+						if (researchaction != Action::NONE)
+							state.SetResearched(researchaction);
+					}
+
+					return state;
+				}
+
+				virtual const char* GetName() const override
+				{
+					return "the macro planner";
+				}
+
+				virtual std::chrono::milliseconds GetDecisionInterval() const override
+				{
+					return PLANNER_DECISIONINTERVAL;
+				}
+
+				virtual bool RequestDecision(const ObservationSnapshot& snapshot) override
+				{
+					Action plan[1];
+					auto start = std::chrono::steady_clock::now();
+					size_t count = _planner.Plan(GetMacroState(snapshot), PLANNER_DECISIONBUDGET, plan, 1);
+
+					_decisionnanoseconds += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+					_iterations += _planner.GetIterationCount();
+					_decisions++;
+					if (count > 0)
+					{
+						PushDecidedAction(plan[0], snapshot.GetStamp());
+						NotifyWaiters();
+					}
+
+					return true;
+				}
+
+				virtual void Stop() override
+				{
+					NotifyWaiters();
+					uint64_t decisions = _decisions.load();
+
+					KOKEKOKO_LOG_INFO("Planner: {} decisions, {} ms per decision on average, {} iterations on {} threads, {} dropped", decisions, ((decisions > 0) ? (static_cast<double>(_decisionnanoseconds.load()) / (decisions * 1000000)) : 0.0), _iterations.load(), _planner.GetThreadCount(), GetDroppedCount());
+				}
+		};
+	}
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#ifdef _WIN32
+	#include <Windows.h>
+#else
+	#include <dlfcn.h>
+#endif
+#include "../Types/Logger.h"
+#include "ActionPlugin.h"
+#include "ActionProvider.h"
+
+namespace KoKeKoKo
+{
+	namespace Agent
+	{
+		//The number of actions that a plugin can return from a single decision
+		const size_t PLUGIN_MAXIMUMACTIONS = 64;
+		//The number of decided actions that can wait to be collected, newer actions are dropped when it is full
+		const size_t PLUGIN_MAXIMUMQUEUEDACTIONS = 256;
+
+		//The units of a snapshot are handed to a plugin as they are, so both layouts must stay the same
+		static_assert(sizeof(ObservedUnit) == sizeof(KoKeKoKoUnit), "An observed unit must have the layout of a plugin unit");
+		static_assert(offsetof(ObservedUnit, tag) == offsetof(KoKeKoKoUnit, tag) && offsetof(ObservedUnit, type) == offsetof(KoKeKoKoUnit, type) && offsetof(ObservedUnit, alliance) == offsetof(KoKeKoKoUnit, alliance) && offsetof(ObservedUnit, x) == offsetof(KoKeKoKoUnit, x) && offsetof(ObservedUnit, y) == offsetof(KoKeKoKoUnit, y), "An observed unit must have the layout of a plugin unit");
+
+		//Decides the actions in the same process through a shared library with the C interface of ActionPlugin.h
+		//The snapshot is passed by pointer and the actions are written into a buffer of the provider, so nothing crosses a process boundary
+		class PluginActionProvider : public QueuedActionProvider
+		{
+			private:
+				#ifdef _WIN32
+					HMODULE _library;
+				#else
+					void* _library;
+				#endif
+				//The path of the shared library
+				std::string _path;
+				KoKeKoKoDecideFunction _decide;
+				//The buffer that the plugin writes its actions into, only used by the thread that requests decisions
+				uint8_t _decidedbuffer[PLUGIN_MAXIMUMACTIONS];
+				//The number of decisions, and the time the plugin has spent on them
+				std::atomic<uint64_t> _decisions;
+				std::atomic<uint64_t> _decisionnanoseconds;
+				//The number of actions from the plugin that the agent does not know
+				std::atomic<uint64_t> _invalidactions;
+
+				PluginActionProvider(const PluginActionProvider&);
+				PluginActionProvider& operator=(const PluginActionProvider&);
+
+				//Returns the address of an exported function, or nullptr if the library does not export it
+				void* GetFunction(const char* name) const
+				{
+					#ifdef _WIN32
+						return reinterpret_cast<void*>(GetProcAddress(_library, name));
+					#else
+						return dlsym(_library, name);
+					#endif
+				}
+
+				void Unload()
+				{
+					if (_library != nullptr)
+					{
+						#ifdef _WIN32
+							FreeLibrary(_library);
+						#else
+							dlclose(_library);
+						#endif
+						_library = nullptr;
+					}
+				}
+
+			public:
+				//Loads the shared library of the plugin, and throws if it cannot be loaded or has another version of the interface
+				PluginActionProvider(const std::string& path) : QueuedActionProvider(PLUGIN_MAXIMUMQUEUEDACTIONS)
+				{
+					KoKeKoKoGetActionPluginVersionFunction getversion = nullptr;
+
+					_path = path;
+					_decisions = 0;
+					_decisionnanoseconds = 0;
+					_invalidactions = 0;
+					#ifdef _WIN32
+						_library = LoadLibraryA(path.c_str());
+						if (_library == nullptr)
+							throw std::runtime_error(("Error Occurred! Failed to load the action plugin " + path + " with an exit code of " + std::to_string(GetLastError()) + "...").c_str());
+					#else
+						_library = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+						if (_library == nullptr)
+							throw std::runtime_error(("Error Occurred! Failed to load the action plugin " + path + ": " + dlerror() + "...").c_str());
+					#endif
+
+					getversion = reinterpret_cast<KoKeKoKoGetActionPluginVersionFunction>(GetFunction("KoKeKoKoGetActionPluginVersion"));
+					_decide = reinterpret_cast<KoKeKoKoDecideFunction>(GetFunction("KoKeKoKoDecide"));
+					if (getversion == nullptr || _decide == nullptr || getversion() != KOKEKOKO_ACTIONPLUGIN_VERSION)
+					{
+						Unload();
+						throw std::runtime_error(("Error Occurred! The action plugin " + path + " does not export version " + std::to_string(KOKEKOKO_ACTIONPLUGIN_VERSION) + " of the interface...").c_str());
+					}
+				}
+
+				virtual ~PluginActionProvider()
+				{
+					Unload();
+				}
+
+				virtual const char* GetName() const override
+				{
+					return _path.c_str();
+				}
+
+				//A plugin decides on every snapshot that the game thread publishes
+				virtual std::chrono::milliseconds GetDecisionInterval() const override
+				{
+					return std::chrono::milliseconds(0);
+				}
+
+				virtual bool RequestDecision(const ObservationSnapshot& snapshot) override
+				{
+					KoKeKoKoSnapshot pluginsnapshot;
+					auto self_units = snapshot.GetSelfUnits(), enemy_units = snapshot.GetEnemyUnits();
+					auto start = std::chrono::steady_clock::now();
+					uint32_t count = 0;
+
+					pluginsnapshot.gameloop = snapshot.GetGameLoop();
+					pluginsnapshot.playerid = snapshot.GetPlayerID();
+					pluginsnapshot.minerals = snapshot.GetMinerals();
+					pluginsnapshot.vespene = snapshot.GetVespene();
+					pluginsnapshot.foodused = snapshot.GetFoodUsed();
+					pluginsnapshot.workers = snapshot.GetWorkers();
+					pluginsnapshot.selfunits = reinterpret_cast<const KoKeKoKoUnit*>(self_units.begin());
+					pluginsnapshot.selfcount = static_cast<uint32_t>(self_units.size());
+					pluginsnapshot.enemyunits = reinterpret_cast<const KoKeKoKoUnit*>(enemy_units.begin());
+					pluginsnapshot.enemycount = static_cast<uint32_t>(enemy_units.size());
+					pluginsnapshot.upgrades = snapshot.GetUpgrades().data();
+					pluginsnapshot.upgradecount = static_cast<uint32_t>(snapshot.GetUpgrades().size());
+
+					count = _decide(&pluginsnapshot, _decidedbuffer, static_cast<uint32_t>(PLUGIN_MAXIMUMACTIONS));
+					_decisionnanoseconds += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+					_decisions++;
+
+					for (uint32_t index = 0; index < count && index < PLUGIN_MAXIMUMACTIONS; index++)
+					{
+						if (_decidedbuffer[index] == static_cast<uint8_t>(Action::NONE) || _decidedbuffer[index] >= ACTION_COUNT)
+							_invalidactions++;
+						else
+							PushDecidedAction(static_cast<Action>(_decidedbuffer[index]), snapshot.GetStamp());
+					}
+					if (count > 0)
+						NotifyWaiters();
+
+					return true;
+				}
+
+				virtual void Stop() override
+				{
+					NotifyWaiters();
+					uint64_t decisions = _decisions.load();
+
+					KOKEKOKO_LOG_INFO("Plugin: {} decisions, {} us per decision on average, {} invalid actions, {} dropped", decisions, ((decisions > 0) ? (static_cast<double>(_decisionnanoseconds.load()) / (decisions * 1000)) : 0.0), _invalidactions.load(), GetDroppedCount());
+				}
+		};
+	}
+}
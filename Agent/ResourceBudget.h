@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstdint>
+#include "Action.h"
+
+namespace KoKeKoKo
+{
+	namespace Agent
+	{
+		//The resources that an action spends when it is executed, upgrades cost as much as their first level
+		struct ActionCost
+		{
+			int32_t minerals;
+			int32_t vespene;
+			int32_t supply;
+		};
+
+		//The costs of the actions in the same order as Action
+		constexpr ActionCost ACTION_COSTS[] =
+		{
+			{ 0, 0, 0 }, //NONE
+			{ 75, 0, 0 }, //BUILD_REFINERY
+			{ 400, 0, 0 }, //BUILD_COMMANDCENTER
+			{ 150, 0, 0 }, //MORPH_ORBITALCOMMAND
+			{ 0, 0, 0 }, //EFFECT_CALLDOWNMULE
+			{ 150, 150, 0 }, //MORPH_PLANETARYFORTRESS
+			{ 50, 0, 1 }, //TRAIN_SCV
+			{ 100, 0, 0 }, //BUILD_SUPPLYDEPOT
+			{ 150, 0, 0 }, //BUILD_BARRACKS
+			{ 50, 0, 1 }, //TRAIN_MARINE
+			{ 50, 50, 1 }, //TRAIN_REAPER
+			{ 100, 25, 2 }, //TRAIN_MARAUDER
+			{ 150, 125, 2 }, //TRAIN_GHOST
+			{ 50, 25, 0 }, //BUILD_BARRACKSTECHLAB
+			{ 100, 100, 0 }, //RESEARCH_COMBATSHIELD
+			{ 100, 100, 0 }, //RESEARCH_STIMPACK
+			{ 50, 50, 0 }, //RESEARCH_CONCUSSIVESHELLS
+			{ 50, 50, 0 }, //BUILD_BARRACKSREACTOR
+			{ 150, 100, 0 }, //BUILD_FACTORY
+			{ 100, 0, 2 }, //TRAIN_HELLION
+			{ 0, 0, 0 }, //MORPH_HELLBAT
+			{ 75, 25, 2 }, //TRAIN_WIDOWMINE
+			{ 150, 125, 3 }, //TRAIN_SIEGETANK
+			{ 0, 0, 0 }, //MORPH_SIEGEMODE
+			{ 0, 0, 0 }, //MORPH_UNSIEGE
+			{ 150, 100, 3 }, //TRAIN_CYCLONE
+			{ 100, 0, 2 }, //TRAIN_HELLBAT
+			{ 0, 0, 0 }, //MORPH_HELLION
+			{ 300, 200, 6 }, //TRAIN_THOR
+			{ 50, 25, 0 }, //BUILD_FACTORYTECHLAB
+			{ 150, 150, 0 }, //RESEARCH_INFERNALPREIGNITER
+			{ 100, 100, 0 }, //RESEARCH_MAGFIELDLAUNCHERS
+			{ 75, 75, 0 }, //RESEARCH_DRILLINGCLAWS
+			{ 50, 50, 0 }, //BUILD_FACTORYREACTOR
+			{ 150, 100, 0 }, //BUILD_STARPORT
+			{ 150, 75, 2 }, //TRAIN_VIKINGFIGHTER
+			{ 0, 0, 0 }, //MORPH_VIKINGFIGHTERMODE
+			{ 0, 0, 0 }, //MORPH_VIKINGASSAULTMODE
+			{ 100, 100, 2 }, //TRAIN_MEDIVAC
+			{ 150, 150, 3 }, //TRAIN_LIBERATOR
+			{ 0, 0, 0 }, //MORPH_LIBERATORAGMODE
+			{ 0, 0, 0 }, //MORPH_LIBERATORAAMODE
+			{ 100, 200, 2 }, //TRAIN_RAVEN
+			{ 0, 0, 0 }, //EFFECT_AUTOTURRET
+			{ 150, 100, 3 }, //TRAIN_BANSHEE
+			{ 400, 300, 6 }, //TRAIN_BATTLECRUISER
+			{ 50, 50, 0 }, //BUILD_STARPORTREACTOR
+			{ 50, 25, 0 }, //BUILD_STARPORTTECHLAB
+			{ 100, 100, 0 }, //RESEARCH_HIGHCAPACITYFUELTANKS
+			{ 150, 150, 0 }, //RESEARCH_RAVENCORVIDREACTOR
+			{ 100, 100, 0 }, //RESEARCH_BANSHEECLOAKINGFIELD
+			{ 150, 150, 0 }, //RESEARCH_BANSHEEHYPERFLIGHTROTORS
+			{ 150, 150, 0 }, //RESEARCH_ADVANCEDBALLISTICS
+			{ 150, 150, 0 }, //BUILD_FUSIONCORE
+			{ 150, 150, 0 }, //RESEARCH_BATTLECRUISERWEAPONREFIT
+			{ 150, 100, 0 }, //BUILD_ARMORY
+			{ 100, 100, 0 }, //RESEARCH_TERRANVEHICLEWEAPONS
+			{ 100, 100, 0 }, //RESEARCH_TERRANSHIPWEAPONS
+			{ 100, 100, 0 }, //RESEARCH_TERRANVEHICLEANDSHIPPLATING
+			{ 100, 0, 0 }, //BUILD_BUNKER
+			{ 125, 0, 0 }, //BUILD_ENGINEERINGBAY
+			{ 100, 100, 0 }, //RESEARCH_TERRANINFANTRYWEAPONS
+			{ 100, 100, 0 }, //RESEARCH_TERRANINFANTRYARMOR
+			{ 150, 50, 0 }, //BUILD_GHOSTACADEMY
+			{ 150, 150, 0 }, //RESEARCH_PERSONALCLOAKING
+			{ 100, 100, 0 }, //BUILD_NUKE
+			{ 100, 0, 0 }, //BUILD_MISSILETURRET
+			{ 125, 100, 0 }, //BUILD_SENSORTOWER
+			{ 0, 0, 0 } //SURRENDER
+		};
+
+		static_assert((sizeof(ACTION_COSTS) / sizeof(ACTION_COSTS[0])) == ACTION_COUNT, "Every action must have a cost");
+
+		inline const ActionCost& GetActionCost(Action action)
+		{
+			return ACTION_COSTS[(static_cast<size_t>(action) < ACTION_COUNT) ? static_cast<size_t>(action) : 0];
+		}
+
+		//The minerals, vespene and supply that are left for the actions of a game step
+		//It is read from the observation once per step, and each executed action reserves its cost from it
+		class ResourceBudget
+		{
+			private:
+				int32_t _minerals;
+				int32_t _vespene;
+				int32_t _supply;
+
+			public:
+				ResourceBudget()
+				{
+					Reset(0, 0, 0);
+				}
+
+				//Starts a new step with the resources of the observation
+				void Reset(int32_t minerals, int32_t vespene, int32_t supply)
+				{
+					_minerals = minerals;
+					_vespene = vespene;
+					_supply = supply;
+				}
+
+				//Returns true if the resources that are left can pay for the cost
+				bool CanAfford(const ActionCost& cost) const
+				{
+					return (_minerals >= cost.minerals && _vespene >= cost.vespene && _supply >= cost.supply);
+				}
+
+				//Takes the cost from the resources that are left
+				void Reserve(const ActionCost& cost)
+				{
+					_minerals -= cost.minerals;
+					_vespene -= cost.vespene;
+					_supply -= cost.supply;
+				}
+
+				int32_t GetMinerals() const
+				{
+					return _minerals;
+				}
+
+				int32_t GetVespene() const
+				{
+					return _vespene;
+				}
+
+				//Returns the supply that is left, the supply cap minus the supply used
+				int32_t GetSupply() const
+				{
+					return _supply;
+				}
+		};
+	}
+}
@@ -0,0 +1,280 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <sc2api/sc2_api.h>
+#include <utility>
+#include <vector>
+
+namespace KoKeKoKo
+{
+	namespace Agent
+	{
+		using namespace sc2;
+		//The largest number of cells on each side of the grid
+		const size_t SPATIALINDEX_MAXIMUMCELLS = 64;
+		//The average number of units in a cell that the grid is sized for
+		const size_t SPATIALINDEX_UNITSPERCELL = 2;
+		//The number of units up to which a nearest query scans every unit rather than the grid
+		const size_t SPATIALINDEX_SCANUNITS = 64;
+
+		//A uniform grid over the positions of units that answers nearest, k-nearest and radius queries
+		//The units are sorted by cell into flat arrays of coordinates, so a cell is scanned as one contiguous run
+		class SpatialIndex
+		{
+			private:
+				//The x coordinates of the units sorted by cell
+				std::vector<float> _xs;
+				//The y coordinates of the units sorted by cell
+				std::vector<float> _ys;
+				//The units sorted by cell
+				std::vector<const Unit*> _units;
+				//The index of the first unit of each cell, with one more entry for the end of the last cell
+				std::vector<uint32_t> _cellstarts;
+				//The cell of each unit while the grid is being built
+				std::vector<uint32_t> _unitcells;
+				//The candidates of a k-nearest query, kept between queries so they do not allocate
+				std::vector<std::pair<float, const Unit*>> _candidates;
+				//The lower corner of the grid
+				float _minimumx, _minimumy;
+				//The size of a cell
+				float _cellwidth, _cellheight;
+				//The number of cells on each side
+				int _columns, _rows;
+
+				int GetColumnOf(float x) const
+				{
+					return std::min(std::max(static_cast<int>((x - _minimumx) / _cellwidth), 0), _columns - 1);
+				}
+
+				int GetRowOf(float y) const
+				{
+					return std::min(std::max(static_cast<int>((y - _minimumy) / _cellheight), 0), _rows - 1);
+				}
+
+				//Returns the squared distance from a position to the nearest unit outside the cells that are within the ring of a cell
+				//The sides of the ring that are on the edge of the grid have nothing outside them
+				float GetDistanceOutsideRing(const Point2D& position, int column, int row, int ring) const
+				{
+					float distance = std::numeric_limits<float>::max();
+
+					if (column - ring > 0)
+						distance = std::min(distance, position.x - (_minimumx + ((column - ring) * _cellwidth)));
+					if (column + ring < _columns - 1)
+						distance = std::min(distance, (_minimumx + ((column + ring + 1) * _cellwidth)) - position.x);
+					if (row - ring > 0)
+						distance = std::min(distance, position.y - (_minimumy + ((row - ring) * _cellheight)));
+					if (row + ring < _rows - 1)
+						distance = std::min(distance, (_minimumy + ((row + ring + 1) * _cellheight)) - position.y);
+
+					if (distance == std::numeric_limits<float>::max())
+						return distance;
+					distance = std::max(distance, 0.0f);
+					return (distance * distance);
+				}
+
+				//Calls the visitor with the range of units of every cell on the ring of a cell
+				template<typename Visitor>
+				void VisitRing(int column, int row, int ring, Visitor& visitor) const
+				{
+					int first_row = std::max(row - ring, 0), last_row = std::min(row + ring, _rows - 1);
+					int first_column = std::max(column - ring, 0), last_column = std::min(column + ring, _columns - 1);
+
+					for (int current_row = first_row; current_row <= last_row; current_row++)
+					{
+						//The rows between the top and the bottom of the ring only have their two ends on the ring
+						bool is_edge = (current_row == row - ring || current_row == row + ring);
+						int step = ((is_edge || ring == 0) ? 1 : (2 * ring));
+
+						for (int current_column = (is_edge ? first_column : column - ring); current_column <= (is_edge ? last_column : column + ring); current_column += step)
+						{
+							if (current_column < 0 || current_column >= _columns)
+								continue;
+
+							size_t cell = (static_cast<size_t>(current_row) * _columns) + current_column;
+							visitor(_cellstarts[cell], _cellstarts[cell + 1]);
+						}
+					}
+				}
+
+			public:
+				SpatialIndex()
+				{
+					_minimumx = 0;
+					_minimumy = 0;
+					_cellwidth = 1;
+					_cellheight = 1;
+					_columns = 1;
+					_rows = 1;
+					_cellstarts = std::vector<uint32_t>(2, 0);
+				}
+
+				//Builds the grid over the units and their positions, the arrays are reused between builds
+				void Build(const Unit* const* units, const Point2D* positions, size_t count)
+				{
+					float maximumx = 0, maximumy = 0;
+					size_t cells_per_side = 1;
+
+					_minimumx = _minimumy = std::numeric_limits<float>::max();
+					maximumx = maximumy = std::numeric_limits<float>::lowest();
+					for (size_t index = 0; index < count; index++)
+					{
+						_minimumx = std::min(_minimumx, positions[index].x);
+						_minimumy = std::min(_minimumy, positions[index].y);
+						maximumx = std::max(maximumx, positions[index].x);
+						maximumy = std::max(maximumy, positions[index].y);
+					}
+					if (count == 0)
+						_minimumx = _minimumy = maximumx = maximumy = 0;
+
+					//Size the grid so that a cell has a few units on average
+					while ((cells_per_side * cells_per_side * SPATIALINDEX_UNITSPERCELL) < count && cells_per_side < SPATIALINDEX_MAXIMUMCELLS)
+						cells_per_side++;
+					_columns = _rows = static_cast<int>(cells_per_side);
+					_cellwidth = std::max((maximumx - _minimumx) / _columns, 1.0f / 1024);
+					_cellheight = std::max((maximumy - _minimumy) / _rows, 1.0f / 1024);
+
+					//Sort the units by cell with a counting sort
+					_cellstarts.assign((cells_per_side * cells_per_side) + 1, 0);
+					_unitcells.resize(count);
+					for (size_t index = 0; index < count; index++)
+					{
+						_unitcells[index] = static_cast<uint32_t>((GetRowOf(positions[index].y) * _columns) + GetColumnOf(positions[index].x));
+						_cellstarts[_unitcells[index] + 1]++;
+					}
+					for (size_t cell = 1; cell < _cellstarts.size(); cell++)
+						_cellstarts[cell] += _cellstarts[cell - 1];
+
+					_xs.resize(count);
+					_ys.resize(count);
+					_units.resize(count);
+					for (size_t index = 0; index < count; index++)
+					{
+						uint32_t position = _cellstarts[_unitcells[index]]++;
+
+						_xs[position] = positions[index].x;
+						_ys[position] = positions[index].y;
+						_units[position] = units[index];
+					}
+					//Move the starts back, each one has been advanced to the start of the next cell
+					for (size_t cell = _cellstarts.size() - 1; cell > 0; cell--)
+						_cellstarts[cell] = _cellstarts[cell - 1];
+					_cellstarts[0] = 0;
+				}
+
+				//Returns the nearest unit from a position, or nullptr if there are no units
+				const Unit* FindNearestOf(const Point2D& position) const
+				{
+					float distance = std::numeric_limits<float>::max();
+					uint32_t nearest = UINT32_MAX;
+					int column = GetColumnOf(position.x), row = GetRowOf(position.y);
+					auto visitor = [&](uint32_t first, uint32_t last)
+					{
+						for (uint32_t index = first; index < last; index++)
+						{
+							float dx = (_xs[index] - position.x), dy = (_ys[index] - position.y), temporary_distance = ((dx * dx) + (dy * dy));
+							if (temporary_distance < distance)
+							{
+								distance = temporary_distance;
+								nearest = index;
+							}
+						}
+					};
+
+					//A few units are faster to scan in one run than to walk the grid
+					if (_units.size() <= SPATIALINDEX_SCANUNITS)
+					{
+						visitor(0, static_cast<uint32_t>(_units.size()));
+						return ((nearest != UINT32_MAX) ? _units[nearest] : nullptr);
+					}
+
+					for (int ring = 0; ring < std::max(_columns, _rows); ring++)
+					{
+						VisitRing(column, row, ring, visitor);
+						if (nearest != UINT32_MAX && distance <= GetDistanceOutsideRing(position, column, row, ring))
+							break;
+					}
+
+					return ((nearest != UINT32_MAX) ? _units[nearest] : nullptr);
+				}
+
+				//Finds the nearest unit of each position and writes them to the results in the same order, nullptr if there are no units
+				void FindNearestOf(const Point2D* positions, size_t count, const Unit** results) const
+				{
+					for (size_t index = 0; index < count; index++)
+						results[index] = FindNearestOf(positions[index]);
+				}
+
+				//Finds the k nearest units from a position, from the nearest to the farthest, and returns the number found
+				size_t FindNearestOf(const Point2D& position, size_t k, std::vector<const Unit*>& results)
+				{
+					int column = GetColumnOf(position.x), row = GetRowOf(position.y);
+					auto byDistance = [](const std::pair<float, const Unit*>& left, const std::pair<float, const Unit*>& right) { return (left.first < right.first); };
+					//The candidates are a max-heap on distance, so the farthest of the k nearest is always on top
+					auto visitor = [&](uint32_t first, uint32_t last)
+					{
+						for (uint32_t index = first; index < last; index++)
+						{
+							float dx = (_xs[index] - position.x), dy = (_ys[index] - position.y), temporary_distance = ((dx * dx) + (dy * dy));
+							if (_candidates.size() < k)
+							{
+								_candidates.push_back(std::make_pair(temporary_distance, _units[index]));
+								std::push_heap(_candidates.begin(), _candidates.end(), byDistance);
+							}
+							else if (temporary_distance < _candidates.front().first)
+							{
+								std::pop_heap(_candidates.begin(), _candidates.end(), byDistance);
+								_candidates.back() = std::make_pair(temporary_distance, _units[index]);
+								std::push_heap(_candidates.begin(), _candidates.end(), byDistance);
+							}
+						}
+					};
+
+					results.clear();
+					_candidates.clear();
+					if (k == 0)
+						return 0;
+
+					for (int ring = 0; ring < std::max(_columns, _rows); ring++)
+					{
+						VisitRing(column, row, ring, visitor);
+						if (_candidates.size() == k && _candidates.front().first <= GetDistanceOutsideRing(position, column, row, ring))
+							break;
+					}
+
+					std::sort_heap(_candidates.begin(), _candidates.end(), byDistance);
+					for (const auto& candidate : _candidates)
+						results.push_back(candidate.second);
+					return results.size();
+				}
+
+				//Finds the units within a radius from a position and returns the number found
+				size_t FindWithinRadiusOf(const Point2D& position, float radius, std::vector<const Unit*>& results) const
+				{
+					float radius_squared = (radius * radius);
+					int first_column = GetColumnOf(position.x - radius), last_column = GetColumnOf(position.x + radius);
+					int first_row = GetRowOf(position.y - radius), last_row = GetRowOf(position.y + radius);
+
+					results.clear();
+					for (int row = first_row; row <= last_row; row++)
+					{
+						for (uint32_t index = _cellstarts[(row * _columns) + first_column], last = _cellstarts[(row * _columns) + last_column + 1]; index < last; index++)
+						{
+							float dx = (_xs[index] - position.x), dy = (_ys[index] - position.y);
+							if (((dx * dx) + (dy * dy)) <= radius_squared)
+								results.push_back(_units[index]);
+						}
+					}
+
+					return results.size();
+				}
+
+				size_t GetUnitCount() const
+				{
+					return _units.size();
+				}
+		};
+	}
+}
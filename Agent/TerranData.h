@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "Action.h"
+
+namespace KoKeKoKo
+{
+	namespace Agent
+	{
+		//The units and structures that the macro of the agent is made of, the army units are only counted by their value
+		enum class MacroUnit : uint8_t
+		{
+			NONE,
+			SCV,
+			COMMANDCENTER,
+			ORBITALCOMMAND,
+			PLANETARYFORTRESS,
+			SUPPLYDEPOT,
+			REFINERY,
+			BARRACKS,
+			BARRACKSTECHLAB,
+			BARRACKSREACTOR,
+			FACTORY,
+			FACTORYTECHLAB,
+			FACTORYREACTOR,
+			STARPORT,
+			STARPORTTECHLAB,
+			STARPORTREACTOR,
+			ENGINEERINGBAY,
+			ARMORY,
+			FUSIONCORE,
+			GHOSTACADEMY,
+			BUNKER,
+			MISSILETURRET,
+			SENSORTOWER,
+			ARMY,
+			//The number of macro units, not a macro unit
+			COUNT
+		};
+
+		//The number of macro units including NONE
+		const size_t MACROUNIT_COUNT = static_cast<size_t>(MacroUnit::COUNT);
+
+		//What an action does to the macro of the agent
+		enum class MacroKind : uint8_t
+		{
+			//Changes nothing that the macro is made of, such as a siege mode or a mule, so it is never planned
+			Tactical,
+			//A worker builds a structure
+			Build,
+			//A structure trains a unit
+			Train,
+			//A command center turns into another base
+			Morph,
+			//A production structure builds its addon
+			Addon,
+			//A structure researches an upgrade once
+			Research
+		};
+
+		//The macro of an action, the cost is in ACTION_COSTS
+		struct MacroActionData
+		{
+			MacroKind kind;
+			//The structure that executes the action, an SCV for the structures
+			MacroUnit producer;
+			//The structure that must exist before the action can be executed
+			MacroUnit requirement;
+			//What exists when the action has finished
+			MacroUnit product;
+			//The seconds of game time that the action takes on the faster speed
+			uint16_t buildseconds;
+		};
+
+		//The macro of the actions in the same order as Action
+		constexpr MacroActionData MACRO_ACTIONS[] =
+		{
+			{ MacroKind::Tactical, MacroUnit::NONE, MacroUnit::NONE, MacroUnit::NONE, 0 }, //NONE
+			{ MacroKind::Build, MacroUnit::SCV, MacroUnit::NONE, MacroUnit::REFINERY, 21 }, //BUILD_REFINERY
+			{ MacroKind::Build, MacroUnit::SCV, MacroUnit::NONE, MacroUnit::COMMANDCENTER, 71 }, //BUILD_COMMANDCENTER
+			{ MacroKind::Morph, MacroUnit::COMMANDCENTER, MacroUnit::BARRACKS, MacroUnit::ORBITALCOMMAND, 25 }, //MORPH_ORBITALCOMMAND
+			{ MacroKind::Tactical, MacroUnit::ORBITALCOMMAND, MacroUnit::NONE, MacroUnit::NONE, 0 }, //EFFECT_CALLDOWNMULE
+			{ MacroKind::Morph, MacroUnit::COMMANDCENTER, MacroUnit::ENGINEERINGBAY, MacroUnit::PLANETARYFORTRESS, 36 }, //MORPH_PLANETARYFORTRESS
+			{ MacroKind::Train, MacroUnit::COMMANDCENTER, MacroUnit::NONE, MacroUnit::SCV, 12 }, //TRAIN_SCV
+			{ MacroKind::Build, MacroUnit::SCV, MacroUnit::NONE, MacroUnit::SUPPLYDEPOT, 21 }, //BUILD_SUPPLYDEPOT
+			{ MacroKind::Build, MacroUnit::SCV, MacroUnit::SUPPLYDEPOT, MacroUnit::BARRACKS, 46 }, //BUILD_BARRACKS
+			{ MacroKind::Train, MacroUnit::BARRACKS, MacroUnit::NONE, MacroUnit::ARMY, 18 }, //TRAIN_MARINE
+			{ MacroKind::Train, MacroUnit::BARRACKS, MacroUnit::NONE, MacroUnit::ARMY, 32 }, //TRAIN_REAPER
+			{ MacroKind::Train, MacroUnit::BARRACKSTECHLAB, MacroUnit::NONE, MacroUnit::ARMY, 21 }, //TRAIN_MARAUDER
+			{ MacroKind::Train, MacroUnit::BARRACKSTECHLAB, MacroUnit::GHOSTACADEMY, MacroUnit::ARMY, 29 }, //TRAIN_GHOST
+			{ MacroKind::Addon, MacroUnit::BARRACKS, MacroUnit::NONE, MacroUnit::BARRACKSTECHLAB, 18 }, //BUILD_BARRACKSTECHLAB
+			{ MacroKind::Research, MacroUnit::BARRACKSTECHLAB, MacroUnit::NONE, MacroUnit::NONE, 79 }, //RESEARCH_COMBATSHIELD
+			{ MacroKind::Research, MacroUnit::BARRACKSTECHLAB, MacroUnit::NONE, MacroUnit::NONE, 100 }, //RESEARCH_STIMPACK
+			{ MacroKind::Research, MacroUnit::BARRACKSTECHLAB, MacroUnit::NONE, MacroUnit::NONE, 43 }, //RESEARCH_CONCUSSIVESHELLS
+			{ MacroKind::Addon, MacroUnit::BARRACKS, MacroUnit::NONE, MacroUnit::BARRACKSREACTOR, 36 }, //BUILD_BARRACKSREACTOR
+			{ MacroKind::Build, MacroUnit::SCV, MacroUnit::BARRACKS, MacroUnit::FACTORY, 43 }, //BUILD_FACTORY
+			{ MacroKind::Train, MacroUnit::FACTORY, MacroUnit::NONE, MacroUnit::ARMY, 21 }, //TRAIN_HELLION
+			{ MacroKind::Tactical, MacroUnit::NONE, MacroUnit::NONE, MacroUnit::NONE, 0 }, //MORPH_HELLBAT
+			{ MacroKind::Train, MacroUnit::FACTORY, MacroUnit::NONE, MacroUnit::ARMY, 21 }, //TRAIN_WIDOWMINE
+			{ MacroKind::Train, MacroUnit::FACTORYTECHLAB, MacroUnit::NONE, MacroUnit::ARMY, 32 }, //TRAIN_SIEGETANK
+			{ MacroKind::Tactical, MacroUnit::NONE, MacroUnit::NONE, MacroUnit::NONE, 0 }, //MORPH_SIEGEMODE
+			{ MacroKind::Tactical, MacroUnit::NONE, MacroUnit::NONE, MacroUnit::NONE, 0 }, //MORPH_UNSIEGE
+			{ MacroKind::Train, MacroUnit::FACTORY, MacroUnit::NONE, MacroUnit::ARMY, 32 }, //TRAIN_CYCLONE
+			{ MacroKind::Train, MacroUnit::FACTORY, MacroUnit::ARMORY, MacroUnit::ARMY, 21 }, //TRAIN_HELLBAT
+			{ MacroKind::Tactical, MacroUnit::NONE, MacroUnit::NONE, MacroUnit::NONE, 0 }, //MORPH_HELLION
+			{ MacroKind::Train, MacroUnit::FACTORYTECHLAB, MacroUnit::ARMORY, MacroUnit::ARMY, 43 }, //TRAIN_THOR
+			{ MacroKind::Addon, MacroUnit::FACTORY, MacroUnit::NONE, MacroUnit::FACTORYTECHLAB, 18 }, //BUILD_FACTORYTECHLAB
+			{ MacroKind::Research, MacroUnit::FACTORYTECHLAB, MacroUnit::NONE, MacroUnit::NONE, 79 }, //RESEARCH_INFERNALPREIGNITER
+			{ MacroKind::Research, MacroUnit::FACTORYTECHLAB, MacroUnit::NONE, MacroUnit::NONE, 79 }, //RESEARCH_MAGFIELDLAUNCHERS
+			{ MacroKind::Research, MacroUnit::FACTORYTECHLAB, MacroUnit::NONE, MacroUnit::NONE, 79 }, //RESEARCH_DRILLINGCLAWS
+			{ MacroKind::Addon, MacroUnit::FACTORY, MacroUnit::NONE, MacroUnit::FACTORYREACTOR, 36 }, //BUILD_FACTORYREACTOR
+			{ MacroKind::Build, MacroUnit::SCV, MacroUnit::FACTORY, MacroUnit::STARPORT, 36 }, //BUILD_STARPORT
+			{ MacroKind::Train, MacroUnit::STARPORT, MacroUnit::NONE, MacroUnit::ARMY, 30 }, //TRAIN_VIKINGFIGHTER
+			{ MacroKind::Tactical, MacroUnit::NONE, MacroUnit::NONE, MacroUnit::NONE, 0 }, //MORPH_VIKINGFIGHTERMODE
+			{ MacroKind::Tactical, MacroUnit::NONE, MacroUnit::NONE, MacroUnit::NONE, 0 }, //MORPH_VIKINGASSAULTMODE
+			{ MacroKind::Train, MacroUnit::STARPORT, MacroUnit::NONE, MacroUnit::ARMY, 30 }, //TRAIN_MEDIVAC
+			{ MacroKind::Train, MacroUnit::STARPORT, MacroUnit::NONE, MacroUnit::ARMY, 43 }, //TRAIN_LIBERATOR
+			{ MacroKind::Tactical, MacroUnit::NONE, MacroUnit::NONE, MacroUnit::NONE, 0 }, //MORPH_LIBERATORAGMODE
+			{ MacroKind::Tactical, MacroUnit::NONE, MacroUnit::NONE, MacroUnit::NONE, 0 }, //MORPH_LIBERATORAAMODE
+			{ MacroKind::Train, MacroUnit::STARPORTTECHLAB, MacroUnit::NONE, MacroUnit::ARMY, 43 }, //TRAIN_RAVEN
+			{ MacroKind::Tactical, MacroUnit::NONE, MacroUnit::NONE, MacroUnit::NONE, 0 }, //EFFECT_AUTOTURRET
+			{ MacroKind::Train, MacroUnit::STARPORTTECHLAB, MacroUnit::NONE, MacroUnit::ARMY, 43 }, //TRAIN_BANSHEE
+			{ MacroKind::Train, MacroUnit::STARPORTTECHLAB, MacroUnit::FUSIONCORE, MacroUnit::ARMY, 64 }, //TRAIN_BATTLECRUISER
+			{ MacroKind::Addon, MacroUnit::STARPORT, MacroUnit::NONE, MacroUnit::STARPORTREACTOR, 36 }, //BUILD_STARPORTREACTOR
+			{ MacroKind::Addon, MacroUnit::STARPORT, MacroUnit::NONE, MacroUnit::STARPORTTECHLAB, 18 }, //BUILD_STARPORTTECHLAB
+			{ MacroKind::Research, MacroUnit::STARPORTTECHLAB, MacroUnit::NONE, MacroUnit::NONE, 57 }, //RESEARCH_HIGHCAPACITYFUELTANKS
+			{ MacroKind::Research, MacroUnit::STARPORTTECHLAB, MacroUnit::NONE, MacroUnit::NONE, 79 }, //RESEARCH_RAVENCORVIDREACTOR
+			{ MacroKind::Research, MacroUnit::STARPORTTECHLAB, MacroUnit::NONE, MacroUnit::NONE, 79 }, //RESEARCH_BANSHEECLOAKINGFIELD
+			{ MacroKind::Research, MacroUnit::STARPORTTECHLAB, MacroUnit::NONE, MacroUnit::NONE, 121 }, //RESEARCH_BANSHEEHYPERFLIGHTROTORS
+			{ MacroKind::Research, MacroUnit::STARPORTTECHLAB, MacroUnit::NONE, MacroUnit::NONE, 79 }, //RESEARCH_ADVANCEDBALLISTICS
+			{ MacroKind::Build, MacroUnit::SCV, MacroUnit::STARPORT, MacroUnit::FUSIONCORE, 46 }, //BUILD_FUSIONCORE
+			{ MacroKind::Research, MacroUnit::FUSIONCORE, MacroUnit::NONE, MacroUnit::NONE, 43 }, //RESEARCH_BATTLECRUISERWEAPONREFIT
+			{ MacroKind::Build, MacroUnit::SCV, MacroUnit::FACTORY, MacroUnit::ARMORY, 46 }, //BUILD_ARMORY
+			{ MacroKind::Research, MacroUnit::ARMORY, MacroUnit::NONE, MacroUnit::NONE, 114 }, //RESEARCH_TERRANVEHICLEWEAPONS
+			{ MacroKind::Research, MacroUnit::ARMORY, MacroUnit::NONE, MacroUnit::NONE, 114 }, //RESEARCH_TERRANSHIPWEAPONS
+			{ MacroKind::Research, MacroUnit::ARMORY, MacroUnit::NONE, MacroUnit::NONE, 114 }, //RESEARCH_TERRANVEHICLEANDSHIPPLATING
+			{ MacroKind::Build, MacroUnit::SCV, MacroUnit::BARRACKS, MacroUnit::BUNKER, 29 }, //BUILD_BUNKER
+			{ MacroKind::Build, MacroUnit::SCV, MacroUnit::NONE, MacroUnit::ENGINEERINGBAY, 25 }, //BUILD_ENGINEERINGBAY
+			{ MacroKind::Research, MacroUnit::ENGINEERINGBAY, MacroUnit::NONE, MacroUnit::NONE, 114 }, //RESEARCH_TERRANINFANTRYWEAPONS
+			{ MacroKind::Research, MacroUnit::ENGINEERINGBAY, MacroUnit::NONE, MacroUnit::NONE, 114 }, //RESEARCH_TERRANINFANTRYARMOR
+			{ MacroKind::Build, MacroUnit::SCV, MacroUnit::BARRACKS, MacroUnit::GHOSTACADEMY, 29 }, //BUILD_GHOSTACADEMY
+			{ MacroKind::Research, MacroUnit::GHOSTACADEMY, MacroUnit::NONE, MacroUnit::NONE, 86 }, //RESEARCH_PERSONALCLOAKING
+			{ MacroKind::Train, MacroUnit::GHOSTACADEMY, MacroUnit::FACTORY, MacroUnit::ARMY, 43 }, //BUILD_NUKE
+			{ MacroKind::Build, MacroUnit::SCV, MacroUnit::ENGINEERINGBAY, MacroUnit::MISSILETURRET, 18 }, //BUILD_MISSILETURRET
+			{ MacroKind::Build, MacroUnit::SCV, MacroUnit::ENGINEERINGBAY, MacroUnit::SENSORTOWER, 18 }, //BUILD_SENSORTOWER
+			{ MacroKind::Tactical, MacroUnit::NONE, MacroUnit::NONE, MacroUnit::NONE, 0 } //SURRENDER
+		};
+
+		static_assert((sizeof(MACRO_ACTIONS) / sizeof(MACRO_ACTIONS[0])) == ACTION_COUNT, "Every action must have its macro");
+
+		inline const MacroActionData& GetMacroActionData(Action action)
+		{
+			return MACRO_ACTIONS[(static_cast<size_t>(action) < ACTION_COUNT) ? static_cast<size_t>(action) : 0];
+		}
+	}
+}
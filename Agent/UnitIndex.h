@@ -0,0 +1,361 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <sc2api/sc2_api.h>
+#include <unordered_map>
+#include <vector>
+#include "SpatialIndex.h"
+
+namespace KoKeKoKo
+{
+	namespace Agent
+	{
+		using namespace sc2;
+		//The number of alliances, the alliances start from 1
+		const size_t UNITINDEX_ALLIANCES = 5;
+		//The number of unit types that have their own bucket, the rest share the last bucket of their alliance
+		const size_t UNITINDEX_TYPES = 2048;
+
+		//A copy of what is read of a unit by the threads that must not touch the observation, such as the tag and the position
+		struct ObservedUnit
+		{
+			Tag tag;
+			uint32_t type;
+			uint32_t alliance;
+			float x;
+			float y;
+		};
+
+		//A contiguous range of elements in the unit index that can be iterated without allocating
+		template<typename T>
+		class UnitIndexRange
+		{
+			private:
+				const T* _first;
+				const T* _last;
+
+			public:
+				UnitIndexRange(const T* first, const T* last)
+				{
+					_first = first;
+					_last = last;
+				}
+
+				const T* begin() const
+				{
+					return _first;
+				}
+
+				const T* end() const
+				{
+					return _last;
+				}
+
+				size_t size() const
+				{
+					return static_cast<size_t>(_last - _first);
+				}
+
+				bool empty() const
+				{
+					return (_first == _last);
+				}
+
+				const T& front() const
+				{
+					return *_first;
+				}
+
+				const T& operator[](size_t index) const
+				{
+					return _first[index];
+				}
+		};
+
+		//The units of a game loop bucketed by alliance and unit type, built once per game loop with a counting sort
+		//The buckets and their counts are kept between game loops, so once the armies stop growing the only allocation of a rebuild is the copy of the units that the observation returns
+		class UnitIndex
+		{
+			private:
+				//The units of the game loop, the index points into them
+				//The observation only hands them out as a new vector, so this is moved from it rather than copied again
+				Units _units;
+				//The units sorted by bucket
+				std::vector<const Unit*> _sortedunits;
+				//The positions and the copies of the sorted units, in the same order
+				std::vector<Point2D> _positions;
+				std::vector<ObservedUnit> _observedunits;
+				//The copies and the buckets of the units in the order of the observation, so that every unit is only read once per rebuild
+				std::vector<ObservedUnit> _unsortedunits;
+				std::vector<uint32_t> _unitbuckets;
+				//The number of units in each bucket
+				std::vector<uint32_t> _counts;
+				//The number of units in each bucket that are still being built
+				std::vector<uint32_t> _inprogresscounts;
+				//The index of the first unit of each bucket
+				std::vector<uint32_t> _starts;
+				//The buckets that have units, only these are cleared on the next rebuild
+				std::vector<uint32_t> _usedbuckets;
+				//The index of the first unit of each alliance, the buckets are placed in order so the units of an alliance are contiguous
+				uint32_t _alliancestarts[UNITINDEX_ALLIANCES + 1];
+				//The number of units that are not alive
+				uint32_t _deadunits;
+				//The spatial indices that have been built where key is a unit type or an alliance, and value is the rebuild they were built for
+				std::unordered_map<uint32_t, std::pair<uint64_t, SpatialIndex>> _spatialindices;
+				//The units and positions that a spatial index is built from, kept so that they do not allocate
+				std::vector<const Unit*> _spatialunits;
+				std::vector<Point2D> _spatialpositions;
+				//The game loop that the index has been built for
+				uint32_t _gameloop;
+				//If the index has been built at least once since it was invalidated
+				bool _isbuilt;
+				//The number of times the index has been rebuilt
+				uint64_t _rebuilds;
+
+				//Returns the bucket of an alliance and a unit type
+				static size_t GetBucket(Unit::Alliance alliance, UNIT_TYPEID unit_type)
+				{
+					size_t type = static_cast<size_t>(unit_type);
+
+					return ((static_cast<size_t>(alliance) % UNITINDEX_ALLIANCES) * UNITINDEX_TYPES) + ((type < UNITINDEX_TYPES) ? type : (UNITINDEX_TYPES - 1));
+				}
+
+				//Returns the spatial index of a key, built from the units that are added by the filler if it is older than this game loop
+				template<typename Filler>
+				SpatialIndex& GetSpatialIndex(uint32_t key, Filler filler)
+				{
+					auto& spatialindex = _spatialindices[key];
+
+					if (spatialindex.first != _rebuilds)
+					{
+						_spatialunits.clear();
+						_spatialpositions.clear();
+						filler();
+						spatialindex.second.Build(_spatialunits.data(), _spatialpositions.data(), _spatialunits.size());
+						spatialindex.first = _rebuilds;
+					}
+
+					return spatialindex.second;
+				}
+
+				//Sorts the units of the game loop into their buckets
+				void Rebuild(const ObservationInterface* observation)
+				{
+					uint32_t next = 0;
+					size_t alliance = 0;
+
+					for (const auto& bucket : _usedbuckets)
+					{
+						_counts[bucket] = 0;
+						_inprogresscounts[bucket] = 0;
+						_starts[bucket] = 0;
+					}
+					_usedbuckets.clear();
+					_deadunits = 0;
+
+					//Read every unit once, count the units of each bucket, and remember the buckets that are used
+					_units = observation->GetUnits();
+					_unsortedunits.resize(_units.size());
+					_unitbuckets.resize(_units.size());
+					for (size_t index = 0; index < _units.size(); index++)
+					{
+						const Unit* unit = _units[index];
+						ObservedUnit& observedunit = _unsortedunits[index];
+						size_t bucket = GetBucket(unit->alliance, unit->unit_type);
+
+						observedunit.tag = unit->tag;
+						observedunit.type = static_cast<uint32_t>(unit->unit_type.ToType());
+						observedunit.alliance = static_cast<uint32_t>(unit->alliance);
+						observedunit.x = unit->pos.x;
+						observedunit.y = unit->pos.y;
+						_unitbuckets[index] = static_cast<uint32_t>(bucket);
+						if (_counts[bucket]++ == 0)
+							_usedbuckets.push_back(static_cast<uint32_t>(bucket));
+						if (unit->build_progress < 1.0f)
+							_inprogresscounts[bucket]++;
+						if (!unit->is_alive)
+							_deadunits++;
+					}
+
+					//Give each used bucket a contiguous range in the order of the buckets, so that the alliances are contiguous as well
+					std::sort(_usedbuckets.begin(), _usedbuckets.end());
+					for (const auto& bucket : _usedbuckets)
+					{
+						for (; alliance <= (bucket / UNITINDEX_TYPES); alliance++)
+							_alliancestarts[alliance] = next;
+						_starts[bucket] = next;
+						next += _counts[bucket];
+					}
+					for (; alliance <= UNITINDEX_ALLIANCES; alliance++)
+						_alliancestarts[alliance] = next;
+
+					//Place the units in their buckets from the copies, without reading them again
+					_sortedunits.resize(_units.size());
+					_positions.resize(_units.size());
+					_observedunits.resize(_units.size());
+					for (size_t index = 0; index < _units.size(); index++)
+					{
+						uint32_t position = _starts[_unitbuckets[index]]++;
+						const ObservedUnit& observedunit = _unsortedunits[index];
+
+						_sortedunits[position] = _units[index];
+						_positions[position] = Point2D(observedunit.x, observedunit.y);
+						_observedunits[position] = observedunit;
+					}
+					for (const auto& bucket : _usedbuckets)
+						_starts[bucket] -= _counts[bucket];
+
+					_gameloop = observation->GetGameLoop();
+					_isbuilt = true;
+					_rebuilds++;
+				}
+
+			public:
+				UnitIndex()
+				{
+					_counts = std::vector<uint32_t>(UNITINDEX_ALLIANCES * UNITINDEX_TYPES, 0);
+					_inprogresscounts = std::vector<uint32_t>(UNITINDEX_ALLIANCES * UNITINDEX_TYPES, 0);
+					_starts = std::vector<uint32_t>(UNITINDEX_ALLIANCES * UNITINDEX_TYPES, 0);
+					std::fill(_alliancestarts, _alliancestarts + UNITINDEX_ALLIANCES + 1, 0);
+					_deadunits = 0;
+					_gameloop = 0;
+					_isbuilt = false;
+					_rebuilds = 0;
+				}
+
+				//Rebuilds the index if the game loop has changed since it was built, otherwise does nothing
+				void Update(const ObservationInterface* observation)
+				{
+					if (!_isbuilt || observation->GetGameLoop() != _gameloop)
+						Rebuild(observation);
+				}
+
+				//Forces the next update to rebuild the index, such as when a new game starts at the same game loop
+				void Invalidate()
+				{
+					_isbuilt = false;
+				}
+
+				//Returns the number of units of a type, including the units that are still being built
+				size_t CountOf(UNIT_TYPEID unit_type, Unit::Alliance alliance = Unit::Alliance::Self) const
+				{
+					return _counts[GetBucket(alliance, unit_type)];
+				}
+
+				//Returns the number of units of a type that are still being built
+				size_t CountInProgressOf(UNIT_TYPEID unit_type, Unit::Alliance alliance = Unit::Alliance::Self) const
+				{
+					return _inprogresscounts[GetBucket(alliance, unit_type)];
+				}
+
+				//Returns the units of a type
+				UnitIndexRange<const Unit*> GetUnits(UNIT_TYPEID unit_type, Unit::Alliance alliance = Unit::Alliance::Self) const
+				{
+					size_t bucket = GetBucket(alliance, unit_type);
+					const Unit* const* first = (_sortedunits.data() + _starts[bucket]);
+
+					return UnitIndexRange<const Unit*>(first, first + _counts[bucket]);
+				}
+
+				//Returns the positions of the units of a type, in the same order as GetUnits
+				UnitIndexRange<Point2D> GetPositions(UNIT_TYPEID unit_type, Unit::Alliance alliance = Unit::Alliance::Self) const
+				{
+					size_t bucket = GetBucket(alliance, unit_type);
+					const Point2D* first = (_positions.data() + _starts[bucket]);
+
+					return UnitIndexRange<Point2D>(first, first + _counts[bucket]);
+				}
+
+				//Returns the spatial index of the units of a type in any alliance, such as the resources
+				SpatialIndex& GetSpatialIndexOf(UNIT_TYPEID unit_type)
+				{
+					return GetSpatialIndex(static_cast<uint32_t>(unit_type), [this, unit_type]()
+					{
+						for (size_t alliance = 1; alliance < UNITINDEX_ALLIANCES; alliance++)
+						{
+							size_t bucket = GetBucket(static_cast<Unit::Alliance>(alliance), unit_type);
+
+							_spatialunits.insert(_spatialunits.end(), _sortedunits.begin() + _starts[bucket], _sortedunits.begin() + _starts[bucket] + _counts[bucket]);
+							_spatialpositions.insert(_spatialpositions.end(), _positions.begin() + _starts[bucket], _positions.begin() + _starts[bucket] + _counts[bucket]);
+						}
+					});
+				}
+
+				//Returns the spatial index of every unit of an alliance, such as our own or the enemy army
+				SpatialIndex& GetSpatialIndexOf(Unit::Alliance alliance)
+				{
+					//The keys of the alliances are after every unit type
+					return GetSpatialIndex(static_cast<uint32_t>(UNITINDEX_ALLIANCES * UNITINDEX_TYPES) + static_cast<uint32_t>(alliance), [this, alliance]()
+					{
+						size_t first = _alliancestarts[static_cast<size_t>(alliance) % UNITINDEX_ALLIANCES], last = _alliancestarts[(static_cast<size_t>(alliance) % UNITINDEX_ALLIANCES) + 1];
+
+						_spatialunits.insert(_spatialunits.end(), _sortedunits.begin() + first, _sortedunits.begin() + last);
+						_spatialpositions.insert(_spatialpositions.end(), _positions.begin() + first, _positions.begin() + last);
+					});
+				}
+
+				//Returns the nearest unit of a type from a position in any alliance, or nullptr if there is none
+				//Many units are searched through the spatial index of their type, a few are scanned directly
+				const Unit* FindNearestOf(const Point2D& source_position, UNIT_TYPEID unit_type)
+				{
+					const Unit* target = nullptr;
+					float distance = std::numeric_limits<float>::max(), temporary_distance = 0;
+					size_t count = 0;
+
+					for (size_t alliance = 1; alliance < UNITINDEX_ALLIANCES; alliance++)
+						count += _counts[GetBucket(static_cast<Unit::Alliance>(alliance), unit_type)];
+					if (count > SPATIALINDEX_SCANUNITS)
+						return GetSpatialIndexOf(unit_type).FindNearestOf(source_position);
+
+					for (size_t alliance = 1; alliance < UNITINDEX_ALLIANCES; alliance++)
+					{
+						size_t bucket = GetBucket(static_cast<Unit::Alliance>(alliance), unit_type);
+
+						for (uint32_t index = _starts[bucket], last = (_starts[bucket] + _counts[bucket]); index < last; index++)
+						{
+							temporary_distance = DistanceSquared2D(_positions[index], source_position);
+							if (temporary_distance < distance)
+							{
+								distance = temporary_distance;
+								target = _sortedunits[index];
+							}
+						}
+					}
+
+					return target;
+				}
+
+				//Returns every unit of the game loop in the order of the observation
+				const Units& GetAllUnits() const
+				{
+					return _units;
+				}
+
+				//Returns the copies of every unit of an alliance, sorted by unit type, so they can be copied without reading the units
+				UnitIndexRange<ObservedUnit> GetObservedUnits(Unit::Alliance alliance) const
+				{
+					size_t index = static_cast<size_t>(alliance) % UNITINDEX_ALLIANCES;
+
+					return UnitIndexRange<ObservedUnit>(_observedunits.data() + _alliancestarts[index], _observedunits.data() + _alliancestarts[index + 1]);
+				}
+
+				//Returns the number of units of the game loop that are not alive
+				size_t CountDead() const
+				{
+					return _deadunits;
+				}
+
+				uint32_t GetGameLoop() const
+				{
+					return _gameloop;
+				}
+
+				uint64_t GetRebuildCount() const
+				{
+					return _rebuilds;
+				}
+		};
+	}
+}
@@ -0,0 +1,366 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../Agent/Action.h"
+#include "../Repository/ColumnarRepository.h"
+
+//Compares the dispatch of the commands of CommandsRepository.csv through the chain of string finds that the agent used to have, with parsing them once and dispatching them through the table of handlers
+//The handlers only count their calls, so that only the dispatch itself is measured
+//Usage: ActionDispatchBenchmark [Documents/Testing directory] [repetitions]
+namespace KoKeKoKo
+{
+	namespace Benchmarks
+	{
+		using namespace KoKeKoKo::Agent;
+
+		template<typename Function>
+		double GetMilliseconds(Function function)
+		{
+			auto start = std::chrono::steady_clock::now();
+
+			function();
+
+			return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		//Stands in for the Try functions of the agent, with the two ways that ExecuteAbility has found them
+		class ActionDispatcher
+		{
+			private:
+				//The number of times each handler has been called
+				uint64_t _calls[ACTION_COUNT];
+
+				ActionDispatcher(const ActionDispatcher&);
+				ActionDispatcher& operator=(const ActionDispatcher&);
+
+				template<Action action>
+				bool Handle()
+				{
+					_calls[static_cast<size_t>(action)]++;
+					return true;
+				}
+
+			public:
+				ActionDispatcher()
+				{
+					Reset();
+				}
+
+				void Reset()
+				{
+					std::fill(_calls, _calls + ACTION_COUNT, 0);
+				}
+
+				//The chain of ExecuteAbility before the actions were parsed, every command is searched for the names in order until one is found in it
+				bool DispatchThroughChain(const std::string& ability)
+				{
+					if (ability.find("BUILD_REFINERY") != std::string::npos)
+						return Handle<Action::BUILD_REFINERY>();
+					else if (ability.find("BUILD_COMMANDCENTER") != std::string::npos)
+						return Handle<Action::BUILD_COMMANDCENTER>();
+					else if (ability.find("MORPH_ORBITALCOMMAND") != std::string::npos)
+						return Handle<Action::MORPH_ORBITALCOMMAND>();
+					else if (ability.find("EFFECT_CALLDOWNMULE") != std::string::npos)
+						return Handle<Action::EFFECT_CALLDOWNMULE>();
+					else if (ability.find("MORPH_PLANETARYFORTRESS") != std::string::npos)
+						return Handle<Action::MORPH_PLANETARYFORTRESS>();
+					else if (ability.find("TRAIN_SCV") != std::string::npos)
+						return Handle<Action::TRAIN_SCV>();
+					else if (ability.find("BUILD_SUPPLYDEPOT") != std::string::npos)
+						return Handle<Action::BUILD_SUPPLYDEPOT>();
+					else if (ability.find("BUILD_BARRACKS") != std::string::npos)
+						return Handle<Action::BUILD_BARRACKS>();
+					else if (ability.find("TRAIN_MARINE") != std::string::npos)
+						return Handle<Action::TRAIN_MARINE>();
+					else if (ability.find("TRAIN_REAPER") != std::string::npos)
+						return Handle<Action::TRAIN_REAPER>();
+					else if (ability.find("TRAIN_MARAUDER") != std::string::npos)
+						return Handle<Action::TRAIN_MARAUDER>();
+					else if (ability.find("TRAIN_GHOST") != std::string::npos)
+						return Handle<Action::TRAIN_GHOST>();
+					else if (ability.find("BUILD_BARRACKSTECHLAB") != std::string::npos)
+						return Handle<Action::BUILD_BARRACKSTECHLAB>();
+					else if (ability.find("RESEARCH_COMBATSHIELD") != std::string::npos)
+						return Handle<Action::RESEARCH_COMBATSHIELD>();
+					else if (ability.find("RESEARCH_STIMPACK") != std::string::npos)
+						return Handle<Action::RESEARCH_STIMPACK>();
+					else if (ability.find("RESEARCH_CONCUSSIVESHELLS") != std::string::npos)
+						return Handle<Action::RESEARCH_CONCUSSIVESHELLS>();
+					else if (ability.find("BUILD_BARRACKSREACTOR") != std::string::npos)
+						return Handle<Action::BUILD_BARRACKSREACTOR>();
+					else if (ability.find("BUILD_FACTORY") != std::string::npos)
+						return Handle<Action::BUILD_FACTORY>();
+					else if (ability.find("TRAIN_HELLION") != std::string::npos)
+						return Handle<Action::TRAIN_HELLION>();
+					else if (ability.find("MORPH_HELLBAT") != std::string::npos)
+						return Handle<Action::MORPH_HELLBAT>();
+					else if (ability.find("TRAIN_WIDOWMINE") != std::string::npos)
+						return Handle<Action::TRAIN_WIDOWMINE>();
+					else if (ability.find("TRAIN_SIEGETANK") != std::string::npos)
+						return Handle<Action::TRAIN_SIEGETANK>();
+					else if (ability.find("MORPH_SIEGEMODE") != std::string::npos)
+						return Handle<Action::MORPH_SIEGEMODE>();
+					else if (ability.find("MORPH_UNSIEGE") != std::string::npos)
+						return Handle<Action::MORPH_UNSIEGE>();
+					else if (ability.find("TRAIN_CYCLONE") != std::string::npos)
+						return Handle<Action::TRAIN_CYCLONE>();
+					else if (ability.find("TRAIN_HELLBAT") != std::string::npos)
+						return Handle<Action::TRAIN_HELLBAT>();
+					else if (ability.find("MORPH_HELLION") != std::string::npos)
+						return Handle<Action::MORPH_HELLION>();
+					else if (ability.find("TRAIN_THOR") != std::string::npos)
+						return Handle<Action::TRAIN_THOR>();
+					else if (ability.find("BUILD_FACTORYTECHLAB") != std::string::npos)
+						return Handle<Action::BUILD_FACTORYTECHLAB>();
+					else if (ability.find("RESEARCH_INFERNALPREIGNITER") != std::string::npos)
+						return Handle<Action::RESEARCH_INFERNALPREIGNITER>();
+					else if (ability.find("RESEARCH_MAGFIELDLAUNCHERS") != std::string::npos)
+						return Handle<Action::RESEARCH_MAGFIELDLAUNCHERS>();
+					else if (ability.find("RESEARCH_DRILLINGCLAWS") != std::string::npos)
+						return Handle<Action::RESEARCH_DRILLINGCLAWS>();
+					else if (ability.find("BUILD_FACTORYREACTOR") != std::string::npos)
+						return Handle<Action::BUILD_FACTORYREACTOR>();
+					else if (ability.find("BUILD_STARPORT") != std::string::npos)
+						return Handle<Action::BUILD_STARPORT>();
+					else if (ability.find("TRAIN_VIKINGFIGHTER") != std::string::npos)
+						return Handle<Action::TRAIN_VIKINGFIGHTER>();
+					else if (ability.find("MORPH_VIKINGFIGHTERMODE") != std::string::npos)
+						return Handle<Action::MORPH_VIKINGFIGHTERMODE>();
+					else if (ability.find("MORPH_VIKINGASSAULTMODE") != std::string::npos)
+						return Handle<Action::MORPH_VIKINGASSAULTMODE>();
+					else if (ability.find("TRAIN_MEDIVAC") != std::string::npos)
+						return Handle<Action::TRAIN_MEDIVAC>();
+					else if (ability.find("TRAIN_LIBERATOR") != std::string::npos)
+						return Handle<Action::TRAIN_LIBERATOR>();
+					else if (ability.find("MORPH_LIBERATORAGMODE") != std::string::npos)
+						return Handle<Action::MORPH_LIBERATORAGMODE>();
+					else if (ability.find("MORPH_LIBERATORAAMODE") != std::string::npos)
+						return Handle<Action::MORPH_LIBERATORAAMODE>();
+					else if (ability.find("TRAIN_RAVEN") != std::string::npos)
+						return Handle<Action::TRAIN_RAVEN>();
+					else if (ability.find("EFFECT_AUTOTURRET") != std::string::npos)
+						return Handle<Action::EFFECT_AUTOTURRET>();
+					else if (ability.find("TRAIN_BANSHEE") != std::string::npos)
+						return Handle<Action::TRAIN_BANSHEE>();
+					else if (ability.find("TRAIN_BATTLECRUISER") != std::string::npos)
+						return Handle<Action::TRAIN_BATTLECRUISER>();
+					else if (ability.find("BUILD_STARPORTREACTOR") != std::string::npos)
+						return Handle<Action::BUILD_STARPORTREACTOR>();
+					else if (ability.find("BUILD_STARPORTTECHLAB") != std::string::npos)
+						return Handle<Action::BUILD_STARPORTTECHLAB>();
+					else if (ability.find("RESEARCH_HIGHCAPACITYFUELTANKS") != std::string::npos)
+						return Handle<Action::RESEARCH_HIGHCAPACITYFUELTANKS>();
+					else if (ability.find("RESEARCH_RAVENCORVIDREACTOR") != std::string::npos)
+						return Handle<Action::RESEARCH_RAVENCORVIDREACTOR>();
+					else if (ability.find("RESEARCH_BANSHEECLOAKINGFIELD") != std::string::npos)
+						return Handle<Action::RESEARCH_BANSHEECLOAKINGFIELD>();
+					else if (ability.find("RESEARCH_BANSHEEHYPERFLIGHTROTORS") != std::string::npos)
+						return Handle<Action::RESEARCH_BANSHEEHYPERFLIGHTROTORS>();
+					else if (ability.find("RESEARCH_ADVANCEDBALLISTICS") != std::string::npos)
+						return Handle<Action::RESEARCH_ADVANCEDBALLISTICS>();
+					else if (ability.find("BUILD_FUSIONCORE") != std::string::npos)
+						return Handle<Action::BUILD_FUSIONCORE>();
+					else if (ability.find("RESEARCH_BATTLECRUISERWEAPONREFIT") != std::string::npos)
+						return Handle<Action::RESEARCH_BATTLECRUISERWEAPONREFIT>();
+					else if (ability.find("BUILD_ARMORY") != std::string::npos)
+						return Handle<Action::BUILD_ARMORY>();
+					else if (ability.find("RESEARCH_TERRANVEHICLEWEAPONS") != std::string::npos)
+						return Handle<Action::RESEARCH_TERRANVEHICLEWEAPONS>();
+					else if (ability.find("RESEARCH_TERRANSHIPWEAPONS") != std::string::npos)
+						return Handle<Action::RESEARCH_TERRANSHIPWEAPONS>();
+					else if (ability.find("RESEARCH_TERRANVEHICLEANDSHIPPLATING") != std::string::npos)
+						return Handle<Action::RESEARCH_TERRANVEHICLEANDSHIPPLATING>();
+					else if (ability.find("BUILD_BUNKER") != std::string::npos)
+						return Handle<Action::BUILD_BUNKER>();
+					else if (ability.find("BUILD_ENGINEERINGBAY") != std::string::npos)
+						return Handle<Action::BUILD_ENGINEERINGBAY>();
+					else if (ability.find("RESEARCH_TERRANINFANTRYWEAPONS") != std::string::npos)
+						return Handle<Action::RESEARCH_TERRANINFANTRYWEAPONS>();
+					else if (ability.find("RESEARCH_TERRANINFANTRYARMOR") != std::string::npos)
+						return Handle<Action::RESEARCH_TERRANINFANTRYARMOR>();
+					else if (ability.find("BUILD_GHOSTACADEMY") != std::string::npos)
+						return Handle<Action::BUILD_GHOSTACADEMY>();
+					else if (ability.find("RESEARCH_PERSONALCLOAKING") != std::string::npos)
+						return Handle<Action::RESEARCH_PERSONALCLOAKING>();
+					else if (ability.find("BUILD_NUKE") != std::string::npos)
+						return Handle<Action::BUILD_NUKE>();
+					else if (ability.find("BUILD_MISSILETURRET") != std::string::npos)
+						return Handle<Action::BUILD_MISSILETURRET>();
+					else if (ability.find("BUILD_SENSORTOWER") != std::string::npos)
+						return Handle<Action::BUILD_SENSORTOWER>();
+					else if (ability.find("SURRENDER") != std::string::npos)
+						return Handle<Action::SURRENDER>();
+
+					return false;
+				}
+
+				//ExecuteAbility of the agent, the action has been parsed when its message arrived
+				bool DispatchThroughTable(Action action)
+				{
+					typedef bool (ActionDispatcher::*ActionHandler)();
+					//The handlers of the actions in the same order as Action
+					static constexpr ActionHandler ACTION_HANDLERS[] =
+					{
+						nullptr, //NONE
+						&ActionDispatcher::Handle<Action::BUILD_REFINERY>,
+						&ActionDispatcher::Handle<Action::BUILD_COMMANDCENTER>,
+						&ActionDispatcher::Handle<Action::MORPH_ORBITALCOMMAND>,
+						&ActionDispatcher::Handle<Action::EFFECT_CALLDOWNMULE>,
+						&ActionDispatcher::Handle<Action::MORPH_PLANETARYFORTRESS>,
+						&ActionDispatcher::Handle<Action::TRAIN_SCV>,
+						&ActionDispatcher::Handle<Action::BUILD_SUPPLYDEPOT>,
+						&ActionDispatcher::Handle<Action::BUILD_BARRACKS>,
+						&ActionDispatcher::Handle<Action::TRAIN_MARINE>,
+						&ActionDispatcher::Handle<Action::TRAIN_REAPER>,
+						&ActionDispatcher::Handle<Action::TRAIN_MARAUDER>,
+						&ActionDispatcher::Handle<Action::TRAIN_GHOST>,
+						&ActionDispatcher::Handle<Action::BUILD_BARRACKSTECHLAB>,
+						&ActionDispatcher::Handle<Action::RESEARCH_COMBATSHIELD>,
+						&ActionDispatcher::Handle<Action::RESEARCH_STIMPACK>,
+						&ActionDispatcher::Handle<Action::RESEARCH_CONCUSSIVESHELLS>,
+						&ActionDispatcher::Handle<Action::BUILD_BARRACKSREACTOR>,
+						&ActionDispatcher::Handle<Action::BUILD_FACTORY>,
+						&ActionDispatcher::Handle<Action::TRAIN_HELLION>,
+						&ActionDispatcher::Handle<Action::MORPH_HELLBAT>,
+						&ActionDispatcher::Handle<Action::TRAIN_WIDOWMINE>,
+						&ActionDispatcher::Handle<Action::TRAIN_SIEGETANK>,
+						&ActionDispatcher::Handle<Action::MORPH_SIEGEMODE>,
+						&ActionDispatcher::Handle<Action::MORPH_UNSIEGE>,
+						&ActionDispatcher::Handle<Action::TRAIN_CYCLONE>,
+						&ActionDispatcher::Handle<Action::TRAIN_HELLBAT>,
+						&ActionDispatcher::Handle<Action::MORPH_HELLION>,
+						&ActionDispatcher::Handle<Action::TRAIN_THOR>,
+						&ActionDispatcher::Handle<Action::BUILD_FACTORYTECHLAB>,
+						&ActionDispatcher::Handle<Action::RESEARCH_INFERNALPREIGNITER>,
+						&ActionDispatcher::Handle<Action::RESEARCH_MAGFIELDLAUNCHERS>,
+						&ActionDispatcher::Handle<Action::RESEARCH_DRILLINGCLAWS>,
+						&ActionDispatcher::Handle<Action::BUILD_FACTORYREACTOR>,
+						&ActionDispatcher::Handle<Action::BUILD_STARPORT>,
+						&ActionDispatcher::Handle<Action::TRAIN_VIKINGFIGHTER>,
+						&ActionDispatcher::Handle<Action::MORPH_VIKINGFIGHTERMODE>,
+						&ActionDispatcher::Handle<Action::MORPH_VIKINGASSAULTMODE>,
+						&ActionDispatcher::Handle<Action::TRAIN_MEDIVAC>,
+						&ActionDispatcher::Handle<Action::TRAIN_LIBERATOR>,
+						&ActionDispatcher::Handle<Action::MORPH_LIBERATORAGMODE>,
+						&ActionDispatcher::Handle<Action::MORPH_LIBERATORAAMODE>,
+						&ActionDispatcher::Handle<Action::TRAIN_RAVEN>,
+						&ActionDispatcher::Handle<Action::EFFECT_AUTOTURRET>,
+						&ActionDispatcher::Handle<Action::TRAIN_BANSHEE>,
+						&ActionDispatcher::Handle<Action::TRAIN_BATTLECRUISER>,
+						&ActionDispatcher::Handle<Action::BUILD_STARPORTREACTOR>,
+						&ActionDispatcher::Handle<Action::BUILD_STARPORTTECHLAB>,
+						&ActionDispatcher::Handle<Action::RESEARCH_HIGHCAPACITYFUELTANKS>,
+						&ActionDispatcher::Handle<Action::RESEARCH_RAVENCORVIDREACTOR>,
+						&ActionDispatcher::Handle<Action::RESEARCH_BANSHEECLOAKINGFIELD>,
+						&ActionDispatcher::Handle<Action::RESEARCH_BANSHEEHYPERFLIGHTROTORS>,
+						&ActionDispatcher::Handle<Action::RESEARCH_ADVANCEDBALLISTICS>,
+						&ActionDispatcher::Handle<Action::BUILD_FUSIONCORE>,
+						&ActionDispatcher::Handle<Action::RESEARCH_BATTLECRUISERWEAPONREFIT>,
+						&ActionDispatcher::Handle<Action::BUILD_ARMORY>,
+						&ActionDispatcher::Handle<Action::RESEARCH_TERRANVEHICLEWEAPONS>,
+						&ActionDispatcher::Handle<Action::RESEARCH_TERRANSHIPWEAPONS>,
+						&ActionDispatcher::Handle<Action::RESEARCH_TERRANVEHICLEANDSHIPPLATING>,
+						&ActionDispatcher::Handle<Action::BUILD_BUNKER>,
+						&ActionDispatcher::Handle<Action::BUILD_ENGINEERINGBAY>,
+						&ActionDispatcher::Handle<Action::RESEARCH_TERRANINFANTRYWEAPONS>,
+						&ActionDispatcher::Handle<Action::RESEARCH_TERRANINFANTRYARMOR>,
+						&ActionDispatcher::Handle<Action::BUILD_GHOSTACADEMY>,
+						&ActionDispatcher::Handle<Action::RESEARCH_PERSONALCLOAKING>,
+						&ActionDispatcher::Handle<Action::BUILD_NUKE>,
+						&ActionDispatcher::Handle<Action::BUILD_MISSILETURRET>,
+						&ActionDispatcher::Handle<Action::BUILD_SENSORTOWER>,
+						&ActionDispatcher::Handle<Action::SURRENDER>
+					};
+
+					static_assert((sizeof(ACTION_HANDLERS) / sizeof(ACTION_HANDLERS[0])) == ACTION_COUNT, "Every action must have a handler");
+
+					if (action == Action::NONE || static_cast<size_t>(action) >= ACTION_COUNT)
+						return false;
+
+					return (this->*ACTION_HANDLERS[static_cast<size_t>(action)])();
+				}
+
+				uint64_t GetCalls(Action action) const
+				{
+					return _calls[static_cast<size_t>(action)];
+				}
+		};
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace KoKeKoKo;
+	using namespace KoKeKoKo::Agent;
+	std::string directory = (argc > 1) ? argv[1] : "Documents/Testing";
+	size_t repetitions = (argc > 2) ? static_cast<size_t>(std::stoi(argv[2])) : 20;
+	Repository::CommandsRepository commands;
+	Benchmarks::ActionDispatcher chain, table;
+
+	try
+	{
+		commands.Load(directory + "/CommandsRepository.csv");
+
+		//The names of the commands in the order of the file, as model service would send them
+		const Repository::RepositoryDictionary& names = commands.GetDictionary(Repository::CommandsColumns::COMMANDS);
+		std::vector<std::string> abilities;
+		for (const auto& command : commands.GetColumns().commands)
+			abilities.push_back(names.GetName(command));
+
+		std::vector<Action> actions(abilities.size());
+		uint64_t chaincalls = 0, parsedactions = 0, tablecalls = 0;
+		double chainbest = 0, parsebest = 0, tablebest = 0;
+		for (size_t repetition = 0; repetition < repetitions; repetition++)
+		{
+			chain.Reset();
+			table.Reset();
+			chaincalls = parsedactions = tablecalls = 0;
+
+			double chainmilliseconds = Benchmarks::GetMilliseconds([&]()
+			{
+				for (const auto& ability : abilities)
+					chaincalls += chain.DispatchThroughChain(ability) ? 1 : 0;
+			});
+			//Parsing happens once when a message arrives, dispatching on every step that executes the action
+			double parsemilliseconds = Benchmarks::GetMilliseconds([&]()
+			{
+				for (size_t index = 0; index < abilities.size(); index++)
+				{
+					actions[index] = ParseAction(abilities[index].data(), abilities[index].size());
+					parsedactions += (actions[index] != Action::NONE) ? 1 : 0;
+				}
+			});
+			double tablemilliseconds = Benchmarks::GetMilliseconds([&]()
+			{
+				for (const auto& action : actions)
+					tablecalls += table.DispatchThroughTable(action) ? 1 : 0;
+			});
+
+			chainbest = (repetition == 0) ? chainmilliseconds : std::min(chainbest, chainmilliseconds);
+			parsebest = (repetition == 0) ? parsemilliseconds : std::min(parsebest, parsemilliseconds);
+			tablebest = (repetition == 0) ? tablemilliseconds : std::min(tablebest, tablemilliseconds);
+		}
+
+		//The chain runs the handler of the first name that a command contains, such as BUILD_BARRACKS for BUILD_BARRACKSTECHLAB
+		uint64_t mismatched = 0;
+		for (size_t action = 1; action < ACTION_COUNT; action++)
+		{
+			uint64_t chained = chain.GetCalls(static_cast<Action>(action)), tabled = table.GetCalls(static_cast<Action>(action));
+
+			mismatched += (chained > tabled) ? (chained - tabled) : (tabled - chained);
+		}
+
+		std::cout << "commands=" << abilities.size() << " chain_dispatched=" << chaincalls << " table_dispatched=" << tablecalls << " parsed=" << parsedactions << " handler_calls_that_differ=" << mismatched << std::endl;
+		std::cout << "chain_nanoseconds_per_command=" << ((chainbest * 1000000) / abilities.size()) << " parse_nanoseconds_per_command=" << ((parsebest * 1000000) / abilities.size()) << " table_nanoseconds_per_command=" << ((tablebest * 1000000) / abilities.size()) << std::endl;
+
+		return (tablecalls > 0) ? 0 : 1;
+	}
+	catch (const std::exception& exception)
+	{
+		std::cout << exception.what() << std::endl;
+		return 1;
+	}
+}
@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <ostream>
+#include <string>
+#include <vector>
+#define KOKEKOKO_SIMULATION 1
+#include "../main.cpp"
+#include "../Repository/ColumnarRepository.h"
+#include "../Repository/RepositoryJoin.h"
+#include "../Simulation/ReplaySimulation.h"
+
+//Measures the hot paths of the agent one at a time, on the busiest game loop of ArmiesRepository.csv as the simulation replays it
+//Every benchmark writes a line of name=value pairs with the fastest nanoseconds per operation of its repetitions, so the results of every commit can be compared
+//Usage: AgentBenchmark [Documents/Testing directory] [milliseconds per benchmark]
+namespace KoKeKoKo
+{
+	namespace Benchmarks
+	{
+		//The repetitions of a benchmark, the fastest one is reported
+		const size_t AGENTBENCHMARK_REPETITIONS = 5;
+		//The game loops between the two snapshots of a delta, model service is sent an update every 10 seconds
+		const uint32_t AGENTBENCHMARK_DELTALOOPS = 10 * Simulation::SIMULATION_GAMELOOPSPERSECOND;
+		//The game loops that the world moves on between two steps of the agent, longer than an issued order is pending
+		const uint32_t AGENTBENCHMARK_STEPLOOPS = 64;
+
+		//Repeats the operations of a benchmark until the time of a repetition is up, and writes the fastest nanoseconds per operation
+		//What the operations return is summed into the checksum, so that none of them can be left out by the compiler
+		//If the operations return the bytes that they have written, the bytes per operation are written as well
+		template<typename Function>
+		void Measure(std::ostream& report, const std::string& name, size_t operations, double milliseconds, Function function, bool isbytes = false)
+		{
+			double best = 0;
+			uint64_t batches = 0, checksum = 0;
+
+			for (size_t repetition = 0; repetition < AGENTBENCHMARK_REPETITIONS; repetition++)
+			{
+				uint64_t count = 0;
+				double elapsed = 0;
+				auto start = std::chrono::steady_clock::now();
+
+				do
+				{
+					checksum += function();
+					count++;
+					elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+				} while (elapsed < (milliseconds / AGENTBENCHMARK_REPETITIONS));
+
+				double nanoseconds = (elapsed * 1000000) / (count * operations);
+				best = (repetition == 0) ? nanoseconds : std::min(best, nanoseconds);
+				batches += count;
+			}
+
+			report << "benchmark=" << name << " operations_per_batch=" << operations << " batches=" << batches << " nanoseconds_per_operation=" << best;
+			if (isbytes)
+				report << " bytes_per_operation=" << (static_cast<double>(checksum) / (batches * operations));
+			report << " checksum=" << checksum << std::endl;
+		}
+
+		//Returns the replay and the game loop with the most units alive, the units of a replay are only destroyed once its battle is reached
+		std::pair<size_t, uint32_t> FindBusiestGameLoop(const Repository::ArmiesRepository& armies, const Repository::CommandsRepository& commands, const Repository::ResourcesRepository& resources, const std::vector<Repository::RepositoryJoinReplay>& replays)
+		{
+			std::pair<size_t, uint32_t> busiest(0, 0);
+			size_t mostunits = 0;
+
+			for (size_t replay = 0; replay < replays.size(); replay++)
+			{
+				std::vector<uint16_t> players = Simulation::ReplaySimulation::GetPlayers(resources, replays[replay]);
+
+				if (players.empty())
+					continue;
+
+				Simulation::ReplaySimulation simulation(armies, commands, resources, replays[replay], players.front());
+				while (simulation.Step(Simulation::SIMULATION_GAMELOOPSPERSECOND))
+				{
+					size_t units = simulation.GetObservation().GetUnits().size();
+
+					if (units > mostunits && simulation.GetObservation().GetGameLoop() > AGENTBENCHMARK_DELTALOOPS)
+					{
+						mostunits = units;
+						busiest = std::make_pair(replay, simulation.GetObservation().GetGameLoop());
+					}
+					simulation.GetObservation().ClearEvents();
+				}
+			}
+
+			return busiest;
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace KoKeKoKo;
+	using namespace KoKeKoKo::Agent;
+	std::string directory = (argc > 1) ? argv[1] : "Documents/Testing";
+	double milliseconds = (argc > 2) ? std::stod(argv[2]) : 500;
+	Repository::ArmiesRepository armies;
+	Repository::CommandsRepository commands;
+	Repository::ResourcesRepository resources;
+	//The messages of the agent are written into nothing by the logger, so that only what they cost the agent is measured
+	std::ostream discarded(nullptr);
+
+	Types::Logger::Start(discarded);
+	try
+	{
+		armies.Load(directory + "/ArmiesRepository.csv");
+		commands.Load(directory + "/CommandsRepository.csv");
+		resources.Load(directory + "/ResourcesRepository.csv");
+
+		Repository::RepositoryJoin join(armies, commands, resources);
+		const std::vector<Repository::RepositoryJoinReplay>& replays = join.GetReplays();
+		std::pair<size_t, uint32_t> busiest = Benchmarks::FindBusiestGameLoop(armies, commands, resources, replays);
+		uint16_t player = Simulation::ReplaySimulation::GetPlayers(resources, replays[busiest.first]).front();
+		Simulation::ReplaySimulation simulation(armies, commands, resources, replays[busiest.first], player);
+		Simulation::ReplayObservation& observation = simulation.GetObservation();
+		Simulation::ReplayActions& actions = simulation.GetActions();
+
+		//The snapshot that the delta starts from is taken before the busiest game loop, then the world is moved on to it
+		UnitIndex unitindex;
+		ObservationSnapshot previous, snapshot;
+		while (observation.GetGameLoop() + Benchmarks::AGENTBENCHMARK_DELTALOOPS < busiest.second && simulation.Step(1));
+		unitindex.Update(&observation);
+		previous.Capture(&observation, unitindex);
+		while (observation.GetGameLoop() < busiest.second && simulation.Step(1));
+		observation.ClearEvents();
+		unitindex.Update(&observation);
+		snapshot.Capture(&observation, unitindex);
+
+		//The workers harvest like they do in a game, so that our units have orders to scan
+		for (const auto& unit : unitindex.GetUnits(UNIT_TYPEID::TERRAN_SCV))
+			actions.UnitCommand(unit, ABILITY_ID::SMART, unitindex.FindNearestOf(unit->pos, UNIT_TYPEID::NEUTRAL_MINERALFIELD));
+		actions.SendActions();
+		unitindex.Invalidate();
+		unitindex.Update(&observation);
+
+		//The agent is only measured, it is never given actions to decide
+		std::vector<Simulation::SimulationDecision> decisions;
+		Simulation::ReplayActionProvider replayprovider(decisions);
+		ModelServiceActionProvider modelprovider(nullptr);
+		KoKeKoKoBot bot(&replayprovider);
+		bot.SetInterfaces(&observation, &actions);
+
+		std::vector<Point2D> positions;
+		for (const auto& unit : unitindex.GetAllUnits())
+			positions.push_back(Point2D(unit->pos.x, unit->pos.y));
+		std::vector<UNIT_TYPEID> types;
+		for (const auto& unittype : Simulation::SIMULATION_UNITTYPES)
+			types.push_back(unittype.type);
+		const Unit::Alliance alliances[] = { Unit::Alliance::Self, Unit::Alliance::Enemy, Unit::Alliance::Neutral };
+		const UNIT_TYPEID nearesttypes[] = { UNIT_TYPEID::NEUTRAL_MINERALFIELD, UNIT_TYPEID::NEUTRAL_VESPENEGEYSER, UNIT_TYPEID::TERRAN_MARINE };
+		//Every action that the agent can execute in a game, surrendering ends it
+		std::vector<Action> executable;
+		std::string message;
+		for (size_t action = 1; action < ACTION_COUNT; action++)
+		{
+			message += (message.empty() ? "" : ",") + std::string(GetActionName(static_cast<Action>(action)));
+			if (static_cast<Action>(action) != Action::SURRENDER)
+				executable.push_back(static_cast<Action>(action));
+		}
+		std::vector<DecidedAction> parsed(ACTION_COUNT);
+
+		std::cout << "replay=" << resources.GetReplays()[replays[busiest.first].resourcesreplay].filename << " player=" << player << " game_loop=" << observation.GetGameLoop() << " units=" << unitindex.GetAllUnits().size() << " self_units=" << snapshot.GetSelfUnits().size() << " enemy_units=" << snapshot.GetEnemyUnits().size() << std::endl;
+
+		Benchmarks::Measure(std::cout, "unit_index_rebuild", 1, milliseconds, [&]()
+		{
+			unitindex.Invalidate();
+			unitindex.Update(&observation);
+			return static_cast<uint64_t>(unitindex.GetAllUnits().size());
+		});
+		Benchmarks::Measure(std::cout, "order_registry_update", 1, milliseconds, [&]()
+		{
+			OrderRegistry orderregistry;
+
+			orderregistry.Update(&observation, unitindex.GetAllUnits());
+			return static_cast<uint64_t>(orderregistry.CountInFlight(ABILITY_ID::SMART));
+		});
+		Benchmarks::Measure(std::cout, "snapshot_capture", 1, milliseconds, [&]()
+		{
+			snapshot.Capture(&observation, unitindex);
+			return static_cast<uint64_t>(snapshot.GetSelfUnits().size());
+		});
+		Benchmarks::Measure(std::cout, "snapshot_text", 1, milliseconds, [&]()
+		{
+			return static_cast<uint64_t>(modelprovider.WriteTextSnapshot(snapshot).size());
+		}, true);
+		Benchmarks::Measure(std::cout, "snapshot_binary", 1, milliseconds, [&]()
+		{
+			return static_cast<uint64_t>(modelprovider.WriteBinarySnapshot(snapshot, false));
+		}, true);
+		//Every other snapshot is the one before, so every delta moves the units of 10 seconds
+		//The bytes are the average of the snapshots that are sent, a keyframe after every SNAPSHOT_KEYFRAMEINTERVAL deltas
+		Benchmarks::Measure(std::cout, "snapshot_binarydelta", 2, milliseconds, [&]()
+		{
+			return static_cast<uint64_t>(modelprovider.WriteBinarySnapshot(previous, true) + modelprovider.WriteBinarySnapshot(snapshot, true));
+		}, true);
+		Benchmarks::Measure(std::cout, "parse_actions", ACTION_COUNT - 1, milliseconds, [&]()
+		{
+			return static_cast<uint64_t>(modelprovider.ParseActions(message, DecisionStamp(), parsed.data(), parsed.size()));
+		});
+		Benchmarks::Measure(std::cout, "count_of", types.size() * 3, milliseconds, [&]()
+		{
+			uint64_t count = 0;
+
+			for (const auto& type : types)
+				for (const auto& alliance : alliances)
+					count += bot.CountOf(type, alliance);
+			return count;
+		});
+		Benchmarks::Measure(std::cout, "find_nearest_of", positions.size() * 3, milliseconds, [&]()
+		{
+			uint64_t found = 0;
+
+			for (const auto& position : positions)
+				for (const auto& type : nearesttypes)
+					found += (bot.FindNearestOf(position, type) != nullptr) ? 1 : 0;
+			return found;
+		});
+		//A step of the agent on a new game loop rebuilds the unit index, captures the snapshot and resets the budget, which every action below needs
+		Benchmarks::Measure(std::cout, "agent_step", 1, milliseconds, [&]()
+		{
+			observation.Advance(observation.GetGameLoop() + Benchmarks::AGENTBENCHMARK_STEPLOOPS);
+			observation.ClearEvents();
+			bot.OnStep();
+			return static_cast<uint64_t>(observation.GetGameLoop());
+		});
+		//Each action is dispatched through the table of handlers, then scans the orders and the units of its producer, the commands are discarded so the world stays the same
+		Benchmarks::Measure(std::cout, "execute_ability", executable.size(), milliseconds, [&]()
+		{
+			uint64_t executed = 0;
+
+			observation.Advance(observation.GetGameLoop() + Benchmarks::AGENTBENCHMARK_STEPLOOPS);
+			observation.ClearEvents();
+			bot.OnStep();
+			for (const auto& action : executable)
+				executed += bot.ExecuteAbility(action) ? 1 : 0;
+			actions.DiscardActions();
+			return executed;
+		});
+
+		Types::Logger::Stop();
+		return 0;
+	}
+	catch (const std::exception& exception)
+	{
+		Types::Logger::Stop();
+		std::cout << exception.what() << std::endl;
+		return 1;
+	}
+}
@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "../Agent/BuildOrderSimulator.h"
+#include "../Agent/MacroState.h"
+#include "Repositories.h"
+
+//Validates the build order simulator against the timing of real games, and measures the build orders that it simulates per second
+//The reserve that players leave unspent is fitted on half of the games and validated on the other half
+//Usage: BuildOrderSimulatorBenchmark [Documents/Testing directory] [build orders for the throughput]
+namespace KoKeKoKo
+{
+	namespace Benchmarks
+	{
+		using namespace Agent;
+
+		//The seconds of a real game whose commands are compared with the simulation, as the repositories count them
+		const int VALIDATION_SECONDS = 360;
+		//The game time that the simulation goes on until, after the last compared command so late commands can still start
+		const float VALIDATION_HORIZONSECONDS = 600.0f;
+		//The seconds of a real game where the workers, the supply and the bank are compared, as the repositories count them
+		const int VALIDATION_CHECKPOINTS[] = { 120, 240, 360 };
+		//The reserves that are tried when fitting, the minerals and the vespene are fitted together
+		const float VALIDATION_RESERVESTEP = 25.0f;
+		const float VALIDATION_MAXIMUMMINERALRESERVE = 400.0f;
+		const float VALIDATION_MAXIMUMVESPENERESERVE = 200.0f;
+
+		//The macro commands of a player of a real game, and the seconds that they were given at
+		struct RecordedBuildOrder
+		{
+			int player;
+			std::vector<Action> actions;
+			std::vector<float> seconds;
+		};
+
+		//How far the start times of simulated build orders are from the times that the commands were given at
+		struct StartErrors
+		{
+			size_t commands;
+			size_t never;
+			double mean;
+			double median;
+			double bias;
+			double within;
+		};
+
+		//Returns the build orders of every player, only with the commands that change the macro
+		std::vector<RecordedBuildOrder> GetRecordedBuildOrders(const std::vector<CommandsRow>& commands, int seconds)
+		{
+			std::vector<RecordedBuildOrder> buildorders;
+			std::map<int, size_t> players;
+
+			for (const auto& command : commands)
+			{
+				if (command.second > seconds || GetMacroActionData(command.action).kind == MacroKind::Tactical)
+					continue;
+
+				auto player = players.find(command.player);
+				if (player == players.end())
+				{
+					player = players.emplace(command.player, buildorders.size()).first;
+					buildorders.push_back(RecordedBuildOrder());
+					buildorders.back().player = command.player;
+				}
+				buildorders[player->second].actions.push_back(command.action);
+				buildorders[player->second].seconds.push_back(GetGameSeconds(command.second));
+			}
+
+			return buildorders;
+		}
+
+		double GetMedian(std::vector<float> values)
+		{
+			if (values.empty())
+				return 0;
+
+			std::sort(values.begin(), values.end());
+			return values[values.size() / 2];
+		}
+
+		//Simulates every other recorded build order, from the first or the second, and compares their start times with the real games
+		StartErrors GetStartErrors(BuildOrderSimulator& simulator, const std::vector<RecordedBuildOrder>& recorded, size_t first)
+		{
+			StartErrors errors = { 0, 0, 0, 0, 0, 0 };
+			std::vector<float> starttimes, absolute;
+			BuildOrderResult result;
+
+			for (size_t index = first; index < recorded.size(); index += 2)
+			{
+				BuildOrder order = { recorded[index].actions.data(), static_cast<uint32_t>(recorded[index].actions.size()), nullptr };
+
+				starttimes.resize(recorded[index].actions.size());
+				order.starttimes = starttimes.data();
+				simulator.Simulate(MacroState::CreateGameStart(), &order, 1, VALIDATION_HORIZONSECONDS, &result);
+				for (size_t action = 0; action < recorded[index].actions.size(); action++)
+				{
+					errors.commands++;
+					if (starttimes[action] < 0)
+					{
+						errors.never++;
+						continue;
+					}
+					absolute.push_back(std::fabs(starttimes[action] - recorded[index].seconds[action]));
+					errors.bias += starttimes[action] - recorded[index].seconds[action];
+					errors.within += (absolute.back() <= 15) ? 1 : 0;
+				}
+			}
+			for (const auto& error : absolute)
+				errors.mean += error;
+			if (!absolute.empty())
+			{
+				errors.mean /= absolute.size();
+				errors.bias /= absolute.size();
+				errors.within /= absolute.size();
+			}
+			errors.median = GetMedian(absolute);
+
+			return errors;
+		}
+
+		void PrintStartErrors(const std::string& name, const StartErrors& errors)
+		{
+			std::cout << name << " commands=" << errors.commands << " never_started=" << errors.never << " start_error_mean_seconds=" << errors.mean << " start_error_median_seconds=" << errors.median << " start_bias_mean_seconds=" << errors.bias << " within_15_seconds=" << errors.within << std::endl;
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace KoKeKoKo;
+	using namespace KoKeKoKo::Agent;
+	using namespace KoKeKoKo::Benchmarks;
+	std::string directory = (argc > 1) ? argv[1] : "Documents/Testing";
+	size_t throughputcount = (argc > 2) ? static_cast<size_t>(std::stoi(argv[2])) : 8192;
+	std::vector<CommandsRow> commands = ReadCommandsRepository(directory + "/CommandsRepository.csv");
+	std::vector<ResourcesRow> resources = ReadResourcesRepository(directory + "/ResourcesRepository.csv");
+	std::vector<RecordedBuildOrder> recorded = GetRecordedBuildOrders(commands, VALIDATION_SECONDS);
+	BuildOrderSimulator simulator;
+
+	if (recorded.size() < 2 || resources.empty())
+	{
+		std::cout << "Error Occurred! Failed to read the repositories from " << directory << "..." << std::endl;
+		return 1;
+	}
+
+	//The reserve with the smallest mean error on the build orders of the fitting half
+	float mineralreserve = 0, vespenereserve = 0;
+	double besterror = GetStartErrors(simulator, recorded, 0).mean;
+	for (float minerals = 0; minerals <= VALIDATION_MAXIMUMMINERALRESERVE; minerals += VALIDATION_RESERVESTEP)
+	{
+		for (float vespene = 0; vespene <= VALIDATION_MAXIMUMVESPENERESERVE; vespene += VALIDATION_RESERVESTEP)
+		{
+			simulator.SetReserve(minerals, vespene);
+			double error = GetStartErrors(simulator, recorded, 0).mean;
+
+			if (error < besterror)
+			{
+				besterror = error;
+				mineralreserve = minerals;
+				vespenereserve = vespene;
+			}
+		}
+	}
+	std::cout << "build_orders=" << recorded.size() << " fitted_build_orders=" << ((recorded.size() + 1) / 2) << " reserve_minerals=" << mineralreserve << " reserve_vespene=" << vespenereserve << std::endl;
+
+	//The validating half, the way the agent would execute it and the way the players did
+	simulator.SetReserve(0, 0);
+	PrintStartErrors("without_reserve", GetStartErrors(simulator, recorded, 1));
+	simulator.SetReserve(mineralreserve, vespenereserve);
+	uint64_t swapped = simulator.GetSwappedCount();
+	PrintStartErrors("with_reserve", GetStartErrors(simulator, recorded, 1));
+	std::cout << "swapped_addons=" << (simulator.GetSwappedCount() - swapped) << std::endl;
+
+	//The workers, the supply and the bank of the recorded build orders against the ones of the real games
+	std::vector<BuildOrder> orders;
+	std::vector<BuildOrderResult> results;
+	for (int checkpoint : VALIDATION_CHECKPOINTS)
+	{
+		std::vector<RecordedBuildOrder> prefixes = GetRecordedBuildOrders(commands, checkpoint);
+		std::map<int, const ResourcesRow*> actual;
+		std::vector<float> workererrors, supplyerrors, mineralerrors;
+
+		for (const auto& row : resources)
+			if (row.second == checkpoint)
+				actual[row.player] = &row;
+		orders.resize(prefixes.size());
+		results.resize(prefixes.size());
+		for (size_t index = 0; index < prefixes.size(); index++)
+		{
+			orders[index].actions = prefixes[index].actions.data();
+			orders[index].count = static_cast<uint32_t>(prefixes[index].actions.size());
+			orders[index].starttimes = nullptr;
+		}
+		simulator.Simulate(MacroState::CreateGameStart(), orders.data(), orders.size(), GetGameSeconds(checkpoint), results.data());
+		for (size_t index = 0; index < prefixes.size(); index++)
+		{
+			auto row = actual.find(prefixes[index].player);
+
+			if (row == actual.end())
+				continue;
+			workererrors.push_back(std::fabs(static_cast<float>(results[index].workers - row->second->workers)));
+			supplyerrors.push_back(std::fabs(static_cast<float>(results[index].supplyused - row->second->foodused)));
+			mineralerrors.push_back(std::fabs(results[index].minerals - static_cast<float>(row->second->minerals)));
+		}
+		std::cout << "second=" << checkpoint << " players=" << workererrors.size() << " workers_error_median=" << GetMedian(workererrors) << " supply_error_median=" << GetMedian(supplyerrors) << " minerals_error_median=" << GetMedian(mineralerrors) << std::endl;
+	}
+
+	//The recorded build orders over and over
+	orders.clear();
+	for (size_t index = 0; index < throughputcount; index++)
+	{
+		const RecordedBuildOrder& buildorder = recorded[index % recorded.size()];
+		orders.push_back({ buildorder.actions.data(), static_cast<uint32_t>(buildorder.actions.size()), nullptr });
+	}
+	results.resize(orders.size());
+	auto start = std::chrono::steady_clock::now();
+	simulator.Simulate(MacroState::CreateGameStart(), orders.data(), orders.size(), VALIDATION_HORIZONSECONDS, results.data());
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << "build_orders=" << orders.size() << " horizon_seconds=" << VALIDATION_HORIZONSECONDS << " build_orders_per_second=" << (orders.size() / seconds) << std::endl;
+
+	return 0;
+}
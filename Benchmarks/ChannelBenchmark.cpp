@@ -0,0 +1,135 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "../Model/Channel.h"
+#include "../Types/Histogram.h"
+#include "ChannelClient.h"
+
+//Measures the messages per second and the round-trip latency of the channel between the agent and a stand-in for model service in the same process
+//The stand-in replies to every frame with a frame of the same correlation id, the way model service replies to a request for a decision
+//Usage: ChannelBenchmark [messages] [bytes per message]
+namespace KoKeKoKo
+{
+	namespace Benchmarks
+	{
+		using namespace Model;
+		//The round trips before the measured ones, so that the buffers of both ends have grown
+		const size_t CHANNELBENCHMARK_WARMUPMESSAGES = 1000;
+
+		//Replies to every frame until the agent disconnects, and returns the number of replies
+		uint64_t ReplyToAgent(Channel& service)
+		{
+			std::string payload;
+			uint32_t correlation = FRAME_UNCORRELATED;
+			uint64_t replies = 0;
+
+			while (service.ReadFrame(payload, correlation))
+			{
+				if (!service.WriteFrame(payload, correlation))
+					break;
+				replies++;
+			}
+
+			return replies;
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace KoKeKoKo;
+	using namespace KoKeKoKo::Model;
+	size_t messages = (argc > 1) ? static_cast<size_t>(std::stoull(argv[1])) : 100000;
+	size_t size = (argc > 2) ? static_cast<size_t>(std::stoull(argv[2])) : 64;
+
+	try
+	{
+		Channel* agent = Channel::CreateChannel(Benchmarks::CHANNELBENCHMARK_NAME);
+		Benchmarks::ChannelClient service(Benchmarks::CHANNELBENCHMARK_NAME);
+		uint64_t replies = 0;
+		std::thread standin([&service, &replies]()
+		{
+			if (service.Accept())
+				replies = Benchmarks::ReplyToAgent(service);
+		});
+
+		if (!agent->Accept())
+			throw std::runtime_error("Error Occurred! The stand-in for model service has failed to connect...");
+
+		std::string request(size, 'K'), reply;
+		uint32_t correlation = FRAME_UNCORRELATED;
+		Types::Histogram roundtrips;
+		bool isconsistent = true;
+
+		//Ping-pong, the agent waits for the reply of a request before it sends the next one
+		for (size_t message = 0; message < Benchmarks::CHANNELBENCHMARK_WARMUPMESSAGES; message++)
+			isconsistent = agent->WriteFrame(request, static_cast<uint32_t>(message + 1)) && agent->ReadFrame(reply, correlation) && isconsistent;
+		auto start = std::chrono::steady_clock::now();
+		for (size_t message = 0; message < messages; message++)
+		{
+			auto sent = std::chrono::steady_clock::now();
+
+			if (!agent->WriteFrame(request, static_cast<uint32_t>(message + 1)) || !agent->ReadFrame(reply, correlation))
+			{
+				isconsistent = false;
+				break;
+			}
+			roundtrips.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - sent).count()));
+			isconsistent = isconsistent && (correlation == (message + 1)) && (reply.size() == size);
+		}
+		double pingpong = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		//Pipelined, the agent keeps sending while another thread collects the replies, the way the agent sends updates and listens for messages
+		start = std::chrono::steady_clock::now();
+		std::thread sender([agent, &request, messages]()
+		{
+			for (size_t message = 0; message < messages; message++)
+				if (!agent->WriteFrame(request, static_cast<uint32_t>(message + 1)))
+					break;
+		});
+		for (size_t message = 0; message < messages; message++)
+		{
+			if (!agent->ReadFrame(reply, correlation))
+			{
+				isconsistent = false;
+				break;
+			}
+			isconsistent = isconsistent && (correlation == (message + 1));
+		}
+		//A reader that has stopped early leaves the sender blocked on a full channel until the channel is closed
+		if (!isconsistent)
+			agent->Close();
+		sender.join();
+		double pipelined = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		uint64_t frameswritten = agent->GetFramesWritten(), framesread = agent->GetFramesRead();
+		agent->Close();
+		standin.join();
+		delete agent;
+		isconsistent = isconsistent && (frameswritten == framesread) && (framesread == replies) && (service.GetFramesRead() == frameswritten);
+
+		std::cout << "backend=" <<
+		#ifdef _WIN32
+			"named_pipe"
+		#else
+			"unix_socket"
+		#endif
+			<< " messages=" << messages << " bytes_per_message=" << size << std::endl;
+		std::cout << "pingpong_messages_per_second=" << (messages / pingpong) << " pipelined_messages_per_second=" << (messages / pipelined) << std::endl;
+		std::cout << "roundtrip_microseconds:";
+		for (const auto& percentile : { 50.0, 90.0, 99.0, 99.9 })
+			std::cout << " p" << percentile << "=" << (roundtrips.GetValueAtPercentile(percentile) / 1000.0);
+		std::cout << " max=" << (roundtrips.GetMaximum() / 1000.0) << " mean=" << (roundtrips.GetMean() / 1000.0) << std::endl;
+		std::cout << "frames_written=" << frameswritten << " frames_read=" << framesread << " frames_replied=" << replies << std::endl;
+		std::cout << "consistent=" << isconsistent << std::endl;
+
+		return isconsistent ? 0 : 1;
+	}
+	catch (const std::exception& exception)
+	{
+		std::cout << exception.what() << std::endl;
+		return 1;
+	}
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include "../Model/Channel.h"
+
+namespace KoKeKoKo
+{
+	namespace Benchmarks
+	{
+		using namespace Model;
+		//The channel of the benchmark, apart from the channel of the agent so that both can run at the same time
+		#ifdef _WIN32
+			const std::string CHANNELBENCHMARK_NAME = "\\\\.\\pipe\\KoKeKoKoBenchmark";
+		#else
+			const std::string CHANNELBENCHMARK_NAME = "/tmp/KoKeKoKoBenchmark.sock";
+		#endif
+		//The milliseconds between the attempts of the stand-in to connect, the channel does not exist until the agent accepts
+		const uint32_t CHANNELBENCHMARK_RETRYMILLISECONDS = 10;
+
+		//The end of the channel that model service has, it connects to the channel that the agent accepts on
+		class ChannelClient : public Channel
+		{
+			private:
+				std::string _name;
+				#ifdef _WIN32
+					HANDLE _client;
+				#else
+					int _client;
+				#endif
+
+			protected:
+				#ifdef _WIN32
+					virtual bool WriteBytes(const char* bytes, size_t size) override
+					{
+						for (size_t written = 0; written < size;)
+						{
+							DWORD transferred = 0;
+
+							if (!WriteFile(_client, bytes + written, static_cast<DWORD>(size - written), &transferred, NULL))
+								return false;
+							written += transferred;
+						}
+
+						return true;
+					}
+
+					virtual bool ReadBytes(char* bytes, size_t size) override
+					{
+						for (size_t read = 0; read < size;)
+						{
+							DWORD transferred = 0;
+
+							if (!ReadFile(_client, bytes + read, static_cast<DWORD>(size - read), &transferred, NULL) || transferred == 0)
+								return false;
+							read += transferred;
+						}
+
+						return true;
+					}
+				#else
+					virtual bool WriteBytes(const char* bytes, size_t size) override
+					{
+						for (size_t written = 0; written < size;)
+						{
+							ssize_t transferred = send(_client, bytes + written, size - written, MSG_NOSIGNAL);
+							if (transferred < 0 && errno == EINTR)
+								continue;
+							if (transferred <= 0)
+								return false;
+							written += static_cast<size_t>(transferred);
+						}
+
+						return true;
+					}
+
+					virtual bool ReadBytes(char* bytes, size_t size) override
+					{
+						for (size_t read = 0; read < size;)
+						{
+							ssize_t transferred = recv(_client, bytes + read, size - read, 0);
+							if (transferred < 0 && errno == EINTR)
+								continue;
+							if (transferred <= 0)
+								return false;
+							read += static_cast<size_t>(transferred);
+						}
+
+						return true;
+					}
+				#endif
+
+			public:
+				ChannelClient(const std::string& name)
+				{
+					_name = name;
+					#ifdef _WIN32
+						_client = INVALID_HANDLE_VALUE;
+					#else
+						_client = -1;
+					#endif
+				}
+
+				virtual ~ChannelClient()
+				{
+					Close();
+				}
+
+				//Connects to the channel, and keeps trying until the agent has created it
+				virtual bool Accept() override
+				{
+					for (;;)
+					{
+						#ifdef _WIN32
+							_client = CreateFileA(_name.c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, 0, NULL);
+							if (_client != INVALID_HANDLE_VALUE)
+								return true;
+						#else
+							sockaddr_un address = {};
+							int client = socket(AF_UNIX, SOCK_STREAM, 0);
+
+							address.sun_family = AF_UNIX;
+							if (client < 0 || _name.size() >= sizeof(address.sun_path))
+								return false;
+							_name.copy(address.sun_path, _name.size());
+							if (connect(client, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0)
+							{
+								_client = client;
+								return true;
+							}
+							::close(client);
+						#endif
+						std::this_thread::sleep_for(std::chrono::milliseconds(CHANNELBENCHMARK_RETRYMILLISECONDS));
+					}
+				}
+
+				virtual void Disconnect() override
+				{
+					#ifdef _WIN32
+						if (_client != INVALID_HANDLE_VALUE)
+							CloseHandle(_client);
+						_client = INVALID_HANDLE_VALUE;
+					#else
+						if (_client >= 0)
+							::close(_client);
+						_client = -1;
+					#endif
+				}
+
+				virtual void Close() override
+				{
+					Disconnect();
+				}
+
+				//Writes only the header of a frame, such as a length that the other end has to refuse
+				bool WriteHeader(uint32_t size, uint32_t correlation)
+				{
+					char header[FRAME_HEADERSIZE] = { 0 };
+
+					for (size_t index = 0; index < sizeof(uint32_t); index++)
+					{
+						header[index] = static_cast<char>((size >> (index * 8)) & 0xFF);
+						header[sizeof(uint32_t) + index] = static_cast<char>((correlation >> (index * 8)) & 0xFF);
+					}
+
+					return WriteBytes(header, FRAME_HEADERSIZE);
+				}
+
+				virtual bool IsConnected() const override
+				{
+					#ifdef _WIN32
+						return (_client != INVALID_HANDLE_VALUE);
+					#else
+						return (_client >= 0);
+					#endif
+				}
+		};
+	}
+}
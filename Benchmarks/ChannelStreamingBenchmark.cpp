@@ -0,0 +1,150 @@
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include "../Model/Channel.h"
+#include "../Types/Histogram.h"
+#include "ChannelClient.h"
+
+//Pushes large snapshots through the channel at a sustained rate to a stand-in for model service in the same process
+//The stand-in checks every snapshot and replies with its size and checksum, then sends a length that is too large, which the agent has to refuse
+//Usage: ChannelStreamingBenchmark [snapshots] [bytes per snapshot] [snapshots per second, 0 for as fast as possible]
+namespace KoKeKoKo
+{
+	namespace Benchmarks
+	{
+		using namespace Model;
+		//The correlation id of the frame that tells the stand-in to send a length that is too large
+		const uint32_t CHANNELSTREAMINGBENCHMARK_REFUSECORRELATION = 0xFFFFFFFF;
+
+		//Returns the FNV-1a checksum of the bytes taken 8 at a time, so that checking a snapshot takes far less than sending it
+		uint64_t GetChecksum(const std::string& bytes)
+		{
+			uint64_t checksum = 14695981039346656037ULL, word = 0;
+			size_t index = 0;
+
+			for (; (index + sizeof(uint64_t)) <= bytes.size(); index += sizeof(uint64_t))
+			{
+				std::memcpy(&word, bytes.data() + index, sizeof(uint64_t));
+				checksum = (checksum ^ word) * 1099511628211ULL;
+			}
+			for (; index < bytes.size(); index++)
+				checksum = (checksum ^ static_cast<unsigned char>(bytes[index])) * 1099511628211ULL;
+
+			return checksum;
+		}
+
+		//Replies to every snapshot with its size and checksum until the agent disconnects, and returns the number of replies
+		//The payload keeps its capacity between the snapshots, so the stand-in only allocates for the first one
+		uint64_t ReplyToSnapshots(ChannelClient& service)
+		{
+			std::string payload;
+			uint32_t correlation = FRAME_UNCORRELATED;
+			uint64_t replies = 0;
+
+			while (service.ReadFrame(payload, correlation))
+			{
+				if (correlation == CHANNELSTREAMINGBENCHMARK_REFUSECORRELATION)
+				{
+					service.WriteHeader(static_cast<uint32_t>(FRAME_MAXIMUMSIZE + 1), correlation);
+					break;
+				}
+				if (!service.WriteFrame(std::to_string(payload.size()) + " " + std::to_string(GetChecksum(payload)), correlation))
+					break;
+				replies++;
+			}
+
+			return replies;
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace KoKeKoKo;
+	using namespace KoKeKoKo::Model;
+	size_t snapshots = (argc > 1) ? static_cast<size_t>(std::stoull(argv[1])) : 500;
+	size_t size = (argc > 2) ? static_cast<size_t>(std::stoull(argv[2])) : (1024 * 1024);
+	double rate = (argc > 3) ? std::stod(argv[3]) : 0;
+
+	try
+	{
+		Channel* agent = Channel::CreateChannel(Benchmarks::CHANNELBENCHMARK_NAME);
+		Benchmarks::ChannelClient service(Benchmarks::CHANNELBENCHMARK_NAME);
+		uint64_t replies = 0;
+		std::thread standin([&service, &replies]()
+		{
+			if (service.Accept())
+				replies = Benchmarks::ReplyToSnapshots(service);
+		});
+
+		if (!agent->Accept())
+			throw std::runtime_error("Error Occurred! The stand-in for model service has failed to connect...");
+
+		//Every snapshot differs from the one before it, so a snapshot that arrives out of order or mixed with another fails its checksum
+		std::mt19937 random(static_cast<uint32_t>(size));
+		std::string snapshot(size, '\0'), reply;
+		uint32_t correlation = FRAME_UNCORRELATED;
+		Types::Histogram roundtrips;
+		uint64_t late = 0;
+		bool isconsistent = true;
+
+		for (auto& byte : snapshot)
+			byte = static_cast<char>(random());
+		auto start = std::chrono::steady_clock::now(), deadline = start;
+		for (size_t index = 0; index < snapshots; index++)
+		{
+			//A snapshot that has to wait for the reply of the one before it past its time is sent right away
+			if (rate > 0)
+			{
+				auto now = std::chrono::steady_clock::now();
+
+				if (now < deadline)
+					std::this_thread::sleep_until(deadline);
+				else if (index > 0)
+					late++;
+				deadline += std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1 / rate));
+			}
+			if (size > 0)
+				snapshot[index % size] = static_cast<char>(random());
+			std::string expected = std::to_string(size) + " " + std::to_string(Benchmarks::GetChecksum(snapshot));
+
+			auto sent = std::chrono::steady_clock::now();
+			if (!agent->WriteFrame(snapshot, static_cast<uint32_t>(index + 1)) || !agent->ReadFrame(reply, correlation))
+			{
+				isconsistent = false;
+				break;
+			}
+			roundtrips.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - sent).count()));
+			isconsistent = isconsistent && (correlation == (index + 1)) && (reply == expected);
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		//Both ends refuse a frame larger than the maximum, the writer before it writes anything and the reader after the header
+		bool isrefusedtowrite = !agent->WriteFrame(snapshot.data(), FRAME_MAXIMUMSIZE + 1) && (agent->GetFramesRefused() == 1);
+		bool isrefusedtoread = agent->WriteFrame("", 0, Benchmarks::CHANNELSTREAMINGBENCHMARK_REFUSECORRELATION) && !agent->ReadFrame(reply, correlation) && (agent->GetFramesRefused() == 2);
+		agent->Close();
+		standin.join();
+		isconsistent = isconsistent && isrefusedtowrite && isrefusedtoread && (replies == snapshots);
+
+		std::cout << "snapshots=" << snapshots << " bytes_per_snapshot=" << size << " target_snapshots_per_second=" << rate << std::endl;
+		std::cout << "snapshots_per_second=" << (snapshots / seconds) << " megabytes_per_second=" << ((static_cast<double>(snapshots) * size) / (seconds * 1024 * 1024)) << " late_snapshots=" << late << std::endl;
+		std::cout << "roundtrip_milliseconds:";
+		for (const auto& percentile : { 50.0, 90.0, 99.0, 99.9 })
+			std::cout << " p" << percentile << "=" << (roundtrips.GetValueAtPercentile(percentile) / 1000.0);
+		std::cout << " max=" << (roundtrips.GetMaximum() / 1000.0) << " mean=" << (roundtrips.GetMean() / 1000.0) << std::endl;
+		std::cout << "replies=" << replies << " refused_to_write=" << isrefusedtowrite << " refused_to_read=" << isrefusedtoread << std::endl;
+		std::cout << "consistent=" << isconsistent << std::endl;
+		delete agent;
+
+		return isconsistent ? 0 : 1;
+	}
+	catch (const std::exception& exception)
+	{
+		std::cout << exception.what() << std::endl;
+		return 1;
+	}
+}
@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../Agent/MacroPlanner.h"
+#include "Repositories.h"
+
+//Measures the iterations per second per core of the macro planner on states taken from the resources of real games
+//Usage: MacroPlannerBenchmark [Documents/Testing/ResourcesRepository.csv] [milliseconds per decision] [decisions]
+namespace KoKeKoKo
+{
+	namespace Benchmarks
+	{
+		using namespace Agent;
+
+		//Returns a macro state that has the resources of the row, the repository has no structures so they are guessed from the workers and the time
+		MacroState GetMacroState(const ResourcesRow& row)
+		{
+			MacroState state;
+			int bases = std::max(1, (row.workers + 21) / 22);
+			int depots = std::max(0, (row.foodused + 7 - (bases * SUPPLY_PERBASE)) / SUPPLY_PERDEPOT);
+
+			state.SetTime(GetGameSeconds(row.second));
+			state.SetResources(static_cast<float>(row.minerals), static_cast<float>(row.vespene));
+			state.SetSupplyUsed(row.foodused);
+			state.AddUnits(MacroUnit::COMMANDCENTER, bases);
+			state.AddUnits(MacroUnit::SCV, row.workers);
+			state.AddUnits(MacroUnit::SUPPLYDEPOT, depots);
+			if (row.second >= 60)
+				state.AddUnits(MacroUnit::BARRACKS, 1 + row.second / 300);
+			if (row.second >= 120 || row.vespene > 0)
+				state.AddUnits(MacroUnit::REFINERY, std::min(bases * REFINERIES_PERBASE, 1 + row.second / 240));
+			state.AddArmyValue(static_cast<float>(std::max(0, row.foodused - row.workers) * 50));
+
+			return state;
+		}
+
+		//Plans from every state and returns the iterations per second per thread
+		double Run(MacroPlanner& planner, const std::vector<MacroState>& states, std::chrono::milliseconds budget)
+		{
+			Action plan[8];
+			uint64_t iterations = 0;
+			auto start = std::chrono::steady_clock::now();
+
+			for (const auto& state : states)
+			{
+				planner.Plan(state, budget, plan, 8);
+				iterations += planner.GetIterationCount();
+			}
+
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			return (iterations / seconds) / planner.GetThreadCount();
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace KoKeKoKo;
+	std::string path = (argc > 1) ? argv[1] : "Documents/Testing/ResourcesRepository.csv";
+	std::chrono::milliseconds budget((argc > 2) ? std::stoi(argv[2]) : 100);
+	size_t decisions = (argc > 3) ? static_cast<size_t>(std::stoi(argv[3])) : 32;
+	std::vector<Benchmarks::ResourcesRow> rows = Benchmarks::ReadResourcesRepository(path);
+	std::vector<Agent::MacroState> states;
+
+	if (rows.empty())
+	{
+		std::cout << "Error Occurred! Failed to read any resources from " << path << "..." << std::endl;
+		return 1;
+	}
+	//The states are spread over the whole repository, so early and late games are both planned from
+	for (size_t index = 0; index < decisions; index++)
+		states.push_back(Benchmarks::GetMacroState(rows[(index * rows.size()) / decisions]));
+
+	Agent::MacroPlanner single(1, 1);
+	double singlerate = Benchmarks::Run(single, states, budget);
+	std::cout << "threads=1 trees=1 iterations_per_second_per_core=" << singlerate << " nodes=" << single.GetNodeCount() << std::endl;
+
+	Agent::MacroPlanner parallel;
+	double parallelrate = Benchmarks::Run(parallel, states, budget);
+	std::cout << "threads=" << parallel.GetThreadCount() << " trees=" << parallel.GetTreeCount() << " iterations_per_second_per_core=" << parallelrate << " nodes=" << parallel.GetNodeCount() << " steals=" << parallel.GetStealCount() << std::endl;
+
+	Agent::Action plan[8];
+	size_t count = parallel.Plan(Agent::MacroState::CreateGameStart(), budget, plan, 8);
+	std::cout << "plan_from_game_start=";
+	for (size_t index = 0; index < count; index++)
+		std::cout << ((index > 0) ? "," : "") << Agent::ACTION_NAMES[static_cast<size_t>(plan[index])].name;
+	std::cout << std::endl;
+
+	return 0;
+}
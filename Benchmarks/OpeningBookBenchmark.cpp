@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../Agent/Opening.h"
+#include "../Agent/OpeningBook.h"
+#include "../Repository/ColumnarRepository.h"
+
+//Writes the opening book of the commands repository, checks that its most played opening is the generated opening, and measures the lookups of the next actions
+//Usage: OpeningBookBenchmark [Documents/Testing directory] [path of the book] [repetitions]
+namespace KoKeKoKo
+{
+	namespace Benchmarks
+	{
+		//The most played next actions that a lookup asks for
+		const size_t OPENINGBOOK_LOOKUPSUCCESSORS = 4;
+		//The parameters of Opening_Generator.py
+		const uint32_t GENERATOR_MINIMUMGAMES = 16;
+		const size_t GENERATOR_MAXIMUMACTIONS = 24;
+
+		template<typename Function>
+		double GetMilliseconds(Function function)
+		{
+			auto start = std::chrono::steady_clock::now();
+
+			function();
+
+			return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		//Adds the actions from the first node to every leaf of the book, the sequences that the agent could have executed
+		void AddSequences(const Agent::OpeningBook& book, uint32_t node, std::vector<Agent::Action>& sequence, std::vector<std::vector<Agent::Action>>& sequences)
+		{
+			std::vector<Agent::OpeningBookSuccessor> successors(Agent::ACTION_COUNT);
+			size_t count = book.GetSuccessors(node, Agent::OPENINGBOOK_ALLRANKS, successors.data(), successors.size());
+
+			if (count == 0)
+				sequences.push_back(sequence);
+			for (size_t index = 0; index < count; index++)
+			{
+				sequence.push_back(successors[index].action);
+				AddSequences(book, successors[index].node, sequence, sequences);
+				sequence.pop_back();
+			}
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace KoKeKoKo;
+	using namespace KoKeKoKo::Agent;
+	std::string directory = (argc > 1) ? argv[1] : "Documents/Testing";
+	std::string bookpath = (argc > 2) ? argv[2] : "Openings.book";
+	size_t repetitions = (argc > 3) ? static_cast<size_t>(std::stoi(argv[3])) : 5;
+	Repository::CommandsRepository commands;
+	OpeningBook book;
+
+	try
+	{
+		commands.Load(directory + "/CommandsRepository.csv");
+		double write = Benchmarks::GetMilliseconds([&]() { OpeningBook::Write(bookpath, commands); });
+		double open = Benchmarks::GetMilliseconds([&]() { book.Open(bookpath); });
+
+		//The most played opening of every rank, the way Opening_Generator.py builds it
+		std::vector<Action> opening;
+		for (uint32_t node = 0; opening.size() < Benchmarks::GENERATOR_MAXIMUMACTIONS; )
+		{
+			OpeningBookSuccessor successor = {};
+
+			if (book.GetSuccessors(node, OPENINGBOOK_ALLRANKS, &successor, 1) == 0 || successor.games < Benchmarks::GENERATOR_MINIMUMGAMES)
+				break;
+			opening.push_back(successor.action);
+			node = successor.node;
+		}
+		bool isgenerated = (opening.size() == OPENING_ACTIONCOUNT) && std::equal(opening.begin(), opening.end(), OPENING_ACTIONS);
+
+		std::vector<std::vector<Action>> sequences;
+		std::vector<Action> sequence;
+		Benchmarks::AddSequences(book, 0, sequence, sequences);
+
+		//A lookup finds the node of every prefix of every sequence from the first node, and asks for its most played next actions
+		OpeningBookSuccessor successors[Benchmarks::OPENINGBOOK_LOOKUPSUCCESSORS];
+		uint64_t lookups = 0, depths = 0, found = 0;
+		double best = 0;
+		for (size_t repetition = 0; repetition < repetitions; repetition++)
+		{
+			lookups = depths = found = 0;
+			double milliseconds = Benchmarks::GetMilliseconds([&]()
+			{
+				for (const auto& actions : sequences)
+					for (size_t depth = 0; depth <= actions.size(); depth++)
+					{
+						found += book.GetSuccessors(book.Find(actions.data(), depth), static_cast<uint32_t>(lookups % book.GetRankCount()), successors, Benchmarks::OPENINGBOOK_LOOKUPSUCCESSORS);
+						depths += depth;
+						lookups++;
+					}
+			});
+			best = (repetition == 0) ? milliseconds : std::min(best, milliseconds);
+		}
+
+		std::cout << "nodes=" << book.GetNodeCount() << " depth=" << book.GetDepth() << " ranks=" << (book.GetRankCount() - 1) << " openings=" << book.GetGames(0, OPENINGBOOK_ALLRANKS) << " sequences=" << sequences.size() << " matches_generated_opening=" << isgenerated << std::endl;
+		for (uint32_t rank = 1; rank < book.GetRankCount(); rank++)
+		{
+			size_t count = book.GetSuccessors(0, rank, successors, Benchmarks::OPENINGBOOK_LOOKUPSUCCESSORS);
+
+			std::cout << "rank=" << book.GetRankName(rank) << " openings=" << book.GetGames(0, rank) << " first_action=" << ((count > 0) ? GetActionName(successors[0].action) : "") << " first_action_games=" << ((count > 0) ? successors[0].games : 0) << std::endl;
+		}
+		std::cout << "write_milliseconds=" << write << " open_milliseconds=" << open << " lookups=" << lookups << " average_depth=" << (static_cast<double>(depths) / lookups) << " successors=" << found << " nanoseconds_per_lookup=" << ((best * 1000000) / lookups) << std::endl;
+
+		return isgenerated ? 0 : 1;
+	}
+	catch (const std::exception& exception)
+	{
+		std::cout << exception.what() << std::endl;
+		return 1;
+	}
+}
@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#define KOKEKOKO_SIMULATION 1
+#include "../main.cpp"
+#include "../Repository/ColumnarRepository.h"
+#include "../Repository/RepositoryJoin.h"
+#include "../Simulation/ReplaySimulation.h"
+
+//Plays a queue whose first action waits for supply that is not on the way, and the supply depot behind it
+//Returns the game loops until the supply depot was commanded, the first action must not hold it up until it has waited too long
+static uint32_t CheckSupplyBlockedQueue()
+{
+	using namespace KoKeKoKo;
+	using namespace sc2;
+	Simulation::ReplayObservation observation(1);
+	Simulation::ReplayActions actions(observation);
+	Simulation::ReplayActionProvider provider({ { 0, Agent::Action::TRAIN_MARINE }, { 0, Agent::Action::BUILD_SUPPLYDEPOT } });
+	Agent::KoKeKoKoBot bot(&provider);
+	Point2D start(32, 32);
+	uint32_t gameloop = 0;
+	bool iscommanded = false;
+
+	//The command center provides the 15 supply that is already used, so the marine cannot be paid for while the supply depot can
+	observation.SetStartLocation(start);
+	observation.AddUnit(observation.CreateTag(), UNIT_TYPEID::TERRAN_COMMANDCENTER, Unit::Alliance::Self, 1, start, 0, false);
+	observation.AddUnit(observation.CreateTag(), UNIT_TYPEID::TERRAN_BARRACKS, Unit::Alliance::Self, 1, Point2D(start.x + 6, start.y), 0, false);
+	observation.AddUnit(observation.CreateTag(), UNIT_TYPEID::TERRAN_SCV, Unit::Alliance::Self, 1, Point2D(start.x, start.y + 3), 0, false);
+	observation.SetResources(1000, 0, 15, 15);
+	observation.Advance(0);
+	observation.ClearEvents();
+	bot.SetInterfaces(&observation, &actions);
+
+	bot.OnGameStart();
+	actions.SendActions();
+	while (!iscommanded && gameloop < Agent::QUEUED_MAXIMUMWAITLOOPS)
+	{
+		//The replay decides on the snapshots that the thread that sends updates hands to it, so give it time to keep up with the game loops
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		observation.Advance(++gameloop);
+		observation.ClearEvents();
+		bot.OnStep();
+		actions.SendActions();
+		iscommanded = std::any_of(actions.GetCommands().begin(), actions.GetCommands().end(), [](const Simulation::SimulationCommand& command) { return (command.ability == ABILITY_ID::BUILD_SUPPLYDEPOT); });
+	}
+	bot.OnGameEnd();
+
+	if (!iscommanded || bot.GetSkippedActionCount() != 1)
+		throw std::runtime_error("Error Occurred! The supply depot was held up by the marine that waits for supply for " + std::to_string(gameloop) + " game loops...");
+
+	return gameloop;
+}
+
+//Plays the agent through the replays of the repositories without the game, as the first player of every replay, and measures the game loops that it plays per second
+//Usage: ReplaySimulationBenchmark [Documents/Testing directory] [replays] [step size]
+int main(int argc, char* argv[])
+{
+	using namespace KoKeKoKo;
+	std::string directory = (argc > 1) ? argv[1] : "Documents/Testing";
+	size_t replaycount = (argc > 2) ? static_cast<size_t>(std::stoi(argv[2])) : 0;
+	uint32_t stepsize = (argc > 3) ? static_cast<uint32_t>(std::stoi(argv[3])) : 1;
+	Repository::ArmiesRepository armies;
+	Repository::CommandsRepository commands;
+	Repository::ResourcesRepository resources;
+	//The messages of the agent are written into nothing by the logger, so that only what they cost the agent is measured
+	std::ostream discarded(nullptr);
+
+	Types::Logger::Start(discarded);
+	try
+	{
+		uint32_t supplyblockedloops = CheckSupplyBlockedQueue();
+
+		armies.Load(directory + "/ArmiesRepository.csv");
+		commands.Load(directory + "/CommandsRepository.csv");
+		resources.Load(directory + "/ResourcesRepository.csv");
+
+		Repository::RepositoryJoin join(armies, commands, resources);
+		const std::vector<Repository::RepositoryJoinReplay>& replays = join.GetReplays();
+		uint64_t simulated = 0, loops = 0, steps = 0, units = 0, decisions = 0, sent = 0, harvests = 0, unknown = 0;
+		double milliseconds = 0;
+		//How long the actions of every replay took from their snapshots to their commands
+		Agent::DecisionTrace trace;
+
+		if (replaycount == 0 || replaycount > replays.size())
+			replaycount = replays.size();
+		for (size_t replay = 0; replay < replaycount; replay++)
+		{
+			std::vector<uint16_t> players = Simulation::ReplaySimulation::GetPlayers(resources, replays[replay]);
+
+			if (players.empty())
+				continue;
+
+			Simulation::ReplaySimulation simulation(armies, commands, resources, replays[replay], players.front());
+			Simulation::ReplayActionProvider provider(simulation.GetDecisions());
+			Agent::KoKeKoKoBot bot(&provider);
+
+			bot.SetInterfaces(&simulation.GetObservation(), &simulation.GetActions());
+
+			auto start = std::chrono::steady_clock::now();
+			simulation.Run(bot, stepsize);
+			milliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			simulated++;
+			loops += simulation.GetObservation().GetGameLoop();
+			steps += simulation.GetStepCount();
+			units += simulation.GetObservation().GetUnitCount();
+			decisions += simulation.GetDecisions().size();
+			sent += simulation.GetActions().GetCommands().size();
+			harvests += std::count_if(simulation.GetActions().GetCommands().begin(), simulation.GetActions().GetCommands().end(), [](const Simulation::SimulationCommand& command) { return (command.ability == sc2::ABILITY_ID::SMART); });
+			unknown += simulation.GetActions().GetUnknownCommandCount();
+			trace.Add(bot.GetDecisionTrace());
+		}
+
+		std::cout << "replays=" << simulated << " step_size=" << stepsize << " game_loops=" << loops << " steps=" << steps << " units=" << units << " replay_actions=" << decisions << " commands=" << sent << " harvest_commands=" << harvests << " unknown_unit_commands=" << unknown << std::endl;
+		std::cout << "milliseconds=" << milliseconds << " game_loops_per_second=" << static_cast<uint64_t>(loops / (milliseconds / 1000)) << " steps_per_second=" << static_cast<uint64_t>(steps / (milliseconds / 1000)) << std::endl;
+		std::cout << "supply_blocked_queue_loops=" << supplyblockedloops << std::endl;
+		trace.Write(std::cout);
+
+		Types::Logger::Stop();
+		return (simulated > 0) ? 0 : 1;
+	}
+	catch (const std::exception& exception)
+	{
+		Types::Logger::Stop();
+		std::cout << exception.what() << std::endl;
+		return 1;
+	}
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <exception>
+#include <string>
+#include <vector>
+#include "../Agent/Action.h"
+#include "../Repository/ColumnarRepository.h"
+
+namespace KoKeKoKo
+{
+	namespace Benchmarks
+	{
+		//The repositories count the seconds of a replay on the normal game speed, the agent counts them on the faster speed that games are played on
+		const float REPOSITORY_SECONDSPERGAMESECOND = 1.4f;
+
+		//Returns the game time of the agent of a second of the repositories
+		inline float GetGameSeconds(int second)
+		{
+			return static_cast<float>(second) / REPOSITORY_SECONDSPERGAMESECOND;
+		}
+
+		//A row of ResourcesRepository.csv, the second of the game, the player, and what the player had
+		struct ResourcesRow
+		{
+			int second;
+			int player;
+			int minerals;
+			int vespene;
+			int foodused;
+			int workers;
+		};
+
+		//A row of CommandsRepository.csv with a command that the agent knows
+		struct CommandsRow
+		{
+			int second;
+			int player;
+			Agent::Action action;
+		};
+
+		//Returns the rows of the repository, the ranks and the names of the replays are left out
+		inline std::vector<ResourcesRow> ReadResourcesRepository(const std::string& path)
+		{
+			std::vector<ResourcesRow> rows;
+			Repository::ResourcesRepository repository;
+
+			try
+			{
+				repository.Load(path);
+			}
+			catch (const std::exception&)
+			{
+				return rows;
+			}
+
+			const Repository::ResourcesColumns& columns = repository.GetColumns();
+			for (size_t row = 0; row < repository.GetRowCount(); row++)
+				rows.push_back({ static_cast<int>(columns.seconds[row]), columns.players[row], static_cast<int>(columns.minerals[row]), static_cast<int>(columns.vespene[row]), columns.supplies[row], columns.workers[row] });
+
+			return rows;
+		}
+
+		//Returns the rows of the repository in the order of the file, the commands that the agent does not know are left out
+		inline std::vector<CommandsRow> ReadCommandsRepository(const std::string& path)
+		{
+			std::vector<CommandsRow> rows;
+			Repository::CommandsRepository repository;
+
+			try
+			{
+				repository.Load(path);
+			}
+			catch (const std::exception&)
+			{
+				return rows;
+			}
+
+			//The names are looked up once for each entry of the dictionary instead of once for each row
+			const Repository::RepositoryDictionary& commands = repository.GetDictionary(Repository::CommandsColumns::COMMANDS);
+			std::vector<Agent::Action> actions(commands.GetCount(), Agent::Action::NONE);
+			for (size_t index = 1; index < Agent::ACTION_NAMECOUNT; index++)
+			{
+				int32_t command = commands.Find(Agent::ACTION_NAMES[index].name);
+
+				if (command >= 0)
+					actions[command] = Agent::ACTION_NAMES[index].action;
+			}
+
+			const Repository::CommandsColumns& columns = repository.GetColumns();
+			for (size_t row = 0; row < repository.GetRowCount(); row++)
+				if (actions[columns.commands[row]] != Agent::Action::NONE)
+					rows.push_back({ static_cast<int>(columns.seconds[row]), columns.players[row], actions[columns.commands[row]] });
+
+			return rows;
+		}
+	}
+}
@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "../Repository/ColumnarRepository.h"
+#include "../Repository/RepositoryCache.h"
+
+#ifndef _WIN32
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+//Converts the repositories into a cache, checks that the cache has the same contents, and measures opening it against loading the repositories
+//Usage: RepositoryCacheBenchmark [Documents/Testing directory] [path of the cache] [repetitions]
+namespace KoKeKoKo
+{
+	namespace Benchmarks
+	{
+		using namespace Repository;
+
+		const char* REPOSITORY_FILENAMES[] = { "ArmiesRepository.csv", "CommandsRepository.csv", "ResourcesRepository.csv" };
+
+		//Drops the pages of the file from the page cache so the next read comes from the disk, only on Linux
+		bool Evict(const std::string& path)
+		{
+			#ifndef _WIN32
+			int file = open(path.c_str(), O_RDONLY);
+
+			if (file < 0)
+				return false;
+			fdatasync(file);
+			bool isevicted = (posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED) == 0);
+			close(file);
+
+			return isevicted;
+			#else
+			return false;
+			#endif
+		}
+
+		template<typename Function>
+		double GetMilliseconds(Function function)
+		{
+			auto start = std::chrono::steady_clock::now();
+
+			function();
+
+			return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		//Returns true if the cache has the same columns, index and dictionaries as the repository that it was written from
+		template<typename Spans, typename Columns>
+		bool IsSame(const RepositoryCache& cache, CachedRepository repository, Spans cached, const ColumnarRepository<Columns>& loaded)
+		{
+			Spans spans = loaded.GetSpans();
+			bool issame = true;
+
+			cached.ForEachColumn([&spans, &issame](size_t index, auto& column)
+			{
+				spans.ForEachColumn([index, &column, &issame](size_t loadedindex, auto& loadedcolumn)
+				{
+					if (index == loadedindex)
+						issame = issame && (column.GetCount() == loadedcolumn.GetCount()) && (std::memcmp(column.GetData(), loadedcolumn.GetData(), column.GetCount() * sizeof(column[0])) == 0);
+				});
+			});
+			if (cache.GetReplays(repository).GetCount() != loaded.GetReplays().size() || cache.GetRanks(repository).GetCount() != loaded.GetRanks().size())
+				return false;
+			for (size_t replay = 0; replay < loaded.GetReplays().size(); replay++)
+				issame = issame && cache.GetReplayFilename(repository, replay) == loaded.GetReplays()[replay].filename && cache.GetReplays(repository)[replay].firstrow == loaded.GetReplays()[replay].firstrow && cache.GetReplays(repository)[replay].endrow == loaded.GetReplays()[replay].endrow;
+			for (size_t rank = 0; rank < loaded.GetRanks().size(); rank++)
+				issame = issame && cache.GetRankName(repository, rank) == loaded.GetRanks()[rank].name;
+			for (size_t dictionary = 0; dictionary < Columns::DICTIONARYCOUNT; dictionary++)
+				for (size_t name = 0; name < loaded.GetDictionary(dictionary).GetCount(); name++)
+					issame = issame && cache.GetDictionary(repository, dictionary).GetName(static_cast<uint16_t>(name)) == loaded.GetDictionary(dictionary).GetName(static_cast<uint16_t>(name));
+
+			return issame;
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace KoKeKoKo;
+	using namespace KoKeKoKo::Repository;
+	std::string directory = (argc > 1) ? argv[1] : "Documents/Testing";
+	std::string cachepath = (argc > 2) ? argv[2] : "Repositories.cache";
+	size_t repetitions = (argc > 3) ? static_cast<size_t>(std::stoi(argv[3])) : 5;
+	ArmiesRepository armies;
+	CommandsRepository commands;
+	ResourcesRepository resources;
+	RepositoryCache cache;
+
+	try
+	{
+		//Cold is after the files have been dropped from the page cache, warm is the best of the repetitions after it
+		auto loadrepositories = [&]()
+		{
+			armies.Load(directory + "/" + Benchmarks::REPOSITORY_FILENAMES[0]);
+			commands.Load(directory + "/" + Benchmarks::REPOSITORY_FILENAMES[1]);
+			resources.Load(directory + "/" + Benchmarks::REPOSITORY_FILENAMES[2]);
+		};
+		bool isevicted = true;
+		for (const char* filename : Benchmarks::REPOSITORY_FILENAMES)
+			isevicted = Benchmarks::Evict(directory + "/" + filename) && isevicted;
+		double coldcsv = Benchmarks::GetMilliseconds(loadrepositories), warmcsv = coldcsv;
+		for (size_t repetition = 0; repetition < repetitions; repetition++)
+			warmcsv = std::min(warmcsv, Benchmarks::GetMilliseconds(loadrepositories));
+
+		double write = Benchmarks::GetMilliseconds([&]() { RepositoryCache::Write(cachepath, armies, commands, resources); });
+
+		isevicted = Benchmarks::Evict(cachepath) && isevicted;
+		double coldcache = Benchmarks::GetMilliseconds([&]() { cache.Open(cachepath); }), warmcache = coldcache, warmunchecked = coldcache;
+		for (size_t repetition = 0; repetition < repetitions; repetition++)
+		{
+			warmcache = std::min(warmcache, Benchmarks::GetMilliseconds([&]() { cache.Open(cachepath); }));
+			warmunchecked = std::min(warmunchecked, Benchmarks::GetMilliseconds([&]() { cache.Open(cachepath, false); }));
+		}
+
+		bool issame = Benchmarks::IsSame(cache, CachedRepository::Armies, cache.GetArmies(), armies) && Benchmarks::IsSame(cache, CachedRepository::Commands, cache.GetCommands(), commands) && Benchmarks::IsSame(cache, CachedRepository::Resources, cache.GetResources(), resources);
+		std::cout << "rows=" << (armies.GetRowCount() + commands.GetRowCount() + resources.GetRowCount()) << " identical=" << issame << " evicted=" << isevicted << " write_milliseconds=" << write << std::endl;
+		std::cout << "csv_cold_milliseconds=" << coldcsv << " csv_warm_milliseconds=" << warmcsv << " cache_cold_milliseconds=" << coldcache << " cache_warm_milliseconds=" << warmcache << " cache_warm_unchecked_milliseconds=" << warmunchecked << std::endl;
+
+		return issame ? 0 : 1;
+	}
+	catch (const std::exception& exception)
+	{
+		std::cout << exception.what() << std::endl;
+		return 1;
+	}
+}
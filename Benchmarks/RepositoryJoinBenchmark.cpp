@@ -0,0 +1,216 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include "../Repository/ColumnarRepository.h"
+#include "../Repository/RepositoryJoin.h"
+
+//Measures the records per second of the join against relating the commands to the resources the way the model service does, and checks that both relate the same rows
+//Usage: RepositoryJoinBenchmark [Documents/Testing directory] [threads] [repetitions]
+namespace KoKeKoKo
+{
+	namespace Benchmarks
+	{
+		//A command and the second of the sample of the resources that it was related to, by the index of the replay in the resources repository
+		typedef std::tuple<uint32_t, uint32_t, uint32_t, uint32_t> Relation;
+
+		//The lines of every player of every replay, by the rank and the filename of the replay, as the model service reads them
+		typedef std::map<std::string, std::map<std::string, std::vector<std::string>>> ReplayLines;
+
+		std::vector<std::string> Split(const std::string& line)
+		{
+			std::vector<std::string> fields(1);
+
+			for (char character : line)
+			{
+				if (character == ',')
+					fields.emplace_back();
+				else if (character != '\r')
+					fields.back().push_back(character);
+			}
+
+			return fields;
+		}
+
+		//Reads the lines of a repository by replay and player, and the keys of the replays in the order of the file
+		//A replay that was recorded twice under the same rank gets a key for each time, like the join matches them
+		ReplayLines ReadLines(const std::string& path, std::vector<std::string>& keys)
+		{
+			ReplayLines lines;
+			std::ifstream file(path);
+			std::string line, rank, key;
+			std::map<std::string, int> occurrences;
+
+			while (std::getline(file, line))
+			{
+				std::string trimmed = line.substr(0, line.find_last_not_of(",\r ") + 1);
+
+				if (trimmed.empty())
+					continue;
+				if (trimmed[0] >= '0' && trimmed[0] <= '9')
+				{
+					if (!key.empty())
+						lines[key][Split(trimmed)[1]].push_back(trimmed);
+				}
+				else if (trimmed.find(".SC2Replay") != std::string::npos)
+				{
+					key = rank + '\n' + trimmed.substr(0, trimmed.find(".SC2Replay") + 10);
+					key += '\n' + std::to_string(occurrences[key]++);
+					keys.push_back(key);
+				}
+				else if (trimmed != "END")
+					rank = trimmed;
+			}
+
+			return lines;
+		}
+
+		//Relates every command to the first sample of the resources at or after it with the nested scans of RelateMacroToMacro
+		std::vector<Relation> RelateNested(const ReplayLines& commands, const ReplayLines& resources, const std::vector<std::string>& keys, size_t& detailbytes)
+		{
+			std::vector<Relation> relations;
+
+			detailbytes = 0;
+
+			for (uint32_t replay = 0; replay < keys.size(); replay++)
+			{
+				auto replaycommands = commands.find(keys[replay]);
+				auto replayresources = resources.find(keys[replay]);
+
+				if (replaycommands == commands.end() || replayresources == resources.end())
+					continue;
+				for (const auto& player : replaycommands->second)
+				{
+					auto playerresources = replayresources->second.find(player.first);
+
+					if (playerresources == replayresources->second.end())
+						continue;
+					for (const auto& commandline : player.second)
+					{
+						std::vector<std::string> command = Split(commandline);
+						int commandsecond = std::stoi(command[0]);
+
+						for (const auto& resourceline : playerresources->second)
+						{
+							std::vector<std::string> resource = Split(resourceline);
+							int resourcesecond = std::stoi(resource[0]);
+
+							if (commandsecond <= resourcesecond)
+							{
+								std::string details = command[0] + "," + resource[0] + "," + command[1] + "," + command[2] + "," + command[3] + "," + resource[2] + "," + resource[3] + "," + resource[4] + "," + resource[5];
+
+								detailbytes += details.size();
+								relations.emplace_back(replay, static_cast<uint32_t>(std::stoi(command[1])), static_cast<uint32_t>(commandsecond), static_cast<uint32_t>(resourcesecond));
+								break;
+							}
+						}
+					}
+				}
+			}
+
+			return relations;
+		}
+
+		template<typename Function>
+		double GetMilliseconds(Function function, size_t repetitions)
+		{
+			double best = 0;
+
+			for (size_t repetition = 0; repetition < repetitions; repetition++)
+			{
+				auto start = std::chrono::steady_clock::now();
+				function();
+				double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+				best = (repetition == 0) ? milliseconds : std::min(best, milliseconds);
+			}
+
+			return best;
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace KoKeKoKo;
+	using namespace KoKeKoKo::Repository;
+	std::string directory = (argc > 1) ? argv[1] : "Documents/Testing";
+	size_t threads = (argc > 2) ? static_cast<size_t>(std::stoi(argv[2])) : 0;
+	size_t repetitions = (argc > 3) ? static_cast<size_t>(std::stoi(argv[3])) : 5;
+	ArmiesRepository armies;
+	CommandsRepository commands;
+	ResourcesRepository resources;
+
+	try
+	{
+		armies.Load(directory + "/ArmiesRepository.csv");
+		commands.Load(directory + "/CommandsRepository.csv");
+		resources.Load(directory + "/ResourcesRepository.csv");
+
+		RepositoryJoin join(armies, commands, resources);
+		const RepositoryJoinSources& sources = join.GetSources();
+		std::atomic<uint64_t> records(0);
+		auto count = [&records](const RepositoryJoinedRecord&) { records++; };
+		double single = Benchmarks::GetMilliseconds([&]() { records = 0; join.ForEach(count, 1); }, repetitions);
+		double parallel = Benchmarks::GetMilliseconds([&]() { records = 0; join.ForEach(count, threads); }, repetitions);
+
+		//The relations of the commands that the join gives, in the order of the nested scans
+		std::vector<Benchmarks::Relation> joined;
+		std::mutex lock;
+		uint64_t unrelated = 0, outoforder = 0;
+		join.ForEach([&](const RepositoryJoinedRecord& record)
+		{
+			std::lock_guard<std::mutex> guard(lock);
+
+			if (record.kind != RepositoryJoinedRecord::Kind::Command)
+				return;
+			if (record.resourcesrow == REPOSITORYJOIN_NOROW)
+				unrelated++;
+			else
+				joined.emplace_back(record.replay, record.player, record.second, sources.resources.seconds[record.resourcesrow]);
+		}, threads);
+		for (uint32_t replay = 0; replay < join.GetReplays().size(); replay++)
+		{
+			RepositoryJoinCursor cursor(sources, join.GetReplays()[replay], replay);
+			RepositoryJoinedRecord record;
+			std::vector<uint32_t> lastseconds;
+
+			while (cursor.Next(record))
+			{
+				if (record.player >= lastseconds.size())
+					lastseconds.resize(static_cast<size_t>(record.player) + 1, 0);
+				outoforder += (record.second < lastseconds[record.player]) ? 1 : 0;
+				lastseconds[record.player] = record.second;
+			}
+		}
+
+		std::vector<std::string> commandkeys, resourcekeys;
+		Benchmarks::ReplayLines commandlines = Benchmarks::ReadLines(directory + "/CommandsRepository.csv", commandkeys);
+		Benchmarks::ReplayLines resourcelines = Benchmarks::ReadLines(directory + "/ResourcesRepository.csv", resourcekeys);
+		std::vector<Benchmarks::Relation> nested;
+		size_t detailbytes = 0;
+		double nestedmilliseconds = Benchmarks::GetMilliseconds([&]() { nested = Benchmarks::RelateNested(commandlines, resourcelines, resourcekeys, detailbytes); }, repetitions);
+
+		std::sort(joined.begin(), joined.end());
+		std::sort(nested.begin(), nested.end());
+		bool issame = (joined == nested);
+		size_t threadcount = (threads > 0) ? threads : static_cast<size_t>(std::max(1u, std::thread::hardware_concurrency()));
+
+		std::cout << "replays=" << join.GetReplays().size() << " records=" << records << " related_commands=" << joined.size() << " unrelated_commands=" << unrelated << " out_of_order=" << outoforder << " identical=" << issame << std::endl;
+		std::cout << "threads=" << threadcount << " join_single_milliseconds=" << single << " join_milliseconds=" << parallel << " records_per_second=" << static_cast<uint64_t>(records / (parallel / 1000)) << " nested_milliseconds=" << nestedmilliseconds << " nested_detail_bytes=" << detailbytes << std::endl;
+
+		return issame ? 0 : 1;
+	}
+	catch (const std::exception& exception)
+	{
+		std::cout << exception.what() << std::endl;
+		return 1;
+	}
+}
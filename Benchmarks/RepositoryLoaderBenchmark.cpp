@@ -0,0 +1,89 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../Repository/ColumnarRepository.h"
+
+//Measures the milliseconds that the columnar loader takes for each repository, against reading every line and splitting it into strings
+//Usage: RepositoryLoaderBenchmark [Documents/Testing directory] [threads] [repetitions]
+namespace KoKeKoKo
+{
+	namespace Benchmarks
+	{
+		//Reads the repository the way the model service does, every line is split into a list of strings
+		size_t ReadAsStrings(const std::string& path)
+		{
+			std::vector<std::vector<std::string>> lines;
+			std::ifstream file(path);
+			std::string line;
+
+			while (std::getline(file, line))
+			{
+				std::vector<std::string> fields(1);
+
+				for (char character : line)
+				{
+					if (character == ',')
+						fields.emplace_back();
+					else
+						fields.back().push_back(character);
+				}
+				lines.push_back(std::move(fields));
+			}
+
+			return lines.size();
+		}
+
+		//Returns the fewest milliseconds of the repetitions, the first one also maps the file into the page cache
+		template<typename Function>
+		double GetMilliseconds(Function function, size_t repetitions)
+		{
+			double best = 0;
+
+			for (size_t repetition = 0; repetition < repetitions; repetition++)
+			{
+				auto start = std::chrono::steady_clock::now();
+				function();
+				double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+				best = (repetition == 0) ? milliseconds : std::min(best, milliseconds);
+			}
+
+			return best;
+		}
+
+		template<typename RepositoryType>
+		void Run(const std::string& directory, const std::string& name, size_t threads, size_t repetitions)
+		{
+			const std::string path = directory + "/" + name;
+			RepositoryType repository;
+			double columnar = GetMilliseconds([&]() { repository.Load(path, threads); }, repetitions);
+			double strings = GetMilliseconds([&]() { ReadAsStrings(path); }, repetitions);
+
+			std::cout << "repository=" << name << " rows=" << repository.GetRowCount() << " skipped_lines=" << repository.GetSkippedLineCount() << " ranks=" << repository.GetRanks().size() << " replays=" << repository.GetReplays().size() << " chunks=" << repository.GetChunkCount() << " columnar_milliseconds=" << columnar << " strings_milliseconds=" << strings << std::endl;
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace KoKeKoKo;
+	std::string directory = (argc > 1) ? argv[1] : "Documents/Testing";
+	size_t threads = (argc > 2) ? static_cast<size_t>(std::stoi(argv[2])) : 0;
+	size_t repetitions = (argc > 3) ? static_cast<size_t>(std::stoi(argv[3])) : 5;
+
+	try
+	{
+		Benchmarks::Run<Repository::ArmiesRepository>(directory, "ArmiesRepository.csv", threads, repetitions);
+		Benchmarks::Run<Repository::CommandsRepository>(directory, "CommandsRepository.csv", threads, repetitions);
+		Benchmarks::Run<Repository::ResourcesRepository>(directory, "ResourcesRepository.csv", threads, repetitions);
+	}
+	catch (const std::exception& exception)
+	{
+		std::cout << exception.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include "../Agent/SpatialIndex.h"
+
+//Compares the nearest unit queries of SpatialIndex.h with scanning every unit, on 50, 200 and 1000 units of a map
+//The units are either spread over the whole map or gathered around a few bases, like the armies and the workers of a game
+//Usage: SpatialIndexBenchmark [milliseconds per benchmark]
+namespace KoKeKoKo
+{
+	namespace Benchmarks
+	{
+		using namespace KoKeKoKo::Agent;
+		//The repetitions of a benchmark, the fastest one is reported
+		const size_t SPATIALINDEXBENCHMARK_REPETITIONS = 5;
+		//The numbers of units that are compared
+		const size_t SPATIALINDEXBENCHMARK_UNITCOUNTS[] = { 50, 200, 1000 };
+		//The positions that are queried on every repetition
+		const size_t SPATIALINDEXBENCHMARK_QUERIES = 1024;
+		//The size of a side of the map, about the playable area of Bel'Shir Vestige
+		const float SPATIALINDEXBENCHMARK_MAPSIZE = 144.0f;
+		//The bases that the gathered units are around, and how far they are spread from them
+		const size_t SPATIALINDEXBENCHMARK_BASES = 4;
+		const float SPATIALINDEXBENCHMARK_BASESPREAD = 12.0f;
+
+		//Repeats the operations until the time of a repetition is up, and returns the fastest nanoseconds per operation
+		//What the operations return is summed into the checksum, so that none of them can be left out by the compiler
+		template<typename Function>
+		double Measure(size_t operations, double milliseconds, uint64_t& checksum, Function function)
+		{
+			double best = 0;
+
+			for (size_t repetition = 0; repetition < SPATIALINDEXBENCHMARK_REPETITIONS; repetition++)
+			{
+				uint64_t count = 0;
+				double elapsed = 0;
+				auto start = std::chrono::steady_clock::now();
+
+				do
+				{
+					checksum += function();
+					count++;
+					elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+				} while (elapsed < (milliseconds / SPATIALINDEXBENCHMARK_REPETITIONS));
+
+				double nanoseconds = (elapsed * 1000000) / (count * operations);
+				best = (repetition == 0) ? nanoseconds : std::min(best, nanoseconds);
+			}
+
+			return best;
+		}
+
+		//Returns the positions of the units, spread over the map or gathered around the bases
+		std::vector<Point2D> GetPositions(size_t count, bool isgathered, std::mt19937& random)
+		{
+			std::uniform_real_distribution<float> map(0, SPATIALINDEXBENCHMARK_MAPSIZE);
+			std::normal_distribution<float> spread(0, SPATIALINDEXBENCHMARK_BASESPREAD);
+			std::vector<Point2D> bases, positions;
+
+			for (size_t base = 0; base < SPATIALINDEXBENCHMARK_BASES; base++)
+				bases.push_back(Point2D(map(random), map(random)));
+			for (size_t index = 0; index < count; index++)
+			{
+				if (!isgathered)
+					positions.push_back(Point2D(map(random), map(random)));
+				else
+				{
+					const Point2D& base = bases[index % bases.size()];
+
+					positions.push_back(Point2D(std::min(std::max(base.x + spread(random), 0.0f), SPATIALINDEXBENCHMARK_MAPSIZE), std::min(std::max(base.y + spread(random), 0.0f), SPATIALINDEXBENCHMARK_MAPSIZE)));
+				}
+			}
+
+			return positions;
+		}
+
+		//Returns the nearest unit from a position by scanning every unit, the way UnitIndex finds the nearest of a few units
+		const Unit* FindNearestByScan(const std::vector<const Unit*>& units, const std::vector<Point2D>& positions, const Point2D& position)
+		{
+			const Unit* nearest = nullptr;
+			float distance = std::numeric_limits<float>::max();
+
+			for (size_t index = 0; index < positions.size(); index++)
+			{
+				float dx = (positions[index].x - position.x), dy = (positions[index].y - position.y), temporary_distance = ((dx * dx) + (dy * dy));
+				if (temporary_distance < distance)
+				{
+					distance = temporary_distance;
+					nearest = units[index];
+				}
+			}
+
+			return nearest;
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace KoKeKoKo;
+	using namespace KoKeKoKo::Agent;
+	double milliseconds = (argc > 1) ? std::stod(argv[1]) : 500;
+	bool isconsistent = true;
+
+	try
+	{
+		for (const auto& isgathered : { false, true })
+		{
+			for (const auto& unitcount : Benchmarks::SPATIALINDEXBENCHMARK_UNITCOUNTS)
+			{
+				std::mt19937 random(static_cast<uint32_t>(unitcount));
+				std::vector<Point2D> positions = Benchmarks::GetPositions(unitcount, isgathered, random);
+				std::vector<Point2D> queries = Benchmarks::GetPositions(Benchmarks::SPATIALINDEXBENCHMARK_QUERIES, false, random);
+				std::vector<Unit> storage(unitcount);
+				std::vector<const Unit*> units;
+				SpatialIndex index;
+				uint64_t checksum = 0;
+
+				for (size_t unit = 0; unit < unitcount; unit++)
+				{
+					storage[unit].tag = unit + 1;
+					storage[unit].pos = Point3D(positions[unit].x, positions[unit].y, 0);
+					units.push_back(&storage[unit]);
+				}
+				index.Build(units.data(), positions.data(), units.size());
+
+				//Both have to find a unit that is as near as the nearest one, units at the same distance may differ
+				for (const auto& query : queries)
+				{
+					const Unit* scanned = Benchmarks::FindNearestByScan(units, positions, query);
+					const Unit* indexed = index.FindNearestOf(query);
+
+					if (indexed == nullptr || DistanceSquared2D(indexed->pos, query) != DistanceSquared2D(scanned->pos, query))
+						isconsistent = false;
+				}
+
+				//The index is built again on every game loop that the agent queries it, so its build counts against the queries
+				double build = Benchmarks::Measure(1, milliseconds, checksum, [&]()
+				{
+					index.Build(units.data(), positions.data(), units.size());
+					return static_cast<uint64_t>(index.GetUnitCount());
+				});
+				double scan = Benchmarks::Measure(queries.size(), milliseconds, checksum, [&]()
+				{
+					uint64_t found = 0;
+
+					for (const auto& query : queries)
+						found += Benchmarks::FindNearestByScan(units, positions, query)->tag;
+					return found;
+				});
+				double indexed = Benchmarks::Measure(queries.size(), milliseconds, checksum, [&]()
+				{
+					uint64_t found = 0;
+
+					for (const auto& query : queries)
+						found += index.FindNearestOf(query)->tag;
+					return found;
+				});
+
+				std::cout << "units=" << unitcount << " layout=" << (isgathered ? "bases" : "uniform") << " scans_every_unit=" << (unitcount <= SPATIALINDEX_SCANUNITS) << " build_nanoseconds=" << build << " scan_nanoseconds_per_query=" << scan << " index_nanoseconds_per_query=" << indexed << " speedup=" << (scan / indexed);
+				if (scan > indexed)
+					std::cout << " queries_to_pay_for_build=" << static_cast<uint64_t>(std::ceil(build / (scan - indexed)));
+				std::cout << " checksum=" << checksum << std::endl;
+			}
+		}
+		std::cout << "consistent=" << isconsistent << std::endl;
+
+		return isconsistent ? 0 : 1;
+	}
+	catch (const std::exception& exception)
+	{
+		std::cout << exception.what() << std::endl;
+		return 1;
+	}
+}
@@ -0,0 +1,82 @@
+import csv, os, re
+from collections import Counter
+
+
+# Generates Agent/Opening.h, the build order that the agent follows until model service has sent its first actions
+# Usage: python Documents/Scripts/Opening_Generator.py
+root_directory = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..'))
+commands_repository = os.path.join(root_directory, 'Documents', 'Testing', 'CommandsRepository.csv')
+actions_header = os.path.join(root_directory, 'Agent', 'Action.h')
+opening_header = os.path.join(root_directory, 'Agent', 'Opening.h')
+
+# Only the commands within the first minutes of a game are part of an opening
+opening_seconds = 300
+# The opening stops when fewer games than this have followed it so far
+minimum_games = 16
+# The opening never has more actions than this
+maximum_actions = 24
+
+
+# Returns the names that the agent knows where key is the name, and value is the action that it maps to
+def read_action_names():
+    with open(actions_header, encoding='utf-8') as f:
+        return dict(re.findall(r'\{ "([^"]+)", Action::(\w+) \}', f.read()))
+
+
+# Returns the commands of each player in each game, in the order that they were given
+def read_openings(action_names):
+    openings = {}
+
+    with open(commands_repository, encoding='utf-8', errors='replace') as f:
+        for row in csv.reader(f):
+            # The rows without a time are the ranks and the replay names
+            if len(row) < 3 or not row[0].isdigit() or int(row[0]) > opening_seconds:
+                continue
+            # The commands that the agent cannot execute are left out
+            if row[2] in action_names:
+                openings.setdefault(row[1], []).append((int(row[0]), action_names[row[2]]))
+
+    return [[action for second, action in sorted(commands, key=lambda command: command[0])] for commands in openings.values()]
+
+
+# Builds the opening one action at a time, each action is the most common next action among the games that have followed it so far
+def build_opening(openings):
+    opening = []
+    followers = openings
+
+    while len(opening) < maximum_actions:
+        next_actions = Counter(commands[len(opening)] for commands in followers if len(commands) > len(opening))
+        if not next_actions:
+            break
+
+        action, games = next_actions.most_common(1)[0]
+        if games < minimum_games:
+            break
+
+        opening.append((action, games))
+        followers = [commands for commands in followers if len(commands) > len(opening) - 1 and commands[len(opening) - 1] == action]
+
+    return opening
+
+
+def write_opening(opening, total_games):
+    with open(opening_header, 'w', encoding='utf-8', newline='\n') as f:
+        f.write('#pragma once\n\n')
+        f.write('#include "Action.h"\n\n')
+        f.write('//Generated by Documents/Scripts/Opening_Generator.py from Documents/Testing/CommandsRepository.csv, do not edit\n')
+        f.write('namespace KoKeKoKo\n{\n\tnamespace Agent\n\t{\n')
+        f.write('\t\t//The build order that the agent follows until model service has sent its first actions\n')
+        f.write('\t\t//Each action is the most common next action of the {0} openings that have been recorded, among the ones that have followed it so far\n'.format(total_games))
+        f.write('\t\tconstexpr Action OPENING_ACTIONS[] =\n\t\t{\n')
+        for index, (action, games) in enumerate(opening):
+            f.write('\t\t\tAction::{0}{1} //{2} games\n'.format(action, ',' if index < len(opening) - 1 else '', games))
+        f.write('\t\t};\n\n')
+        f.write('\t\t//The number of actions in the opening\n')
+        f.write('\t\tconst size_t OPENING_ACTIONCOUNT = sizeof(OPENING_ACTIONS) / sizeof(OPENING_ACTIONS[0]);\n')
+        f.write('\t}\n}\n')
+
+
+openings = read_openings(read_action_names())
+opening = build_opening(openings)
+write_opening(opening, len(openings))
+print('Wrote {0} actions from {1} openings to {2}'.format(len(opening), len(openings), opening_header))
@@ -0,0 +1,466 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+	#include <Windows.h>
+#else
+	#include <cerrno>
+	#include <sys/socket.h>
+	#include <sys/un.h>
+	#include <unistd.h>
+#endif
+
+namespace KoKeKoKo
+{
+	namespace Model
+	{
+		using namespace std;
+		//The name of the duplex channel between agent and model
+		#ifdef _WIN32
+			const string CHANNEL_NAME = "\\\\.\\pipe\\KoKeKoKo";
+			//The prefix of a named pipe, the environment variable below only names the pipe itself
+			const string CHANNEL_PIPEPREFIX = "\\\\.\\pipe\\";
+		#else
+			//The unix domain socket that model service connects to, it does not rely on how a runtime maps the names of its pipes
+			const string CHANNEL_NAME = "/tmp/KoKeKoKo.sock";
+		#endif
+		//The environment variable that overrides the name of the channel, model service reads the same one
+		//It holds the name of the pipe on Windows and the path of the socket elsewhere
+		const char* const CHANNEL_ENVIRONMENTVARIABLE = "KOKEKOKO_CHANNEL";
+		//The size of the frame header that holds the length of the payload and the correlation id
+		const size_t FRAME_HEADERSIZE = sizeof(uint32_t) * 2;
+		//The correlation id of a frame that is not a request nor a reply to a request
+		const uint32_t FRAME_UNCORRELATED = 0;
+		//The largest payload of a frame, a larger length means that the connection cannot be trusted anymore
+		const size_t FRAME_MAXIMUMSIZE = 64 * 1024 * 1024;
+		//The number of bytes of a payload that are read at a time, so a frame is only allocated as its bytes arrive
+		const size_t FRAME_CHUNKSIZE = 64 * 1024;
+
+		//Returns the name of the channel from the environment variable, or the default name when it is not set
+		inline string GetChannelName()
+		{
+			#ifdef _WIN32
+				char name[MAX_PATH] = { 0 };
+				DWORD size = GetEnvironmentVariableA(CHANNEL_ENVIRONMENTVARIABLE, name, MAX_PATH);
+
+				return ((size > 0 && size < MAX_PATH) ? (CHANNEL_PIPEPREFIX + name) : CHANNEL_NAME);
+			#else
+				const char* name = getenv(CHANNEL_ENVIRONMENTVARIABLE);
+
+				return (((name != nullptr) && (*name != '\0')) ? string(name) : CHANNEL_NAME);
+			#endif
+		}
+
+		//A long-lived duplex connection to model service that exchanges length-prefixed frames
+		class Channel
+		{
+			private:
+				//Lock for writing frames, so that frames from different threads do not interleave
+				mutex _writelock;
+				//The number of frames that has been written
+				atomic<uint64_t> _frameswritten;
+				//The number of frames that has been read
+				atomic<uint64_t> _framesread;
+				//The number of frames that has been refused for being larger than the maximum size
+				atomic<uint64_t> _framesrefused;
+
+				Channel(const Channel&);
+				Channel& operator=(const Channel&);
+
+			protected:
+				//Writes all bytes to the connection and returns true if successfully written
+				virtual bool WriteBytes(const char* bytes, size_t size) = 0;
+				//Reads exactly the size of bytes from the connection and returns true if successfully read
+				virtual bool ReadBytes(char* bytes, size_t size) = 0;
+
+			public:
+				Channel()
+				{
+					_frameswritten = 0;
+					_framesread = 0;
+					_framesrefused = 0;
+				}
+
+				virtual ~Channel() {}
+
+				//Creates the server if needed and waits for model service to connect
+				virtual bool Accept() = 0;
+				//Disconnects model service but keeps the server for the next connection
+				virtual void Disconnect() = 0;
+				//Cancels any blocking accept, read or write and releases the server
+				virtual void Close() = 0;
+				//Returns true if model service is connected
+				virtual bool IsConnected() const = 0;
+
+				//Writes a single frame of any size up to the maximum and returns true if successfully written
+				bool WriteFrame(const char* payload, size_t size, uint32_t correlation = FRAME_UNCORRELATED)
+				{
+					char header[FRAME_HEADERSIZE] = { 0 };
+
+					if (size > FRAME_MAXIMUMSIZE)
+					{
+						_framesrefused++;
+						return false;
+					}
+
+					//The length and the correlation id are always little-endian regardless of the platform
+					for (size_t index = 0; index < sizeof(uint32_t); index++)
+					{
+						header[index] = static_cast<char>((size >> (index * 8)) & 0xFF);
+						header[sizeof(uint32_t) + index] = static_cast<char>((correlation >> (index * 8)) & 0xFF);
+					}
+
+					lock_guard<mutex> lock(_writelock);
+					if (!WriteBytes(header, FRAME_HEADERSIZE) || !WriteBytes(payload, size))
+						return false;
+
+					_frameswritten++;
+					return true;
+				}
+
+				//Writes a single frame and returns true if successfully written
+				bool WriteFrame(const string& payload, uint32_t correlation = FRAME_UNCORRELATED)
+				{
+					return WriteFrame(payload.data(), payload.size(), correlation);
+				}
+
+				//Blocks until a whole frame has been read and returns true if successfully read
+				//The payload is reassembled chunk by chunk into the given string, which keeps its capacity if it is reused for the next frame
+				bool ReadFrame(string& payload, uint32_t& correlation)
+				{
+					unsigned char header[FRAME_HEADERSIZE] = { 0 };
+					size_t size = 0;
+
+					if (!ReadBytes(reinterpret_cast<char*>(header), FRAME_HEADERSIZE))
+						return false;
+					correlation = 0;
+					for (size_t index = 0; index < sizeof(uint32_t); index++)
+					{
+						size |= (static_cast<size_t>(header[index]) << (index * 8));
+						correlation |= (static_cast<uint32_t>(header[sizeof(uint32_t) + index]) << (index * 8));
+					}
+
+					//The rest of the stream cannot be found after a length that is too large, so the connection has to be dropped
+					if (size > FRAME_MAXIMUMSIZE)
+					{
+						_framesrefused++;
+						return false;
+					}
+
+					payload.clear();
+					for (size_t read = 0; read < size;)
+					{
+						size_t chunk = ((size - read) < FRAME_CHUNKSIZE) ? (size - read) : FRAME_CHUNKSIZE;
+
+						payload.resize(read + chunk);
+						if (!ReadBytes(&payload[read], chunk))
+							return false;
+						read += chunk;
+					}
+
+					_framesread++;
+					return true;
+				}
+
+				uint64_t GetFramesWritten() const
+				{
+					return _frameswritten;
+				}
+
+				uint64_t GetFramesRead() const
+				{
+					return _framesread;
+				}
+
+				uint64_t GetFramesRefused() const
+				{
+					return _framesrefused;
+				}
+
+				//Creates the channel backend of the current platform
+				static Channel* CreateChannel(const string& name = GetChannelName());
+		};
+
+		#ifdef _WIN32
+			//A channel that uses an overlapped named pipe, so that reading and writing do not block each other
+			class NamedPipeChannel : public Channel
+			{
+				private:
+					//The name of the named pipe
+					string _name;
+					//The server end of the named pipe
+					HANDLE _server;
+					//Signalled when an overlapped read or connection has finished
+					HANDLE _readevent;
+					//Signalled when an overlapped write has finished
+					HANDLE _writeevent;
+					//If model service is connected
+					atomic<bool> _isconnected;
+					//If the channel has been closed
+					atomic<bool> _isclosed;
+
+					//Waits for an overlapped operation to finish and returns the transferred bytes
+					bool WaitForOverlapped(BOOL result, OVERLAPPED& overlapped, DWORD& transferred)
+					{
+						if (!result && GetLastError() != ERROR_IO_PENDING)
+							return false;
+
+						return (GetOverlappedResult(_server, &overlapped, &transferred, TRUE) != FALSE);
+					}
+
+				protected:
+					virtual bool WriteBytes(const char* bytes, size_t size) override
+					{
+						for (size_t written = 0; written < size;)
+						{
+							OVERLAPPED overlapped = { 0 };
+							DWORD transferred = 0;
+
+							overlapped.hEvent = _writeevent;
+							if (!WaitForOverlapped(WriteFile(_server, bytes + written, static_cast<DWORD>(size - written), NULL, &overlapped), overlapped, transferred))
+							{
+								_isconnected = false;
+								return false;
+							}
+							written += transferred;
+						}
+
+						return true;
+					}
+
+					virtual bool ReadBytes(char* bytes, size_t size) override
+					{
+						for (size_t read = 0; read < size;)
+						{
+							OVERLAPPED overlapped = { 0 };
+							DWORD transferred = 0;
+
+							overlapped.hEvent = _readevent;
+							if (!WaitForOverlapped(ReadFile(_server, bytes + read, static_cast<DWORD>(size - read), NULL, &overlapped), overlapped, transferred) || transferred == 0)
+							{
+								_isconnected = false;
+								return false;
+							}
+							read += transferred;
+						}
+
+						return true;
+					}
+
+				public:
+					NamedPipeChannel(const string& name)
+					{
+						_name = name;
+						_server = INVALID_HANDLE_VALUE;
+						_readevent = CreateEventA(NULL, TRUE, FALSE, NULL);
+						_writeevent = CreateEventA(NULL, TRUE, FALSE, NULL);
+						_isconnected = false;
+						_isclosed = false;
+					}
+
+					virtual ~NamedPipeChannel()
+					{
+						Close();
+						CloseHandle(_readevent);
+						CloseHandle(_writeevent);
+					}
+
+					virtual bool Accept() override
+					{
+						OVERLAPPED overlapped = { 0 };
+						DWORD transferred = 0;
+
+						if (_isclosed)
+							return false;
+
+						if (_server == INVALID_HANDLE_VALUE)
+						{
+							_server = CreateNamedPipeA(_name.c_str(), PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED, PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT, 1, 65536, 65536, 0, NULL);
+							if (_server == INVALID_HANDLE_VALUE)
+								throw runtime_error(("Error Occurred! Failed to create a server for model service with an exit code of " + to_string(GetLastError()) + "...").c_str());
+						}
+
+						//Wait for model service to connect, it may have connected before we started waiting
+						overlapped.hEvent = _readevent;
+						if (!ConnectNamedPipe(_server, &overlapped))
+						{
+							if (GetLastError() == ERROR_PIPE_CONNECTED)
+								_isconnected = true;
+							else if (GetLastError() == ERROR_IO_PENDING)
+								_isconnected = (GetOverlappedResult(_server, &overlapped, &transferred, TRUE) != FALSE);
+						}
+						else
+							_isconnected = true;
+
+						return _isconnected;
+					}
+
+					virtual void Disconnect() override
+					{
+						_isconnected = false;
+						if (_server != INVALID_HANDLE_VALUE)
+							DisconnectNamedPipe(_server);
+					}
+
+					virtual void Close() override
+					{
+						_isclosed = true;
+						_isconnected = false;
+						if (_server != INVALID_HANDLE_VALUE)
+						{
+							CancelIoEx(_server, NULL);
+							DisconnectNamedPipe(_server);
+							CloseHandle(_server);
+							_server = INVALID_HANDLE_VALUE;
+						}
+					}
+
+					virtual bool IsConnected() const override
+					{
+						return _isconnected;
+					}
+			};
+
+			inline Channel* Channel::CreateChannel(const string& name)
+			{
+				return new NamedPipeChannel(name);
+			}
+		#else
+			//A channel that uses a unix domain socket
+			class UnixSocketChannel : public Channel
+			{
+				private:
+					//The path of the unix domain socket
+					string _path;
+					//The listening socket
+					atomic<int> _server;
+					//The socket of the connected model service
+					atomic<int> _client;
+					//If the channel has been closed
+					atomic<bool> _isclosed;
+
+				protected:
+					virtual bool WriteBytes(const char* bytes, size_t size) override
+					{
+						for (size_t written = 0; written < size;)
+						{
+							ssize_t transferred = send(_client, bytes + written, size - written, MSG_NOSIGNAL);
+							if (transferred < 0 && errno == EINTR)
+								continue;
+							if (transferred <= 0)
+								return false;
+							written += static_cast<size_t>(transferred);
+						}
+
+						return true;
+					}
+
+					virtual bool ReadBytes(char* bytes, size_t size) override
+					{
+						for (size_t read = 0; read < size;)
+						{
+							ssize_t transferred = recv(_client, bytes + read, size - read, 0);
+							if (transferred < 0 && errno == EINTR)
+								continue;
+							if (transferred <= 0)
+								return false;
+							read += static_cast<size_t>(transferred);
+						}
+
+						return true;
+					}
+
+				public:
+					UnixSocketChannel(const string& path)
+					{
+						_path = path;
+						_server = -1;
+						_client = -1;
+						_isclosed = false;
+					}
+
+					virtual ~UnixSocketChannel()
+					{
+						Close();
+					}
+
+					virtual bool Accept() override
+					{
+						if (_isclosed)
+							return false;
+
+						if (_server < 0)
+						{
+							sockaddr_un address = {};
+							int server = socket(AF_UNIX, SOCK_STREAM, 0);
+
+							address.sun_family = AF_UNIX;
+							if (server < 0 || _path.size() >= sizeof(address.sun_path))
+								throw runtime_error(("Error Occurred! Failed to create a server for model service with an exit code of " + to_string(errno) + "...").c_str());
+							_path.copy(address.sun_path, _path.size());
+
+							unlink(_path.c_str());
+							if (bind(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(server, 1) != 0)
+							{
+								::close(server);
+								throw runtime_error(("Error Occurred! Failed to bind a server for model service with an exit code of " + to_string(errno) + "...").c_str());
+							}
+							_server = server;
+						}
+
+						Disconnect();
+						for (int client = -1; client < 0;)
+						{
+							client = accept(_server, NULL, NULL);
+							if (client < 0 && errno != EINTR)
+								return false;
+							_client = client;
+						}
+
+						return true;
+					}
+
+					virtual void Disconnect() override
+					{
+						int client = _client.exchange(-1);
+						if (client >= 0)
+						{
+							shutdown(client, SHUT_RDWR);
+							::close(client);
+						}
+					}
+
+					virtual void Close() override
+					{
+						_isclosed = true;
+						Disconnect();
+
+						//Shutting down the listening socket wakes up a blocking accept
+						int server = _server.exchange(-1);
+						if (server >= 0)
+						{
+							shutdown(server, SHUT_RDWR);
+							::close(server);
+							unlink(_path.c_str());
+						}
+					}
+
+					virtual bool IsConnected() const override
+					{
+						return (_client >= 0);
+					}
+			};
+
+			inline Channel* Channel::CreateChannel(const string& name)
+			{
+				return new UnixSocketChannel(name);
+			}
+		#endif
+	}
+}
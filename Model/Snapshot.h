@@ -0,0 +1,411 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace KoKeKoKo
+{
+	namespace Model
+	{
+		using namespace std;
+		//The formats of the snapshot that can be sent to model service
+		enum class SnapshotFormat
+		{
+			//The legacy "Macromanagement:" text message
+			Text,
+			//The versioned binary snapshot described by SnapshotHeader and SnapshotUnit
+			Binary,
+			//The binary snapshot that only has the added, moved and removed units since the last snapshot
+			BinaryDelta
+		};
+
+		//The first 4 bytes of a binary snapshot, "KKKS" in little-endian
+		const uint32_t SNAPSHOT_MAGIC = 0x534B4B4B;
+		//The version of the binary snapshot, increase it when the layout changes
+		const uint16_t SNAPSHOT_VERSION = 2;
+		//The number of 64-bit words in the upgrade bitset
+		const size_t SNAPSHOT_UPGRADEWORDS = 8;
+		//The number of upgrade ids that can be stored in the upgrade bitset
+		const size_t SNAPSHOT_MAXUPGRADES = SNAPSHOT_UPGRADEWORDS * 64;
+		//The snapshot has every living unit, the receiver replaces its units with the snapshot
+		const uint16_t SNAPSHOT_KEYFRAME = 0x1;
+		//The snapshot only has the added and moved units and the tags of removed units
+		const uint16_t SNAPSHOT_DELTA = 0x2;
+		//The number of delta snapshots between two keyframes
+		const uint32_t SNAPSHOT_KEYFRAMEINTERVAL = 6;
+		//The distance that a unit has to move before it is sent again in a delta snapshot
+		const float SNAPSHOT_POSITIONEPSILON = 0.5f;
+
+		//The sections of units in a binary snapshot, units are written section by section
+		//The enemy section only holds Unit::Alliance::Enemy units, so a unit does not carry its alliance
+		enum class SnapshotSection : uint8_t
+		{
+			Self,
+			Enemy
+		};
+
+		#pragma pack(push, 1)
+		//The fixed-width header of a binary snapshot, all fields are little-endian
+		struct SnapshotHeader
+		{
+			uint32_t magic;
+			uint16_t version;
+			uint16_t flags;
+			uint32_t gameloop;
+			uint32_t playerid;
+			int32_t minerals;
+			int32_t vespene;
+			int32_t supply;
+			int32_t workers;
+			uint64_t upgrades[SNAPSHOT_UPGRADEWORDS];
+			uint32_t selfcount;
+			uint32_t enemycount;
+			uint32_t removedcount;
+		};
+
+		//A packed record of a unit in a binary snapshot
+		struct SnapshotUnit
+		{
+			uint32_t type;
+			uint64_t tag;
+			float x;
+			float y;
+		};
+		#pragma pack(pop)
+
+		static_assert(sizeof(SnapshotHeader) == 108, "The snapshot header must not have padding");
+		static_assert(sizeof(SnapshotUnit) == 20, "The snapshot unit must not have padding");
+
+		//Returns the number of bytes needed for a binary snapshot with the number of units and removed units
+		inline size_t GetSnapshotSize(size_t units, size_t removedunits = 0)
+		{
+			return (sizeof(SnapshotHeader) + (units * sizeof(SnapshotUnit)) + (removedunits * sizeof(uint64_t)));
+		}
+
+		//Writes a binary snapshot into a caller-provided buffer without allocating
+		class SnapshotWriter
+		{
+			private:
+				//The buffer where the snapshot is written
+				char* _buffer;
+				//The size of the buffer
+				size_t _capacity;
+				//The number of bytes that has been written
+				size_t _size;
+				//The header that is copied to the buffer when the snapshot ends
+				SnapshotHeader _header;
+
+			public:
+				SnapshotWriter(char* buffer, size_t capacity)
+				{
+					_buffer = buffer;
+					_capacity = capacity;
+					_size = 0;
+					memset(&_header, 0, sizeof(_header));
+				}
+
+				//Starts a new snapshot and returns false if the buffer cannot hold the header
+				bool Begin(uint32_t gameloop, uint32_t playerid, int32_t minerals, int32_t vespene, int32_t supply, int32_t workers)
+				{
+					if (_capacity < sizeof(SnapshotHeader))
+						return false;
+
+					memset(&_header, 0, sizeof(_header));
+					_header.magic = SNAPSHOT_MAGIC;
+					_header.version = SNAPSHOT_VERSION;
+					_header.flags = SNAPSHOT_KEYFRAME;
+					_header.gameloop = gameloop;
+					_header.playerid = playerid;
+					_header.minerals = minerals;
+					_header.vespene = vespene;
+					_header.supply = supply;
+					_header.workers = workers;
+					_size = sizeof(SnapshotHeader);
+					return true;
+				}
+
+				//Marks an upgrade as researched, upgrades beyond the bitset are ignored
+				void AddUpgrade(uint32_t upgrade)
+				{
+					if (upgrade < SNAPSHOT_MAXUPGRADES)
+						_header.upgrades[upgrade / 64] |= (uint64_t(1) << (upgrade % 64));
+				}
+
+				//Appends a unit to a section and returns false if the buffer is full or the section is out of order
+				bool AddUnit(SnapshotSection section, uint32_t type, uint64_t tag, float x, float y)
+				{
+					SnapshotUnit unit;
+
+					if ((_size + sizeof(SnapshotUnit)) > _capacity)
+						return false;
+					if ((section == SnapshotSection::Self && _header.enemycount > 0) || _header.removedcount > 0)
+						return false;
+
+					unit.type = type;
+					unit.tag = tag;
+					unit.x = x;
+					unit.y = y;
+					memcpy(_buffer + _size, &unit, sizeof(unit));
+					_size += sizeof(unit);
+
+					if (section == SnapshotSection::Self)
+						_header.selfcount++;
+					else
+						_header.enemycount++;
+					return true;
+				}
+
+				//Appends the tag of a unit that no longer exists, removed units are written after every other unit
+				bool AddRemovedUnit(uint64_t tag)
+				{
+					if ((_size + sizeof(tag)) > _capacity)
+						return false;
+
+					memcpy(_buffer + _size, &tag, sizeof(tag));
+					_size += sizeof(tag);
+					_header.removedcount++;
+					return true;
+				}
+
+				void SetFlags(uint16_t flags)
+				{
+					_header.flags = flags;
+				}
+
+				//Finishes the snapshot and returns the number of bytes written
+				size_t End()
+				{
+					memcpy(_buffer, &_header, sizeof(_header));
+					return _size;
+				}
+
+				size_t GetSize() const
+				{
+					return _size;
+				}
+		};
+
+		//The number of slots that the table of sent units starts with, a power of two
+		const size_t SNAPSHOT_SENTUNITSLOTS = 256;
+
+		//Keeps the last sent units keyed by tag and only writes the units that changed since then
+		//The sent units are kept in an open addressing table that is reused from snapshot to snapshot, it only allocates when the armies outgrow it
+		class SnapshotDeltaEncoder
+		{
+			private:
+				//The unit that has been sent, and the snapshot where it was last seen
+				//A slot of an older epoch is empty, so a keyframe forgets every unit by starting a new epoch instead of clearing the slots
+				struct SentUnit
+				{
+					SnapshotUnit unit;
+					SnapshotSection section;
+					//The unit has been removed, the slot is skipped by the lookups until the next epoch
+					bool isremoved;
+					uint32_t generation;
+					uint32_t epoch;
+				};
+
+				//The slots of the last sent units, probed linearly from the hash of the tag
+				vector<SentUnit> _sentunits;
+				//The slots of the current epoch that hold a unit, and the ones that hold a unit or a removed unit
+				size_t _sentunitcount;
+				size_t _usedslots;
+				//The current epoch of the slots, started again by every keyframe
+				uint32_t _epoch;
+				//The number of snapshots that has been encoded, used to find the removed units
+				uint32_t _generation;
+				//The number of delta snapshots since the last keyframe
+				uint32_t _deltas;
+				//The number of delta snapshots between two keyframes
+				uint32_t _keyframeinterval;
+				//The squared distance that a unit has to move before it is sent again
+				float _positionepsilonsquared;
+				//If the current snapshot is a keyframe
+				bool _iskeyframe;
+
+				//Returns the first slot of the tag, the tags of the game are spread over the table by a Fibonacci hash
+				size_t GetSlot(uint64_t tag) const
+				{
+					return static_cast<size_t>((tag * 0x9E3779B97F4A7C15ULL) >> 32) & (_sentunits.size() - 1);
+				}
+
+				//Forgets every sent unit by starting a new epoch, the slots are only cleared when the epochs run out
+				void Forget()
+				{
+					if (++_epoch == 0)
+					{
+						for (auto& sentunit : _sentunits)
+							sentunit.epoch = 0;
+						_epoch = 1;
+					}
+					_sentunitcount = 0;
+					_usedslots = 0;
+				}
+
+				//Moves the units of the current epoch into a table of the given number of slots, which drops the removed units
+				void Rehash(size_t slots)
+				{
+					vector<SentUnit> sentunits(slots);
+
+					sentunits.swap(_sentunits);
+					_sentunitcount = 0;
+					_usedslots = 0;
+					for (const auto& sentunit : sentunits)
+					{
+						if (sentunit.epoch == _epoch && !sentunit.isremoved)
+						{
+							SentUnit& slot = Find(sentunit.unit.tag);
+
+							slot = sentunit;
+						}
+					}
+				}
+
+				//Returns the slot of the tag, a new unit that has never been sent is added with the generation 0
+				SentUnit& Find(uint64_t tag)
+				{
+					size_t slot = GetSlot(tag), mask = _sentunits.size() - 1, removed = _sentunits.size();
+
+					for (;; slot = (slot + 1) & mask)
+					{
+						SentUnit& sentunit = _sentunits[slot];
+
+						if (sentunit.epoch != _epoch)
+							break;
+						if (!sentunit.isremoved && sentunit.unit.tag == tag)
+							return sentunit;
+						if (sentunit.isremoved && removed == _sentunits.size())
+							removed = slot;
+					}
+
+					//The table is kept at most half full with units and removed units, so the probes stay short and always end on an empty slot
+					if (removed == _sentunits.size() && ((_usedslots + 1) * 2) > _sentunits.size())
+					{
+						Rehash(((_sentunitcount + 1) * 4 > _sentunits.size()) ? (_sentunits.size() * 2) : _sentunits.size());
+						return Find(tag);
+					}
+					if (removed < _sentunits.size())
+						slot = removed;
+					else
+						_usedslots++;
+
+					SentUnit& sentunit = _sentunits[slot];
+					memset(&sentunit, 0, sizeof(sentunit));
+					sentunit.unit.tag = tag;
+					sentunit.epoch = _epoch;
+					_sentunitcount++;
+					return sentunit;
+				}
+
+			public:
+				SnapshotDeltaEncoder(uint32_t keyframeinterval = SNAPSHOT_KEYFRAMEINTERVAL, float positionepsilon = SNAPSHOT_POSITIONEPSILON) : _sentunits(SNAPSHOT_SENTUNITSLOTS)
+				{
+					_sentunitcount = 0;
+					_usedslots = 0;
+					_epoch = 0;
+					_generation = 0;
+					_deltas = 0;
+					_keyframeinterval = keyframeinterval;
+					_positionepsilonsquared = positionepsilon * positionepsilon;
+					_iskeyframe = true;
+					Reset();
+				}
+
+				//Forgets the sent units, so that the next snapshot is a keyframe
+				void Reset()
+				{
+					Forget();
+					_deltas = _keyframeinterval;
+				}
+
+				//Starts a snapshot that has already begun in the writer, and returns true if it is a keyframe
+				bool Begin(SnapshotWriter& writer)
+				{
+					_generation++;
+					_iskeyframe = (_deltas >= _keyframeinterval);
+					if (_iskeyframe)
+					{
+						Forget();
+						_deltas = 0;
+					}
+					else
+						_deltas++;
+
+					writer.SetFlags(_iskeyframe ? SNAPSHOT_KEYFRAME : SNAPSHOT_DELTA);
+					return _iskeyframe;
+				}
+
+				//Writes the unit if it has been added, has moved, or has changed its type since the last snapshot
+				bool AddUnit(SnapshotWriter& writer, SnapshotSection section, uint32_t type, uint64_t tag, float x, float y)
+				{
+					SentUnit& sentunit = Find(tag);
+					bool ischanged = (_iskeyframe || sentunit.generation == 0 || sentunit.unit.type != type || sentunit.section != section);
+
+					if (!ischanged)
+					{
+						float dx = (sentunit.unit.x - x), dy = (sentunit.unit.y - y);
+						ischanged = (((dx * dx) + (dy * dy)) > _positionepsilonsquared);
+					}
+
+					sentunit.generation = _generation;
+					if (!ischanged)
+						return true;
+
+					//Only a sent unit is remembered, so that a failed write is sent again in the next snapshot
+					if (!writer.AddUnit(section, type, tag, x, y))
+					{
+						sentunit.generation = 0;
+						return false;
+					}
+
+					sentunit.unit.type = type;
+					sentunit.unit.x = x;
+					sentunit.unit.y = y;
+					sentunit.section = section;
+					return true;
+				}
+
+				//Writes the units that were not seen in this snapshot as removed and returns false if the writer is full
+				//A removed unit keeps its slot as removed until the next keyframe or the table is rehashed
+				bool End(SnapshotWriter& writer)
+				{
+					bool iscomplete = true;
+
+					for (auto& sentunit : _sentunits)
+					{
+						if (sentunit.epoch != _epoch || sentunit.isremoved || sentunit.generation == _generation)
+							continue;
+						if (sentunit.generation != 0 && !writer.AddRemovedUnit(sentunit.unit.tag))
+						{
+							iscomplete = false;
+							continue;
+						}
+
+						sentunit.isremoved = true;
+						_sentunitcount--;
+					}
+
+					return iscomplete;
+				}
+
+				//Returns the number of units that the receiver currently knows
+				size_t GetSentUnitCount() const
+				{
+					return _sentunitcount;
+				}
+		};
+
+		//Returns true if the message is a binary snapshot rather than a text message
+		inline bool IsBinarySnapshot(const char* message, size_t size)
+		{
+			uint32_t magic = 0;
+
+			if (size < sizeof(SnapshotHeader))
+				return false;
+
+			memcpy(&magic, message, sizeof(magic));
+			return (magic == SNAPSHOT_MAGIC);
+		}
+	}
+}
@@ -4,7 +4,6 @@ using System.Collections.Generic;
 using System.Collections.Specialized;
 using System.Diagnostics;
 using System.IO;
-using System.IO.Pipes;
 using System.Linq;
 using System.Threading;
 
@@ -16,9 +15,9 @@ namespace ModelService
     public partial class ModelRepositoryService
     {
         /// <summary>
-        /// The sent messages by the agent to model
+        /// The sent messages by the agent to model, and the correlation id that their replies must have
         /// </summary>
-        private Queue<string> _recievedmessages = null;
+        private Queue<Tuple<uint, string>> _recievedmessages = null;
         /// <summary>
         /// A thread in model that keeps listening to agent
         /// </summary>
@@ -27,6 +26,22 @@ namespace ModelService
         /// If the model has to keep listening to agent
         /// </summary>
         private bool _keeplisteningtoagent = false;
+        /// <summary>
+        /// The long-lived duplex connection to agent
+        /// </summary>
+        private Stream _agent = null;
+        /// <summary>
+        /// Lock for writing frames to agent
+        /// </summary>
+        private object _sendlock = new object();
+        /// <summary>
+        /// The correlation id of a message that is not a reply to a request of agent
+        /// </summary>
+        public const uint FRAME_UNCORRELATED = 0;
+        /// <summary>
+        /// The largest payload of a frame, a larger length means that the connection cannot be trusted anymore
+        /// </summary>
+        private const int FRAME_MAXIMUMSIZE = 64 * 1024 * 1024;
 
         /// <summary>
         /// The different ranks in StarCraft 2
@@ -53,11 +68,32 @@ namespace ModelService
         }
 
         /// <summary>
-        /// Keeps listening to agent through pipe server
+        /// Reads exactly the number of bytes from the connection into the start of the buffer
+        /// </summary>
+        /// <param name="stream"></param>
+        /// <param name="buffer"></param>
+        /// <param name="count"></param>
+        /// <returns>Returns false if agent has disconnected</returns>
+        private bool ReadExactly(Stream stream, byte[] buffer, int count)
+        {
+            for (int read = 0, transferred = 0; read < count; read += transferred)
+            {
+                transferred = stream.Read(buffer, read, count - read);
+                if (transferred <= 0)
+                    return false;
+            }
+
+            return true;
+        }
+
+        /// <summary>
+        /// Keeps listening to agent through a single long-lived connection with length-prefixed frames
         /// </summary>
         private void ListenToAgent()
         {
-            NamedPipeServerStream server = null;
+            var header = new byte[sizeof(int) * 2];
+            //The payloads are read into the same buffer, it only grows when a larger frame arrives
+            var payload = new byte[64 * 1024];
 
             try
             {
@@ -69,39 +105,46 @@ namespace ModelService
 
                 while(_keeplisteningtoagent)
                 {
-                    server = null;
+                    //Connect to the agent and keep the connection until it closes
+                    var agent = ConnectToAgent();
+                    if (agent == null)
+                        break;
+                    ResetSnapshotUnits();
+                    lock (_sendlock)
+                        _agent = agent;
 
-                    using (server = new NamedPipeServerStream("ModelServer"))
+                    //Read the frames, a frame is a little-endian length and correlation id followed by the message
+                    while (_keeplisteningtoagent && ReadExactly(agent, header, header.Length))
                     {
-                        //Wait for a client to connect
-                        server.WaitForConnection();
-                        if (server.IsConnected)
+                        var length = (uint)(header[0] | (header[1] << 8) | (header[2] << 16) | (header[3] << 24));
+                        var correlation = (uint)(header[4] | (header[5] << 8) | (header[6] << 16) | (header[7] << 24));
+                        //The rest of the stream cannot be found after a length that is too large, so drop the connection
+                        if (length > FRAME_MAXIMUMSIZE)
                         {
-                            using (var listener = new StreamReader(server))
-                            {
-                                //Read the message
-                                var message = listener.ReadLine();
-
-                                //Check if the message is good
-                                if (IsGoodMessage(message))
-                                {
-                                    lock (_recievedmessages)
-                                    {
-                                        //Queue the message
-                                        _recievedmessages.Enqueue(message.Trim('\r', '\0', ' '));
-                                    }
-                                }
+                            Trace.WriteLine($@"Error in Model! ModelRepositoryService -> ListenToAgent(): \n\tRefused a frame of {length} bytes");
+                            break;
+                        }
+                        if (payload.Length < length)
+                            Array.Resize(ref payload, Math.Max((int)length, Math.Min(payload.Length * 2, FRAME_MAXIMUMSIZE)));
+                        if (!ReadExactly(agent, payload, (int)length))
+                            break;
 
-                                listener.Close();
+                        //Check if the message is good, binary snapshots are converted to the text message
+                        var message = IsBinarySnapshot(payload, (int)length) ? DecodeBinarySnapshot(payload, (int)length) : System.Text.Encoding.ASCII.GetString(payload, 0, (int)length);
+                        if (IsGoodMessage(message))
+                        {
+                            lock (_recievedmessages)
+                            {
+                                //Queue the message
+                                _recievedmessages.Enqueue(Tuple.Create(correlation, message.Trim('\r', '\0', ' ')));
                             }
                         }
-
-                        //Close the server pipe
-                        server.Close();
                     }
 
-                    //Give way to other threads by 1 second
-                    Thread.Sleep(1000);
+                    //Close the connection, the agent will accept a new one
+                    lock (_sendlock)
+                        _agent = null;
+                    agent.Close();
                 }
             }
             catch(Exception ex)
@@ -121,7 +164,7 @@ namespace ModelService
             {
                 if(_listentoagent == null)
                 {
-                    _recievedmessages = new Queue<string>();
+                    _recievedmessages = new Queue<Tuple<uint, string>>();
                     _listentoagent = new Thread(new ThreadStart(ListenToAgent));
                     _listentoagent.Start();
                 }
@@ -221,16 +264,21 @@ namespace ModelService
         }
 
         /// <summary>
-        /// Retrieves a message in queue
+        /// Retrieves a message in queue and the correlation id that its reply must be sent with
         /// </summary>
+        /// <param name="correlation">The correlation id to pass to <see cref="SendMessageToAgent(string, uint)"/> with the reply</param>
         /// <returns>Returns null if there is an error in retrieval</returns>
-        public string GetMessageFromQueue()
+        public string GetMessageFromQueue(out uint correlation)
         {
+            correlation = FRAME_UNCORRELATED;
             lock(_recievedmessages)
             {
                 try
                 {
-                    return _recievedmessages.Dequeue();
+                    var message = _recievedmessages.Dequeue();
+
+                    correlation = message.Item1;
+                    return message.Item2;
                 }
                 catch(Exception ex)
                 {
@@ -243,27 +291,40 @@ namespace ModelService
         }
 
         /// <summary>
-        /// Sends a message to agent
+        /// Sends a message to agent as a single frame through the connection that is not a reply to a request
         /// </summary>
         /// <param name="message"></param>
         public void SendMessageToAgent(string message)
+        {
+            SendMessageToAgent(message, FRAME_UNCORRELATED);
+        }
+
+        /// <summary>
+        /// Sends a message to agent as a single frame through the connection
+        /// </summary>
+        /// <param name="message"></param>
+        /// <param name="correlation">The correlation id of the request that the message replies to, from <see cref="GetMessageFromQueue(out uint)"/></param>
+        public void SendMessageToAgent(string message, uint correlation)
         {
             try
             {
-                using (var client = new NamedPipeClientStream("AgentServer"))
+                var payload = System.Text.Encoding.ASCII.GetBytes(message);
+
+                lock (_sendlock)
                 {
-                    client.Connect();
-                    
-                    if(client.IsConnected)
+                    if (_agent == null)
+                        throw new InvalidOperationException("Agent is not yet connected!");
+
+                    var header = BitConverter.GetBytes(payload.Length).Concat(BitConverter.GetBytes(correlation)).ToArray();
+                    if (!BitConverter.IsLittleEndian)
                     {
-                        using (var writer = new StreamWriter(client))
-                        {
-                            writer.WriteLine(message);
-                            writer.Flush();
-                        }
+                        Array.Reverse(header, 0, sizeof(int));
+                        Array.Reverse(header, sizeof(int), sizeof(int));
                     }
 
-                    client.Close();
+                    _agent.Write(header, 0, header.Length);
+                    _agent.Write(payload, 0, payload.Length);
+                    _agent.Flush();
                 }
             }
             catch(Exception ex)
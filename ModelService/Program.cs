@@ -121,7 +121,8 @@ namespace ModelService
                             //If there is a request from agent
                             if (modelrepositoryservice.HasMessageFromAgent())
                             {
-                                var rawmessage = modelrepositoryservice.GetMessageFromQueue();
+                                var correlation = ModelRepositoryService.FRAME_UNCORRELATED;
+                                var rawmessage = modelrepositoryservice.GetMessageFromQueue(out correlation);
                                 Console.WriteLine(rawmessage);
                                 Console.WriteLine("Message has been received!\n\n\n\n");
                                 var partitionedmessage = rawmessage.Split('~');
@@ -148,11 +149,11 @@ namespace ModelService
                                 {
                                     case 0:
                                         player = new Macromanagement.Macromanagement(partitionedmessage[0], partitionedmessage[1]);
-                                        modelrepositoryservice.SendMessageToAgent(String.Join(",", player.GetMacromanagementStuff()));
+                                        modelrepositoryservice.SendMessageToAgent(String.Join(",", player.GetMacromanagementStuff()), correlation);
                                         mode = 1;
                                         break;
                                     case 1:
-                                        modelrepositoryservice.SendMessageToAgent(String.Join(",", player.GetMacromanagementStuff()));
+                                        modelrepositoryservice.SendMessageToAgent(String.Join(",", player.GetMacromanagementStuff()), correlation);
                                         break;
                                 }
 
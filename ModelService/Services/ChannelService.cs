@@ -0,0 +1,148 @@
+﻿using System;
+using System.IO;
+using System.IO.Pipes;
+using System.Net;
+using System.Net.Sockets;
+using System.Text;
+using System.Threading;
+
+namespace ModelService
+{
+    public partial class ModelRepositoryService
+    {
+        /// <summary>
+        /// The environment variable that overrides the name of the channel, agent reads the same one.
+        /// It holds the name of the pipe on Windows and the path of the socket elsewhere
+        /// </summary>
+        private const string CHANNEL_ENVIRONMENTVARIABLE = "KOKEKOKO_CHANNEL";
+
+        /// <summary>
+        /// The name of the named pipe of agent on Windows
+        /// </summary>
+        private const string CHANNEL_PIPENAME = "KoKeKoKo";
+
+        /// <summary>
+        /// The path of the unix domain socket of agent elsewhere, the same as CHANNEL_NAME of Model/Channel.h
+        /// </summary>
+        private const string CHANNEL_SOCKETPATH = "/tmp/KoKeKoKo.sock";
+
+        /// <summary>
+        /// The milliseconds between the attempts to connect to the socket of agent, it does not exist until agent listens
+        /// </summary>
+        private const int CHANNEL_RETRYMILLISECONDS = 100;
+
+        /// <summary>
+        /// The address of a unix domain socket, which .NET Framework does not have.
+        /// It is laid out the same as Mono.Unix.UnixEndPoint, so it works on Mono and on .NET Core alike
+        /// </summary>
+        private class UnixSocketEndPoint : EndPoint
+        {
+            /// <summary>
+            /// The path of the socket
+            /// </summary>
+            public string Path { get; private set; }
+
+            public UnixSocketEndPoint(string path)
+            {
+                Path = path;
+            }
+
+            public override AddressFamily AddressFamily
+            {
+                get { return AddressFamily.Unix; }
+            }
+
+            /// <summary>
+            /// The family takes the first 2 bytes of the address and the path follows it with a terminating zero
+            /// </summary>
+            /// <returns></returns>
+            public override SocketAddress Serialize()
+            {
+                var path = Encoding.UTF8.GetBytes(Path);
+                var address = new SocketAddress(AddressFamily.Unix, 2 + path.Length + 1);
+
+                for (int index = 0; index < path.Length; index++)
+                    address[2 + index] = path[index];
+
+                return address;
+            }
+
+            public override EndPoint Create(SocketAddress address)
+            {
+                var path = new byte[address.Size - 2];
+                int length = 0;
+
+                for (; length < path.Length && address[2 + length] != 0; length++)
+                    path[length] = address[2 + length];
+
+                return new UnixSocketEndPoint(Encoding.UTF8.GetString(path, 0, length));
+            }
+
+            public override string ToString()
+            {
+                return Path;
+            }
+        }
+
+        /// <summary>
+        /// Checks if the channel of agent is a unix domain socket rather than a named pipe
+        /// </summary>
+        /// <returns></returns>
+        private static bool IsUnixSocketChannel()
+        {
+            return (Environment.OSVersion.Platform == PlatformID.Unix || Environment.OSVersion.Platform == PlatformID.MacOSX);
+        }
+
+        /// <summary>
+        /// Gets the name of the channel from the environment variable, or the default name of the platform when it is not set
+        /// </summary>
+        /// <returns></returns>
+        public static string GetChannelName()
+        {
+            var name = Environment.GetEnvironmentVariable(CHANNEL_ENVIRONMENTVARIABLE);
+
+            if (!String.IsNullOrEmpty(name))
+                return name;
+
+            return IsUnixSocketChannel() ? CHANNEL_SOCKETPATH : CHANNEL_PIPENAME;
+        }
+
+        /// <summary>
+        /// Connects to the channel of agent, a named pipe on Windows and a unix domain socket elsewhere.
+        /// The socket is connected directly instead of through NamedPipeClientStream, because the path
+        /// that a runtime maps the name of a pipe to differs between .NET Core and Mono
+        /// </summary>
+        /// <returns>Returns the connected stream, it blocks until agent accepts the connection or model stops listening</returns>
+        private Stream ConnectToAgent()
+        {
+            var name = GetChannelName();
+
+            if (!IsUnixSocketChannel())
+            {
+                var pipe = new NamedPipeClientStream(".", name, PipeDirection.InOut, PipeOptions.Asynchronous);
+
+                pipe.Connect();
+                return pipe;
+            }
+
+            while (_keeplisteningtoagent)
+            {
+                var socket = new Socket(AddressFamily.Unix, SocketType.Stream, ProtocolType.Unspecified);
+
+                try
+                {
+                    socket.Connect(new UnixSocketEndPoint(name));
+                    return new NetworkStream(socket, true);
+                }
+                catch (SocketException)
+                {
+                    //Agent is not listening yet, the same as waiting in NamedPipeClientStream.Connect
+                    socket.Close();
+                    Thread.Sleep(CHANNEL_RETRYMILLISECONDS);
+                }
+            }
+
+            return null;
+        }
+    }
+}
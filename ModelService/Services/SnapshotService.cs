@@ -0,0 +1,124 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+using System.Text;
+
+namespace ModelService
+{
+    public partial class ModelRepositoryService
+    {
+        /// <summary>
+        /// The first 4 bytes of a binary snapshot from agent, "KKKS" in little-endian
+        /// </summary>
+        private const uint SNAPSHOT_MAGIC = 0x534B4B4B;
+
+        /// <summary>
+        /// The version of the binary snapshot that this model understands
+        /// </summary>
+        private const ushort SNAPSHOT_VERSION = 2;
+
+        /// <summary>
+        /// The number of 64-bit words in the upgrade bitset of a binary snapshot
+        /// </summary>
+        private const int SNAPSHOT_UPGRADEWORDS = 8;
+
+        /// <summary>
+        /// The snapshot has every living unit of agent
+        /// </summary>
+        private const ushort SNAPSHOT_KEYFRAME = 0x1;
+
+        /// <summary>
+        /// The alliance of the units in the enemy section, agent only writes its Unit::Alliance::Enemy units there
+        /// so a binary unit does not carry its alliance
+        /// </summary>
+        private const uint SNAPSHOT_ENEMYALLIANCE = 4;
+
+        /// <summary>
+        /// The units of agent from the applied snapshots where key is the tag of the unit,
+        /// and value is if the unit is an enemy, the type, and the position of the unit
+        /// </summary>
+        private Dictionary<ulong, Tuple<bool, uint, float, float>> _snapshotunits = new Dictionary<ulong, Tuple<bool, uint, float, float>>();
+
+        /// <summary>
+        /// Forgets the units from the applied snapshots, the next snapshot from agent will be a keyframe
+        /// </summary>
+        private void ResetSnapshotUnits()
+        {
+            _snapshotunits.Clear();
+        }
+
+        /// <summary>
+        /// Checks if the sent message is a binary snapshot
+        /// </summary>
+        /// <param name="payload"></param>
+        /// <param name="length"></param>
+        /// <returns></returns>
+        private bool IsBinarySnapshot(byte[] payload, int length)
+        {
+            return (length >= 4 && BitConverter.ToUInt32(payload, 0) == SNAPSHOT_MAGIC);
+        }
+
+        /// <summary>
+        /// Applies a binary snapshot from agent and converts the known units to the "Macromanagement:"
+        /// text message, so that the rest of the model does not depend on the format that agent has used
+        /// </summary>
+        /// <param name="payload"></param>
+        /// <param name="length"></param>
+        /// <returns>Returns null if the snapshot has an unknown version</returns>
+        private string DecodeBinarySnapshot(byte[] payload, int length)
+        {
+            using (var reader = new BinaryReader(new MemoryStream(payload, 0, length)))
+            {
+                var message = new StringBuilder("Macromanagement:");
+
+                //Header
+                reader.ReadUInt32(); //Magic
+                if (reader.ReadUInt16() != SNAPSHOT_VERSION)
+                    return null;
+                var flags = reader.ReadUInt16();
+                var gameloop = reader.ReadUInt32();
+                var playerid = reader.ReadUInt32();
+                message.Append($@"{gameloop},{playerid},{reader.ReadInt32()},{reader.ReadInt32()},{reader.ReadInt32()},{reader.ReadInt32()}");
+
+                //Upgrades
+                for (int word = 0; word < SNAPSHOT_UPGRADEWORDS; word++)
+                {
+                    var upgrades = reader.ReadUInt64();
+                    for (int bit = 0; bit < 64; bit++)
+                    {
+                        if ((upgrades & (1UL << bit)) != 0)
+                            message.Append($@",{(word * 64) + bit}");
+                    }
+                }
+                message.Append(":");
+
+                //A keyframe replaces the known units, a delta only updates the added, moved and removed units
+                if ((flags & SNAPSHOT_KEYFRAME) != 0)
+                    _snapshotunits.Clear();
+                var selfcount = reader.ReadUInt32();
+                var enemycount = reader.ReadUInt32();
+                var removedcount = reader.ReadUInt32();
+                for (uint unit = 0; unit < (selfcount + enemycount); unit++)
+                {
+                    var type = reader.ReadUInt32();
+                    var tag = reader.ReadUInt64();
+                    _snapshotunits[tag] = Tuple.Create(unit >= selfcount, type, reader.ReadSingle(), reader.ReadSingle());
+                }
+                for (uint unit = 0; unit < removedcount; unit++)
+                    _snapshotunits.Remove(reader.ReadUInt64());
+
+                //Self and Enemy units
+                //The positions are written with a dot like agent writes them, whatever the culture of the machine is
+                foreach (var unit in _snapshotunits.Where(unit => !unit.Value.Item1))
+                    message.AppendFormat(CultureInfo.InvariantCulture, "{0},{1},{2},{3:F6},{4:F6}\n", playerid, unit.Value.Item2, unit.Key, unit.Value.Item3, unit.Value.Item4);
+                message.Append("~");
+                foreach (var unit in _snapshotunits.Where(unit => unit.Value.Item1))
+                    message.AppendFormat(CultureInfo.InvariantCulture, "{0},{1},{2},{3:F6},{4:F6}\n", SNAPSHOT_ENEMYALLIANCE, unit.Value.Item2, unit.Key, unit.Value.Item3, unit.Value.Item4);
+
+                return message.ToString();
+            }
+        }
+    }
+}
@@ -0,0 +1,877 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../Types/MappedFile.h"
+#include "../Types/WorkStealingPool.h"
+
+namespace KoKeKoKo
+{
+	namespace Repository
+	{
+		//The bytes that a thread parses at least, a smaller repository is parsed by fewer threads
+		const size_t REPOSITORY_MINIMUMCHUNKBYTES = 1 << 18;
+		//The fewest bytes that a row of a repository has, the columns of a chunk reserve room for as many rows as it could have
+		const size_t REPOSITORY_MINIMUMROWBYTES = 16;
+		//The most names that a dictionary can have, a name is stored as a 16-bit index
+		const size_t REPOSITORY_MAXIMUMNAMES = std::numeric_limits<uint16_t>::max();
+		//The suffix of the lines that name a replay, the lines that name a rank have none
+		const char REPOSITORY_REPLAYSUFFIX[] = ".SC2Replay";
+		//The line in ArmiesRepository.csv between the armies before a battle and the units that survived it
+		const char REPOSITORY_ENDLINE[] = "END";
+
+		//The ranks of the repository in the order of the file, with the replays that were played at that rank
+		struct RepositoryRank
+		{
+			std::string name;
+			uint32_t firstreplay;
+			uint32_t replaycount;
+		};
+
+		//The replays of the repository in the order of the file, with the rows that were recorded from it
+		struct RepositoryReplay
+		{
+			std::string filename;
+			uint32_t rank;
+			uint32_t firstrow;
+			uint32_t rowcount;
+			//The first row after the END line, the rows from there on are the units that survived the battle, or the end of the rows if the replay has none
+			uint32_t endrow;
+		};
+
+		//A read-only view of values that are stored elsewhere, in the columns of a repository or in a mapped cache
+		template<typename T>
+		class RepositorySpan
+		{
+			private:
+				const T* _data;
+				size_t _count;
+
+			public:
+				typedef T ValueType;
+
+				RepositorySpan() : _data(nullptr), _count(0)
+				{
+
+				}
+
+				RepositorySpan(const T* data, size_t count) : _data(data), _count(count)
+				{
+
+				}
+
+				RepositorySpan(const std::vector<T>& values) : _data(values.data()), _count(values.size())
+				{
+
+				}
+
+				const T& operator[](size_t index) const
+				{
+					return _data[index];
+				}
+
+				const T* begin() const
+				{
+					return _data;
+				}
+
+				const T* end() const
+				{
+					return _data + _count;
+				}
+
+				const T* GetData() const
+				{
+					return _data;
+				}
+
+				size_t GetCount() const
+				{
+					return _count;
+				}
+		};
+
+		//Names that are stored once and referred to by their index, in the order that they were first added
+		class RepositoryDictionary
+		{
+			private:
+				std::vector<std::string> _names;
+				//An open addressing table of the index of each name plus one, zero is an empty slot
+				std::vector<uint32_t> _slots;
+
+				static uint32_t GetHash(const char* name, size_t length)
+				{
+					uint32_t hash = 2166136261u;
+
+					for (size_t index = 0; index < length; index++)
+						hash = (hash ^ static_cast<uint8_t>(name[index])) * 16777619u;
+
+					return hash;
+				}
+
+				//Returns the slot of the name, or the empty slot where it would be added
+				size_t GetSlot(const char* name, size_t length) const
+				{
+					const size_t mask = _slots.size() - 1;
+
+					for (size_t slot = GetHash(name, length) & mask; ; slot = (slot + 1) & mask)
+					{
+						if (_slots[slot] == 0)
+							return slot;
+
+						const std::string& existing = _names[_slots[slot] - 1];
+						if (existing.size() == length && std::memcmp(existing.data(), name, length) == 0)
+							return slot;
+					}
+				}
+
+				void Grow()
+				{
+					std::vector<uint32_t> slots(_slots.size() * 2, 0);
+
+					_slots.swap(slots);
+					for (size_t index = 0; index < _names.size(); index++)
+						_slots[GetSlot(_names[index].data(), _names[index].size())] = static_cast<uint32_t>(index + 1);
+				}
+
+			public:
+				RepositoryDictionary() : _slots(64, 0)
+				{
+
+				}
+
+				//Returns the index of the name, and adds it if it is new
+				uint16_t Add(const char* name, size_t length)
+				{
+					size_t slot = GetSlot(name, length);
+
+					if (_slots[slot] == 0)
+					{
+						if (_names.size() >= REPOSITORY_MAXIMUMNAMES)
+							throw std::runtime_error("Error Occurred! A repository has more names than a dictionary can hold...");
+						_names.emplace_back(name, length);
+						_slots[slot] = static_cast<uint32_t>(_names.size());
+						if ((_names.size() * 2) > _slots.size())
+							Grow();
+						return static_cast<uint16_t>(_names.size() - 1);
+					}
+
+					return static_cast<uint16_t>(_slots[slot] - 1);
+				}
+
+				uint16_t Add(const std::string& name)
+				{
+					return Add(name.data(), name.size());
+				}
+
+				//Returns the index of the name, or -1 if it is not in the dictionary
+				int32_t Find(const std::string& name) const
+				{
+					size_t slot = GetSlot(name.data(), name.size());
+
+					return (_slots[slot] == 0) ? -1 : static_cast<int32_t>(_slots[slot] - 1);
+				}
+
+				const std::string& GetName(uint16_t index) const
+				{
+					return _names[index];
+				}
+
+				size_t GetCount() const
+				{
+					return _names.size();
+				}
+		};
+
+		//Reads the fields of a line of a repository, every parse returns false without moving on if the field is not there
+		class RepositoryCursor
+		{
+			private:
+				const char* _position;
+				const char* _end;
+
+			public:
+				RepositoryCursor(const char* position, const char* end) : _position(position), _end(end)
+				{
+
+				}
+
+				bool ParseUnsigned(uint32_t& value)
+				{
+					const char* position = _position;
+					uint32_t result = 0;
+
+					while (position < _end && *position >= '0' && *position <= '9')
+						result = (result * 10) + static_cast<uint32_t>(*position++ - '0');
+					if (position == _position)
+						return false;
+					value = result;
+					_position = position;
+
+					return true;
+				}
+
+				//Parses a tag such as [37C0001], the hexadecimal unit tag of the replay
+				bool ParseTag(uint64_t& value)
+				{
+					const char* position = _position;
+					uint64_t result = 0;
+
+					if (position >= _end || *position != '[')
+						return false;
+					for (position++; position < _end && *position != ']'; position++)
+					{
+						char digit = *position;
+
+						if (digit >= '0' && digit <= '9')
+							result = (result << 4) | static_cast<uint64_t>(digit - '0');
+						else if (digit >= 'A' && digit <= 'F')
+							result = (result << 4) | static_cast<uint64_t>(digit - 'A' + 10);
+						else if (digit >= 'a' && digit <= 'f')
+							result = (result << 4) | static_cast<uint64_t>(digit - 'a' + 10);
+						else
+							return false;
+					}
+					if (position >= _end)
+						return false;
+					value = result;
+					_position = position + 1;
+
+					return true;
+				}
+
+				//Parses a coordinate, the repositories write whole numbers but a fraction is read too
+				bool ParseFloat(float& value)
+				{
+					const char* position = _position;
+					bool isnegative = (position < _end && *position == '-');
+					float result = 0, scale = 1;
+
+					if (isnegative)
+						position++;
+
+					const char* digits = position;
+					while (position < _end && *position >= '0' && *position <= '9')
+						result = (result * 10) + static_cast<float>(*position++ - '0');
+					if (position < _end && *position == '.')
+						for (position++; position < _end && *position >= '0' && *position <= '9'; position++)
+							result += static_cast<float>(*position - '0') * (scale *= 0.1f);
+					if (position == digits)
+						return false;
+					value = (isnegative) ? -result : result;
+					_position = position;
+
+					return true;
+				}
+
+				//Parses the text until the next comma or the end of the line
+				bool ParseName(const char*& name, size_t& length)
+				{
+					const char* position = _position;
+
+					while (position < _end && *position != ',' && *position != '\r')
+						position++;
+					if (position == _position)
+						return false;
+					name = _position;
+					length = static_cast<size_t>(position - _position);
+					_position = position;
+
+					return true;
+				}
+
+				bool Skip(char separator)
+				{
+					if (_position >= _end || *_position != separator)
+						return false;
+					_position++;
+
+					return true;
+				}
+		};
+
+		//A line of a repository that is not a row, with the number of rows that came before it in its chunk
+		struct RepositoryMarker
+		{
+			enum class Kind : uint8_t
+			{
+				Rank,
+				Replay,
+				End
+			};
+
+			Kind kind;
+			uint32_t row;
+			const char* name;
+			size_t length;
+		};
+
+		//A repository that is kept as one array per column, with an index of its ranks and replays
+		//The columns type has an array for each column, the names of the dictionaries, and parses and appends the rows of the repository
+		//A load maps the file and parses it in chunks of whole lines on a pool of threads, the chunks are then joined in the order of the file
+		template<typename Columns>
+		class ColumnarRepository
+		{
+			private:
+				//What a thread has parsed from its chunk, the names of the rows index the dictionaries of the chunk
+				struct Chunk
+				{
+					Columns columns;
+					std::array<RepositoryDictionary, Columns::DICTIONARYCOUNT> dictionaries;
+					std::vector<RepositoryMarker> markers;
+					size_t skippedlines;
+				};
+
+				Columns _columns;
+				std::array<RepositoryDictionary, Columns::DICTIONARYCOUNT> _dictionaries;
+				std::vector<RepositoryRank> _ranks;
+				std::vector<RepositoryReplay> _replays;
+				size_t _skippedlines;
+				size_t _chunkcount;
+
+				ColumnarRepository(const ColumnarRepository&);
+				ColumnarRepository& operator=(const ColumnarRepository&);
+
+				//Returns the text of a line without the commas that the repositories pad it with
+				static size_t GetTrimmedLength(const char* line, size_t length)
+				{
+					while (length > 0 && (line[length - 1] == ',' || line[length - 1] == ' ' || line[length - 1] == '\r'))
+						length--;
+
+					return length;
+				}
+
+				//Returns the length of the filename if the line names a replay, or zero if it does not
+				//The filename ends at the suffix, since a few lines of the repositories have the start of a row written right after it
+				static size_t GetReplayLength(const char* line, size_t length)
+				{
+					const size_t suffixlength = sizeof(REPOSITORY_REPLAYSUFFIX) - 1;
+
+					for (size_t start = 0; (start + suffixlength) <= length; start++)
+					{
+						size_t index = 0;
+
+						while (index < suffixlength && std::tolower(static_cast<unsigned char>(line[start + index])) == std::tolower(static_cast<unsigned char>(REPOSITORY_REPLAYSUFFIX[index])))
+							index++;
+						if (index == suffixlength)
+							return start + suffixlength;
+					}
+
+					return 0;
+				}
+
+				//Parses every line of a chunk, the rows go into the columns and the other lines become markers
+				static void Parse(const char* begin, const char* end, Chunk& chunk)
+				{
+					chunk.skippedlines = 0;
+					chunk.columns.Reserve(static_cast<size_t>(end - begin) / REPOSITORY_MINIMUMROWBYTES);
+					for (const char* line = begin; line < end; )
+					{
+						const char* next = static_cast<const char*>(std::memchr(line, '\n', static_cast<size_t>(end - line)));
+						const char* lineend = (next != nullptr) ? next : end;
+
+						if (*line >= '0' && *line <= '9')
+						{
+							RepositoryCursor cursor(line, lineend);
+
+							if (!chunk.columns.ParseRow(cursor, chunk.dictionaries.data()))
+								chunk.skippedlines++;
+						}
+						else
+						{
+							size_t length = GetTrimmedLength(line, static_cast<size_t>(lineend - line)), replaylength = GetReplayLength(line, length);
+							RepositoryMarker marker;
+
+							marker.row = static_cast<uint32_t>(chunk.columns.GetRowCount());
+							marker.name = line;
+							marker.length = length;
+							if (length == (sizeof(REPOSITORY_ENDLINE) - 1) && std::memcmp(line, REPOSITORY_ENDLINE, length) == 0)
+								marker.kind = RepositoryMarker::Kind::End;
+							else if (replaylength > 0)
+							{
+								marker.kind = RepositoryMarker::Kind::Replay;
+								marker.length = replaylength;
+							}
+							else
+								marker.kind = RepositoryMarker::Kind::Rank;
+							if (length > 0)
+								chunk.markers.push_back(marker);
+						}
+						line = lineend + 1;
+					}
+				}
+
+				//Returns where each chunk starts, every chunk but the first starts right after a new line
+				static std::vector<const char*> GetChunkBounds(const char* data, size_t size, size_t chunkcount)
+				{
+					std::vector<const char*> bounds(1, data);
+
+					for (size_t chunk = 1; chunk < chunkcount; chunk++)
+					{
+						const char* position = std::max(bounds.back(), data + ((size * chunk) / chunkcount));
+						const char* newline = static_cast<const char*>(std::memchr(position, '\n', static_cast<size_t>((data + size) - position)));
+
+						if (newline == nullptr)
+							break;
+						bounds.push_back(newline + 1);
+					}
+					bounds.push_back(data + size);
+
+					return bounds;
+				}
+
+				void CloseReplay(uint32_t row)
+				{
+					if (_replays.empty() || _replays.back().rowcount != std::numeric_limits<uint32_t>::max())
+						return;
+
+					RepositoryReplay& replay = _replays.back();
+					replay.rowcount = row - replay.firstrow;
+					if (replay.endrow == std::numeric_limits<uint32_t>::max())
+						replay.endrow = row;
+				}
+
+				//Adds the rows of a chunk after the ones before it, and indexes the ranks and replays that it names
+				void Join(const Chunk& chunk)
+				{
+					const uint32_t offset = static_cast<uint32_t>(_columns.GetRowCount());
+					std::array<std::vector<uint16_t>, Columns::DICTIONARYCOUNT> remaps;
+
+					for (size_t dictionary = 0; dictionary < Columns::DICTIONARYCOUNT; dictionary++)
+						for (size_t index = 0; index < chunk.dictionaries[dictionary].GetCount(); index++)
+							remaps[dictionary].push_back(_dictionaries[dictionary].Add(chunk.dictionaries[dictionary].GetName(static_cast<uint16_t>(index))));
+					_columns.Append(chunk.columns, remaps.data());
+					_skippedlines += chunk.skippedlines;
+
+					for (const auto& marker : chunk.markers)
+					{
+						const uint32_t row = offset + marker.row;
+
+						switch (marker.kind)
+						{
+							case RepositoryMarker::Kind::Rank:
+								CloseReplay(row);
+								_ranks.push_back({ std::string(marker.name, marker.length), static_cast<uint32_t>(_replays.size()), 0 });
+								break;
+							case RepositoryMarker::Kind::Replay:
+								CloseReplay(row);
+								//The replays before the first rank belong to a rank without a name
+								if (_ranks.empty())
+									_ranks.push_back({ std::string(), 0, 0 });
+								_replays.push_back({ std::string(marker.name, marker.length), static_cast<uint32_t>(_ranks.size() - 1), row, std::numeric_limits<uint32_t>::max(), std::numeric_limits<uint32_t>::max() });
+								_ranks.back().replaycount++;
+								break;
+							case RepositoryMarker::Kind::End:
+								if (!_replays.empty() && _replays.back().rowcount == std::numeric_limits<uint32_t>::max())
+									_replays.back().endrow = row;
+								break;
+						}
+					}
+				}
+
+			public:
+				ColumnarRepository()
+				{
+					_skippedlines = 0;
+					_chunkcount = 0;
+				}
+
+				//Loads the repository with a thread for each core unless told otherwise, the previous contents are replaced
+				void Load(const std::string& path, size_t threads = 0)
+				{
+					Types::MappedFile file(path);
+					size_t chunkcount = std::max(static_cast<size_t>(1), std::min((threads > 0) ? threads : static_cast<size_t>(std::max(1u, std::thread::hardware_concurrency())), file.GetSize() / REPOSITORY_MINIMUMCHUNKBYTES));
+					std::vector<const char*> bounds = GetChunkBounds(file.GetData(), file.GetSize(), chunkcount);
+					std::vector<Chunk> chunks(bounds.size() - 1);
+
+					if (chunks.size() == 1)
+						Parse(bounds[0], bounds[1], chunks[0]);
+					else
+					{
+						Types::WorkStealingPool pool(chunks.size());
+
+						for (size_t chunk = 0; chunk < chunks.size(); chunk++)
+							pool.Submit([&bounds, &chunks, chunk]() { Parse(bounds[chunk], bounds[chunk + 1], chunks[chunk]); });
+						pool.WaitForIdle();
+					}
+
+					_columns = Columns();
+					for (auto& dictionary : _dictionaries)
+						dictionary = RepositoryDictionary();
+					_ranks.clear();
+					_replays.clear();
+					_skippedlines = 0;
+					_chunkcount = chunks.size();
+					size_t rows = 0;
+					for (const auto& chunk : chunks)
+						rows += chunk.columns.GetRowCount();
+					_columns.Reserve(rows);
+					for (const auto& chunk : chunks)
+						Join(chunk);
+					CloseReplay(static_cast<uint32_t>(_columns.GetRowCount()));
+				}
+
+				const Columns& GetColumns() const
+				{
+					return _columns;
+				}
+
+				//Returns views of the columns, they are valid until the next load
+				typename Columns::Spans GetSpans() const
+				{
+					return _columns.GetSpans();
+				}
+
+				const RepositoryDictionary& GetDictionary(size_t dictionary) const
+				{
+					return _dictionaries[dictionary];
+				}
+
+				const std::vector<RepositoryRank>& GetRanks() const
+				{
+					return _ranks;
+				}
+
+				const std::vector<RepositoryReplay>& GetReplays() const
+				{
+					return _replays;
+				}
+
+				//Returns the index of the rank, or -1 if the repository has no replays of that rank
+				int32_t FindRank(const std::string& name) const
+				{
+					for (size_t index = 0; index < _ranks.size(); index++)
+						if (_ranks[index].name == name)
+							return static_cast<int32_t>(index);
+
+					return -1;
+				}
+
+				size_t GetRowCount() const
+				{
+					return _columns.GetRowCount();
+				}
+
+				//Returns the rows that did not have the fields of the repository and were left out
+				size_t GetSkippedLineCount() const
+				{
+					return _skippedlines;
+				}
+
+				//Returns the number of chunks that the last load was parsed in
+				size_t GetChunkCount() const
+				{
+					return _chunkcount;
+				}
+		};
+
+		//The columns of a repository as views, so the same code reads them from the columns of a load and from a mapped cache
+		struct ArmiesSpans
+		{
+			RepositorySpan<uint32_t> seconds;
+			RepositorySpan<uint16_t> players;
+			RepositorySpan<uint64_t> tags;
+			RepositorySpan<uint16_t> types;
+			RepositorySpan<float> x;
+			RepositorySpan<float> y;
+
+			template<typename Function>
+			void ForEachColumn(Function function)
+			{
+				function(0, seconds);
+				function(1, players);
+				function(2, tags);
+				function(3, types);
+				function(4, x);
+				function(5, y);
+			}
+
+			size_t GetRowCount() const
+			{
+				return seconds.GetCount();
+			}
+		};
+
+		struct CommandsSpans
+		{
+			RepositorySpan<uint32_t> seconds;
+			RepositorySpan<uint16_t> players;
+			RepositorySpan<uint16_t> commands;
+			RepositorySpan<uint16_t> categories;
+
+			template<typename Function>
+			void ForEachColumn(Function function)
+			{
+				function(0, seconds);
+				function(1, players);
+				function(2, commands);
+				function(3, categories);
+			}
+
+			size_t GetRowCount() const
+			{
+				return seconds.GetCount();
+			}
+		};
+
+		struct ResourcesSpans
+		{
+			RepositorySpan<uint32_t> seconds;
+			RepositorySpan<uint16_t> players;
+			RepositorySpan<uint32_t> minerals;
+			RepositorySpan<uint32_t> vespene;
+			RepositorySpan<uint16_t> supplies;
+			RepositorySpan<uint16_t> workers;
+
+			template<typename Function>
+			void ForEachColumn(Function function)
+			{
+				function(0, seconds);
+				function(1, players);
+				function(2, minerals);
+				function(3, vespene);
+				function(4, supplies);
+				function(5, workers);
+			}
+
+			size_t GetRowCount() const
+			{
+				return seconds.GetCount();
+			}
+		};
+
+		//The columns of ArmiesRepository.csv, the units of both players before a battle and the ones that survived it
+		//A row is the second of the replay, the player, the unit tag, the unit type and the position
+		struct ArmiesColumns
+		{
+			typedef ArmiesSpans Spans;
+			static const size_t DICTIONARYCOUNT = 1;
+			//The dictionary of the unit types
+			static const size_t TYPES = 0;
+
+			std::vector<uint32_t> seconds;
+			std::vector<uint16_t> players;
+			std::vector<uint64_t> tags;
+			std::vector<uint16_t> types;
+			std::vector<float> x;
+			std::vector<float> y;
+
+			template<typename Function>
+			void ForEachColumn(Function function) const
+			{
+				function(0, seconds);
+				function(1, players);
+				function(2, tags);
+				function(3, types);
+				function(4, x);
+				function(5, y);
+			}
+
+			bool ParseRow(RepositoryCursor& cursor, RepositoryDictionary* dictionaries)
+			{
+				uint32_t second = 0, player = 0;
+				uint64_t tag = 0;
+				const char* type = nullptr;
+				size_t typelength = 0;
+				float positionx = 0, positiony = 0;
+
+				if (!cursor.ParseUnsigned(second) || !cursor.Skip(',') || !cursor.ParseUnsigned(player) || !cursor.Skip(',') || !cursor.ParseTag(tag) || !cursor.Skip(',') || !cursor.ParseName(type, typelength) || !cursor.Skip(',') || !cursor.ParseFloat(positionx) || !cursor.Skip(',') || !cursor.ParseFloat(positiony))
+					return false;
+				seconds.push_back(second);
+				players.push_back(static_cast<uint16_t>(player));
+				tags.push_back(tag);
+				types.push_back(dictionaries[TYPES].Add(type, typelength));
+				x.push_back(positionx);
+				y.push_back(positiony);
+
+				return true;
+			}
+
+			void Reserve(size_t rows)
+			{
+				seconds.reserve(rows);
+				players.reserve(rows);
+				tags.reserve(rows);
+				types.reserve(rows);
+				x.reserve(rows);
+				y.reserve(rows);
+			}
+
+			void Append(const ArmiesColumns& chunk, const std::vector<uint16_t>* remaps)
+			{
+				seconds.insert(seconds.end(), chunk.seconds.begin(), chunk.seconds.end());
+				players.insert(players.end(), chunk.players.begin(), chunk.players.end());
+				tags.insert(tags.end(), chunk.tags.begin(), chunk.tags.end());
+				for (uint16_t type : chunk.types)
+					types.push_back(remaps[TYPES][type]);
+				x.insert(x.end(), chunk.x.begin(), chunk.x.end());
+				y.insert(y.end(), chunk.y.begin(), chunk.y.end());
+			}
+
+			ArmiesSpans GetSpans() const
+			{
+				return { seconds, players, tags, types, x, y };
+			}
+
+			size_t GetRowCount() const
+			{
+				return seconds.size();
+			}
+		};
+
+		//The columns of CommandsRepository.csv, the commands of every player in the order that they were given
+		//A row is the second of the replay, the player, the name of the command and its category
+		struct CommandsColumns
+		{
+			typedef CommandsSpans Spans;
+			static const size_t DICTIONARYCOUNT = 2;
+			//The dictionaries of the names of the commands, and of their categories such as Economy and Army
+			static const size_t COMMANDS = 0;
+			static const size_t CATEGORIES = 1;
+
+			std::vector<uint32_t> seconds;
+			std::vector<uint16_t> players;
+			std::vector<uint16_t> commands;
+			std::vector<uint16_t> categories;
+
+			template<typename Function>
+			void ForEachColumn(Function function) const
+			{
+				function(0, seconds);
+				function(1, players);
+				function(2, commands);
+				function(3, categories);
+			}
+
+			bool ParseRow(RepositoryCursor& cursor, RepositoryDictionary* dictionaries)
+			{
+				uint32_t second = 0, player = 0;
+				const char* command = nullptr;
+				const char* category = nullptr;
+				size_t commandlength = 0, categorylength = 0;
+
+				if (!cursor.ParseUnsigned(second) || !cursor.Skip(',') || !cursor.ParseUnsigned(player) || !cursor.Skip(',') || !cursor.ParseName(command, commandlength) || !cursor.Skip(',') || !cursor.ParseName(category, categorylength))
+					return false;
+				seconds.push_back(second);
+				players.push_back(static_cast<uint16_t>(player));
+				commands.push_back(dictionaries[COMMANDS].Add(command, commandlength));
+				categories.push_back(dictionaries[CATEGORIES].Add(category, categorylength));
+
+				return true;
+			}
+
+			void Reserve(size_t rows)
+			{
+				seconds.reserve(rows);
+				players.reserve(rows);
+				commands.reserve(rows);
+				categories.reserve(rows);
+			}
+
+			void Append(const CommandsColumns& chunk, const std::vector<uint16_t>* remaps)
+			{
+				seconds.insert(seconds.end(), chunk.seconds.begin(), chunk.seconds.end());
+				players.insert(players.end(), chunk.players.begin(), chunk.players.end());
+				for (uint16_t command : chunk.commands)
+					commands.push_back(remaps[COMMANDS][command]);
+				for (uint16_t category : chunk.categories)
+					categories.push_back(remaps[CATEGORIES][category]);
+			}
+
+			CommandsSpans GetSpans() const
+			{
+				return { seconds, players, commands, categories };
+			}
+
+			size_t GetRowCount() const
+			{
+				return seconds.size();
+			}
+		};
+
+		//The columns of ResourcesRepository.csv, what every player had every ten seconds
+		//A row is the second of the replay, the player, the minerals, the vespene, the supply that is used, and the workers
+		struct ResourcesColumns
+		{
+			typedef ResourcesSpans Spans;
+			static const size_t DICTIONARYCOUNT = 0;
+
+			std::vector<uint32_t> seconds;
+			std::vector<uint16_t> players;
+			std::vector<uint32_t> minerals;
+			std::vector<uint32_t> vespene;
+			std::vector<uint16_t> supplies;
+			std::vector<uint16_t> workers;
+
+			template<typename Function>
+			void ForEachColumn(Function function) const
+			{
+				function(0, seconds);
+				function(1, players);
+				function(2, minerals);
+				function(3, vespene);
+				function(4, supplies);
+				function(5, workers);
+			}
+
+			bool ParseRow(RepositoryCursor& cursor, RepositoryDictionary*)
+			{
+				uint32_t second = 0, player = 0, mineral = 0, gas = 0, supply = 0, worker = 0;
+
+				if (!cursor.ParseUnsigned(second) || !cursor.Skip(',') || !cursor.ParseUnsigned(player) || !cursor.Skip(',') || !cursor.ParseUnsigned(mineral) || !cursor.Skip(',') || !cursor.ParseUnsigned(gas) || !cursor.Skip(',') || !cursor.ParseUnsigned(supply) || !cursor.Skip(',') || !cursor.ParseUnsigned(worker))
+					return false;
+				seconds.push_back(second);
+				players.push_back(static_cast<uint16_t>(player));
+				minerals.push_back(mineral);
+				vespene.push_back(gas);
+				supplies.push_back(static_cast<uint16_t>(supply));
+				workers.push_back(static_cast<uint16_t>(worker));
+
+				return true;
+			}
+
+			void Reserve(size_t rows)
+			{
+				seconds.reserve(rows);
+				players.reserve(rows);
+				minerals.reserve(rows);
+				vespene.reserve(rows);
+				supplies.reserve(rows);
+				workers.reserve(rows);
+			}
+
+			void Append(const ResourcesColumns& chunk, const std::vector<uint16_t>*)
+			{
+				seconds.insert(seconds.end(), chunk.seconds.begin(), chunk.seconds.end());
+				players.insert(players.end(), chunk.players.begin(), chunk.players.end());
+				minerals.insert(minerals.end(), chunk.minerals.begin(), chunk.minerals.end());
+				vespene.insert(vespene.end(), chunk.vespene.begin(), chunk.vespene.end());
+				supplies.insert(supplies.end(), chunk.supplies.begin(), chunk.supplies.end());
+				workers.insert(workers.end(), chunk.workers.begin(), chunk.workers.end());
+			}
+
+			ResourcesSpans GetSpans() const
+			{
+				return { seconds, players, minerals, vespene, supplies, workers };
+			}
+
+			size_t GetRowCount() const
+			{
+				return seconds.size();
+			}
+		};
+
+		typedef ColumnarRepository<ArmiesColumns> ArmiesRepository;
+		typedef ColumnarRepository<CommandsColumns> CommandsRepository;
+		typedef ColumnarRepository<ResourcesColumns> ResourcesRepository;
+	}
+}
@@ -0,0 +1,416 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "../Types/MappedFile.h"
+#include "ColumnarRepository.h"
+
+namespace KoKeKoKo
+{
+	namespace Repository
+	{
+		//The first bytes of a cache, and the version of its layout that is written and read, a cache of another version is not read
+		const char REPOSITORYCACHE_MAGIC[8] = { 'K', 'O', 'K', 'E', 'R', 'E', 'P', 'O' };
+		const uint32_t REPOSITORYCACHE_VERSION = 1;
+		//Every block starts on a cache line, so a column can be read with aligned loads
+		const size_t REPOSITORYCACHE_ALIGNMENT = 64;
+		//The blocks of a repository other than its columns, the columns are the blocks from zero in the order of the columns type
+		const uint32_t REPOSITORYCACHE_RANKS = 16;
+		const uint32_t REPOSITORYCACHE_REPLAYS = 17;
+		const uint32_t REPOSITORYCACHE_NAMES = 18;
+		//The blocks of the dictionaries, the offsets and then the characters of each dictionary in turn
+		const uint32_t REPOSITORYCACHE_DICTIONARIES = 32;
+		//The blocks of a repository are numbered from its index times this
+		const uint32_t REPOSITORYCACHE_REPOSITORYBLOCKS = 256;
+
+		//The repositories of a cache, in the order that they are written
+		enum class CachedRepository : uint32_t
+		{
+			Armies,
+			Commands,
+			Resources,
+			COUNT
+		};
+
+		//The start of a cache, the file is little-endian like the machines that the agent runs on
+		struct RepositoryCacheHeader
+		{
+			char magic[8];
+			uint32_t version;
+			uint32_t blockcount;
+			uint64_t size;
+			//The checksum of everything after the header
+			uint64_t checksum;
+		};
+
+		//Where a block is in the cache, the header is followed by the table of the blocks
+		struct RepositoryCacheBlock
+		{
+			uint32_t id;
+			uint32_t elementsize;
+			uint64_t offset;
+			uint64_t count;
+		};
+
+		//A rank and a replay of a repository as the cache has them, the names are in the names block of the repository
+		struct CachedRank
+		{
+			uint32_t nameoffset;
+			uint32_t namelength;
+			uint32_t firstreplay;
+			uint32_t replaycount;
+		};
+
+		struct CachedReplay
+		{
+			uint32_t nameoffset;
+			uint32_t namelength;
+			uint32_t rank;
+			uint32_t firstrow;
+			uint32_t rowcount;
+			uint32_t endrow;
+		};
+
+		//A dictionary of a repository as the cache has it, the name of an index is between its offset and the next one
+		class CachedDictionary
+		{
+			private:
+				RepositorySpan<uint32_t> _offsets;
+				RepositorySpan<char> _characters;
+
+			public:
+				CachedDictionary()
+				{
+
+				}
+
+				CachedDictionary(RepositorySpan<uint32_t> offsets, RepositorySpan<char> characters) : _offsets(offsets), _characters(characters)
+				{
+
+				}
+
+				std::string GetName(uint16_t index) const
+				{
+					return std::string(_characters.GetData() + _offsets[index], _offsets[index + 1] - _offsets[index]);
+				}
+
+				//Returns the index of the name, or -1 if it is not in the dictionary
+				int32_t Find(const std::string& name) const
+				{
+					for (size_t index = 0; index < GetCount(); index++)
+						if ((_offsets[index + 1] - _offsets[index]) == name.size() && std::memcmp(_characters.GetData() + _offsets[index], name.data(), name.size()) == 0)
+							return static_cast<int32_t>(index);
+
+					return -1;
+				}
+
+				size_t GetCount() const
+				{
+					return (_offsets.GetCount() > 0) ? (_offsets.GetCount() - 1) : 0;
+				}
+		};
+
+		//The Armies, Commands and Resources repositories in one file that is mapped and read in place
+		//The columns, the dictionaries and the index of the ranks and replays are blocks of the file, so opening a cache only checks it and nothing is parsed
+		class RepositoryCache
+		{
+			private:
+				//The blocks of a repository that are found when the cache is opened
+				struct Section
+				{
+					RepositorySpan<CachedRank> ranks;
+					RepositorySpan<CachedReplay> replays;
+					RepositorySpan<char> names;
+					std::vector<CachedDictionary> dictionaries;
+				};
+
+				//The blocks of a cache while it is written, every block is padded to the alignment
+				class Writer
+				{
+					private:
+						std::vector<RepositoryCacheBlock> _blocks;
+						std::vector<char> _data;
+
+					public:
+						template<typename T>
+						void Add(uint32_t id, const T* values, size_t count)
+						{
+							RepositoryCacheBlock block;
+
+							block.id = id;
+							block.elementsize = sizeof(T);
+							block.offset = _data.size();
+							block.count = count;
+							_blocks.push_back(block);
+							if (count > 0)
+								_data.insert(_data.end(), reinterpret_cast<const char*>(values), reinterpret_cast<const char*>(values + count));
+							_data.resize((_data.size() + REPOSITORYCACHE_ALIGNMENT - 1) & ~(REPOSITORYCACHE_ALIGNMENT - 1), 0);
+						}
+
+						//Returns the whole file, the offsets of the blocks are moved past the header and the table
+						std::vector<char> GetFile()
+						{
+							const size_t tablesize = sizeof(RepositoryCacheHeader) + (_blocks.size() * sizeof(RepositoryCacheBlock));
+							const size_t datastart = (tablesize + REPOSITORYCACHE_ALIGNMENT - 1) & ~(REPOSITORYCACHE_ALIGNMENT - 1);
+							std::vector<char> file(datastart + _data.size(), 0);
+							RepositoryCacheHeader header;
+
+							for (auto& block : _blocks)
+								block.offset += datastart;
+							std::memcpy(file.data() + sizeof(RepositoryCacheHeader), _blocks.data(), _blocks.size() * sizeof(RepositoryCacheBlock));
+							if (!_data.empty())
+								std::memcpy(file.data() + datastart, _data.data(), _data.size());
+							std::memcpy(header.magic, REPOSITORYCACHE_MAGIC, sizeof(header.magic));
+							header.version = REPOSITORYCACHE_VERSION;
+							header.blockcount = static_cast<uint32_t>(_blocks.size());
+							header.size = file.size();
+							header.checksum = GetChecksum(file.data() + sizeof(RepositoryCacheHeader), file.size() - sizeof(RepositoryCacheHeader));
+							std::memcpy(file.data(), &header, sizeof(header));
+
+							return file;
+						}
+				};
+
+				std::unique_ptr<Types::MappedFile> _file;
+				const RepositoryCacheBlock* _blocks;
+				uint32_t _blockcount;
+				Section _sections[static_cast<size_t>(CachedRepository::COUNT)];
+				ArmiesSpans _armies;
+				CommandsSpans _commands;
+				ResourcesSpans _resources;
+
+				RepositoryCache(const RepositoryCache&);
+				RepositoryCache& operator=(const RepositoryCache&);
+
+				static uint32_t GetBlockId(CachedRepository repository, uint32_t block)
+				{
+					return (static_cast<uint32_t>(repository) * REPOSITORYCACHE_REPOSITORYBLOCKS) + block;
+				}
+
+				//Adds the columns, the index and the dictionaries of a repository to a cache that is written
+				template<typename Columns>
+				static void AddRepository(Writer& writer, CachedRepository repository, const ColumnarRepository<Columns>& source)
+				{
+					std::vector<CachedRank> ranks;
+					std::vector<CachedReplay> replays;
+					std::vector<char> names;
+
+					source.GetColumns().ForEachColumn([&writer, repository](size_t index, const auto& column)
+					{
+						writer.Add(GetBlockId(repository, static_cast<uint32_t>(index)), column.data(), column.size());
+					});
+					for (const auto& rank : source.GetRanks())
+					{
+						ranks.push_back({ static_cast<uint32_t>(names.size()), static_cast<uint32_t>(rank.name.size()), rank.firstreplay, rank.replaycount });
+						names.insert(names.end(), rank.name.begin(), rank.name.end());
+					}
+					for (const auto& replay : source.GetReplays())
+					{
+						replays.push_back({ static_cast<uint32_t>(names.size()), static_cast<uint32_t>(replay.filename.size()), replay.rank, replay.firstrow, replay.rowcount, replay.endrow });
+						names.insert(names.end(), replay.filename.begin(), replay.filename.end());
+					}
+					writer.Add(GetBlockId(repository, REPOSITORYCACHE_RANKS), ranks.data(), ranks.size());
+					writer.Add(GetBlockId(repository, REPOSITORYCACHE_REPLAYS), replays.data(), replays.size());
+					writer.Add(GetBlockId(repository, REPOSITORYCACHE_NAMES), names.data(), names.size());
+					for (size_t dictionary = 0; dictionary < Columns::DICTIONARYCOUNT; dictionary++)
+					{
+						const RepositoryDictionary& entries = source.GetDictionary(dictionary);
+						std::vector<uint32_t> offsets(1, 0);
+						std::vector<char> characters;
+
+						for (size_t index = 0; index < entries.GetCount(); index++)
+						{
+							const std::string& name = entries.GetName(static_cast<uint16_t>(index));
+
+							characters.insert(characters.end(), name.begin(), name.end());
+							offsets.push_back(static_cast<uint32_t>(characters.size()));
+						}
+						writer.Add(GetBlockId(repository, REPOSITORYCACHE_DICTIONARIES + static_cast<uint32_t>(dictionary * 2)), offsets.data(), offsets.size());
+						writer.Add(GetBlockId(repository, REPOSITORYCACHE_DICTIONARIES + static_cast<uint32_t>(dictionary * 2) + 1), characters.data(), characters.size());
+					}
+				}
+
+				//Returns the values of a block, the cache is not read if a block is missing or does not fit in the file
+				template<typename T>
+				RepositorySpan<T> GetBlock(CachedRepository repository, uint32_t block) const
+				{
+					const uint32_t id = GetBlockId(repository, block);
+
+					for (uint32_t index = 0; index < _blockcount; index++)
+					{
+						const RepositoryCacheBlock& entry = _blocks[index];
+
+						if (entry.id != id)
+							continue;
+						if (entry.elementsize != sizeof(T) || (entry.offset % alignof(T)) != 0 || entry.offset > _file->GetSize() || entry.count > ((_file->GetSize() - entry.offset) / sizeof(T)))
+							throw std::runtime_error("Error Occurred! A block of the repository cache does not fit its file...");
+						return RepositorySpan<T>(reinterpret_cast<const T*>(_file->GetData() + entry.offset), static_cast<size_t>(entry.count));
+					}
+
+					throw std::runtime_error("Error Occurred! The repository cache is missing a block...");
+				}
+
+				template<typename Spans>
+				void OpenRepository(CachedRepository repository, Spans& spans, size_t dictionarycount)
+				{
+					Section& section = _sections[static_cast<size_t>(repository)];
+
+					spans.ForEachColumn([this, repository, &spans](size_t index, auto& span)
+					{
+						span = GetBlock<typename std::decay<decltype(span)>::type::ValueType>(repository, static_cast<uint32_t>(index));
+						if (span.GetCount() != spans.seconds.GetCount())
+							throw std::runtime_error("Error Occurred! The columns of the repository cache do not have the same rows...");
+					});
+					section.ranks = GetBlock<CachedRank>(repository, REPOSITORYCACHE_RANKS);
+					section.replays = GetBlock<CachedReplay>(repository, REPOSITORYCACHE_REPLAYS);
+					section.names = GetBlock<char>(repository, REPOSITORYCACHE_NAMES);
+					section.dictionaries.clear();
+					for (size_t dictionary = 0; dictionary < dictionarycount; dictionary++)
+					{
+						RepositorySpan<uint32_t> offsets = GetBlock<uint32_t>(repository, REPOSITORYCACHE_DICTIONARIES + static_cast<uint32_t>(dictionary * 2));
+						RepositorySpan<char> characters = GetBlock<char>(repository, REPOSITORYCACHE_DICTIONARIES + static_cast<uint32_t>(dictionary * 2) + 1);
+
+						if (offsets.GetCount() == 0 || offsets[0] != 0 || offsets[offsets.GetCount() - 1] != characters.GetCount() || !std::is_sorted(offsets.begin(), offsets.end()))
+							throw std::runtime_error("Error Occurred! A dictionary of the repository cache does not fit its block...");
+						section.dictionaries.emplace_back(offsets, characters);
+					}
+					//The index is checked once here, so the rows of a replay can be read without checking them again
+					for (const auto& rank : section.ranks)
+						if (rank.firstreplay > section.replays.GetCount() || rank.replaycount > (section.replays.GetCount() - rank.firstreplay))
+							throw std::runtime_error("Error Occurred! A rank of the repository cache does not fit its replays...");
+					for (const auto& replay : section.replays)
+						if (replay.rank >= section.ranks.GetCount() || replay.firstrow > spans.GetRowCount() || replay.rowcount > (spans.GetRowCount() - replay.firstrow) || replay.endrow < replay.firstrow || replay.endrow > (replay.firstrow + replay.rowcount))
+							throw std::runtime_error("Error Occurred! A replay of the repository cache does not fit its rows...");
+				}
+
+				std::string GetName(CachedRepository repository, uint32_t offset, uint32_t length) const
+				{
+					const Section& section = _sections[static_cast<size_t>(repository)];
+
+					if (static_cast<uint64_t>(offset) + length > section.names.GetCount())
+						throw std::runtime_error("Error Occurred! A name of the repository cache does not fit its block...");
+
+					return std::string(section.names.GetData() + offset, length);
+				}
+
+			public:
+				RepositoryCache() : _blocks(nullptr), _blockcount(0)
+				{
+
+				}
+
+				//Returns the checksum of a cache, it mixes in eight bytes at a time so checking it costs little next to reading the pages
+				static uint64_t GetChecksum(const char* data, size_t size)
+				{
+					uint64_t checksum = 0xCBF29CE484222325ull;
+					size_t index = 0;
+
+					for (; (index + sizeof(uint64_t)) <= size; index += sizeof(uint64_t))
+					{
+						uint64_t word;
+
+						std::memcpy(&word, data + index, sizeof(word));
+						checksum = (checksum ^ word) * 0x100000001B3ull;
+						checksum ^= checksum >> 29;
+					}
+					for (; index < size; index++)
+						checksum = (checksum ^ static_cast<uint8_t>(data[index])) * 0x100000001B3ull;
+
+					return checksum;
+				}
+
+				//Writes the repositories into a cache, the file is replaced
+				static void Write(const std::string& path, const ArmiesRepository& armies, const CommandsRepository& commands, const ResourcesRepository& resources)
+				{
+					Writer writer;
+
+					AddRepository(writer, CachedRepository::Armies, armies);
+					AddRepository(writer, CachedRepository::Commands, commands);
+					AddRepository(writer, CachedRepository::Resources, resources);
+
+					std::vector<char> file = writer.GetFile();
+					std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+					if (!stream.write(file.data(), static_cast<std::streamsize>(file.size())) || !stream.flush())
+						throw std::runtime_error("Error Occurred! Failed to write the repository cache to " + path + "...");
+				}
+
+				//Maps the cache and finds its blocks, the checksum is only checked if asked since it reads every page of the file
+				void Open(const std::string& path, bool ischecked = true)
+				{
+					RepositoryCacheHeader header;
+
+					_file.reset(new Types::MappedFile(path));
+					if (_file->GetSize() < sizeof(RepositoryCacheHeader))
+						throw std::runtime_error("Error Occurred! " + path + " is too small to be a repository cache...");
+					std::memcpy(&header, _file->GetData(), sizeof(header));
+					if (std::memcmp(header.magic, REPOSITORYCACHE_MAGIC, sizeof(header.magic)) != 0)
+						throw std::runtime_error("Error Occurred! " + path + " is not a repository cache...");
+					if (header.version != REPOSITORYCACHE_VERSION)
+						throw std::runtime_error("Error Occurred! " + path + " is a repository cache of another version...");
+					if (header.size != _file->GetSize() || header.blockcount > ((_file->GetSize() - sizeof(RepositoryCacheHeader)) / sizeof(RepositoryCacheBlock)))
+						throw std::runtime_error("Error Occurred! " + path + " has been cut short...");
+					if (ischecked && header.checksum != GetChecksum(_file->GetData() + sizeof(RepositoryCacheHeader), _file->GetSize() - sizeof(RepositoryCacheHeader)))
+						throw std::runtime_error("Error Occurred! The checksum of " + path + " does not match...");
+
+					_blocks = reinterpret_cast<const RepositoryCacheBlock*>(_file->GetData() + sizeof(RepositoryCacheHeader));
+					_blockcount = header.blockcount;
+					OpenRepository(CachedRepository::Armies, _armies, ArmiesColumns::DICTIONARYCOUNT);
+					OpenRepository(CachedRepository::Commands, _commands, CommandsColumns::DICTIONARYCOUNT);
+					OpenRepository(CachedRepository::Resources, _resources, ResourcesColumns::DICTIONARYCOUNT);
+				}
+
+				//The columns of the repositories, they are valid for as long as the cache is open
+				const ArmiesSpans& GetArmies() const
+				{
+					return _armies;
+				}
+
+				const CommandsSpans& GetCommands() const
+				{
+					return _commands;
+				}
+
+				const ResourcesSpans& GetResources() const
+				{
+					return _resources;
+				}
+
+				const CachedDictionary& GetDictionary(CachedRepository repository, size_t dictionary) const
+				{
+					return _sections[static_cast<size_t>(repository)].dictionaries[dictionary];
+				}
+
+				RepositorySpan<CachedRank> GetRanks(CachedRepository repository) const
+				{
+					return _sections[static_cast<size_t>(repository)].ranks;
+				}
+
+				RepositorySpan<CachedReplay> GetReplays(CachedRepository repository) const
+				{
+					return _sections[static_cast<size_t>(repository)].replays;
+				}
+
+				std::string GetRankName(CachedRepository repository, size_t rank) const
+				{
+					const CachedRank& entry = _sections[static_cast<size_t>(repository)].ranks[rank];
+
+					return GetName(repository, entry.nameoffset, entry.namelength);
+				}
+
+				std::string GetReplayFilename(CachedRepository repository, size_t replay) const
+				{
+					const CachedReplay& entry = _sections[static_cast<size_t>(repository)].replays[replay];
+
+					return GetName(repository, entry.nameoffset, entry.namelength);
+				}
+		};
+	}
+}
@@ -0,0 +1,385 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "ColumnarRepository.h"
+#include "RepositoryCache.h"
+#include "../Types/WorkStealingPool.h"
+
+namespace KoKeKoKo
+{
+	namespace Repository
+	{
+		//The row of a joined record that has no row of that repository
+		const uint32_t REPOSITORYJOIN_NOROW = std::numeric_limits<uint32_t>::max();
+
+		//The rows of a replay in one of the repositories, the rows from the end row on are the units that survived the battle
+		struct RepositoryJoinRange
+		{
+			uint32_t firstrow;
+			uint32_t endrow;
+			uint32_t lastrow;
+		};
+
+		//A replay of the resources repository with its rows in each of the three repositories, a repository without the replay has an empty range
+		struct RepositoryJoinReplay
+		{
+			uint32_t resourcesreplay;
+			RepositoryJoinRange armies;
+			RepositoryJoinRange commands;
+			RepositoryJoinRange resources;
+		};
+
+		//The columns of the three repositories that are joined, from the repositories or from a cache
+		struct RepositoryJoinSources
+		{
+			ArmiesSpans armies;
+			CommandsSpans commands;
+			ResourcesSpans resources;
+		};
+
+		//A command or a unit of a replay with the resources of the player at that time, the rows index the columns of the sources
+		struct RepositoryJoinedRecord
+		{
+			enum class Kind : uint8_t
+			{
+				Command,
+				Army,
+				Survivor
+			};
+
+			uint32_t replay;
+			uint32_t second;
+			uint16_t player;
+			Kind kind;
+			//The first sample of the resources of the player at or after the second, as the model service relates them, or no row if the replay has no later sample
+			uint32_t resourcesrow;
+			//The command of the record, or the last command of the player before the unit
+			uint32_t commandsrow;
+			//The unit of the record, or the last unit of the player before the command
+			uint32_t armiesrow;
+		};
+
+		//Walks the rows of one replay in the order of their seconds and gives a joined record for each command and unit
+		//Every repository has the rows of a replay sorted for each player, so the rows are split into sorted runs and the runs are merged with a heap
+		//A record waits until the next sample of the resources of its player is reached, so the records of a player come in the order of their seconds
+		class RepositoryJoinCursor
+		{
+			private:
+				//The sources in the order that the rows of the same second are taken, so a sample of the resources comes after the commands and units of its second
+				enum class Source : uint8_t
+				{
+					Commands,
+					Armies,
+					Survivors,
+					Resources
+				};
+
+				struct Run
+				{
+					Source source;
+					uint32_t row;
+					uint32_t end;
+				};
+
+				//What is known of a player so far, and its records that wait for the next sample of its resources
+				struct Player
+				{
+					uint32_t commandsrow;
+					uint32_t armiesrow;
+					std::vector<RepositoryJoinedRecord> waiting;
+				};
+
+				const RepositoryJoinSources& _sources;
+				const uint32_t _replay;
+				std::vector<Run> _runs;
+				//The indexes of the runs that still have rows, as a heap of the run with the earliest row
+				std::vector<uint32_t> _heap;
+				std::vector<Player> _players;
+				std::vector<RepositoryJoinedRecord> _ready;
+				size_t _nextready;
+
+				RepositoryJoinCursor(const RepositoryJoinCursor&);
+				RepositoryJoinCursor& operator=(const RepositoryJoinCursor&);
+
+				const RepositorySpan<uint32_t>& GetSeconds(Source source) const
+				{
+					switch (source)
+					{
+						case Source::Commands:
+							return _sources.commands.seconds;
+						case Source::Resources:
+							return _sources.resources.seconds;
+						default:
+							return _sources.armies.seconds;
+					}
+				}
+
+				const RepositorySpan<uint16_t>& GetPlayers(Source source) const
+				{
+					switch (source)
+					{
+						case Source::Commands:
+							return _sources.commands.players;
+						case Source::Resources:
+							return _sources.resources.players;
+						default:
+							return _sources.armies.players;
+					}
+				}
+
+				//Splits the rows into runs of one player where the seconds do not go back
+				void AddRuns(Source source, uint32_t firstrow, uint32_t lastrow)
+				{
+					const RepositorySpan<uint32_t>& seconds = GetSeconds(source);
+					const RepositorySpan<uint16_t>& players = GetPlayers(source);
+
+					for (uint32_t row = firstrow; row < lastrow; )
+					{
+						uint32_t end = row + 1;
+
+						while (end < lastrow && players[end] == players[row] && seconds[end] >= seconds[end - 1])
+							end++;
+						_runs.push_back({ source, row, end });
+						row = end;
+					}
+				}
+
+				//Returns true if the run comes after the other one, for the heap that keeps the earliest run on top
+				bool IsLater(uint32_t run, uint32_t other) const
+				{
+					const uint32_t second = GetSeconds(_runs[run].source)[_runs[run].row], othersecond = GetSeconds(_runs[other].source)[_runs[other].row];
+
+					if (second != othersecond)
+						return second > othersecond;
+					if (_runs[run].source != _runs[other].source)
+						return _runs[run].source > _runs[other].source;
+
+					return run > other;
+				}
+
+				Player& GetPlayer(uint16_t player)
+				{
+					if (player >= _players.size())
+						_players.resize(static_cast<size_t>(player) + 1, { REPOSITORYJOIN_NOROW, REPOSITORYJOIN_NOROW, std::vector<RepositoryJoinedRecord>() });
+
+					return _players[player];
+				}
+
+				//Gives the waiting records of the player the sample of its resources
+				void Release(Player& player, uint32_t resourcesrow)
+				{
+					for (auto& record : player.waiting)
+					{
+						record.resourcesrow = resourcesrow;
+						_ready.push_back(record);
+					}
+					player.waiting.clear();
+				}
+
+				//Takes the earliest row of the runs, and returns false if every run has been taken
+				bool Take()
+				{
+					if (_heap.empty())
+						return false;
+
+					auto islater = [this](uint32_t run, uint32_t other) { return IsLater(run, other); };
+					std::pop_heap(_heap.begin(), _heap.end(), islater);
+					Run& run = _runs[_heap.back()];
+					const uint32_t row = run.row;
+					const uint16_t playerindex = GetPlayers(run.source)[row];
+					Player& player = GetPlayer(playerindex);
+					RepositoryJoinedRecord record = { _replay, GetSeconds(run.source)[row], playerindex, RepositoryJoinedRecord::Kind::Command, REPOSITORYJOIN_NOROW, player.commandsrow, player.armiesrow };
+
+					switch (run.source)
+					{
+						case Source::Commands:
+							record.commandsrow = player.commandsrow = row;
+							player.waiting.push_back(record);
+							break;
+						case Source::Armies:
+							record.kind = RepositoryJoinedRecord::Kind::Army;
+							record.armiesrow = player.armiesrow = row;
+							player.waiting.push_back(record);
+							break;
+						case Source::Survivors:
+							record.kind = RepositoryJoinedRecord::Kind::Survivor;
+							record.armiesrow = row;
+							player.waiting.push_back(record);
+							break;
+						case Source::Resources:
+							Release(player, row);
+							break;
+					}
+
+					if (++run.row < run.end)
+						std::push_heap(_heap.begin(), _heap.end(), islater);
+					else
+						_heap.pop_back();
+
+					return true;
+				}
+
+			public:
+				RepositoryJoinCursor(const RepositoryJoinSources& sources, const RepositoryJoinReplay& replay, uint32_t replayindex) : _sources(sources), _replay(replayindex)
+				{
+					_nextready = 0;
+					AddRuns(Source::Commands, replay.commands.firstrow, replay.commands.lastrow);
+					AddRuns(Source::Armies, replay.armies.firstrow, replay.armies.endrow);
+					AddRuns(Source::Survivors, replay.armies.endrow, replay.armies.lastrow);
+					AddRuns(Source::Resources, replay.resources.firstrow, replay.resources.lastrow);
+					for (uint32_t run = 0; run < _runs.size(); run++)
+						_heap.push_back(run);
+					std::make_heap(_heap.begin(), _heap.end(), [this](uint32_t run, uint32_t other) { return IsLater(run, other); });
+				}
+
+				//Gives the next joined record, and returns false once the replay has no more
+				bool Next(RepositoryJoinedRecord& record)
+				{
+					while (_nextready == _ready.size())
+					{
+						_ready.clear();
+						_nextready = 0;
+						if (!Take())
+						{
+							//The records after the last sample of the resources have none
+							for (auto& player : _players)
+								Release(player, REPOSITORYJOIN_NOROW);
+							if (_ready.empty())
+								return false;
+						}
+					}
+					record = _ready[_nextready++];
+
+					return true;
+				}
+		};
+
+		//Relates the rows of the three repositories that were recorded from the same replay, like the relations of the model service
+		//A replay of the resources repository is matched with the replay of the same rank and filename in the other two, and nothing is copied from the columns
+		class RepositoryJoin
+		{
+			private:
+				RepositoryJoinSources _sources;
+				std::vector<RepositoryJoinReplay> _replays;
+
+				RepositoryJoin(const RepositoryJoin&);
+				RepositoryJoin& operator=(const RepositoryJoin&);
+
+				template<typename Replay>
+				static RepositoryJoinRange GetRange(const Replay& replay)
+				{
+					return { replay.firstrow, replay.endrow, replay.firstrow + replay.rowcount };
+				}
+
+				//Adds the range of a replay by its key, the rank and the filename of the replay and how many replays before it have both
+				//The repositories have a few replays that were recorded twice, the first of them is matched with the first in the other repositories and so on
+				static void AddRange(std::vector<std::pair<std::string, RepositoryJoinRange>>& ranges, std::unordered_map<std::string, uint32_t>& occurrences, const std::string& rank, const std::string& filename, const RepositoryJoinRange& range)
+				{
+					std::string key = rank + '\n' + filename;
+
+					ranges.emplace_back(key + '\n' + std::to_string(occurrences[key]++), range);
+				}
+
+				template<typename Columns>
+				static std::vector<std::pair<std::string, RepositoryJoinRange>> GetRanges(const ColumnarRepository<Columns>& repository)
+				{
+					std::vector<std::pair<std::string, RepositoryJoinRange>> ranges;
+					std::unordered_map<std::string, uint32_t> occurrences;
+
+					for (const auto& replay : repository.GetReplays())
+						AddRange(ranges, occurrences, repository.GetRanks()[replay.rank].name, replay.filename, GetRange(replay));
+
+					return ranges;
+				}
+
+				static std::vector<std::pair<std::string, RepositoryJoinRange>> GetRanges(const RepositoryCache& cache, CachedRepository repository)
+				{
+					std::vector<std::pair<std::string, RepositoryJoinRange>> ranges;
+					std::unordered_map<std::string, uint32_t> occurrences;
+					RepositorySpan<CachedReplay> replays = cache.GetReplays(repository);
+
+					for (size_t replay = 0; replay < replays.GetCount(); replay++)
+						AddRange(ranges, occurrences, cache.GetRankName(repository, replays[replay].rank), cache.GetReplayFilename(repository, replay), GetRange(replays[replay]));
+
+					return ranges;
+				}
+
+				//Joins every replay of the resources with the replays of the armies and the commands that have the same key
+				void Match(const std::vector<std::pair<std::string, RepositoryJoinRange>>& armies, const std::vector<std::pair<std::string, RepositoryJoinRange>>& commands, const std::vector<std::pair<std::string, RepositoryJoinRange>>& resources)
+				{
+					const RepositoryJoinRange empty = { 0, 0, 0 };
+					std::unordered_map<std::string, RepositoryJoinRange> armiesbykey(armies.begin(), armies.end()), commandsbykey(commands.begin(), commands.end());
+
+					_replays.clear();
+					_replays.reserve(resources.size());
+					for (size_t replay = 0; replay < resources.size(); replay++)
+					{
+						auto army = armiesbykey.find(resources[replay].first);
+						auto command = commandsbykey.find(resources[replay].first);
+
+						_replays.push_back({ static_cast<uint32_t>(replay), (army != armiesbykey.end()) ? army->second : empty, (command != commandsbykey.end()) ? command->second : empty, resources[replay].second });
+					}
+				}
+
+			public:
+				//Joins loaded repositories, they have to stay loaded for as long as the join is used
+				RepositoryJoin(const ArmiesRepository& armies, const CommandsRepository& commands, const ResourcesRepository& resources)
+				{
+					_sources = { armies.GetSpans(), commands.GetSpans(), resources.GetSpans() };
+					Match(GetRanges(armies), GetRanges(commands), GetRanges(resources));
+				}
+
+				//Joins the repositories of an open cache, it has to stay open for as long as the join is used
+				RepositoryJoin(const RepositoryCache& cache)
+				{
+					_sources = { cache.GetArmies(), cache.GetCommands(), cache.GetResources() };
+					Match(GetRanges(cache, CachedRepository::Armies), GetRanges(cache, CachedRepository::Commands), GetRanges(cache, CachedRepository::Resources));
+				}
+
+				//Calls the function with every joined record, the replays are joined in parallel on a thread for each core unless told otherwise
+				//The records of a replay come from one thread in the order of the cursor, the function is called from several threads at once and keeps what it needs
+				//Nothing is collected, so the memory that the join uses grows with the rows of the replays that are being joined and not with the repositories
+				template<typename Function>
+				void ForEach(Function function, size_t threads = 0) const
+				{
+					auto join = [this, &function](uint32_t replay)
+					{
+						RepositoryJoinCursor cursor(_sources, _replays[replay], replay);
+						RepositoryJoinedRecord record;
+
+						while (cursor.Next(record))
+							function(record);
+					};
+
+					if (threads == 1)
+					{
+						for (uint32_t replay = 0; replay < _replays.size(); replay++)
+							join(replay);
+						return;
+					}
+
+					Types::WorkStealingPool pool(threads);
+					for (uint32_t replay = 0; replay < _replays.size(); replay++)
+						pool.Submit([&join, replay]() { join(replay); });
+					pool.WaitForIdle();
+				}
+
+				const RepositoryJoinSources& GetSources() const
+				{
+					return _sources;
+				}
+
+				const std::vector<RepositoryJoinReplay>& GetReplays() const
+				{
+					return _replays;
+				}
+		};
+	}
+}
@@ -0,0 +1,1331 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <sc2api/sc2_api.h>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "../Agent/Action.h"
+#include "../Agent/ActionProvider.h"
+#include "../Agent/PlannerActionProvider.h"
+#include "../Agent/TerranData.h"
+#include "../Repository/ColumnarRepository.h"
+#include "../Repository/RepositoryJoin.h"
+#include "../Types/Logger.h"
+
+namespace KoKeKoKo
+{
+	namespace Simulation
+	{
+		using namespace sc2;
+
+		//The game loops in a second of the repositories, the replays were recorded on the normal speed
+		const uint32_t SIMULATION_GAMELOOPSPERSECOND = 16;
+		//The workers that every player starts with, the repositories only have the ones that were trained
+		const uint32_t SIMULATION_STARTWORKERS = 12;
+		//The mineral fields and vespene geysers around every start location, and what they hold
+		const uint32_t SIMULATION_MINERALFIELDS = 8;
+		const uint32_t SIMULATION_VESPENEGEYSERS = 2;
+		const int SIMULATION_MINERALCONTENTS = 1800;
+		const int SIMULATION_VESPENECONTENTS = 2250;
+		//The player of the resources, the same as in the game
+		const int SIMULATION_NEUTRALPLAYER = 16;
+		//The most supply of a player
+		const int32_t SIMULATION_MAXIMUMFOOD = 200;
+		//The game loops that an order of the agent is carried out for before its unit is idle again, an order to harvest is carried out until the unit gets another
+		const uint32_t SIMULATION_ORDERLOOPS = 5 * SIMULATION_GAMELOOPSPERSECOND;
+		//The first tag of the units that the simulation adds, far above the tags of the replays
+		const Tag SIMULATION_FIRSTTAG = 1ULL << 48;
+		//The actions of the replay that can wait for the agent, and how long the provider waits between two snapshots
+		const size_t SIMULATION_MAXIMUMQUEUEDACTIONS = 256;
+		const std::chrono::milliseconds SIMULATION_DECISIONINTERVAL = std::chrono::milliseconds(1);
+
+		//A unit type that the simulation knows, by its name in ArmiesRepository.csv
+		struct SimulationUnitType
+		{
+			const char* name;
+			UNIT_TYPEID type;
+			//The ability that has produced a unit of the type, as the orders of the agent name it
+			ABILITY_ID ability;
+			//What the unit is in the macro of the agent, the structures are started by the commands of the replays
+			Agent::MacroUnit macrounit;
+			float foodrequired;
+			float foodprovided;
+		};
+
+		//The units of the replays and the structures of the macro, the morphs of a unit are produced by the ability of the unit
+		constexpr SimulationUnitType SIMULATION_UNITTYPES[] =
+		{
+			{ "TERRAN_SCV", UNIT_TYPEID::TERRAN_SCV, ABILITY_ID::TRAIN_SCV, Agent::MacroUnit::SCV, 1, 0 },
+			{ "TERRAN_MULE", UNIT_TYPEID::TERRAN_MULE, ABILITY_ID::EFFECT_CALLDOWNMULE, Agent::MacroUnit::NONE, 0, 0 },
+			{ "TERRAN_MARINE", UNIT_TYPEID::TERRAN_MARINE, ABILITY_ID::TRAIN_MARINE, Agent::MacroUnit::ARMY, 1, 0 },
+			{ "TERRAN_REAPER", UNIT_TYPEID::TERRAN_REAPER, ABILITY_ID::TRAIN_REAPER, Agent::MacroUnit::ARMY, 1, 0 },
+			{ "TERRAN_MARAUDER", UNIT_TYPEID::TERRAN_MARAUDER, ABILITY_ID::TRAIN_MARAUDER, Agent::MacroUnit::ARMY, 2, 0 },
+			{ "TERRAN_GHOST", UNIT_TYPEID::TERRAN_GHOST, ABILITY_ID::TRAIN_GHOST, Agent::MacroUnit::ARMY, 2, 0 },
+			{ "TERRAN_HELLION", UNIT_TYPEID::TERRAN_HELLION, ABILITY_ID::TRAIN_HELLION, Agent::MacroUnit::ARMY, 2, 0 },
+			{ "TERRAN_HELLIONTANK", UNIT_TYPEID::TERRAN_HELLIONTANK, ABILITY_ID::TRAIN_HELLBAT, Agent::MacroUnit::ARMY, 2, 0 },
+			{ "TERRAN_WIDOWMINE", UNIT_TYPEID::TERRAN_WIDOWMINE, ABILITY_ID::TRAIN_WIDOWMINE, Agent::MacroUnit::ARMY, 2, 0 },
+			{ "TERRAN_WIDOWMINEBURROWED", UNIT_TYPEID::TERRAN_WIDOWMINEBURROWED, ABILITY_ID::TRAIN_WIDOWMINE, Agent::MacroUnit::ARMY, 2, 0 },
+			{ "TERRAN_SIEGETANK", UNIT_TYPEID::TERRAN_SIEGETANK, ABILITY_ID::TRAIN_SIEGETANK, Agent::MacroUnit::ARMY, 3, 0 },
+			{ "TERRAN_SIEGETANKSIEGED", UNIT_TYPEID::TERRAN_SIEGETANKSIEGED, ABILITY_ID::TRAIN_SIEGETANK, Agent::MacroUnit::ARMY, 3, 0 },
+			{ "TERRAN_CYCLONE", UNIT_TYPEID::TERRAN_CYCLONE, ABILITY_ID::TRAIN_CYCLONE, Agent::MacroUnit::ARMY, 3, 0 },
+			{ "TERRAN_THOR", UNIT_TYPEID::TERRAN_THOR, ABILITY_ID::TRAIN_THOR, Agent::MacroUnit::ARMY, 6, 0 },
+			{ "TERRAN_THORAP", UNIT_TYPEID::TERRAN_THORAP, ABILITY_ID::TRAIN_THOR, Agent::MacroUnit::ARMY, 6, 0 },
+			{ "TERRAN_VIKINGFIGHTER", UNIT_TYPEID::TERRAN_VIKINGFIGHTER, ABILITY_ID::TRAIN_VIKINGFIGHTER, Agent::MacroUnit::ARMY, 2, 0 },
+			{ "TERRAN_VIKINGASSAULT", UNIT_TYPEID::TERRAN_VIKINGASSAULT, ABILITY_ID::TRAIN_VIKINGFIGHTER, Agent::MacroUnit::ARMY, 2, 0 },
+			{ "TERRAN_MEDIVAC", UNIT_TYPEID::TERRAN_MEDIVAC, ABILITY_ID::TRAIN_MEDIVAC, Agent::MacroUnit::ARMY, 2, 0 },
+			{ "TERRAN_LIBERATOR", UNIT_TYPEID::TERRAN_LIBERATOR, ABILITY_ID::TRAIN_LIBERATOR, Agent::MacroUnit::ARMY, 3, 0 },
+			{ "TERRAN_LIBERATORAG", UNIT_TYPEID::TERRAN_LIBERATORAG, ABILITY_ID::TRAIN_LIBERATOR, Agent::MacroUnit::ARMY, 3, 0 },
+			{ "TERRAN_RAVEN", UNIT_TYPEID::TERRAN_RAVEN, ABILITY_ID::TRAIN_RAVEN, Agent::MacroUnit::ARMY, 2, 0 },
+			{ "TERRAN_BANSHEE", UNIT_TYPEID::TERRAN_BANSHEE, ABILITY_ID::TRAIN_BANSHEE, Agent::MacroUnit::ARMY, 3, 0 },
+			{ "TERRAN_BATTLECRUISER", UNIT_TYPEID::TERRAN_BATTLECRUISER, ABILITY_ID::TRAIN_BATTLECRUISER, Agent::MacroUnit::ARMY, 6, 0 },
+			{ "TERRAN_AUTOTURRET", UNIT_TYPEID::TERRAN_AUTOTURRET, ABILITY_ID::EFFECT_AUTOTURRET, Agent::MacroUnit::NONE, 0, 0 },
+			{ "TERRAN_KD8CHARGE", UNIT_TYPEID::TERRAN_KD8CHARGE, ABILITY_ID::EFFECT_KD8CHARGE, Agent::MacroUnit::NONE, 0, 0 },
+			{ "TERRAN_NUKE", UNIT_TYPEID::TERRAN_NUKE, ABILITY_ID::BUILD_NUKE, Agent::MacroUnit::NONE, 0, 0 },
+			{ "TERRAN_COMMANDCENTER", UNIT_TYPEID::TERRAN_COMMANDCENTER, ABILITY_ID::BUILD_COMMANDCENTER, Agent::MacroUnit::COMMANDCENTER, 0, 15 },
+			{ "TERRAN_ORBITALCOMMAND", UNIT_TYPEID::TERRAN_ORBITALCOMMAND, ABILITY_ID::MORPH_ORBITALCOMMAND, Agent::MacroUnit::ORBITALCOMMAND, 0, 15 },
+			{ "TERRAN_PLANETARYFORTRESS", UNIT_TYPEID::TERRAN_PLANETARYFORTRESS, ABILITY_ID::MORPH_PLANETARYFORTRESS, Agent::MacroUnit::PLANETARYFORTRESS, 0, 15 },
+			{ "TERRAN_SUPPLYDEPOT", UNIT_TYPEID::TERRAN_SUPPLYDEPOT, ABILITY_ID::BUILD_SUPPLYDEPOT, Agent::MacroUnit::SUPPLYDEPOT, 0, 8 },
+			{ "TERRAN_REFINERY", UNIT_TYPEID::TERRAN_REFINERY, ABILITY_ID::BUILD_REFINERY, Agent::MacroUnit::REFINERY, 0, 0 },
+			{ "TERRAN_BARRACKS", UNIT_TYPEID::TERRAN_BARRACKS, ABILITY_ID::BUILD_BARRACKS, Agent::MacroUnit::BARRACKS, 0, 0 },
+			{ "TERRAN_BARRACKSTECHLAB", UNIT_TYPEID::TERRAN_BARRACKSTECHLAB, ABILITY_ID::BUILD_TECHLAB_BARRACKS, Agent::MacroUnit::BARRACKSTECHLAB, 0, 0 },
+			{ "TERRAN_BARRACKSREACTOR", UNIT_TYPEID::TERRAN_BARRACKSREACTOR, ABILITY_ID::BUILD_REACTOR_BARRACKS, Agent::MacroUnit::BARRACKSREACTOR, 0, 0 },
+			{ "TERRAN_FACTORY", UNIT_TYPEID::TERRAN_FACTORY, ABILITY_ID::BUILD_FACTORY, Agent::MacroUnit::FACTORY, 0, 0 },
+			{ "TERRAN_FACTORYTECHLAB", UNIT_TYPEID::TERRAN_FACTORYTECHLAB, ABILITY_ID::BUILD_TECHLAB_FACTORY, Agent::MacroUnit::FACTORYTECHLAB, 0, 0 },
+			{ "TERRAN_FACTORYREACTOR", UNIT_TYPEID::TERRAN_FACTORYREACTOR, ABILITY_ID::BUILD_REACTOR_FACTORY, Agent::MacroUnit::FACTORYREACTOR, 0, 0 },
+			{ "TERRAN_STARPORT", UNIT_TYPEID::TERRAN_STARPORT, ABILITY_ID::BUILD_STARPORT, Agent::MacroUnit::STARPORT, 0, 0 },
+			{ "TERRAN_STARPORTTECHLAB", UNIT_TYPEID::TERRAN_STARPORTTECHLAB, ABILITY_ID::BUILD_TECHLAB_STARPORT, Agent::MacroUnit::STARPORTTECHLAB, 0, 0 },
+			{ "TERRAN_STARPORTREACTOR", UNIT_TYPEID::TERRAN_STARPORTREACTOR, ABILITY_ID::BUILD_REACTOR_STARPORT, Agent::MacroUnit::STARPORTREACTOR, 0, 0 },
+			{ "TERRAN_ENGINEERINGBAY", UNIT_TYPEID::TERRAN_ENGINEERINGBAY, ABILITY_ID::BUILD_ENGINEERINGBAY, Agent::MacroUnit::ENGINEERINGBAY, 0, 0 },
+			{ "TERRAN_ARMORY", UNIT_TYPEID::TERRAN_ARMORY, ABILITY_ID::BUILD_ARMORY, Agent::MacroUnit::ARMORY, 0, 0 },
+			{ "TERRAN_FUSIONCORE", UNIT_TYPEID::TERRAN_FUSIONCORE, ABILITY_ID::BUILD_FUSIONCORE, Agent::MacroUnit::FUSIONCORE, 0, 0 },
+			{ "TERRAN_GHOSTACADEMY", UNIT_TYPEID::TERRAN_GHOSTACADEMY, ABILITY_ID::BUILD_GHOSTACADEMY, Agent::MacroUnit::GHOSTACADEMY, 0, 0 },
+			{ "TERRAN_BUNKER", UNIT_TYPEID::TERRAN_BUNKER, ABILITY_ID::BUILD_BUNKER, Agent::MacroUnit::BUNKER, 0, 0 },
+			{ "TERRAN_MISSILETURRET", UNIT_TYPEID::TERRAN_MISSILETURRET, ABILITY_ID::BUILD_MISSILETURRET, Agent::MacroUnit::MISSILETURRET, 0, 0 },
+			{ "TERRAN_SENSORTOWER", UNIT_TYPEID::TERRAN_SENSORTOWER, ABILITY_ID::BUILD_SENSORTOWER, Agent::MacroUnit::SENSORTOWER, 0, 0 },
+			{ "NEUTRAL_MINERALFIELD", UNIT_TYPEID::NEUTRAL_MINERALFIELD, ABILITY_ID::INVALID, Agent::MacroUnit::NONE, 0, 0 },
+			{ "NEUTRAL_VESPENEGEYSER", UNIT_TYPEID::NEUTRAL_VESPENEGEYSER, ABILITY_ID::INVALID, Agent::MacroUnit::NONE, 0, 0 }
+		};
+
+		//Returns the unit type of a name of the armies, or nullptr if the simulation does not know it
+		inline const SimulationUnitType* FindSimulationUnitType(const std::string& name)
+		{
+			for (const auto& unittype : SIMULATION_UNITTYPES)
+			{
+				if (name == unittype.name)
+					return &unittype;
+			}
+
+			return nullptr;
+		}
+
+		//Returns the unit type of a structure of the macro, or nullptr if it is not one
+		inline const SimulationUnitType* FindSimulationUnitType(Agent::MacroUnit macrounit)
+		{
+			for (const auto& unittype : SIMULATION_UNITTYPES)
+			{
+				if (macrounit != Agent::MacroUnit::ARMY && unittype.macrounit == macrounit)
+					return &unittype;
+			}
+
+			return nullptr;
+		}
+
+		//A research of the macro, the ability that its structure is ordered and the first level of the upgrade that it finishes
+		struct SimulationResearch
+		{
+			Agent::Action action;
+			ABILITY_ID ability;
+			//The upgrade, or INVALID for the ones that the agent never looks for
+			UPGRADE_ID upgrade;
+			//The levels of the upgrade, which have consecutive ids
+			uint32_t levels;
+		};
+
+		constexpr SimulationResearch SIMULATION_RESEARCHES[] =
+		{
+			{ Agent::Action::RESEARCH_COMBATSHIELD, ABILITY_ID::RESEARCH_COMBATSHIELD, UPGRADE_ID::SHIELDWALL, 1 },
+			{ Agent::Action::RESEARCH_STIMPACK, ABILITY_ID::RESEARCH_STIMPACK, UPGRADE_ID::STIMPACK, 1 },
+			{ Agent::Action::RESEARCH_CONCUSSIVESHELLS, ABILITY_ID::RESEARCH_CONCUSSIVESHELLS, UPGRADE_ID::PUNISHERGRENADES, 1 },
+			{ Agent::Action::RESEARCH_INFERNALPREIGNITER, ABILITY_ID::RESEARCH_INFERNALPREIGNITER, UPGRADE_ID::INVALID, 1 },
+			{ Agent::Action::RESEARCH_MAGFIELDLAUNCHERS, ABILITY_ID::RESEARCH_MAGFIELDLAUNCHERS, UPGRADE_ID::INVALID, 1 },
+			{ Agent::Action::RESEARCH_DRILLINGCLAWS, ABILITY_ID::RESEARCH_DRILLINGCLAWS, UPGRADE_ID::INVALID, 1 },
+			{ Agent::Action::RESEARCH_HIGHCAPACITYFUELTANKS, ABILITY_ID::RESEARCH_HIGHCAPACITYFUELTANKS, UPGRADE_ID::INVALID, 1 },
+			{ Agent::Action::RESEARCH_RAVENCORVIDREACTOR, ABILITY_ID::RESEARCH_RAVENCORVIDREACTOR, UPGRADE_ID::INVALID, 1 },
+			{ Agent::Action::RESEARCH_BANSHEECLOAKINGFIELD, ABILITY_ID::RESEARCH_BANSHEECLOAKINGFIELD, UPGRADE_ID::INVALID, 1 },
+			{ Agent::Action::RESEARCH_BANSHEEHYPERFLIGHTROTORS, ABILITY_ID::RESEARCH_BANSHEEHYPERFLIGHTROTORS, UPGRADE_ID::INVALID, 1 },
+			{ Agent::Action::RESEARCH_ADVANCEDBALLISTICS, ABILITY_ID::RESEARCH_ADVANCEDBALLISTICS, UPGRADE_ID::INVALID, 1 },
+			{ Agent::Action::RESEARCH_BATTLECRUISERWEAPONREFIT, ABILITY_ID::RESEARCH_BATTLECRUISERWEAPONREFIT, UPGRADE_ID::INVALID, 1 },
+			{ Agent::Action::RESEARCH_TERRANVEHICLEWEAPONS, ABILITY_ID::RESEARCH_TERRANVEHICLEWEAPONS, UPGRADE_ID::TERRANVEHICLEWEAPONSLEVEL1, 3 },
+			{ Agent::Action::RESEARCH_TERRANSHIPWEAPONS, ABILITY_ID::RESEARCH_TERRANSHIPWEAPONS, UPGRADE_ID::TERRANSHIPWEAPONSLEVEL1, 3 },
+			{ Agent::Action::RESEARCH_TERRANVEHICLEANDSHIPPLATING, ABILITY_ID::RESEARCH_TERRANVEHICLEANDSHIPPLATING, UPGRADE_ID::TERRANVEHICLEANDSHIPARMORSLEVEL1, 3 },
+			{ Agent::Action::RESEARCH_TERRANINFANTRYWEAPONS, ABILITY_ID::RESEARCH_TERRANINFANTRYWEAPONS, UPGRADE_ID::TERRANINFANTRYWEAPONSLEVEL1, 3 },
+			{ Agent::Action::RESEARCH_TERRANINFANTRYARMOR, ABILITY_ID::RESEARCH_TERRANINFANTRYARMOR, UPGRADE_ID::TERRANINFANTRYARMORSLEVEL1, 3 },
+			{ Agent::Action::RESEARCH_PERSONALCLOAKING, ABILITY_ID::RESEARCH_PERSONALCLOAKING, UPGRADE_ID::INVALID, 1 }
+		};
+
+		//Returns the research of an action, or nullptr if it is not one
+		inline const SimulationResearch* FindSimulationResearch(Agent::Action action)
+		{
+			for (const auto& research : SIMULATION_RESEARCHES)
+			{
+				if (research.action == action)
+					return &research;
+			}
+
+			return nullptr;
+		}
+
+		//The game of a replay as the observation of the player that the agent plays, the world is changed by the simulation and read by the agent
+		//Every function of the interface is overridden, so a signature that differs from the api fails to build, and the ones that the agent does not use return what an empty game would
+		class ReplayObservation : public ObservationInterface
+		{
+			private:
+				//Something that the world finishes at a game loop, a structure that is being built or an order that is being carried out
+				struct Task
+				{
+					enum class Kind : uint8_t
+					{
+						Construction,
+						Order
+					};
+
+					Kind kind;
+					uint32_t startloop;
+					uint32_t endloop;
+					Unit* unit;
+					ABILITY_ID ability;
+					//The type that the unit turns into once the order is carried out, or INVALID
+					UNIT_TYPEID morph;
+					//The upgrade that is researched once the order is carried out, or INVALID
+					UPGRADE_ID upgrade;
+				};
+
+				uint32_t _playerid;
+				uint32_t _gameloop;
+				//Every unit that has existed, a unit keeps its address after it has been destroyed like in the game
+				std::deque<Unit> _units;
+				std::unordered_map<Tag, Unit*> _tags;
+				//The alive units in the order they were added, updated once per step
+				Units _aliveunits;
+				std::vector<Task> _tasks;
+				std::vector<UpgradeID> _upgrades;
+				UnitTypes _unittypedata;
+				Tag _nexttag;
+				Point3D _startlocation;
+				//The last sample of the resources of the player, and what is counted from the units
+				int32_t _minerals;
+				int32_t _vespene;
+				int32_t _foodused;
+				int32_t _foodworkers;
+				int32_t _foodcap;
+				int32_t _idleworkers;
+				int32_t _armycount;
+				//What has happened since the events were cleared, in the order of the callbacks of the agent
+				Units _destroyedunits;
+				Units _createdunits;
+				Units _idleunits;
+				std::vector<UpgradeID> _completedupgrades;
+				Units _constructedunits;
+
+				ReplayObservation(const ReplayObservation&);
+				ReplayObservation& operator=(const ReplayObservation&);
+
+				//Returns true if the unit is one of our own that has just become idle
+				static bool IsIdle(const Unit* unit)
+				{
+					return (unit->alliance == Unit::Alliance::Self && unit->is_alive && unit->build_progress >= 1.0f && unit->orders.empty());
+				}
+
+				//Removes the first order of the ability from the unit, and returns false if it has already been replaced
+				static bool RemoveOrder(Unit* unit, ABILITY_ID ability)
+				{
+					for (auto order = unit->orders.begin(); order != unit->orders.end(); order++)
+					{
+						if (order->ability_id == ability)
+						{
+							unit->orders.erase(order);
+							return true;
+						}
+					}
+
+					return false;
+				}
+
+				//Finishes a task at its end, the unit of the task may have been destroyed or given another order since
+				void Finish(const Task& task)
+				{
+					Unit* unit = task.unit;
+
+					if (!unit->is_alive)
+						return;
+					if (task.kind == Task::Kind::Construction)
+					{
+						unit->build_progress = 1.0f;
+						if (unit->alliance == Unit::Alliance::Self)
+							_constructedunits.push_back(unit);
+					}
+					else
+					{
+						if (!RemoveOrder(unit, task.ability))
+							return;
+						if (task.morph != UNIT_TYPEID::INVALID)
+							unit->unit_type = task.morph;
+						if (task.upgrade != UPGRADE_ID::INVALID && unit->alliance == Unit::Alliance::Self)
+						{
+							_upgrades.push_back(task.upgrade);
+							_completedupgrades.push_back(task.upgrade);
+						}
+					}
+					if (IsIdle(unit))
+						_idleunits.push_back(unit);
+				}
+
+				//Counts what the agent reads from the units, only the units that have been built count
+				void Recount()
+				{
+					float foodcap = 0;
+
+					_aliveunits.clear();
+					_idleworkers = 0;
+					_armycount = 0;
+					for (auto& unit : _units)
+					{
+						if (!unit.is_alive)
+							continue;
+
+						_aliveunits.push_back(&unit);
+						if (unit.alliance != Unit::Alliance::Self || unit.build_progress < 1.0f)
+							continue;
+
+						const UnitTypeData& unittypedata = _unittypedata[static_cast<size_t>(unit.unit_type.ToType())];
+						foodcap += unittypedata.food_provided;
+						if (unit.unit_type == UNIT_TYPEID::TERRAN_SCV)
+							_idleworkers += (unit.orders.empty() ? 1 : 0);
+						else if (unittypedata.food_required > 0)
+							_armycount++;
+					}
+					_foodcap = std::min(SIMULATION_MAXIMUMFOOD, static_cast<int32_t>(foodcap));
+				}
+
+			public:
+				ReplayObservation(uint32_t playerid)
+				{
+					size_t unittypecount = 0;
+
+					_playerid = playerid;
+					_gameloop = 0;
+					_nexttag = SIMULATION_FIRSTTAG;
+					_minerals = 0;
+					_vespene = 0;
+					_foodused = 0;
+					_foodworkers = 0;
+					_foodcap = 0;
+					_idleworkers = 0;
+					_armycount = 0;
+
+					//The data of the unit types is indexed by the type like in the game
+					for (const auto& unittype : SIMULATION_UNITTYPES)
+						unittypecount = std::max(unittypecount, static_cast<size_t>(unittype.type) + 1);
+					_unittypedata = UnitTypes(unittypecount);
+					for (const auto& unittype : SIMULATION_UNITTYPES)
+					{
+						UnitTypeData& unittypedata = _unittypedata[static_cast<size_t>(unittype.type)];
+
+						unittypedata.unit_type_id = unittype.type;
+						unittypedata.name = unittype.name;
+						unittypedata.ability_id = unittype.ability;
+						unittypedata.food_required = unittype.foodrequired;
+						unittypedata.food_provided = unittype.foodprovided;
+					}
+				}
+
+				//Adds a unit that is built over the given game loops, or is already built if there are none, and returns the unit with the tag if it already exists
+				//A unit of our own is announced to the agent as created unless told otherwise, such as the units that the game starts with
+				Unit* AddUnit(Tag tag, UNIT_TYPEID type, Unit::Alliance alliance, int owner, const Point2D& position, uint32_t buildloops, bool isannounced = true)
+				{
+					auto existing = _tags.find(tag);
+					if (existing != _tags.end() && existing->second->is_alive)
+						return existing->second;
+
+					_units.emplace_back();
+					Unit* unit = &_units.back();
+					unit->display_type = Unit::DisplayType::Visible;
+					unit->alliance = alliance;
+					unit->tag = tag;
+					unit->unit_type = type;
+					unit->owner = owner;
+					unit->pos = Point3D(position.x, position.y, 0);
+					unit->facing = 0;
+					unit->radius = 1.0f;
+					unit->build_progress = ((buildloops > 0) ? 0.0f : 1.0f);
+					unit->is_alive = true;
+					unit->add_on_tag = 0;
+					unit->health = 100;
+					unit->health_max = 100;
+					unit->mineral_contents = ((type == UNIT_TYPEID::NEUTRAL_MINERALFIELD) ? SIMULATION_MINERALCONTENTS : 0);
+					unit->vespene_contents = ((type == UNIT_TYPEID::NEUTRAL_VESPENEGEYSER) ? SIMULATION_VESPENECONTENTS : 0);
+					unit->is_flying = false;
+					unit->assigned_harvesters = 0;
+					unit->ideal_harvesters = 0;
+					_tags[tag] = unit;
+
+					if (buildloops > 0)
+						_tasks.push_back({ Task::Kind::Construction, _gameloop, _gameloop + buildloops, unit, ABILITY_ID::INVALID, UNIT_TYPEID::INVALID, UPGRADE_ID::INVALID });
+					if (alliance == Unit::Alliance::Self && isannounced)
+						_createdunits.push_back(unit);
+					if (IsIdle(unit))
+						_idleunits.push_back(unit);
+
+					return unit;
+				}
+
+				//Gives an order to a unit that is carried out over the given game loops, or until it is replaced if there are none
+				//An order that is not queued replaces the orders of the unit, and the unit can turn into another type or research an upgrade once it is carried out
+				void Order(Unit* unit, const UnitOrder& order, bool isqueued, uint32_t loops, UNIT_TYPEID morph = UNIT_TYPEID::INVALID, UPGRADE_ID upgrade = UPGRADE_ID::INVALID)
+				{
+					if (!unit->is_alive)
+						return;
+
+					if (!isqueued)
+						unit->orders.clear();
+					unit->orders.push_back(order);
+					if (loops > 0)
+						_tasks.push_back({ Task::Kind::Order, _gameloop, _gameloop + loops, unit, static_cast<ABILITY_ID>(static_cast<uint32_t>(order.ability_id)), morph, upgrade });
+				}
+
+				void DestroyUnit(Unit* unit)
+				{
+					if (!unit->is_alive)
+						return;
+
+					unit->is_alive = false;
+					unit->orders.clear();
+					_destroyedunits.push_back(unit);
+				}
+
+				//Returns the unit with the tag that can be changed, alive or not, or nullptr if it has never existed
+				Unit* FindUnit(Tag tag)
+				{
+					auto unit = _tags.find(tag);
+
+					return ((unit != _tags.end()) ? unit->second : nullptr);
+				}
+
+				//Returns the first alive unit of a player and a type that the predicate accepts, or nullptr if there is none
+				template<typename Predicate>
+				Unit* FindUnit(int owner, UNIT_TYPEID type, Predicate predicate)
+				{
+					for (auto& unit : _units)
+					{
+						if (unit.is_alive && unit.owner == owner && unit.unit_type == type && predicate(unit))
+							return &unit;
+					}
+
+					return nullptr;
+				}
+
+				//Calls the function with every alive unit
+				template<typename Function>
+				void ForEachUnit(Function function)
+				{
+					for (auto& unit : _units)
+					{
+						if (unit.is_alive)
+							function(unit);
+					}
+				}
+
+				//Returns a new tag for a unit that the replays do not have
+				Tag CreateTag()
+				{
+					return _nexttag++;
+				}
+
+				void SetStartLocation(const Point2D& position)
+				{
+					_startlocation = Point3D(position.x, position.y, 0);
+				}
+
+				void SetResources(int32_t minerals, int32_t vespene, int32_t foodused, int32_t foodworkers)
+				{
+					_minerals = minerals;
+					_vespene = vespene;
+					_foodused = foodused;
+					_foodworkers = foodworkers;
+				}
+
+				//Moves the world to a later game loop, the tasks that end until then are finished and the structures that are being built make progress
+				void Advance(uint32_t gameloop)
+				{
+					_gameloop = gameloop;
+					for (size_t index = 0; index < _tasks.size();)
+					{
+						Task& task = _tasks[index];
+
+						if (task.endloop <= _gameloop)
+						{
+							Task finished = task;
+
+							task = _tasks.back();
+							_tasks.pop_back();
+							Finish(finished);
+							continue;
+						}
+						if (task.kind == Task::Kind::Construction)
+							task.unit->build_progress = static_cast<float>(_gameloop - task.startloop) / (task.endloop - task.startloop);
+						index++;
+					}
+					Recount();
+				}
+
+				//Forgets what has happened, once the agent has been told
+				void ClearEvents()
+				{
+					_destroyedunits.clear();
+					_createdunits.clear();
+					_idleunits.clear();
+					_completedupgrades.clear();
+					_constructedunits.clear();
+				}
+
+				const Units& GetDestroyedUnits() const
+				{
+					return _destroyedunits;
+				}
+
+				const Units& GetCreatedUnits() const
+				{
+					return _createdunits;
+				}
+
+				//The units of our own that have become idle, a unit that has been given an order since is not idle anymore
+				Units GetIdleUnits() const
+				{
+					Units idleunits;
+
+					for (const auto& unit : _idleunits)
+					{
+						if (IsIdle(unit))
+							idleunits.push_back(unit);
+					}
+
+					return idleunits;
+				}
+
+				const std::vector<UpgradeID>& GetCompletedUpgrades() const
+				{
+					return _completedupgrades;
+				}
+
+				const Units& GetConstructedUnits() const
+				{
+					return _constructedunits;
+				}
+
+				size_t GetUnitCount() const
+				{
+					return _units.size();
+				}
+
+				virtual uint32_t GetPlayerID() const override
+				{
+					return _playerid;
+				}
+
+				virtual uint32_t GetGameLoop() const override
+				{
+					return _gameloop;
+				}
+
+				virtual Units GetUnits() const override
+				{
+					return _aliveunits;
+				}
+
+				virtual Units GetUnits(Unit::Alliance alliance, Filter filter = {}) const override
+				{
+					Units units;
+
+					for (const auto& unit : _aliveunits)
+					{
+						if (unit->alliance == alliance && (!filter || filter(*unit)))
+							units.push_back(unit);
+					}
+
+					return units;
+				}
+
+				virtual Units GetUnits(Filter filter) const override
+				{
+					Units units;
+
+					for (const auto& unit : _aliveunits)
+					{
+						if (!filter || filter(*unit))
+							units.push_back(unit);
+					}
+
+					return units;
+				}
+
+				virtual const Unit* GetUnit(Tag tag) const override
+				{
+					auto unit = _tags.find(tag);
+
+					return ((unit != _tags.end()) ? unit->second : nullptr);
+				}
+
+				virtual const RawActions& GetRawActions() const override
+				{
+					static const RawActions rawactions;
+					return rawactions;
+				}
+
+				virtual const SpatialActions& GetFeatureLayerActions() const override
+				{
+					static const SpatialActions featurelayeractions;
+					return featurelayeractions;
+				}
+
+				virtual const SpatialActions& GetRenderedActions() const override
+				{
+					static const SpatialActions renderedactions;
+					return renderedactions;
+				}
+
+				virtual const std::vector<ChatMessage>& GetChatMessages() const override
+				{
+					static const std::vector<ChatMessage> chatmessages;
+					return chatmessages;
+				}
+
+				virtual const std::vector<PowerSource>& GetPowerSources() const override
+				{
+					static const std::vector<PowerSource> powersources;
+					return powersources;
+				}
+
+				virtual const std::vector<Effect>& GetEffects() const override
+				{
+					static const std::vector<Effect> effects;
+					return effects;
+				}
+
+				virtual const std::vector<UpgradeID>& GetUpgrades() const override
+				{
+					return _upgrades;
+				}
+
+				virtual const Score& GetScore() const override
+				{
+					static const Score score;
+					return score;
+				}
+
+				virtual const Abilities& GetAbilityData(bool /*force_refresh*/ = false) const override
+				{
+					static const Abilities abilities;
+					return abilities;
+				}
+
+				virtual const UnitTypes& GetUnitTypeData(bool /*force_refresh*/ = false) const override
+				{
+					return _unittypedata;
+				}
+
+				virtual const Upgrades& GetUpgradeData(bool /*force_refresh*/ = false) const override
+				{
+					static const Upgrades upgrades;
+					return upgrades;
+				}
+
+				virtual const Buffs& GetBuffData(bool /*force_refresh*/ = false) const override
+				{
+					static const Buffs buffs;
+					return buffs;
+				}
+
+				virtual const Effects& GetEffectData(bool /*force_refresh*/ = false) const override
+				{
+					static const Effects effects;
+					return effects;
+				}
+
+				virtual const GameInfo& GetGameInfo() const override
+				{
+					static const GameInfo gameinfo;
+					return gameinfo;
+				}
+
+				virtual int32_t GetMinerals() const override
+				{
+					return _minerals;
+				}
+
+				virtual int32_t GetVespene() const override
+				{
+					return _vespene;
+				}
+
+				virtual int32_t GetFoodCap() const override
+				{
+					return _foodcap;
+				}
+
+				virtual int32_t GetFoodUsed() const override
+				{
+					return _foodused;
+				}
+
+				virtual int32_t GetFoodArmy() const override
+				{
+					return (_foodused - _foodworkers);
+				}
+
+				virtual int32_t GetFoodWorkers() const override
+				{
+					return _foodworkers;
+				}
+
+				virtual int32_t GetIdleWorkerCount() const override
+				{
+					return _idleworkers;
+				}
+
+				virtual int32_t GetArmyCount() const override
+				{
+					return _armycount;
+				}
+
+				virtual int32_t GetWarpGateCount() const override
+				{
+					return 0;
+				}
+
+				virtual Point2D GetCameraPos() const override
+				{
+					return Point2D(_startlocation.x, _startlocation.y);
+				}
+
+				virtual Point3D GetStartLocation() const override
+				{
+					return _startlocation;
+				}
+
+				virtual const std::vector<PlayerResult>& GetResults() const override
+				{
+					static const std::vector<PlayerResult> results;
+					return results;
+				}
+
+				virtual bool HasCreep(const Point2D& /*point*/) const override
+				{
+					return false;
+				}
+
+				virtual Visibility GetVisibility(const Point2D& /*point*/) const override
+				{
+					return Visibility::Visible;
+				}
+
+				virtual bool IsPathable(const Point2D& /*point*/) const override
+				{
+					return true;
+				}
+
+				virtual bool IsPlacable(const Point2D& /*point*/) const override
+				{
+					return true;
+				}
+
+				virtual float TerrainHeight(const Point2D& /*point*/) const override
+				{
+					return 0;
+				}
+
+				virtual const SC2APIProtocol::Observation* GetRawObservation() const override
+				{
+					return nullptr;
+				}
+		};
+
+		//A command that the agent has given through the actions
+		struct SimulationCommand
+		{
+			uint32_t gameloop;
+			Tag unit;
+			ABILITY_ID ability;
+			//The unit that the command targets or 0, and the point that it targets if it has one
+			Tag target;
+			Point2D point;
+			bool haspoint;
+			bool isqueued;
+		};
+
+		//Records the commands of the agent and gives them to the units of the observation once the step is sent, like the game does
+		class ReplayActions : public ActionInterface
+		{
+			private:
+				ReplayObservation& _observation;
+				//The commands of this step, and the tags of their units
+				std::vector<SimulationCommand> _stepcommands;
+				std::vector<Tag> _commandedtags;
+				//Every command that has been sent
+				std::vector<SimulationCommand> _commands;
+				//The number of commands that were given to a unit that does not exist
+				uint64_t _unknowncommands;
+
+				ReplayActions(const ReplayActions&);
+				ReplayActions& operator=(const ReplayActions&);
+
+				void AddCommand(const Unit* unit, AbilityID ability, Tag target, const Point2D& point, bool haspoint, bool isqueued)
+				{
+					if (unit == nullptr)
+					{
+						_unknowncommands++;
+						return;
+					}
+
+					_stepcommands.push_back({ _observation.GetGameLoop(), unit->tag, static_cast<ABILITY_ID>(static_cast<uint32_t>(ability)), target, point, haspoint, isqueued });
+					_commandedtags.push_back(unit->tag);
+				}
+
+			public:
+				ReplayActions(ReplayObservation& observation) : _observation(observation)
+				{
+					_unknowncommands = 0;
+				}
+
+				virtual void UnitCommand(const Unit* unit, AbilityID ability, bool queued_command = false) override
+				{
+					AddCommand(unit, ability, 0, Point2D(), false, queued_command);
+				}
+
+				virtual void UnitCommand(const Unit* unit, AbilityID ability, const Point2D& point, bool queued_command = false) override
+				{
+					AddCommand(unit, ability, 0, point, true, queued_command);
+				}
+
+				virtual void UnitCommand(const Unit* unit, AbilityID ability, const Unit* target, bool queued_command = false) override
+				{
+					if (target != nullptr)
+						AddCommand(unit, ability, target->tag, Point2D(target->pos.x, target->pos.y), true, queued_command);
+					else
+						AddCommand(unit, ability, 0, Point2D(), false, queued_command);
+				}
+
+				virtual void UnitCommand(const Units& units, AbilityID ability, bool queued_move = false) override
+				{
+					for (const auto& unit : units)
+						UnitCommand(unit, ability, queued_move);
+				}
+
+				virtual void UnitCommand(const Units& units, AbilityID ability, const Point2D& point, bool queued_command = false) override
+				{
+					for (const auto& unit : units)
+						UnitCommand(unit, ability, point, queued_command);
+				}
+
+				virtual void UnitCommand(const Units& units, AbilityID ability, const Unit* target, bool queued_command = false) override
+				{
+					for (const auto& unit : units)
+						UnitCommand(unit, ability, target, queued_command);
+				}
+
+				//Returns the tags of the units that have been given a command in this step
+				virtual const std::vector<Tag>& Commands() const override
+				{
+					return _commandedtags;
+				}
+
+				virtual void ToggleAutocast(Tag /*unit_tag*/, AbilityID /*ability*/) override
+				{
+
+				}
+
+				virtual void ToggleAutocast(const std::vector<Tag>& /*unit_tags*/, AbilityID /*ability*/) override
+				{
+
+				}
+
+				virtual void SendChat(const std::string& /*message*/, ChatChannel /*channel*/ = ChatChannel::All) override
+				{
+
+				}
+
+				//Gives the commands of this step to their units, an order to harvest lasts until it is replaced and any other order for a while
+				virtual void SendActions() override
+				{
+					for (const auto& command : _stepcommands)
+					{
+						Unit* unit = _observation.FindUnit(command.unit);
+						UnitOrder order;
+
+						if (unit == nullptr || !unit->is_alive)
+						{
+							_unknowncommands++;
+							continue;
+						}
+						order.ability_id = command.ability;
+						order.target_unit_tag = command.target;
+						order.target_pos = command.point;
+						order.progress = 0;
+						_observation.Order(unit, order, command.isqueued, ((command.ability == ABILITY_ID::SMART) ? 0 : SIMULATION_ORDERLOOPS));
+						_commands.push_back(command);
+					}
+					_stepcommands.clear();
+					_commandedtags.clear();
+				}
+
+				//Forgets the commands of this step without giving them to their units, so the agent can be measured without changing the world
+				void DiscardActions()
+				{
+					_stepcommands.clear();
+					_commandedtags.clear();
+				}
+
+				const std::vector<SimulationCommand>& GetCommands() const
+				{
+					return _commands;
+				}
+
+				uint64_t GetUnknownCommandCount() const
+				{
+					return _unknowncommands;
+				}
+		};
+
+		//An action that the player of a replay has commanded, and the game loop of the command
+		struct SimulationDecision
+		{
+			uint32_t gameloop;
+			Agent::Action action;
+		};
+
+		//Decides the actions that the player of the replay has commanded, each once a snapshot has reached its game loop
+		//It stands in for model service in the simulation, so the agent takes over from the opening and executes the actions like in a game
+		class ReplayActionProvider : public Agent::QueuedActionProvider
+		{
+			private:
+				std::vector<SimulationDecision> _decisions;
+				//The next decision to queue, only used by the thread that requests the decisions
+				size_t _nextdecision;
+				std::atomic<uint64_t> _requests;
+
+				ReplayActionProvider(const ReplayActionProvider&);
+				ReplayActionProvider& operator=(const ReplayActionProvider&);
+
+			public:
+				ReplayActionProvider(const std::vector<SimulationDecision>& decisions) : QueuedActionProvider(SIMULATION_MAXIMUMQUEUEDACTIONS)
+				{
+					_decisions = decisions;
+					_nextdecision = 0;
+					_requests = 0;
+				}
+
+				virtual const char* GetName() const override
+				{
+					return "the replay";
+				}
+
+				virtual std::chrono::milliseconds GetDecisionInterval() const override
+				{
+					return SIMULATION_DECISIONINTERVAL;
+				}
+
+				virtual bool RequestDecision(const Agent::ObservationSnapshot& snapshot) override
+				{
+					size_t first = _nextdecision;
+
+					for (; _nextdecision < _decisions.size() && _decisions[_nextdecision].gameloop <= snapshot.GetGameLoop(); _nextdecision++)
+						PushDecidedAction(_decisions[_nextdecision].action, snapshot.GetStamp());
+					if (_nextdecision > first)
+						NotifyWaiters();
+					_requests++;
+
+					return true;
+				}
+
+				virtual void Stop() override
+				{
+					NotifyWaiters();
+					KOKEKOKO_LOG_INFO("Replay: {} of {} actions decided in {} snapshots, {} dropped", _nextdecision, _decisions.size(), _requests.load(), GetDroppedCount());
+				}
+		};
+
+		//Plays a replay of the repositories as the game of one of its players, game loop by game loop
+		//The units of both players come from the armies, the structures and researches from the commands, and the resources of the player from its samples
+		//The player that the agent plays sees the units of the other player as the enemy, the recorded commands are what the agent is given to decide
+		class ReplaySimulation
+		{
+			private:
+				//A row of the repositories that changes the world at its game loop, in the order that the rows of the same game loop are applied
+				struct Event
+				{
+					enum class Kind : uint8_t
+					{
+						//A unit from the rows of the armies before the END line
+						Unit,
+						//A unit that survived the battle, from the rows after the END line
+						Survivor,
+						Command,
+						Resources
+					};
+
+					uint32_t gameloop;
+					Kind kind;
+					uint32_t row;
+
+					bool operator<(const Event& other) const
+					{
+						return ((gameloop != other.gameloop) ? (gameloop < other.gameloop) : ((kind != other.kind) ? (kind < other.kind) : (row < other.row)));
+					}
+				};
+
+				//Where a player starts, and what it has built there
+				struct Player
+				{
+					Point2D startlocation;
+					bool haslocation;
+					uint32_t structures;
+					//The units that survived the battle, and if the battle has been reached
+					std::unordered_set<Tag> survivors;
+					bool isbattlereached;
+					//The levels of the upgrades that have been started
+					std::unordered_map<uint32_t, uint32_t> upgradelevels;
+
+					Player() : haslocation(false), structures(0), isbattlereached(false)
+					{
+
+					}
+				};
+
+				Repository::ArmiesSpans _armies;
+				Repository::CommandsSpans _commands;
+				Repository::ResourcesSpans _resources;
+				uint16_t _player;
+				ReplayObservation _observation;
+				ReplayActions _actions;
+				std::vector<Event> _events;
+				size_t _nextevent;
+				//The unit type of every name of the armies, and the action of every name of the commands
+				std::vector<const SimulationUnitType*> _unittypes;
+				std::vector<Agent::Action> _actionsbyname;
+				std::unordered_map<uint16_t, Player> _players;
+				std::vector<SimulationDecision> _decisions;
+				uint64_t _steps;
+
+				ReplaySimulation(const ReplaySimulation&);
+				ReplaySimulation& operator=(const ReplaySimulation&);
+
+				static uint32_t GetGameLoop(uint32_t second)
+				{
+					return (second * SIMULATION_GAMELOOPSPERSECOND);
+				}
+
+				//The build time of the macro is in seconds of the faster speed
+				static uint32_t GetBuildLoops(const Agent::MacroActionData& macroaction)
+				{
+					return std::max(1u, static_cast<uint32_t>(macroaction.buildseconds * Agent::GAMELOOPS_PERSECOND));
+				}
+
+				Unit::Alliance GetAlliance(uint16_t player) const
+				{
+					return ((player == _player) ? Unit::Alliance::Self : Unit::Alliance::Enemy);
+				}
+
+				//Returns the next free place for a structure of a player, in rows behind its start location
+				Point2D PlaceStructure(Player& player)
+				{
+					uint32_t index = player.structures++;
+
+					return Point2D(player.startlocation.x + (4.0f * ((index % 6) - 2.5f)), player.startlocation.y + 6.0f + (4.0f * (index / 6)));
+				}
+
+				//Gives every player a base, its workers and the resources around it, where its first unit was trained
+				void AddStartUnits()
+				{
+					for (auto& player : _players)
+					{
+						Point2D position = player.second.startlocation;
+						Unit::Alliance alliance = GetAlliance(player.first);
+
+						_observation.AddUnit(_observation.CreateTag(), UNIT_TYPEID::TERRAN_COMMANDCENTER, alliance, player.first, position, 0, false);
+						for (uint32_t worker = 0; worker < SIMULATION_STARTWORKERS; worker++)
+							_observation.AddUnit(_observation.CreateTag(), UNIT_TYPEID::TERRAN_SCV, alliance, player.first, Point2D(position.x - 5.5f + worker, position.y - 3.0f), 0, false);
+						for (uint32_t mineralfield = 0; mineralfield < SIMULATION_MINERALFIELDS; mineralfield++)
+							_observation.AddUnit(_observation.CreateTag(), UNIT_TYPEID::NEUTRAL_MINERALFIELD, Unit::Alliance::Neutral, SIMULATION_NEUTRALPLAYER, Point2D(position.x - 7.0f + (2.0f * mineralfield), position.y - 8.0f), 0, false);
+						for (uint32_t vespenegeyser = 0; vespenegeyser < SIMULATION_VESPENEGEYSERS; vespenegeyser++)
+							_observation.AddUnit(_observation.CreateTag(), UNIT_TYPEID::NEUTRAL_VESPENEGEYSER, Unit::Alliance::Neutral, SIMULATION_NEUTRALPLAYER, Point2D(position.x + ((vespenegeyser == 0) ? -9.0f : 9.0f), position.y - 3.0f), 0, false);
+						if (player.first == _player)
+							_observation.SetStartLocation(position);
+					}
+				}
+
+				void AddReplayUnit(uint32_t row)
+				{
+					const SimulationUnitType* unittype = _unittypes[_armies.types[row]];
+
+					if (unittype != nullptr)
+						_observation.AddUnit(_armies.tags[row], unittype->type, GetAlliance(_armies.players[row]), _armies.players[row], Point2D(_armies.x[row], _armies.y[row]), 0);
+				}
+
+				//The units of a player that did not survive its battle are destroyed when the battle is reached, the survivors move to where they were seen
+				void Survive(uint32_t row)
+				{
+					uint16_t playerindex = _armies.players[row];
+					Player& player = _players[playerindex];
+					Unit* unit = _observation.FindUnit(_armies.tags[row]);
+
+					if (!player.isbattlereached)
+					{
+						player.isbattlereached = true;
+						_observation.ForEachUnit([this, playerindex, &player](Unit& unit)
+						{
+							if (unit.owner == playerindex && unit.tag < SIMULATION_FIRSTTAG && player.survivors.count(unit.tag) == 0)
+								_observation.DestroyUnit(&unit);
+						});
+					}
+					if (unit != nullptr && unit->is_alive)
+						unit->pos = Point3D(_armies.x[row], _armies.y[row], unit->pos.z);
+					else
+						AddReplayUnit(row);
+				}
+
+				//Starts what a command makes of the macro, the units that it trains come from the armies
+				void Command(uint32_t row)
+				{
+					uint16_t playerindex = _commands.players[row];
+					Player& player = _players[playerindex];
+					Agent::Action action = _actionsbyname[_commands.commands[row]];
+					const Agent::MacroActionData& macroaction = Agent::GetMacroActionData(action);
+					const SimulationUnitType* product = FindSimulationUnitType(macroaction.product);
+					const SimulationUnitType* producer = FindSimulationUnitType(macroaction.producer);
+					UnitOrder order;
+
+					order.ability_id = ((product != nullptr) ? product->ability : ABILITY_ID::INVALID);
+					order.target_unit_tag = 0;
+					order.progress = 0;
+					switch (macroaction.kind)
+					{
+						case Agent::MacroKind::Build:
+						{
+							if (product != nullptr)
+								_observation.AddUnit(_observation.CreateTag(), product->type, GetAlliance(playerindex), playerindex, PlaceStructure(player), GetBuildLoops(macroaction));
+							break;
+						}
+						case Agent::MacroKind::Morph:
+						{
+							Unit* base = _observation.FindUnit(playerindex, producer->type, [](const Unit& unit) { return (unit.build_progress >= 1.0f && unit.orders.empty()); });
+
+							if (base != nullptr)
+								_observation.Order(base, order, false, GetBuildLoops(macroaction), product->type);
+							break;
+						}
+						case Agent::MacroKind::Addon:
+						{
+							Unit* structure = _observation.FindUnit(playerindex, producer->type, [](const Unit& unit) { return (unit.build_progress >= 1.0f && unit.add_on_tag == 0); });
+
+							if (structure != nullptr)
+							{
+								Unit* addon = _observation.AddUnit(_observation.CreateTag(), product->type, GetAlliance(playerindex), playerindex, Point2D(structure->pos.x + 2.5f, structure->pos.y - 0.5f), GetBuildLoops(macroaction));
+
+								structure->add_on_tag = addon->tag;
+								_observation.Order(structure, order, false, GetBuildLoops(macroaction));
+							}
+							break;
+						}
+						case Agent::MacroKind::Research:
+						{
+							const SimulationResearch* research = FindSimulationResearch(action);
+							uint32_t& level = player.upgradelevels[static_cast<uint32_t>(action)];
+							Unit* structure = _observation.FindUnit(playerindex, producer->type, [](const Unit& unit) { return (unit.build_progress >= 1.0f); });
+							UPGRADE_ID upgrade = UPGRADE_ID::INVALID;
+
+							if (research == nullptr || structure == nullptr || level >= research->levels)
+								break;
+							if (research->upgrade != UPGRADE_ID::INVALID)
+								upgrade = static_cast<UPGRADE_ID>(static_cast<uint32_t>(research->upgrade) + level);
+							order.ability_id = research->ability;
+							level++;
+							_observation.Order(structure, order, true, GetBuildLoops(macroaction), UNIT_TYPEID::INVALID, upgrade);
+							break;
+						}
+						default:
+							break;
+					}
+				}
+
+				void Apply(const Event& event)
+				{
+					switch (event.kind)
+					{
+						case Event::Kind::Unit:
+							AddReplayUnit(event.row);
+							break;
+						case Event::Kind::Survivor:
+							Survive(event.row);
+							break;
+						case Event::Kind::Command:
+							Command(event.row);
+							break;
+						case Event::Kind::Resources:
+							_observation.SetResources(static_cast<int32_t>(_resources.minerals[event.row]), static_cast<int32_t>(_resources.vespene[event.row]), _resources.supplies[event.row], _resources.workers[event.row]);
+							break;
+					}
+				}
+
+				void AddEvents(Event::Kind kind, uint32_t firstrow, uint32_t lastrow, const Repository::RepositorySpan<uint32_t>& seconds)
+				{
+					for (uint32_t row = firstrow; row < lastrow; row++)
+						_events.push_back({ GetGameLoop(seconds[row]), kind, row });
+				}
+
+			public:
+				//Prepares the replay as the game of the player, the repositories have to stay loaded for as long as the simulation is used
+				ReplaySimulation(const Repository::ArmiesRepository& armies, const Repository::CommandsRepository& commands, const Repository::ResourcesRepository& resources, const Repository::RepositoryJoinReplay& replay, uint16_t player) : _observation(player), _actions(_observation)
+				{
+					const Repository::RepositoryDictionary& types = armies.GetDictionary(Repository::ArmiesColumns::TYPES);
+					const Repository::RepositoryDictionary& names = commands.GetDictionary(Repository::CommandsColumns::COMMANDS);
+
+					_armies = armies.GetSpans();
+					_commands = commands.GetSpans();
+					_resources = resources.GetSpans();
+					_player = player;
+					_nextevent = 0;
+					_steps = 0;
+					for (size_t type = 0; type < types.GetCount(); type++)
+						_unittypes.push_back(FindSimulationUnitType(types.GetName(static_cast<uint16_t>(type))));
+					for (size_t name = 0; name < names.GetCount(); name++)
+						_actionsbyname.push_back(Agent::ParseAction(names.GetName(static_cast<uint16_t>(name)).data(), names.GetName(static_cast<uint16_t>(name)).size()));
+
+					//Only the resources of the player are known to the agent
+					AddEvents(Event::Kind::Unit, replay.armies.firstrow, replay.armies.endrow, _armies.seconds);
+					AddEvents(Event::Kind::Survivor, replay.armies.endrow, replay.armies.lastrow, _armies.seconds);
+					AddEvents(Event::Kind::Command, replay.commands.firstrow, replay.commands.lastrow, _commands.seconds);
+					for (uint32_t row = replay.resources.firstrow; row < replay.resources.lastrow; row++)
+					{
+						if (_resources.players[row] == player)
+							_events.push_back({ GetGameLoop(_resources.seconds[row]), Event::Kind::Resources, row });
+					}
+					std::sort(_events.begin(), _events.end());
+
+					//Every player starts where its first unit was trained, the agent plays its player even if it has no unit
+					_players[player] = Player();
+					for (const auto& event : _events)
+					{
+						if (event.kind == Event::Kind::Unit || event.kind == Event::Kind::Survivor)
+						{
+							auto inserted = _players.emplace(_armies.players[event.row], Player());
+							Player& current = inserted.first->second;
+
+							if (!current.haslocation)
+							{
+								current.startlocation = Point2D(_armies.x[event.row], _armies.y[event.row]);
+								current.haslocation = true;
+							}
+							if (event.kind == Event::Kind::Survivor)
+								current.survivors.insert(_armies.tags[event.row]);
+						}
+						else if (event.kind == Event::Kind::Command)
+						{
+							Agent::Action action = _actionsbyname[_commands.commands[event.row]];
+
+							_players.emplace(_commands.players[event.row], Player());
+							if (_commands.players[event.row] == player && action != Agent::Action::NONE)
+								_decisions.push_back({ event.gameloop, action });
+						}
+					}
+					AddStartUnits();
+					_observation.Advance(0);
+				}
+
+				//Returns the players of a replay by their resources, the agent can play any of them
+				static std::vector<uint16_t> GetPlayers(const Repository::ResourcesRepository& resources, const Repository::RepositoryJoinReplay& replay)
+				{
+					const Repository::ResourcesSpans spans = resources.GetSpans();
+					std::vector<uint16_t> players;
+
+					for (uint32_t row = replay.resources.firstrow; row < replay.resources.lastrow; row++)
+					{
+						if (std::find(players.begin(), players.end(), spans.players[row]) == players.end())
+							players.push_back(spans.players[row]);
+					}
+					std::sort(players.begin(), players.end());
+
+					return players;
+				}
+
+				//Moves the game on by the game loops of a step, and returns false once every row of the replay has been played
+				bool Step(uint32_t loops)
+				{
+					uint32_t gameloop = _observation.GetGameLoop() + loops;
+
+					if (_nextevent >= _events.size())
+						return false;
+
+					while (_nextevent < _events.size() && _events[_nextevent].gameloop <= gameloop)
+						Apply(_events[_nextevent++]);
+					_observation.Advance(gameloop);
+					_steps++;
+
+					return true;
+				}
+
+				//Plays the whole replay against the agent, each step moves the game on by the step size like the game does in a step
+				//The agent is told what has happened in the order of the client of the game, then steps, and its commands are sent at the end of the step
+				void Run(sc2::Agent& agent, uint32_t stepsize = 1)
+				{
+					agent.OnGameStart();
+					_actions.SendActions();
+					while (Step(stepsize))
+					{
+						for (const auto& unit : _observation.GetDestroyedUnits())
+							agent.OnUnitDestroyed(unit);
+						for (const auto& unit : _observation.GetCreatedUnits())
+							agent.OnUnitCreated(unit);
+						for (const auto& unit : _observation.GetIdleUnits())
+							agent.OnUnitIdle(unit);
+						for (const auto& upgrade : _observation.GetCompletedUpgrades())
+							agent.OnUpgradeCompleted(upgrade);
+						for (const auto& unit : _observation.GetConstructedUnits())
+							agent.OnBuildingConstructionComplete(unit);
+						_observation.ClearEvents();
+
+						agent.OnStep();
+						_actions.SendActions();
+					}
+					agent.OnGameEnd();
+				}
+
+				ReplayObservation& GetObservation()
+				{
+					return _observation;
+				}
+
+				ReplayActions& GetActions()
+				{
+					return _actions;
+				}
+
+				//Returns the actions that the player has commanded, at their game loops
+				const std::vector<SimulationDecision>& GetDecisions() const
+				{
+					return _decisions;
+				}
+
+				uint64_t GetStepCount() const
+				{
+					return _steps;
+				}
+		};
+	}
+}
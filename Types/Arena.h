@@ -0,0 +1,67 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace KoKeKoKo
+{
+	namespace Types
+	{
+		using namespace std;
+
+		//A fixed pool of items that many threads take runs of items from without locking, the items are only given back all at once
+		//The items are constructed once when the arena is created, so a taken item still has what was written into it before
+		template<typename T>
+		class Arena
+		{
+			private:
+				vector<T> _items;
+				//The index of the first item that has not been taken, it goes past the capacity once the arena has run out
+				atomic<size_t> _next;
+
+				Arena(const Arena&);
+				Arena& operator=(const Arena&);
+
+			public:
+				Arena(size_t capacity) : _items(capacity)
+				{
+					_next = 0;
+				}
+
+				//Takes a run of items that are next to each other, and returns nullptr if the arena does not have that many left
+				T* Allocate(size_t count)
+				{
+					size_t first = _next.fetch_add(count, memory_order_relaxed);
+
+					if ((first + count) > _items.size())
+						return nullptr;
+
+					return &_items[first];
+				}
+
+				//Gives back every item, must not be called while another thread can still allocate or use them
+				void Reset()
+				{
+					_next = 0;
+				}
+
+				//Returns true if an allocation has failed since the last reset
+				bool IsExhausted() const
+				{
+					return (_next.load(memory_order_relaxed) > _items.size());
+				}
+
+				size_t GetAllocatedCount() const
+				{
+					return min(_next.load(memory_order_relaxed), _items.size());
+				}
+
+				size_t GetCapacity() const
+				{
+					return _items.size();
+				}
+		};
+	}
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace KoKeKoKo
+{
+	namespace Types
+	{
+		using namespace std;
+		//The linear sub-buckets of every power of two are 2^HISTOGRAM_SUBBUCKETBITS, so a recorded value is off by at most 1/32 of itself
+		const uint32_t HISTOGRAM_SUBBUCKETBITS = 5;
+		const uint64_t HISTOGRAM_SUBBUCKETS = 1ULL << HISTOGRAM_SUBBUCKETBITS;
+		//Enough buckets for every 64 bit value
+		const size_t HISTOGRAM_BUCKETS = static_cast<size_t>((65 - HISTOGRAM_SUBBUCKETBITS) * HISTOGRAM_SUBBUCKETS);
+
+		//Counts values in buckets that keep the same relative precision from the smallest to the largest value, like an HDR histogram
+		//The values below HISTOGRAM_SUBBUCKETS are exact, every higher power of two is split into HISTOGRAM_SUBBUCKETS linear buckets
+		//Recording never allocates, and a histogram must only be recorded and read by one thread
+		class Histogram
+		{
+			private:
+				vector<uint64_t> _counts;
+				uint64_t _count;
+				uint64_t _minimum;
+				uint64_t _maximum;
+				//The sum of the values for the mean, a double does not overflow
+				double _sum;
+
+				//Returns the index of the highest set bit of a value that is not zero
+				static uint32_t GetHighestBit(uint64_t value)
+				{
+					uint32_t bit = 0;
+
+					for (uint32_t shift = 32; shift > 0; shift /= 2)
+					{
+						if ((value >> shift) != 0)
+						{
+							value >>= shift;
+							bit += shift;
+						}
+					}
+
+					return bit;
+				}
+
+				static size_t GetBucket(uint64_t value)
+				{
+					if (value < HISTOGRAM_SUBBUCKETS)
+						return static_cast<size_t>(value);
+
+					uint32_t shift = GetHighestBit(value) - HISTOGRAM_SUBBUCKETBITS;
+					return static_cast<size_t>((shift * HISTOGRAM_SUBBUCKETS) + (value >> shift));
+				}
+
+				//Returns the highest value that is counted in the bucket
+				static uint64_t GetHighestValue(size_t bucket)
+				{
+					if (bucket < (2 * HISTOGRAM_SUBBUCKETS))
+						return bucket;
+
+					uint32_t shift = static_cast<uint32_t>(bucket / HISTOGRAM_SUBBUCKETS) - 1;
+					uint64_t subbucket = bucket - (shift * HISTOGRAM_SUBBUCKETS);
+					return (((subbucket + 1) << shift) - 1);
+				}
+
+			public:
+				Histogram() : _counts(HISTOGRAM_BUCKETS, 0)
+				{
+					Reset();
+				}
+
+				void Record(uint64_t value)
+				{
+					_counts[GetBucket(value)]++;
+					_count++;
+					_minimum = min(_minimum, value);
+					_maximum = max(_maximum, value);
+					_sum += static_cast<double>(value);
+				}
+
+				void Reset()
+				{
+					fill(_counts.begin(), _counts.end(), 0);
+					_count = 0;
+					_minimum = numeric_limits<uint64_t>::max();
+					_maximum = 0;
+					_sum = 0;
+				}
+
+				//Adds the values that another histogram has recorded
+				void Add(const Histogram& histogram)
+				{
+					for (size_t bucket = 0; bucket < _counts.size(); bucket++)
+						_counts[bucket] += histogram._counts[bucket];
+					_count += histogram._count;
+					_minimum = min(_minimum, histogram._minimum);
+					_maximum = max(_maximum, histogram._maximum);
+					_sum += histogram._sum;
+				}
+
+				//Returns the value that the percentile of the recorded values are at or below, off by at most the precision of its bucket
+				uint64_t GetValueAtPercentile(double percentile) const
+				{
+					uint64_t rank = static_cast<uint64_t>((min(max(percentile, 0.0), 100.0) / 100.0) * _count + 0.5), seen = 0;
+
+					if (_count == 0)
+						return 0;
+
+					rank = max<uint64_t>(rank, 1);
+					for (size_t bucket = 0; bucket < _counts.size(); bucket++)
+					{
+						seen += _counts[bucket];
+						if (seen >= rank)
+							return min(GetHighestValue(bucket), _maximum);
+					}
+
+					return _maximum;
+				}
+
+				uint64_t GetCount() const
+				{
+					return _count;
+				}
+
+				uint64_t GetMinimum() const
+				{
+					return ((_count > 0) ? _minimum : 0);
+				}
+
+				uint64_t GetMaximum() const
+				{
+					return _maximum;
+				}
+
+				double GetMean() const
+				{
+					return ((_count > 0) ? (_sum / _count) : 0.0);
+				}
+		};
+	}
+}
@@ -0,0 +1,400 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SpscQueue.h"
+
+//The lowest level that is logged, the calls of the lower levels are left out at compile time
+//Define KOKEKOKO_LOGLEVEL to one of the levels below, the default logs everything in debug builds and leaves out the debug messages otherwise
+#define KOKEKOKO_LOGLEVEL_DEBUG 0
+#define KOKEKOKO_LOGLEVEL_INFO 1
+#define KOKEKOKO_LOGLEVEL_WARNING 2
+#define KOKEKOKO_LOGLEVEL_ERROR 3
+#ifndef KOKEKOKO_LOGLEVEL
+	#if _DEBUG
+		#define KOKEKOKO_LOGLEVEL KOKEKOKO_LOGLEVEL_DEBUG
+	#else
+		#define KOKEKOKO_LOGLEVEL KOKEKOKO_LOGLEVEL_INFO
+	#endif
+#endif
+
+//Every {} of the format is replaced by the next argument when the message is written, the format must outlive the logger, such as a string literal
+#if KOKEKOKO_LOGLEVEL <= KOKEKOKO_LOGLEVEL_DEBUG
+	#define KOKEKOKO_LOG_DEBUG(...) KoKeKoKo::Types::Logger::Log(KoKeKoKo::Types::LogLevel::Debug, __VA_ARGS__)
+#else
+	#define KOKEKOKO_LOG_DEBUG(...)
+#endif
+#if KOKEKOKO_LOGLEVEL <= KOKEKOKO_LOGLEVEL_INFO
+	#define KOKEKOKO_LOG_INFO(...) KoKeKoKo::Types::Logger::Log(KoKeKoKo::Types::LogLevel::Info, __VA_ARGS__)
+#else
+	#define KOKEKOKO_LOG_INFO(...)
+#endif
+#if KOKEKOKO_LOGLEVEL <= KOKEKOKO_LOGLEVEL_WARNING
+	#define KOKEKOKO_LOG_WARNING(...) KoKeKoKo::Types::Logger::Log(KoKeKoKo::Types::LogLevel::Warning, __VA_ARGS__)
+#else
+	#define KOKEKOKO_LOG_WARNING(...)
+#endif
+#define KOKEKOKO_LOG_ERROR(...) KoKeKoKo::Types::Logger::Log(KoKeKoKo::Types::LogLevel::Error, __VA_ARGS__)
+
+namespace KoKeKoKo
+{
+	namespace Types
+	{
+		using namespace std;
+		//The messages that a thread can keep until the writer takes them, newer messages are dropped
+		const size_t LOGGER_QUEUEDRECORDS = 1024;
+		//The arguments of a message, and the characters of the strings among them, a longer string is cut off
+		const size_t LOGGER_MAXIMUMARGUMENTS = 8;
+		const size_t LOGGER_TEXTSIZE = 256;
+		//How long the writer sleeps when nothing has been logged
+		const chrono::milliseconds LOGGER_WRITEINTERVAL = chrono::milliseconds(10);
+
+		enum class LogLevel : uint8_t
+		{
+			Debug,
+			Info,
+			Warning,
+			Error
+		};
+
+		enum class LogArgumentType : uint8_t
+		{
+			Integer,
+			Unsigned,
+			Real,
+			Text
+		};
+
+		//An argument as it was passed, it is only turned into text by the writer
+		struct LogArgument
+		{
+			LogArgumentType type;
+			//Where the characters of a string are in the text of the record
+			uint16_t offset;
+			uint16_t length;
+			union
+			{
+				int64_t integer;
+				uint64_t natural;
+				double real;
+			};
+		};
+
+		//A message that has been logged but not formatted
+		struct LogRecord
+		{
+			//The nanoseconds since the logger has started
+			int64_t time;
+			const char* format;
+			LogLevel level;
+			uint8_t count;
+			uint16_t textsize;
+			uint32_t thread;
+			LogArgument arguments[LOGGER_MAXIMUMARGUMENTS];
+			char text[LOGGER_TEXTSIZE];
+		};
+
+		//Logs the messages of every thread without blocking it on the output
+		//A thread copies the arguments of its messages into a queue of its own, and a single writer thread formats and writes them in batches in the order they were logged
+		class Logger
+		{
+			private:
+				typedef SpscQueue<LogRecord> LogQueue;
+
+				//When the logger has started, every message is timed from it
+				chrono::steady_clock::time_point _epoch;
+				//Guards the queues, the output and the state of the writer, the messages themselves are queued without it
+				mutex _loggerlock;
+				condition_variable _loggercondition;
+				vector<unique_ptr<LogQueue>> _queues;
+				ostream* _output;
+				thread* _writer;
+				bool _shouldkeepwriting;
+				//The number of flushes that have been asked for, and the number that the writer has finished
+				uint64_t _flushrequests;
+				uint64_t _flushed;
+				//The messages and the formatted output of a batch, only used by the writer
+				vector<LogRecord> _batch;
+				ostringstream _formatter;
+
+				Logger(const Logger&);
+				Logger& operator=(const Logger&);
+
+				Logger()
+				{
+					_epoch = chrono::steady_clock::now();
+					_output = nullptr;
+					_writer = nullptr;
+					_shouldkeepwriting = false;
+					_flushrequests = 0;
+					_flushed = 0;
+				}
+
+				~Logger()
+				{
+					Stop();
+				}
+
+				static Logger& GetLogger()
+				{
+					static Logger logger;
+
+					return logger;
+				}
+
+				//Returns the queue of the calling thread, it is created on the first message of the thread
+				static LogQueue& GetQueue(uint32_t& thread)
+				{
+					static thread_local LogQueue* queue = nullptr;
+					static thread_local uint32_t queueindex = 0;
+
+					if (queue == nullptr)
+					{
+						Logger& logger = GetLogger();
+						lock_guard<mutex> lock(logger._loggerlock);
+
+						logger._queues.push_back(unique_ptr<LogQueue>(new LogQueue(LOGGER_QUEUEDRECORDS, OverflowPolicy::DropNewest)));
+						queue = logger._queues.back().get();
+						queueindex = static_cast<uint32_t>(logger._queues.size());
+					}
+					thread = queueindex;
+
+					return *queue;
+				}
+
+				static void AddArgument(LogRecord& record, LogArgumentType type, int64_t integer)
+				{
+					LogArgument& argument = record.arguments[record.count++];
+
+					argument.type = type;
+					argument.integer = integer;
+				}
+
+				static void AddArgument(LogRecord& record, const char* text, size_t length)
+				{
+					LogArgument& argument = record.arguments[record.count++];
+
+					argument.type = LogArgumentType::Text;
+					argument.offset = record.textsize;
+					argument.length = static_cast<uint16_t>(min(length, LOGGER_TEXTSIZE - record.textsize));
+					memcpy(record.text + argument.offset, text, argument.length);
+					record.textsize += argument.length;
+				}
+
+				static void AddArguments(LogRecord&) {}
+
+				template<typename Argument, typename... Arguments>
+				static void AddArguments(LogRecord& record, const Argument& argument, const Arguments&... arguments)
+				{
+					AddArgument(record, argument);
+					AddArguments(record, arguments...);
+				}
+
+				static void AddArgument(LogRecord& record, bool value) { AddArgument(record, value ? "true" : "false"); }
+				static void AddArgument(LogRecord& record, int value) { AddArgument(record, LogArgumentType::Integer, value); }
+				static void AddArgument(LogRecord& record, long value) { AddArgument(record, LogArgumentType::Integer, value); }
+				static void AddArgument(LogRecord& record, long long value) { AddArgument(record, LogArgumentType::Integer, value); }
+				static void AddArgument(LogRecord& record, unsigned int value) { AddArgument(record, LogArgumentType::Unsigned, value); }
+				static void AddArgument(LogRecord& record, unsigned long value) { AddArgument(record, LogArgumentType::Unsigned, value); }
+				static void AddArgument(LogRecord& record, unsigned long long value) { AddArgument(record, LogArgumentType::Unsigned, static_cast<int64_t>(value)); }
+				static void AddArgument(LogRecord& record, double value)
+				{
+					LogArgument& argument = record.arguments[record.count++];
+
+					argument.type = LogArgumentType::Real;
+					argument.real = value;
+				}
+				static void AddArgument(LogRecord& record, float value) { AddArgument(record, static_cast<double>(value)); }
+				static void AddArgument(LogRecord& record, const char* value) { AddArgument(record, value, strlen(value)); }
+				static void AddArgument(LogRecord& record, const string& value) { AddArgument(record, value.data(), value.size()); }
+
+				static const char* GetLevelName(LogLevel level)
+				{
+					switch (level)
+					{
+						case LogLevel::Debug:
+							return "DEBUG";
+						case LogLevel::Info:
+							return "INFO";
+						case LogLevel::Warning:
+							return "WARNING";
+						default:
+							return "ERROR";
+					}
+				}
+
+				//Formats a message as a line of its time, its level, the thread that logged it, and its format with the arguments in place of every {}
+				void Format(const LogRecord& record)
+				{
+					size_t next = 0;
+
+					_formatter << (record.time / 1000000000) << '.' << setw(6) << setfill('0') << ((record.time / 1000) % 1000000) << ' ' << GetLevelName(record.level) << " [" << record.thread << "] ";
+					for (const char* character = record.format; *character != '\0'; character++)
+					{
+						if (character[0] == '{' && character[1] == '}' && next < record.count)
+						{
+							const LogArgument& argument = record.arguments[next++];
+
+							switch (argument.type)
+							{
+								case LogArgumentType::Integer:
+									_formatter << argument.integer;
+									break;
+								case LogArgumentType::Unsigned:
+									_formatter << argument.natural;
+									break;
+								case LogArgumentType::Real:
+									_formatter << argument.real;
+									break;
+								case LogArgumentType::Text:
+									_formatter.write(record.text + argument.offset, argument.length);
+									break;
+							}
+							character++;
+						}
+						else
+							_formatter << *character;
+					}
+					_formatter << '\n';
+				}
+
+				//Takes the messages of every thread, and writes them in the order that they were logged
+				//Must only be called by the writer, with the lock held
+				size_t WriteBatch()
+				{
+					LogRecord record;
+
+					_batch.clear();
+					for (const auto& queue : _queues)
+						while (queue->TryPop(record))
+							_batch.push_back(record);
+					if (_batch.empty())
+						return 0;
+
+					stable_sort(_batch.begin(), _batch.end(), [](const LogRecord& first, const LogRecord& second) { return (first.time < second.time); });
+					_formatter.str("");
+					for (const auto& batchrecord : _batch)
+						Format(batchrecord);
+					if (_output != nullptr)
+					{
+						string output = _formatter.str();
+
+						_output->write(output.data(), output.size());
+						_output->flush();
+					}
+
+					return _batch.size();
+				}
+
+				void WriteMessages()
+				{
+					unique_lock<mutex> lock(_loggerlock);
+
+					for (;;)
+					{
+						uint64_t flushrequests = _flushrequests;
+						bool shouldkeepwriting = _shouldkeepwriting;
+
+						WriteBatch();
+						_flushed = flushrequests;
+						_loggercondition.notify_all();
+						if (!shouldkeepwriting)
+							break;
+
+						_loggercondition.wait_for(lock, LOGGER_WRITEINTERVAL, [this, flushrequests]() { return (!_shouldkeepwriting || _flushrequests != flushrequests); });
+					}
+				}
+
+			public:
+				//Queues a message of the calling thread, it is dropped if the thread already keeps LOGGER_QUEUEDRECORDS messages
+				//The arguments are copied as they are, numbers, strings and anything else that can be written to a stream with a conversion to one of them
+				template<typename... Arguments>
+				static void Log(LogLevel level, const char* format, const Arguments&... arguments)
+				{
+					static_assert(sizeof...(Arguments) <= LOGGER_MAXIMUMARGUMENTS, "Too many arguments for a message");
+					LogRecord record;
+
+					record.time = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - GetLogger()._epoch).count();
+					record.format = format;
+					record.level = level;
+					record.count = 0;
+					record.textsize = 0;
+					AddArguments(record, arguments...);
+					GetQueue(record.thread).Push(record);
+				}
+
+				//Starts the writer, which writes the messages to the output until the logger is stopped, the output has to stay alive until then
+				static void Start(ostream& output)
+				{
+					Logger& logger = GetLogger();
+
+					Stop();
+					lock_guard<mutex> lock(logger._loggerlock);
+					logger._output = &output;
+					logger._shouldkeepwriting = true;
+					logger._writer = new thread(&Logger::WriteMessages, &logger);
+				}
+
+				//Writes the messages that are left and stops the writer, the messages that are logged afterwards wait for the next start
+				static void Stop()
+				{
+					Logger& logger = GetLogger();
+					thread* writer = nullptr;
+
+					{
+						lock_guard<mutex> lock(logger._loggerlock);
+						logger._shouldkeepwriting = false;
+						writer = logger._writer;
+						logger._writer = nullptr;
+					}
+					logger._loggercondition.notify_all();
+					if (writer != nullptr)
+					{
+						if (writer->joinable())
+							writer->join();
+						delete writer;
+					}
+				}
+
+				//Waits until the messages that have been logged before the call have been written, such as before writing to the output directly
+				static void Flush()
+				{
+					Logger& logger = GetLogger();
+					unique_lock<mutex> lock(logger._loggerlock);
+					uint64_t request = ++logger._flushrequests;
+
+					if (logger._writer == nullptr)
+						return;
+
+					logger._loggercondition.notify_all();
+					logger._loggercondition.wait(lock, [&logger, request]() { return (logger._flushed >= request || logger._writer == nullptr); });
+				}
+
+				//Returns the messages that have been dropped by every thread since the logger has started
+				static uint64_t GetDroppedCount()
+				{
+					Logger& logger = GetLogger();
+					lock_guard<mutex> lock(logger._loggerlock);
+					uint64_t dropped = 0;
+
+					for (const auto& queue : logger._queues)
+						dropped += queue->GetDroppedCount();
+
+					return dropped;
+				}
+		};
+	}
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+	#include <Windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace KoKeKoKo
+{
+	namespace Types
+	{
+		using namespace std;
+
+		#if !defined(_WIN32) && defined(MAP_POPULATE)
+		//The pages of the whole file are read in while it is mapped, instead of one fault for each page as it is touched
+		const int MAPPEDFILE_FLAGS = MAP_PRIVATE | MAP_POPULATE;
+		#elif !defined(_WIN32)
+		const int MAPPEDFILE_FLAGS = MAP_PRIVATE;
+		#endif
+
+		//A file that is mapped into memory read-only, it stays mapped until it is destroyed
+		class MappedFile
+		{
+			private:
+				const char* _data;
+				size_t _size;
+				#ifdef _WIN32
+				HANDLE _file;
+				HANDLE _mapping;
+				#else
+				int _file;
+				#endif
+
+				MappedFile(const MappedFile&);
+				MappedFile& operator=(const MappedFile&);
+
+				void Close()
+				{
+					#ifdef _WIN32
+					if (_data != nullptr)
+						UnmapViewOfFile(_data);
+					if (_mapping != nullptr)
+						CloseHandle(_mapping);
+					if (_file != INVALID_HANDLE_VALUE)
+						CloseHandle(_file);
+					_mapping = nullptr;
+					_file = INVALID_HANDLE_VALUE;
+					#else
+					if (_data != nullptr)
+						munmap(const_cast<char*>(_data), _size);
+					if (_file >= 0)
+						close(_file);
+					_file = -1;
+					#endif
+					_data = nullptr;
+					_size = 0;
+				}
+
+			public:
+				//Maps the whole file, an empty file has no data
+				MappedFile(const string& path)
+				{
+					_data = nullptr;
+					_size = 0;
+					#ifdef _WIN32
+					LARGE_INTEGER size;
+
+					_mapping = nullptr;
+					_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+					if (_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(_file, &size))
+					{
+						Close();
+						throw runtime_error("Error Occurred! Failed to open " + path + " for mapping...");
+					}
+					_size = static_cast<size_t>(size.QuadPart);
+					if (_size > 0)
+					{
+						_mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+						_data = (_mapping != nullptr) ? static_cast<const char*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+						if (_data == nullptr)
+						{
+							Close();
+							throw runtime_error("Error Occurred! Failed to map " + path + "...");
+						}
+					}
+					#else
+					struct stat status;
+
+					_file = open(path.c_str(), O_RDONLY);
+					if (_file < 0 || fstat(_file, &status) != 0)
+					{
+						Close();
+						throw runtime_error("Error Occurred! Failed to open " + path + " for mapping...");
+					}
+					_size = static_cast<size_t>(status.st_size);
+					if (_size > 0)
+					{
+						void* data = mmap(nullptr, _size, PROT_READ, MAPPEDFILE_FLAGS, _file, 0);
+
+						if (data == MAP_FAILED)
+						{
+							_size = 0;
+							Close();
+							throw runtime_error("Error Occurred! Failed to map " + path + "...");
+						}
+						_data = static_cast<const char*>(data);
+						//The file is usually read from the start to the end, so the pages ahead are read early
+						madvise(data, _size, MADV_SEQUENTIAL);
+					}
+					#endif
+				}
+
+				~MappedFile()
+				{
+					Close();
+				}
+
+				const char* GetData() const
+				{
+					return _data;
+				}
+
+				size_t GetSize() const
+				{
+					return _size;
+				}
+		};
+	}
+}
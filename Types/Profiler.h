@@ -0,0 +1,344 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+//Define KOKEKOKO_PROFILER to time the zones of the agent, otherwise the macros below leave nothing behind
+//KOKEKOKO_PROFILE_ZONE times the rest of the enclosing scope under a name that must outlive the profiler, such as a string literal
+//KOKEKOKO_PROFILE_THREAD names the calling thread in the trace
+#if KOKEKOKO_PROFILER
+	#define KOKEKOKO_PROFILE_CONCATENATE(first, second) first##second
+	#define KOKEKOKO_PROFILE_ZONENAME(line) KOKEKOKO_PROFILE_CONCATENATE(profilerzone, line)
+	#define KOKEKOKO_PROFILE_ZONE(name) KoKeKoKo::Types::ProfilerZone KOKEKOKO_PROFILE_ZONENAME(__LINE__)(name)
+	#define KOKEKOKO_PROFILE_THREAD(name) KoKeKoKo::Types::Profiler::SetThreadName(name)
+#else
+	#define KOKEKOKO_PROFILE_ZONE(name)
+	#define KOKEKOKO_PROFILE_THREAD(name)
+#endif
+
+namespace KoKeKoKo
+{
+	namespace Types
+	{
+		using namespace std;
+		//The zones of a chunk, a thread only allocates when it has filled one
+		const size_t PROFILER_CHUNKEVENTS = 4096;
+		//The zones that a thread can keep until they are written, newer zones are dropped
+		const uint64_t PROFILER_MAXIMUMEVENTS = 1ULL << 20;
+
+		//A timed zone, in nanoseconds since the profiler has started
+		struct ProfilerEvent
+		{
+			const char* name;
+			int64_t begin;
+			int64_t end;
+		};
+
+		//The zones of a thread are appended to a list of chunks, a chunk is never touched by the thread again once it has moved on to the next one
+		struct ProfilerChunk
+		{
+			ProfilerEvent events[PROFILER_CHUNKEVENTS];
+			atomic<size_t> count;
+			atomic<ProfilerChunk*> next;
+
+			ProfilerChunk() : count(0), next(nullptr) {}
+		};
+
+		//The zones of a single thread, recorded by that thread without locking and taken by the thread that writes the trace
+		class ProfilerBuffer
+		{
+			private:
+				//The chunk that is being filled and the zones that have been recorded, only used by the recording thread
+				ProfilerChunk* _last;
+				uint64_t _recorded;
+				//The oldest chunk that has not been written and the next zone of it, only used by the writing thread
+				ProfilerChunk* _first;
+				size_t _read;
+				//The zones that have been written, so that the recording thread knows how many it keeps
+				atomic<uint64_t> _released;
+				atomic<uint64_t> _dropped;
+				uint32_t _threadid;
+
+				ProfilerBuffer(const ProfilerBuffer&);
+				ProfilerBuffer& operator=(const ProfilerBuffer&);
+
+			public:
+				ProfilerBuffer(uint32_t threadid) : _released(0), _dropped(0)
+				{
+					_first = new ProfilerChunk();
+					_last = _first;
+					_recorded = 0;
+					_read = 0;
+					_threadid = threadid;
+				}
+
+				~ProfilerBuffer()
+				{
+					while (_first != nullptr)
+					{
+						ProfilerChunk* next = _first->next.load(memory_order_relaxed);
+
+						delete _first;
+						_first = next;
+					}
+				}
+
+				//Must only be called by the thread that the buffer belongs to
+				void Record(const ProfilerEvent& event)
+				{
+					size_t count = _last->count.load(memory_order_relaxed);
+
+					if (_recorded - _released.load(memory_order_acquire) >= PROFILER_MAXIMUMEVENTS)
+					{
+						_dropped.fetch_add(1, memory_order_relaxed);
+						return;
+					}
+
+					if (count == PROFILER_CHUNKEVENTS)
+					{
+						ProfilerChunk* chunk = new ProfilerChunk();
+
+						_last->next.store(chunk, memory_order_release);
+						_last = chunk;
+						count = 0;
+					}
+					_last->events[count] = event;
+					_last->count.store(count + 1, memory_order_release);
+					_recorded++;
+				}
+
+				//Hands every zone that has been recorded since the last call to the function, and frees the chunks that the recording thread has left
+				//Must only be called by one thread at a time
+				template<typename Function>
+				uint64_t Take(Function function)
+				{
+					uint64_t taken = 0;
+
+					for (;;)
+					{
+						//The next chunk is read first, once it exists the count of this one does not change anymore
+						ProfilerChunk* next = _first->next.load(memory_order_acquire);
+						size_t count = _first->count.load(memory_order_acquire);
+
+						for (; _read < count; _read++, taken++)
+							function(_first->events[_read]);
+						if (next == nullptr)
+							break;
+
+						delete _first;
+						_first = next;
+						_read = 0;
+					}
+					_released.fetch_add(taken, memory_order_release);
+
+					return taken;
+				}
+
+				uint64_t GetDroppedCount() const
+				{
+					return _dropped.load(memory_order_relaxed);
+				}
+
+				uint32_t GetThreadID() const
+				{
+					return _threadid;
+				}
+		};
+
+		//Collects the zones of every thread and writes them as a Chrome trace, which chrome://tracing and Perfetto open
+		//A thread gets its own buffer when it records its first zone, the buffers are kept after their threads have ended until the profiler is destroyed
+		class Profiler
+		{
+			private:
+				//When the profiler has started, every zone is relative to it
+				chrono::steady_clock::time_point _epoch;
+				//Guards the list of buffers and the names of the threads, the zones themselves are recorded without it
+				mutex _bufferslock;
+				vector<unique_ptr<ProfilerBuffer>> _buffers;
+				vector<string> _threadnames;
+
+				Profiler(const Profiler&);
+				Profiler& operator=(const Profiler&);
+
+				Profiler()
+				{
+					_epoch = chrono::steady_clock::now();
+				}
+
+				static Profiler& GetProfiler()
+				{
+					static Profiler profiler;
+
+					return profiler;
+				}
+
+				//Returns the buffer of the calling thread, it is created on the first call of the thread
+				static ProfilerBuffer& GetBuffer()
+				{
+					static thread_local ProfilerBuffer* buffer = nullptr;
+
+					if (buffer == nullptr)
+					{
+						Profiler& profiler = GetProfiler();
+						lock_guard<mutex> lock(profiler._bufferslock);
+
+						profiler._buffers.push_back(unique_ptr<ProfilerBuffer>(new ProfilerBuffer(static_cast<uint32_t>(profiler._buffers.size() + 1))));
+						profiler._threadnames.push_back("Thread " + to_string(profiler._buffers.size()));
+						buffer = profiler._buffers.back().get();
+					}
+
+					return *buffer;
+				}
+
+				static void AppendName(string& line, const char* name)
+				{
+					line += '"';
+					for (const char* character = name; *character != '\0'; character++)
+					{
+						if (*character == '"' || *character == '\\')
+							line += '\\';
+						line += *character;
+					}
+					line += '"';
+				}
+
+				//Appends the nanoseconds as microseconds with three decimals, which is what a Chrome trace counts in
+				//The digits are written by hand, formatting a double through the stream takes longer than recording the zone
+				static void AppendMicroseconds(string& line, int64_t nanoseconds)
+				{
+					char digits[24];
+					size_t count = 0;
+					uint64_t value = static_cast<uint64_t>((nanoseconds < 0) ? -nanoseconds : nanoseconds);
+
+					do
+					{
+						digits[count++] = static_cast<char>('0' + (value % 10));
+						value /= 10;
+					} while (value > 0 || count < 4);
+					if (nanoseconds < 0)
+						line += '-';
+					while (count > 0)
+					{
+						line += digits[--count];
+						if (count == 3)
+							line += '.';
+					}
+				}
+
+			public:
+				//Returns the nanoseconds since the profiler has started
+				static int64_t Now()
+				{
+					return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - GetProfiler()._epoch).count();
+				}
+
+				//Records a zone of the calling thread, it is dropped if the thread already keeps PROFILER_MAXIMUMEVENTS zones
+				static void Record(const char* name, int64_t begin, int64_t end)
+				{
+					ProfilerEvent event;
+
+					event.name = name;
+					event.begin = begin;
+					event.end = end;
+					GetBuffer().Record(event);
+				}
+
+				static void SetThreadName(const string& name)
+				{
+					ProfilerBuffer& buffer = GetBuffer();
+					Profiler& profiler = GetProfiler();
+					lock_guard<mutex> lock(profiler._bufferslock);
+
+					profiler._threadnames[buffer.GetThreadID() - 1] = name;
+				}
+
+				//Writes the zones that every thread has recorded since the last trace as a Chrome trace, and returns the number of written zones
+				static uint64_t Write(const string& filename)
+				{
+					Profiler& profiler = GetProfiler();
+					lock_guard<mutex> lock(profiler._bufferslock);
+					ofstream output(filename, ios::out | ios::trunc);
+					uint64_t written = 0;
+
+					if (!output.is_open())
+						throw runtime_error("Error Occurred! Failed to open " + filename + " to write the profile...");
+
+					string line;
+
+					output << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+					for (size_t thread = 0; thread < profiler._buffers.size(); thread++)
+					{
+						string threadid = to_string(profiler._buffers[thread]->GetThreadID());
+
+						line = ((thread > 0) ? ",\n" : "\n");
+						line += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + threadid + ",\"args\":{\"name\":";
+						AppendName(line, profiler._threadnames[thread].c_str());
+						line += "}}";
+						output << line;
+						written += profiler._buffers[thread]->Take([&output, &line, &threadid](const ProfilerEvent& event)
+						{
+							line = ",\n{\"name\":";
+							AppendName(line, event.name);
+							line += ",\"ph\":\"X\",\"pid\":1,\"tid\":";
+							line += threadid;
+							line += ",\"ts\":";
+							AppendMicroseconds(line, event.begin);
+							line += ",\"dur\":";
+							AppendMicroseconds(line, event.end - event.begin);
+							line += '}';
+							output.write(line.data(), line.size());
+						});
+					}
+					output << "\n]}" << '\n';
+					if (!output)
+						throw runtime_error("Error Occurred! Failed to write the profile to " + filename + "...");
+
+					return written;
+				}
+
+				//Returns the zones that have been dropped by every thread since the profiler has started
+				static uint64_t GetDroppedCount()
+				{
+					Profiler& profiler = GetProfiler();
+					lock_guard<mutex> lock(profiler._bufferslock);
+					uint64_t dropped = 0;
+
+					for (const auto& buffer : profiler._buffers)
+						dropped += buffer->GetDroppedCount();
+
+					return dropped;
+				}
+		};
+
+		//Times the scope that it is declared in, and records the zone when it leaves the scope
+		class ProfilerZone
+		{
+			private:
+				const char* _name;
+				int64_t _begin;
+
+				ProfilerZone(const ProfilerZone&);
+				ProfilerZone& operator=(const ProfilerZone&);
+
+			public:
+				ProfilerZone(const char* name)
+				{
+					_name = name;
+					_begin = Profiler::Now();
+				}
+
+				~ProfilerZone()
+				{
+					Profiler::Record(_name, _begin, Profiler::Now());
+				}
+		};
+	}
+}
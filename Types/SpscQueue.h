@@ -0,0 +1,201 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace KoKeKoKo
+{
+	namespace Types
+	{
+		using namespace std;
+		//The assumed size of a cache line, the indices are kept apart so that both threads do not fight over one line
+		const size_t CACHELINE_SIZE = 64;
+
+		//What happens when an item is pushed to a full queue
+		enum class OverflowPolicy
+		{
+			//The pushed item is discarded and counted as dropped
+			DropNewest,
+			//The producer yields until the consumer has freed a slot or the queue has been closed
+			Wait
+		};
+
+		//A bounded lock-free queue with preallocated slots between exactly one producer thread and one consumer thread
+		template<typename T>
+		class SpscQueue
+		{
+			private:
+				//The slots of the ring buffer, the number of slots is a power of two
+				vector<T> _slots;
+				//The number of slots minus one, used to wrap an index into a slot
+				size_t _mask;
+				//What happens when an item is pushed to a full queue
+				OverflowPolicy _policy;
+				char _padding0[CACHELINE_SIZE];
+				//The index of the next slot to be read, only written by the consumer
+				atomic<size_t> _head;
+				//The last head that the producer has seen, so it only reads the head when the queue looks full
+				size_t _cachedhead;
+				char _padding1[CACHELINE_SIZE];
+				//The index of the next slot to be written, only written by the producer
+				atomic<size_t> _tail;
+				//The last tail that the consumer has seen, so it only reads the tail when the queue looks empty
+				size_t _cachedtail;
+				char _padding2[CACHELINE_SIZE];
+				//If a waiting producer should give up
+				atomic<bool> _isclosed;
+				//The number of items that has been pushed
+				atomic<uint64_t> _pushed;
+				//The number of items that has been popped
+				atomic<uint64_t> _popped;
+				//The number of times an item was pushed to a full queue
+				atomic<uint64_t> _overflows;
+				//The number of items that has been discarded because the queue was full
+				atomic<uint64_t> _dropped;
+
+				SpscQueue(const SpscQueue&);
+				SpscQueue& operator=(const SpscQueue&);
+
+				//Returns the smallest power of two that is not less than the capacity
+				static size_t GetSlotCount(size_t capacity)
+				{
+					size_t slots = 2;
+
+					while (slots < capacity)
+						slots <<= 1;
+
+					return slots;
+				}
+
+			public:
+				SpscQueue(size_t capacity, OverflowPolicy policy = OverflowPolicy::DropNewest) : _slots(GetSlotCount(capacity))
+				{
+					_mask = _slots.size() - 1;
+					_policy = policy;
+					_head = 0;
+					_cachedhead = 0;
+					_tail = 0;
+					_cachedtail = 0;
+					_isclosed = false;
+					_pushed = 0;
+					_popped = 0;
+					_overflows = 0;
+					_dropped = 0;
+				}
+
+				//Pushes an item and returns false if the queue is full, the item is only moved if it has been pushed
+				//Must only be called by the producer thread
+				bool TryPush(T& item)
+				{
+					size_t tail = _tail.load(memory_order_relaxed);
+
+					if ((tail - _cachedhead) > _mask)
+					{
+						_cachedhead = _head.load(memory_order_acquire);
+						if ((tail - _cachedhead) > _mask)
+							return false;
+					}
+
+					_slots[tail & _mask] = move(item);
+					_tail.store(tail + 1, memory_order_release);
+					_pushed.fetch_add(1, memory_order_relaxed);
+					return true;
+				}
+
+				//Pushes an item and applies the overflow policy if the queue is full, returns false if the item has not been pushed
+				//Must only be called by the producer thread
+				bool Push(T item)
+				{
+					if (TryPush(item))
+						return true;
+
+					_overflows.fetch_add(1, memory_order_relaxed);
+					if (_policy == OverflowPolicy::Wait)
+					{
+						while (!_isclosed.load(memory_order_acquire))
+						{
+							this_thread::yield();
+							if (TryPush(item))
+								return true;
+						}
+					}
+
+					_dropped.fetch_add(1, memory_order_relaxed);
+					return false;
+				}
+
+				//Pops the oldest item and returns false if the queue is empty
+				//Must only be called by the consumer thread
+				bool TryPop(T& item)
+				{
+					size_t head = _head.load(memory_order_relaxed);
+
+					if (head == _cachedtail)
+					{
+						_cachedtail = _tail.load(memory_order_acquire);
+						if (head == _cachedtail)
+							return false;
+					}
+
+					item = move(_slots[head & _mask]);
+					_head.store(head + 1, memory_order_release);
+					_popped.fetch_add(1, memory_order_relaxed);
+					return true;
+				}
+
+				//Wakes up a waiting producer, the items that are still in the queue can be popped
+				void Close()
+				{
+					_isclosed = true;
+				}
+
+				//Allows a producer to wait again after the queue has been closed
+				void Reopen()
+				{
+					_isclosed = false;
+				}
+
+				//Returns true if the queue looked empty at the time of the call
+				bool IsEmpty() const
+				{
+					return (_head.load(memory_order_acquire) == _tail.load(memory_order_acquire));
+				}
+
+				//Returns the number of items at the time of the call
+				size_t GetSize() const
+				{
+					size_t head = _head.load(memory_order_acquire);
+					return (_tail.load(memory_order_acquire) - head);
+				}
+
+				size_t GetCapacity() const
+				{
+					return _slots.size();
+				}
+
+				uint64_t GetPushedCount() const
+				{
+					return _pushed;
+				}
+
+				uint64_t GetPoppedCount() const
+				{
+					return _popped;
+				}
+
+				uint64_t GetOverflowCount() const
+				{
+					return _overflows;
+				}
+
+				uint64_t GetDroppedCount() const
+				{
+					return _dropped;
+				}
+		};
+	}
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "SpscQueue.h"
+
+namespace KoKeKoKo
+{
+	namespace Types
+	{
+		using namespace std;
+
+		//Three slots shared by exactly one producer thread and one consumer thread, where the producer publishes whole values without waiting
+		//The producer writes into its own slot and swaps it with the published slot, the consumer swaps the published slot with its own to read it
+		//Neither thread ever sees a slot that the other one is using, and the consumer always gets the newest published value
+		template<typename T>
+		class TripleBuffer
+		{
+			private:
+				//The bit of the published slot that is set when it has not been taken by the consumer yet
+				static const uint32_t FRESH = 4;
+				//The bits of the published slot that hold its index
+				static const uint32_t INDEX = 3;
+
+				T _slots[3];
+				//The slot that the producer writes into, only used by the producer
+				uint32_t _back;
+				char _padding0[CACHELINE_SIZE];
+				//The slot that has been published last, with the fresh bit
+				atomic<uint32_t> _middle;
+				char _padding1[CACHELINE_SIZE];
+				//The slot that the consumer reads from, only used by the consumer
+				uint32_t _front;
+				//The number of values that has been published
+				atomic<uint64_t> _published;
+				//The number of published values that the consumer has taken
+				atomic<uint64_t> _acquired;
+
+				TripleBuffer(const TripleBuffer&);
+				TripleBuffer& operator=(const TripleBuffer&);
+
+			public:
+				TripleBuffer()
+				{
+					_back = 0;
+					_middle = 1;
+					_front = 2;
+					_published = 0;
+					_acquired = 0;
+				}
+
+				//Returns the slot that the producer should write the next value into, it keeps what was written into it before
+				//Must only be called by the producer thread
+				T& GetBackBuffer()
+				{
+					return _slots[_back];
+				}
+
+				//Publishes the back slot as the newest value and gives the producer another slot to write into
+				//Must only be called by the producer thread
+				void Publish()
+				{
+					_back = (_middle.exchange(_back | FRESH, memory_order_acq_rel) & INDEX);
+					_published.fetch_add(1, memory_order_relaxed);
+				}
+
+				//Takes the newest published value if there is one that has not been taken, and returns false otherwise
+				//Must only be called by the consumer thread
+				bool Acquire()
+				{
+					if ((_middle.load(memory_order_relaxed) & FRESH) == 0)
+						return false;
+
+					_front = (_middle.exchange(_front, memory_order_acq_rel) & INDEX);
+					_acquired.fetch_add(1, memory_order_relaxed);
+					return true;
+				}
+
+				//Returns the value that the consumer has taken last, it does not change until the next acquire
+				//Must only be called by the consumer thread
+				const T& GetFrontBuffer() const
+				{
+					return _slots[_front];
+				}
+
+				//The front slot is only touched by the consumer, so it may change it until it acquires the next one
+				T& GetFrontBuffer()
+				{
+					return _slots[_front];
+				}
+
+				uint64_t GetPublishedCount() const
+				{
+					return _published;
+				}
+
+				uint64_t GetAcquiredCount() const
+				{
+					return _acquired;
+				}
+		};
+	}
+}
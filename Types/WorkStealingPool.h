@@ -0,0 +1,191 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "SpscQueue.h"
+
+namespace KoKeKoKo
+{
+	namespace Types
+	{
+		using namespace std;
+
+		//A fixed set of threads where each thread has its own queue of tasks, and takes the oldest task of another thread once its own queue is empty
+		//A task that is submitted from one of the threads goes to the queue of that thread, so a task that keeps resubmitting itself stays on its thread until another one runs dry
+		class WorkStealingPool
+		{
+			private:
+				//The tasks of a thread, its own thread takes the newest task and the other threads take the oldest one
+				struct WorkerQueue
+				{
+					mutex lock;
+					deque<function<void()>> tasks;
+					char padding[CACHELINE_SIZE];
+				};
+
+				vector<unique_ptr<WorkerQueue>> _queues;
+				vector<thread> _threads;
+				//Lock and condition for the idle threads, and for the threads that wait for every task to finish
+				mutex _idlelock;
+				condition_variable _idlecondition;
+				condition_variable _donecondition;
+				//The tasks that are in a queue, and the tasks that are in a queue or running
+				atomic<size_t> _queuedtasks;
+				atomic<size_t> _unfinishedtasks;
+				//The queue that the next task from outside of the pool goes to
+				atomic<size_t> _nextqueue;
+				//The number of tasks that a thread has taken from the queue of another thread
+				atomic<uint64_t> _steals;
+				//If the threads should stop, guarded by the idle lock
+				bool _isstopping;
+
+				WorkStealingPool(const WorkStealingPool&);
+				WorkStealingPool& operator=(const WorkStealingPool&);
+
+				//Returns the index of the pool thread that is calling, or the number of threads if it is not one of them
+				size_t GetCurrentIndex() const
+				{
+					for (size_t index = 0; index < _threads.size(); index++)
+						if (_threads[index].get_id() == this_thread::get_id())
+							return index;
+
+					return _threads.size();
+				}
+
+				bool TryTakeTask(size_t index, function<void()>& task)
+				{
+					//The newest task of its own queue first, since its data is still in the cache
+					{
+						lock_guard<mutex> lock(_queues[index]->lock);
+						if (!_queues[index]->tasks.empty())
+						{
+							task = move(_queues[index]->tasks.back());
+							_queues[index]->tasks.pop_back();
+							return true;
+						}
+					}
+
+					for (size_t offset = 1; offset < _queues.size(); offset++)
+					{
+						WorkerQueue& victim = *_queues[(index + offset) % _queues.size()];
+						lock_guard<mutex> lock(victim.lock);
+
+						if (!victim.tasks.empty())
+						{
+							task = move(victim.tasks.front());
+							victim.tasks.pop_front();
+							_steals++;
+							return true;
+						}
+					}
+
+					return false;
+				}
+
+				void Run(size_t index)
+				{
+					function<void()> task;
+
+					while (true)
+					{
+						if (TryTakeTask(index, task))
+						{
+							_queuedtasks--;
+							task();
+							task = nullptr;
+							if (--_unfinishedtasks == 0)
+							{
+								lock_guard<mutex> lock(_idlelock);
+								_donecondition.notify_all();
+							}
+							continue;
+						}
+
+						unique_lock<mutex> lock(_idlelock);
+						_idlecondition.wait(lock, [this]() { return (_isstopping || _queuedtasks > 0); });
+						if (_isstopping)
+							return;
+					}
+				}
+
+			public:
+				//Starts the threads, one for each core if no number is given
+				WorkStealingPool(size_t threads = 0)
+				{
+					threads = (threads > 0) ? threads : max<size_t>(1, thread::hardware_concurrency());
+
+					_queuedtasks = 0;
+					_unfinishedtasks = 0;
+					_nextqueue = 0;
+					_steals = 0;
+					_isstopping = false;
+					for (size_t index = 0; index < threads; index++)
+						_queues.emplace_back(new WorkerQueue());
+					_threads.reserve(threads);
+					for (size_t index = 0; index < threads; index++)
+						_threads.emplace_back(&WorkStealingPool::Run, this, index);
+				}
+
+				//Stops the threads once they have finished the tasks that they are running, the tasks that are still queued are discarded
+				~WorkStealingPool()
+				{
+					{
+						lock_guard<mutex> lock(_idlelock);
+						_isstopping = true;
+					}
+					_idlecondition.notify_all();
+					for (auto& worker : _threads)
+						if (worker.joinable())
+							worker.join();
+				}
+
+				//Queues a task, on the queue of the calling thread if it belongs to the pool, otherwise on the queues in turn
+				void Submit(function<void()> task)
+				{
+					size_t index = GetCurrentIndex();
+
+					if (index == _threads.size())
+						index = _nextqueue++ % _queues.size();
+
+					_unfinishedtasks++;
+					{
+						lock_guard<mutex> lock(_idlelock);
+						_queuedtasks++;
+					}
+					{
+						lock_guard<mutex> lock(_queues[index]->lock);
+						_queues[index]->tasks.push_back(move(task));
+					}
+					_idlecondition.notify_one();
+				}
+
+				//Blocks until every task that has been submitted, including the ones that the tasks have submitted, has finished
+				//Must not be called from one of the threads of the pool
+				void WaitForIdle()
+				{
+					unique_lock<mutex> lock(_idlelock);
+
+					_donecondition.wait(lock, [this]() { return (_unfinishedtasks == 0); });
+				}
+
+				size_t GetThreadCount() const
+				{
+					return _threads.size();
+				}
+
+				uint64_t GetStealCount() const
+				{
+					return _steals;
+				}
+		};
+	}
+}
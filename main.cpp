@@ -1,11 +1,33 @@
 #define NOMINMAX
 
+#include <condition_variable>
+#include <future>
 #include <iostream>
 #include <queue>
 #include <sc2api/sc2_api.h>
 #include <sstream>
+#include <stdexcept>
 #include <thread>
-#include <Windows.h>
+#ifdef _WIN32
+	#include <Windows.h>
+#endif
+#include "Model/Channel.h"
+#include "Agent/Action.h"
+#include "Agent/ActionProvider.h"
+#include "Agent/DecisionTrace.h"
+#include "Agent/ObservationSnapshot.h"
+#include "Agent/Opening.h"
+#include "Agent/OpeningBook.h"
+#include "Agent/OrderRegistry.h"
+#include "Agent/PlannerActionProvider.h"
+#include "Agent/PluginActionProvider.h"
+#include "Agent/ResourceBudget.h"
+#include "Agent/UnitIndex.h"
+#include "Model/Snapshot.h"
+#include "Types/Logger.h"
+#include "Types/Profiler.h"
+#include "Types/SpscQueue.h"
+#include "Types/TripleBuffer.h"
 
 namespace KoKeKoKo
 {
@@ -18,6 +40,14 @@ namespace KoKeKoKo
 		#else
 			const string MODELSERVICE_FILENAME = "ModelService\\bin\\Release\\ModelService.exe";
 		#endif
+		//The format of the snapshots sent to model service, define KOKEKOKO_TEXTSNAPSHOT to use the legacy text message
+		#if KOKEKOKO_TEXTSNAPSHOT
+			const SnapshotFormat SNAPSHOT_FORMAT = SnapshotFormat::Text;
+		#else
+			const SnapshotFormat SNAPSHOT_FORMAT = SnapshotFormat::BinaryDelta;
+		#endif
+		//The number of messages from model service that can wait for the agent, the listener stops reading when it is full
+		const size_t MAXIMUM_QUEUEDMESSAGES = 64;
 
 		//Manages the communication between agent and model
 		class ModelRepositoryService
@@ -25,111 +55,156 @@ namespace KoKeKoKo
 			private:
 				//Instace of this class
 				static ModelRepositoryService* _instance;
-				//The execution of the model
-				PROCESS_INFORMATION _model;
+				#ifdef _WIN32
+					//The execution of the model
+					PROCESS_INFORMATION _model;
+				#endif
+				//The long-lived connection to model service
+				Channel* _channel;
 				//If the agent should accept messages from model service
 				atomic<bool> _shouldacceptmessages;
-				//The messages from the model
-				deque<string> _messages;
+				//The number of times model service has connected
+				atomic<uint64_t> _connections;
+				//The messages from the model, pushed by the listener and popped by the agent
+				Types::SpscQueue<string> _messages;
 				//A map of created threads where key is the method name, and value is the thread
 				map<string, thread*> _threads;
-				//Lock for message handling
+				//Lock for the arrival of messages
 				mutex _messagelock;
+				//Signalled when a message or a reply from the model has arrived
+				condition_variable _messagecondition;
+				//The number of times the message condition has been signalled, guarded by the message lock
+				uint64_t _arrivals;
+				//The correlation id of the next request
+				atomic<uint32_t> _nextcorrelation;
+				//The requests that are waiting for a reply where key is the correlation id, and value is the reply
+				map<uint32_t, promise<string>> _pendingrequests;
+				//Lock for the pending requests
+				mutex _requestlock;
 
 				ModelRepositoryService(const ModelRepositoryService&);
 				ModelRepositoryService& operator=(const ModelRepositoryService&);
 				//Initializes fields and starts the model service
-				ModelRepositoryService()
+				ModelRepositoryService() : _messages(MAXIMUM_QUEUEDMESSAGES, Types::OverflowPolicy::Wait)
 				{
 					//Perform initializations
+					_channel = Channel::CreateChannel();
 					_shouldacceptmessages = false;
-					_messages = deque<string>();
+					_connections = 0;
+					_arrivals = 0;
+					_nextcorrelation = FRAME_UNCORRELATED + 1;
+					_pendingrequests = map<uint32_t, promise<string>>();
 					_threads = map<string, thread*>();
 
 					//Start the model service
-					STARTUPINFO startupinfo = { 0 };
-					LPSTR executablefile = new char[MAX_PATH];
-					string executabledirectory = "";
+					#ifdef _WIN32
+						STARTUPINFO startupinfo = { 0 };
+						LPSTR executablefile = new char[MAX_PATH];
+						string executabledirectory = "";
+
+						ZeroMemory(&_model, sizeof(_model));
+						ZeroMemory(&startupinfo, sizeof(startupinfo));
+						startupinfo.cb = sizeof(startupinfo);
+						executabledirectory = GetAbsoluteDirectoryOf(MODELSERVICE_FILENAME);
+						executablefile = const_cast<char *>(executabledirectory.c_str());
+
+						if (!CreateProcessA(NULL, executablefile, NULL, NULL, FALSE, 0, NULL, NULL, &startupinfo, &_model))
+							throw runtime_error(("Error Occurred! Failed to create process for model service with an exit code of " + to_string(GetLastError()) + "...").c_str());
+					#else
+						//There is no process to create, model service is started separately and connects to the channel
+						KOKEKOKO_LOG_INFO("ModelRepositoryService() -> Waiting for model service to connect to {}...", GetChannelName());
+					#endif
 
-					ZeroMemory(&_model, sizeof(_model));
-					ZeroMemory(&startupinfo, sizeof(startupinfo));
-					startupinfo.cb = sizeof(startupinfo);
-					executabledirectory = GetAbsoluteDirectoryOf(MODELSERVICE_FILENAME);
-					executablefile = const_cast<char *>(executabledirectory.c_str());
+					KOKEKOKO_LOG_DEBUG("ModelRepositoryService() has been executed! The model should start by now...");
+				}
 
-					if (!CreateProcessA(NULL, executablefile, NULL, NULL, FALSE, 0, NULL, NULL, &startupinfo, &_model))
-						throw exception(("Error Occurred! Failed to create process for model service with an exit code of " + to_string(GetLastError()) + "...").c_str());
+				//Wakes up the threads that are waiting for messages
+				void SignalArrival()
+				{
+					_messagelock.lock();
+					_arrivals++;
+					_messagelock.unlock();
+					_messagecondition.notify_all();
+				}
 
-					#if _DEBUG
-						cout << "ModelRepositoryService() has been executed! The model should start by now..." << endl;
-					#endif
+				//Breaks the pending requests, their replies will never arrive through the current connection
+				void FailPendingRequests()
+				{
+					_requestlock.lock();
+					for (auto& request : _pendingrequests)
+						request.second.set_exception(make_exception_ptr(runtime_error("Error Occurred! Model service has disconnected before replying...")));
+					_pendingrequests.clear();
+					_requestlock.unlock();
+
+					SignalArrival();
+				}
+
+				//Delivers a reply to the request with the same correlation id and returns false if there is no such request
+				bool CompleteRequest(uint32_t correlation, string& message)
+				{
+					lock_guard<mutex> lock(_requestlock);
+					auto request = _pendingrequests.find(correlation);
+
+					if (request == _pendingrequests.end())
+						return false;
+
+					request->second.set_value(move(message));
+					_pendingrequests.erase(request);
+					return true;
 				}
 
 				//Waits for model service to connect and accepts any messages from model service
 				void ListenForMessages()
 				{
-					DWORD readpointer = 0;
-					HANDLE server = INVALID_HANDLE_VALUE;
-					LPSTR name = TEXT("\\\\.\\pipe\\AgentServer");
-					char buffer[4096] = { 0 };
 					string message = "";
+					uint32_t correlation = FRAME_UNCORRELATED;
 
-					#if _DEBUG
-						cout << "ListenForMessages() has been called! Preparing to listen for messages..." << endl;
-					#endif
+					KOKEKOKO_PROFILE_THREAD("ListenForMessages");
+					KOKEKOKO_LOG_DEBUG("ListenForMessages() has been called! Preparing to listen for messages...");
 
 					for (int failures = 0; _shouldacceptmessages;)
 					{
 						try
 						{
-							//Re-initialize variables
-							readpointer = 0;
-							server = INVALID_HANDLE_VALUE;
-							ZeroMemory(buffer, sizeof(buffer));
-							message = "";
-
-							//Create a named pipe
-							server = CreateNamedPipeA(name, PIPE_ACCESS_DUPLEX, PIPE_TYPE_MESSAGE | PIPE_READMODE_MESSAGE | PIPE_WAIT, PIPE_UNLIMITED_INSTANCES, sizeof(buffer), sizeof(buffer), 0, NULL);
-							if (server != INVALID_HANDLE_VALUE)
+							//Wait for model service to connect, the connection is kept until either side closes it
+							if (!_channel->IsConnected())
 							{
-								#if _DEBUG
-									cout << "ListenForMessages() -> Successfully created a server for model service! Waiting for a connection..." << endl;
-								#endif
-
-								//Wait for model service to connect
-								if (ConnectNamedPipe(server, NULL))
+								KOKEKOKO_LOG_DEBUG("ListenForMessages() -> Waiting for a connection from model service...");
+								if (!_channel->Accept())
 								{
-									//Read the message from model service
-									while (ReadFile(server, buffer, sizeof(buffer), &readpointer, NULL))
-										buffer[readpointer] = '\0';
-
-									//Enqueue the message
-									_messagelock.lock();
-									message = string(buffer);
-									#if _DEBUG
-										cout << "ListenForMessages() -> Model service has connected! Your message is: \n\t" << message << endl;
-									#endif
-									_messages.push_back(message);
-									_messagelock.unlock();
-
-									//Disconnect model service
-									DisconnectNamedPipe(server);
+									if (_shouldacceptmessages)
+										throw runtime_error("Error Occurred! Failed to accept a connection from model service...");
+									break;
 								}
+								_connections++;
+							}
 
-								//Close the server
-								#if _DEBUG
-									cout << "ListenForMessages() -> Model Service has been disconnected..." << endl;
-								#endif
-								CloseHandle(server);
+							//Read the frames from model service until it disconnects
+							while (_shouldacceptmessages && _channel->ReadFrame(message, correlation))
+							{
+								KOKEKOKO_PROFILE_ZONE("DeliverMessage");
+								KOKEKOKO_LOG_DEBUG("ListenForMessages() -> Model service has sent a message: \n\t{}", message);
+
+								//A reply is delivered to its request, any other message is enqueued
+								//A reply to a request that has been cancelled or has failed is dropped, nothing waits for it anymore
+								//If the agent has fallen behind, wait for it rather than reading more from model service
+								if (correlation == FRAME_UNCORRELATED)
+									_messages.Push(move(message));
+								else if (!CompleteRequest(correlation, message))
+									KOKEKOKO_LOG_DEBUG("ListenForMessages() -> Dropped the reply to request {} that nothing waits for...", correlation);
+								SignalArrival();
+								failures = 0;
 							}
-							else
-								throw exception(("Error Occurred! Failed to create a server for model service with an exit code of " + to_string(GetLastError()) + "...").c_str());
+
+							KOKEKOKO_LOG_DEBUG("ListenForMessages() -> Model Service has been disconnected...");
+							_channel->Disconnect();
+							FailPendingRequests();
 						}
 						catch (const exception& ex)
 						{
-							cout << ex.what() << endl;
+							KOKEKOKO_LOG_ERROR("{}", ex.what());
 							if (++failures >= 5)
-								throw exception("Error Occurred! Exceeded number of tries to create a server for model service...");
+								throw runtime_error("Error Occurred! Exceeded number of tries to create a server for model service...");
 						}
 					}
 				}
@@ -138,16 +213,22 @@ namespace KoKeKoKo
 				//Disposes the instance and terminates model service
 				virtual ~ModelRepositoryService()
 				{
-					DWORD exitcode = 0;
+					StopAcceptingMessages();
+					delete _channel;
+					_channel = nullptr;
+
+					#ifdef _WIN32
+						DWORD exitcode = 0;
 
-					//Try to wait for 30s before releasing the process
-					WaitForSingleObject(_model.hProcess, 30000);
-					if (!GetExitCodeProcess(_model.hProcess, &exitcode))
-						throw exception(("Error Occurred! Failed to get exit status of process with an exit code of " + to_string(GetLastError()) + "...").c_str());
+						//Try to wait for 30s before releasing the process
+						WaitForSingleObject(_model.hProcess, 30000);
+						if (!GetExitCodeProcess(_model.hProcess, &exitcode))
+							throw runtime_error(("Error Occurred! Failed to get exit status of process with an exit code of " + to_string(GetLastError()) + "...").c_str());
 
-					cout << "Model Service is terminated with an exit code of " << exitcode << endl;
-					CloseHandle(_model.hProcess);
-					CloseHandle(_model.hThread);
+						KOKEKOKO_LOG_INFO("Model Service is terminated with an exit code of {}", exitcode);
+						CloseHandle(_model.hProcess);
+						CloseHandle(_model.hThread);
+					#endif
 				}
 
 				//Starts model service and returns the instance of this class
@@ -160,63 +241,128 @@ namespace KoKeKoKo
 				}
 
 				//Sends a message to model service and returns true if successfully sent
-				bool SendMessageToModelService(string message)
+				bool SendMessageToModelService(const string& message)
 				{
-					DWORD writepointer = 0;
-					HANDLE client = INVALID_HANDLE_VALUE;
-					LPSTR name = TEXT("\\\\.\\pipe\\ModelServer");
-					char buffer[4096] = { 0 };
+					return SendMessageToModelService(message.data(), message.size());
+				}
 
+				//Sends a message to model service and returns true if successfully sent
+				bool SendMessageToModelService(const char* message, size_t size)
+				{
 					try
 					{
-						#if _DEBUG
-							cout << "SendMessageToModelService() has been called! Sending a message to model service..." << endl;
-						#endif
-						strcpy_s(buffer, message.c_str());
+						KOKEKOKO_LOG_DEBUG("SendMessageToModelService() has been called! Sending a message to model service...");
 
-						client = CreateFileA(name, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, 0, NULL);
-						if (client != INVALID_HANDLE_VALUE)
-						{
-							if (WriteFile(client, buffer, (message.size() + 1), &writepointer, NULL))
-								FlushFileBuffers(client);
-							else
-								throw exception(("Error Occurred! Failed to send a message with an exit code of " + to_string(GetLastError()) + "...").c_str());
+						if (!_channel->IsConnected())
+							throw runtime_error("Error Occurred! Model service is not yet connected...");
+						if (!_channel->WriteFrame(message, size))
+							throw runtime_error("Error Occurred! Failed to send a message to model service...");
 
-							//Close the client
-							#if _DEBUG
-								cout << "SendMessageToModelService() -> Finished sending a message to model service..." << endl;
-							#endif
-							CloseHandle(client);
-						}
-						else if (GetLastError() == ERROR_PIPE_BUSY)
-							throw exception(("Error Occurred! The server is currently busy with an exit code of " + to_string(GetLastError())).c_str());
-						else
-							throw exception(("Error Occurred! Failed to create a client pipe with an exit code of " + to_string(GetLastError())).c_str());
+						KOKEKOKO_LOG_DEBUG("SendMessageToModelService() -> Finished sending a message to model service...");
+						return true;
+					}
+					catch (const exception& ex)
+					{
+						KOKEKOKO_LOG_ERROR("{}", ex.what());
+					}
+
+					return false;
+				}
+
+				//Sends a request to model service and returns true if successfully sent
+				//The reply will arrive with the same correlation id, or fails if model service disconnects first
+				//A request whose reply is no longer wanted must be cancelled with its correlation id, or it waits until model service disconnects
+				bool RequestToModelService(const char* message, size_t size, future<string>& reply, uint32_t& correlation)
+				{
+					correlation = _nextcorrelation++;
+
+					//Skip the id of uncorrelated messages when the ids wrap around
+					if (correlation == FRAME_UNCORRELATED)
+						correlation = _nextcorrelation++;
+
+					_requestlock.lock();
+					reply = _pendingrequests[correlation].get_future();
+					_requestlock.unlock();
+
+					try
+					{
+						if (!_channel->IsConnected())
+							throw runtime_error("Error Occurred! Model service is not yet connected...");
+						if (!_channel->WriteFrame(message, size, correlation))
+							throw runtime_error("Error Occurred! Failed to send a request to model service...");
 
 						return true;
 					}
 					catch (const exception& ex)
 					{
-						cout << ex.what() << endl;
+						KOKEKOKO_LOG_ERROR("{}", ex.what());
+
+						lock_guard<mutex> lock(_requestlock);
+						auto request = _pendingrequests.find(correlation);
+						if (request != _pendingrequests.end())
+						{
+							request->second.set_exception(make_exception_ptr(runtime_error(ex.what())));
+							_pendingrequests.erase(request);
+						}
 					}
 
 					return false;
 				}
 
+				//Forgets a request whose reply is no longer wanted, its future is broken and the reply is dropped if it arrives later
+				void CancelRequest(uint32_t correlation)
+				{
+					lock_guard<mutex> lock(_requestlock);
+					_pendingrequests.erase(correlation);
+				}
+
+				//Blocks until something has arrived since the last seen arrival, or the timeout has elapsed
+				//The last seen arrival is updated, so that an arrival is never missed between two waits
+				void WaitForMessages(chrono::milliseconds timeout, uint64_t& lastarrival)
+				{
+					unique_lock<mutex> lock(_messagelock);
+					_messagecondition.wait_for(lock, timeout, [this, &lastarrival]() { return (_arrivals != lastarrival); });
+					lastarrival = _arrivals;
+				}
+
+				//Wakes up any thread that is waiting for messages
+				void NotifyMessageWaiters()
+				{
+					SignalArrival();
+				}
+
+				//Returns the number of times model service has connected, a new connection has no state from the previous one
+				uint64_t GetConnectionCount() const
+				{
+					return _connections;
+				}
+
+				//Returns the number of frames that were too large to be sent or received
+				uint64_t GetRefusedFrameCount() const
+				{
+					return _channel->GetFramesRefused();
+				}
+
 				//Gets the current project directory and returns the absolute directory of the file
 				string GetAbsoluteDirectoryOf(string filename)
 				{
-					LPSTR currentdirectory = new char[MAX_PATH];
 					string absolutedirectory = "";
 
 					try
 					{
-						if (GetCurrentDirectoryA(MAX_PATH, currentdirectory) != 0)
-							absolutedirectory = (((string)currentdirectory) + "\\" + filename);
+						#ifdef _WIN32
+							LPSTR currentdirectory = new char[MAX_PATH];
+							if (GetCurrentDirectoryA(MAX_PATH, currentdirectory) != 0)
+								absolutedirectory = (((string)currentdirectory) + "\\" + filename);
+						#else
+							char currentdirectory[4096] = { 0 };
+							if (getcwd(currentdirectory, sizeof(currentdirectory)) != nullptr)
+								absolutedirectory = (((string)currentdirectory) + "/" + filename);
+						#endif
 					}
 					catch (const exception& ex)
 					{
-						cout << "Error Occurred! Failed to get the absolute directory of the file..." << endl;
+						KOKEKOKO_LOG_ERROR("Error Occurred! Failed to get the absolute directory of the file...");
 					}
 
 					return absolutedirectory;
@@ -228,35 +374,35 @@ namespace KoKeKoKo
 
 					try
 					{
-						#if _DEBUG
-							cout << "GetMessageFromModelService() has been called!" << endl;
-						#endif
+						KOKEKOKO_LOG_DEBUG("GetMessageFromModelService() has been called!");
 
-						_messagelock.lock();
-						while (!_messages.empty())
+						for (string message = ""; _messages.TryPop(message);)
 						{
-							#if _DEBUG
-								cout << "GetMessageFromModelService() -> Getting the messages..." << endl;
-							#endif
-							messages.push(_messages.front());
-							_messages.pop_front();
+							KOKEKOKO_LOG_DEBUG("GetMessageFromModelService() -> Getting the messages...");
+							messages.push(move(message));
 						}
-						_messagelock.unlock();
 					}
 					catch (const exception& ex)
 					{
-						cout << ex.what() << endl;
+						KOKEKOKO_LOG_ERROR("{}", ex.what());
 					}
 
 					return messages;
 				}
 
+				//Returns the queue of messages from model service, only to read its counters
+				const Types::SpscQueue<string>& GetMessageQueue() const
+				{
+					return _messages;
+				}
+
 				//Starts accepting messages from model service
 				void StartAcceptingMessages()
 				{
 					StopAcceptingMessages();
 
 					_shouldacceptmessages = true;
+					_messages.Reopen();
 					auto listenformessages = new thread(&Model::ModelRepositoryService::ListenForMessages, this);
 					_threads.insert(make_pair("ListenForMessages", listenformessages));
 				}
@@ -265,6 +411,10 @@ namespace KoKeKoKo
 				void StopAcceptingMessages()
 				{
 					_shouldacceptmessages = false;
+					//Wake up the listener if it is blocked on the channel or on a full queue
+					_messages.Close();
+					if (_threads.find("ListenForMessages") != _threads.end())
+						_channel->Close();
 
 					if (_threads.find("ListenForMessages") != _threads.end())
 					{
@@ -272,6 +422,11 @@ namespace KoKeKoKo
 							_threads["ListenForMessages"]->join();
 
 						_threads.erase("ListenForMessages");
+
+						KOKEKOKO_LOG_INFO("StopAcceptingMessages() -> Channel: {} frames written, {} read, {} refused over {} connections", _channel->GetFramesWritten(), _channel->GetFramesRead(), _channel->GetFramesRefused(), _connections.load());
+						//A closed channel cannot be reused, prepare a new one for the next listener
+						delete _channel;
+						_channel = Channel::CreateChannel();
 					}
 				}
 		};
@@ -281,145 +436,452 @@ namespace KoKeKoKo
 	{
 		using namespace sc2;
 
+		//The number of requested decisions that can wait for a reply, older requests are dropped
+		const size_t MAXIMUM_PENDINGDECISIONS = 8;
+		//The number of actions that can wait to be executed, newer actions are dropped when it is full
+		const size_t MAXIMUM_QUEUEDACTIONS = 256;
+		//The number of actions that can be executed in a single game step
+		const size_t MAXIMUM_ACTIONSPERSTEP = 32;
+		//The number of game loops that an action of the opening can wait to be executed before it is skipped, about 10 seconds
+		const uint32_t OPENING_MAXIMUMWAITLOOPS = 224;
+		//The number of game loops that an action of model service can wait to be paid for before it is skipped, so that it does not hold up the actions behind it
+		const uint32_t QUEUED_MAXIMUMWAITLOOPS = 224;
+		//The supply cap of the game, an action that needs more supply than is left at the cap can never be paid for
+		const int32_t MAXIMUM_FOODCAP = 200;
+		//The opening of an opening book stops when fewer games than this have followed it so far, the same as Opening_Generator.py
+		const uint32_t OPENING_MINIMUMGAMES = 16;
+		//The Chrome trace of the zones of the game, written when the game ends if the agent was built with KOKEKOKO_PROFILER
+		const std::string PROFILE_FILENAME = "KoKeKoKoProfile.json";
+
+		//Decides the actions of the agent through model service, a separate process that the snapshots are sent to
+		class ModelServiceActionProvider : public ActionProvider
+		{
+			private:
+				//A requested decision, the stamp of the snapshot that it will be computed from, and the correlation id of its request
+				struct PendingDecision
+				{
+					DecisionStamp stamp;
+					std::future<std::string> reply;
+					uint32_t correlation;
+				};
+
+				Model::ModelRepositoryService* _instance;
+				std::mutex _decisionslock;
+				std::deque<PendingDecision> _decisions;
+				//The number of arrivals that the thread collecting the actions has seen
+				uint64_t _lastarrival;
+				//The number of actions from model service that the agent does not know
+				std::atomic<uint64_t> _unknownactions;
+				Model::SnapshotFormat _snapshotformat;
+				std::vector<char> _snapshotbuffer;
+				Model::SnapshotDeltaEncoder _deltaencoder;
+				uint64_t _deltaconnection;
+
+				ModelServiceActionProvider(const ModelServiceActionProvider&);
+				ModelServiceActionProvider& operator=(const ModelServiceActionProvider&);
+
+				//Returns the replies to the requested decisions that have arrived with the stamps of their snapshots, a reply supersedes the older requests that are still waiting
+				std::vector<std::pair<DecisionStamp, std::string>> GetArrivedDecisions()
+				{
+					std::vector<std::pair<DecisionStamp, std::string>> replies = std::vector<std::pair<DecisionStamp, std::string>>();
+					std::lock_guard<std::mutex> lock(_decisionslock);
+					//If nothing has arrived, only drop the oldest requests that model service will not answer anymore
+					size_t newest = ((_decisions.size() > MAXIMUM_PENDINGDECISIONS) ? (_decisions.size() - MAXIMUM_PENDINGDECISIONS) : 0);
+
+					for (size_t index = _decisions.size(); index > newest; index--)
+					{
+						if (_decisions[index - 1].reply.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+						{
+							newest = index;
+							break;
+						}
+					}
+
+					for (; newest > 0; newest--)
+					{
+						auto decision = std::move(_decisions.front());
+						_decisions.pop_front();
+
+						try
+						{
+							//A superseded request is cancelled, so that the service does not keep it until model service disconnects
+							if (decision.reply.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+							{
+								decision.stamp.decided = std::chrono::steady_clock::now();
+								replies.push_back(std::make_pair(decision.stamp, decision.reply.get()));
+							}
+							else
+								_instance->CancelRequest(decision.correlation);
+						}
+						catch (const std::exception& ex)
+						{
+							KOKEKOKO_LOG_ERROR("{}", ex.what());
+						}
+					}
+
+					return replies;
+				}
+
+				//Sends a snapshot to model service and keeps the decision that will be computed from it
+				bool RequestDecision(const DecisionStamp& stamp, const char* snapshot, size_t size)
+				{
+					PendingDecision decision;
+
+					decision.stamp = stamp;
+					if (!_instance->RequestToModelService(snapshot, size, decision.reply, decision.correlation))
+						return false;
+
+					_decisionslock.lock();
+					_decisions.push_back(std::move(decision));
+					_decisionslock.unlock();
+
+					//The reply may have arrived before the decision was kept, so let the waiting thread check again
+					_instance->NotifyMessageWaiters();
+					return true;
+				}
+
+			public:
+				//Returns the state of the agent in the snapshot as a "Macromanagement:" text message
+				std::string WriteTextSnapshot(const ObservationSnapshot& current_snapshot)
+				{
+					std::string message = "Macromanagement:";
+
+					//Send the current state of the agent
+					//Macro details
+					//don't forget gameloop, combine supply
+					message += std::to_string(current_snapshot.GetGameLoop()) + ","; //Gameloop
+					message += std::to_string(current_snapshot.GetPlayerID()) + ","; //Player ID
+					message += std::to_string(current_snapshot.GetMinerals()) + ","; //Minerals
+					message += std::to_string(current_snapshot.GetVespene()) + ","; //Vespene
+					message += std::to_string(current_snapshot.GetFoodUsed()) + ","; //Supply
+					message += std::to_string(current_snapshot.GetWorkers()); //No. of Workers
+					for (const auto& upgrade : current_snapshot.GetUpgrades())
+						message += ("," + std::to_string(upgrade)); //Upgrades
+					message += ":";
+
+					//Self Army details
+					for (const auto& unit : current_snapshot.GetSelfUnits())
+						message += (std::to_string(current_snapshot.GetPlayerID()) + "," + std::to_string(unit.type) + "," + std::to_string(unit.tag) + "," + std::to_string(unit.x) + "," + std::to_string(unit.y) + "\n");
+					message += "~";
+
+					//Enemy Army Units
+					for (const auto& unit : current_snapshot.GetEnemyUnits())
+						message += (std::to_string(unit.alliance) + "," + std::to_string(unit.type) + "," + std::to_string(unit.tag) + "," + std::to_string(unit.x) + "," + std::to_string(unit.y) + "\n");
+
+					return message;
+				}
+
+				//Writes the state of the agent in the snapshot as a binary snapshot into the snapshot buffer and returns its size
+				//If deltas are used, only the units that were added, moved or removed since the last snapshot are written
+				size_t WriteBinarySnapshot(const ObservationSnapshot& current_snapshot, bool usedeltas)
+				{
+					auto self_units = current_snapshot.GetSelfUnits(), enemy_units = current_snapshot.GetEnemyUnits();
+					size_t required_size = Model::GetSnapshotSize(self_units.size() + enemy_units.size(), _deltaencoder.GetSentUnitCount());
+
+					//The buffer is only grown when the armies outgrow it, so the encoder itself never allocates
+					if (_snapshotbuffer.size() < required_size)
+						_snapshotbuffer.resize(required_size * 2);
+
+					Model::SnapshotWriter writer(_snapshotbuffer.data(), _snapshotbuffer.size());
+					writer.Begin(current_snapshot.GetGameLoop(), current_snapshot.GetPlayerID(), current_snapshot.GetMinerals(), current_snapshot.GetVespene(), current_snapshot.GetFoodUsed(), current_snapshot.GetWorkers());
+					for (const auto& upgrade : current_snapshot.GetUpgrades())
+						writer.AddUpgrade(upgrade);
+					if (usedeltas)
+					{
+						//Model service forgets the units when it reconnects, so start again from a keyframe, there is no connection without an instance
+						if (_instance != nullptr && _deltaconnection != _instance->GetConnectionCount())
+						{
+							_deltaconnection = _instance->GetConnectionCount();
+							_deltaencoder.Reset();
+						}
+
+						_deltaencoder.Begin(writer);
+						for (const auto& unit : self_units)
+							_deltaencoder.AddUnit(writer, Model::SnapshotSection::Self, unit.type, unit.tag, unit.x, unit.y);
+						for (const auto& unit : enemy_units)
+							_deltaencoder.AddUnit(writer, Model::SnapshotSection::Enemy, unit.type, unit.tag, unit.x, unit.y);
+						_deltaencoder.End(writer);
+					}
+					else
+					{
+						for (const auto& unit : self_units)
+							writer.AddUnit(Model::SnapshotSection::Self, unit.type, unit.tag, unit.x, unit.y);
+						for (const auto& unit : enemy_units)
+							writer.AddUnit(Model::SnapshotSection::Enemy, unit.type, unit.tag, unit.x, unit.y);
+					}
+
+					return writer.End();
+				}
+
+				ModelServiceActionProvider(Model::ModelRepositoryService* instance)
+				{
+					_instance = instance;
+					_lastarrival = 0;
+					_unknownactions = 0;
+					_snapshotformat = Model::SNAPSHOT_FORMAT;
+					_snapshotbuffer = std::vector<char>(Model::GetSnapshotSize(256));
+					_deltaconnection = 0;
+				}
+
+				virtual const char* GetName() const override
+				{
+					return "ModelService";
+				}
+
+				//Model service is sent an update every 10 seconds
+				virtual std::chrono::milliseconds GetDecisionInterval() const override
+				{
+					return std::chrono::milliseconds(10000);
+				}
+
+				//Sends the snapshot to model service in the selected format
+				virtual bool RequestDecision(const ObservationSnapshot& snapshot) override
+				{
+					if (_snapshotformat != Model::SnapshotFormat::Text)
+					{
+						size_t size = WriteBinarySnapshot(snapshot, (_snapshotformat == Model::SnapshotFormat::BinaryDelta));
+
+						KOKEKOKO_LOG_DEBUG("RequestDecision() -> Finished processing snapshot of {} bytes...", size);
+						//If the snapshot is lost, model service cannot apply the next delta, so start again from a keyframe
+						if (!RequestDecision(snapshot.GetStamp(), _snapshotbuffer.data(), size))
+						{
+							_deltaencoder.Reset();
+							return false;
+						}
+
+						return true;
+					}
+					else
+					{
+						std::string message = WriteTextSnapshot(snapshot);
+
+						KOKEKOKO_LOG_DEBUG("RequestDecision() -> Finished processing message...");
+						return RequestDecision(snapshot.GetStamp(), message.data(), message.size());
+					}
+				}
+
+				//Waits for the replies and messages from model service, and parses their actions into the buffer
+				virtual size_t GetDecidedActions(DecidedAction* actions, size_t capacity, std::chrono::milliseconds timeout) override
+				{
+					size_t count = 0;
+
+					//Wake up as soon as something has arrived instead of checking periodically
+					_instance->WaitForMessages(timeout, _lastarrival);
+
+					//The replies to our snapshots, then any other message from model service, which was not decided on a snapshot
+					auto messages = GetArrivedDecisions();
+					for (auto message = _instance->GetMessageFromModelService(); !message.empty(); message.pop())
+						messages.push_back(std::make_pair(DecisionStamp(), message.front()));
+
+					for (const auto& message : messages)
+					{
+						KOKEKOKO_LOG_DEBUG("GetDecidedActions() -> Retrieving message: {}", message.second);
+
+						KOKEKOKO_LOG_DEBUG("The sent actions for gameloop {} are:", message.first.gameloop);
+						count += ParseActions(message.second, message.first, actions + count, capacity - count);
+					}
+
+					return count;
+				}
+
+				//Splits a message of comma separated action names into the buffer with the stamp of the message, and returns the number of actions that were parsed into it
+				//The actions are parsed once here, so that the game thread only has to dispatch them
+				size_t ParseActions(const std::string& message, const DecisionStamp& stamp, DecidedAction* actions, size_t capacity)
+				{
+					KOKEKOKO_PROFILE_ZONE("ParseActions");
+					size_t count = 0;
+
+					for (size_t start = 0, end = 0; start <= message.size(); start = end + 1)
+					{
+						end = message.find(',', start);
+						if (end == std::string::npos)
+							end = message.size();
+
+						Action current_action = ParseAction(message.data() + start, end - start);
+						KOKEKOKO_LOG_DEBUG("{}", GetActionName(current_action));
+						if (current_action == Action::NONE)
+						{
+							if (end > start)
+							{
+								_unknownactions++;
+								KOKEKOKO_LOG_WARNING("GetDecidedActions() -> Unknown action {}...", message.substr(start, end - start));
+							}
+						}
+						else if (count < capacity)
+						{
+							actions[count].action = current_action;
+							actions[count++].stamp = stamp;
+						}
+						else
+							KOKEKOKO_LOG_WARNING("GetDecidedActions() -> Dropped action {}, too many actions have arrived at once...", GetActionName(current_action));
+					}
+
+					return count;
+				}
+
+				virtual void NotifyWaiters() override
+				{
+					if (_instance != nullptr)
+						_instance->NotifyMessageWaiters();
+				}
+
+				//Reports how much the messages have overflowed, then disposes the modelrepositoryservice instance
+				virtual void Stop() override
+				{
+					if (_instance == nullptr)
+						return;
+
+					KOKEKOKO_LOG_INFO("Messages: {} queued, {} overflowed, {} frames refused, {} unknown actions", _instance->GetMessageQueue().GetPushedCount(), _instance->GetMessageQueue().GetOverflowCount(), _instance->GetRefusedFrameCount(), _unknownactions);
+					_instance->~ModelRepositoryService();
+					_instance = nullptr;
+				}
+
+				//Selects the format of the snapshots that are sent to model service
+				void SetSnapshotFormat(Model::SnapshotFormat format)
+				{
+					_snapshotformat = format;
+					_deltaencoder.Reset();
+				}
+
+		};
+
 		//Manages the agent in the environment
 		class KoKeKoKoBot : public Agent
 		{
 			private:
-				Model::ModelRepositoryService* _instance;
+				//Decides the actions of the agent, either model service or a native plugin
+				ActionProvider* _provider;
+				//The observation and the actions that stand in for the ones of the game, such as a replay of the simulation, or nullptr to play the game
+				const ObservationInterface* _observationinterface;
+				ActionInterface* _actioninterface;
 				std::atomic<bool> _shouldkeepupdating;
 				std::map<std::string, std::thread*> _threads;
-				std::mutex _actionslock;
-				std::queue<std::string> _actions;
-				std::string _currentaction;
-
-				//Returns a single action from a queue of actions
-				std::string GetAnActionFromMessage()
-				{
-					std::string action = "";
+				//The decided actions, pushed by the thread that collects them and popped by the game thread without locking
+				Types::SpscQueue<DecidedAction> _actions;
+				Action _currentaction;
+				//The game loop since the current action has been waiting to be paid for, and the number of actions that were skipped because they waited too long
+				uint32_t _currentwaitloop;
+				uint64_t _skippedactions;
+				//The stamp of the current action, and how long the actions took from their snapshots to their commands
+				DecisionStamp _currentstamp;
+				DecisionTrace _decisiontrace;
+				//The units of the current game loop, only used by the game thread
+				UnitIndex _unitindex;
+				//The orders of our units, recounted whenever the unit index is rebuilt
+				OrderRegistry _orderregistry;
+				//The rebuild of the unit index that the orders were recounted for
+				uint64_t _orderregistryrebuild;
+				//The resources that are left for the actions of the current step
+				ResourceBudget _budget;
+				//The number of actions that have been executed, and the number of steps that executed any
+				uint64_t _executedactions;
+				uint64_t _executingsteps;
+				//The most actions that have been executed in a single step
+				size_t _maximumexecutedactions;
+				//The snapshots of the observation, published by the game thread and read by the thread that sends updates to model service
+				Types::TripleBuffer<ObservationSnapshot> _snapshots;
+				//The next action of the opening, the opening is over once model service has sent its first actions
+				size_t _openingstep;
+				bool _isopening;
+				//The game loop since the next action of the opening has been waiting to be executed
+				uint32_t _openingwaitloop;
+				//The opening book that the opening follows instead of the generated opening if there is one, the rank of its openings, and the node of the actions of the opening so far
+				const OpeningBook* _openingbook;
+				uint32_t _openingrank;
+				uint32_t _openingnode;
+				//When the game has started, and how long it took until the first action and the first action of model service were executed
+				std::chrono::steady_clock::time_point _gamestarttime;
+				double _firstactionmilliseconds;
+				double _firstmodelactionmilliseconds;
+
+				//Returns a single action from a queue of actions, and keeps its stamp as the stamp of the current action
+				Action GetAnActionFromMessage()
+				{
+					DecidedAction action;
+
+					action.action = Action::NONE;
 
 					try
 					{
-						#if _DEBUG
-							std::cout << "GetAnActionFromMessage() has been called!" << std::endl;
-						#endif
+						KOKEKOKO_LOG_DEBUG("GetAnActionFromMessage() has been called!");
 
-						_actionslock.lock();
-						if (!_actions.empty())
+						if (_actions.TryPop(action))
 						{
-							action = _actions.front();
-							_actions.pop();
-							#if _DEBUG
-								std::cout << "GetAnActionFromMessage() -> An action has been retrieved from queue..." << std::endl;
-							#endif							
+							_currentstamp = action.stamp;
+							_currentstamp.dequeued = std::chrono::steady_clock::now();
+							KOKEKOKO_LOG_DEBUG("GetAnActionFromMessage() -> An action has been retrieved from queue...");
 						}
 					}
 					catch (const std::exception& ex)
 					{
-						std::cout << ex.what() << std::endl;
+						KOKEKOKO_LOG_ERROR("{}", ex.what());
 					}
 
-					_actionslock.unlock();
-					return action;
+					return action.action;
 				}
 
-				//Retrieves the recently sent messages from model service and stores in a queue of actions
-				void GetMessageFromModelService()
+				//Waits for the actions that the provider has decided and stores them in a queue of actions, stamped with when they were queued
+				void ReceiveActionsFromProvider()
 				{
+					std::vector<DecidedAction> decided_actions = std::vector<DecidedAction>(MAXIMUM_QUEUEDACTIONS);
+
+					KOKEKOKO_PROFILE_THREAD("ReceiveActionsFromProvider");
 					for (int failures = 0; _shouldkeepupdating;)
 					{
 						try
 						{
-							#if _DEBUG
-								std::cout << "GetMessageFromModelService() has been called!" << std::endl;
-							#endif
+							KOKEKOKO_LOG_DEBUG("ReceiveActionsFromProvider() has been called!");
 
-							_actionslock.lock();
-							for (auto message = _instance->GetMessageFromModelService(); !message.empty();)
+							//Wake up as soon as something has been decided instead of checking periodically
+							size_t count = _provider->GetDecidedActions(decided_actions.data(), decided_actions.size(), std::chrono::milliseconds(1000));
+							KOKEKOKO_PROFILE_ZONE("QueueDecidedActions");
+							auto queued = std::chrono::steady_clock::now();
+							for (size_t index = 0; index < count; index++)
 							{
-								#if _DEBUG
-									std::cout << "GetMessageFromModelService() -> Retrieving message: " << message.front() << std::endl;
-								#endif
-								
-								std::stringstream new_actions(message.front());
-								message.pop();
-
-								std::cout << "The sent actions are:" << std::endl;
-								for (std::string current_action = ""; std::getline(new_actions, current_action, ',');)
-								{
-									std::cout << current_action << std::endl;
-									_actions.push(current_action);
-								}
+								decided_actions[index].stamp.queued = queued;
+								if (!_actions.Push(decided_actions[index]))
+									KOKEKOKO_LOG_WARNING("ReceiveActionsFromProvider() -> Dropped action {}, the queue of actions is full...", GetActionName(decided_actions[index].action));
 							}
-							_actionslock.unlock();
-
-							//Check if there is a message again after 15 seconds
-							std::this_thread::sleep_for(std::chrono::milliseconds(15000));
 						}
 						catch (const std::exception& ex)
 						{
-							std::cout << ex.what() << std::endl;
+							KOKEKOKO_LOG_ERROR("{}", ex.what());
 							if (++failures >= 5)
-								throw std::exception("Error Occurred! Exceeded number of tries to get message from model service...");
+								throw std::runtime_error("Error Occurred! Exceeded number of tries to get actions from the provider...");
 						}
 					}
 				}
 
-				void SendUpdatesToModelService()
+				//Hands the newest published snapshot to the provider, it never reads the observation itself
+				void SendUpdatesToProvider()
 				{
+					KOKEKOKO_PROFILE_THREAD("SendUpdatesToProvider");
 					for (int failures = 0; _shouldkeepupdating;)
 					{
 						try
 						{
-							#if _DEBUG
-								std::cout << "SendUpdatesToModelService() has been called!" << std::endl;
-							#endif
-
-							const ObservationInterface* current_observation = Observation();
-							std::string message = "Macromanagement:";
-							
-							//Send the current state of the agent
-							//Macro details
-							//don't forget gameloop, combine supply
-							message += std::to_string(current_observation->GetGameLoop()) + ","; //Gameloop
-							message += std::to_string(current_observation->GetPlayerID()) + ","; //Player ID
-							message += std::to_string(current_observation->GetMinerals()) + ","; //Minerals
-							message += std::to_string(current_observation->GetVespene()) + ","; //Vespene
-							message += std::to_string(current_observation->GetFoodUsed()) + ","; //Supply
-							message += std::to_string(CountOf(UNIT_TYPEID::TERRAN_SCV)); //No. of Workers
-							for (const auto& upgrade : current_observation->GetUpgrades())
-								message += ("," + upgrade.to_string()); //Upgrades
-							message += ":";
-
-							//Self Army details
-							for (const auto& unit : current_observation->GetUnits(Unit::Alliance::Self))
+							KOKEKOKO_LOG_DEBUG("SendUpdatesToProvider() has been called!");
+
+							//The game thread keeps publishing newer snapshots, the one taken here does not change while the provider reads it
+							if (!_snapshots.Acquire())
 							{
-								if (unit->is_alive)
-									message += (std::to_string(current_observation->GetPlayerID()) + "," + unit->unit_type.to_string() + "," + std::to_string(unit->tag) + "," + std::to_string(unit->pos.x) + "," + std::to_string(unit->pos.y) + "\n");
+								std::this_thread::sleep_for(std::chrono::milliseconds(1));
+								continue;
 							}
-							message += "~";
-
-							//Enemy Army Units
-							for (const auto& unit : current_observation->GetUnits(Unit::Alliance::Enemy))
 							{
-								if (unit->is_alive)
-									message += (std::to_string(unit->alliance) + "," + unit->unit_type.to_string() + "," + std::to_string(unit->tag) + "," + std::to_string(unit->pos.x) + "," + std::to_string(unit->pos.y) + "\n");
+								KOKEKOKO_PROFILE_ZONE("RequestDecision");
+								_snapshots.GetFrontBuffer().StampRequest();
+								_provider->RequestDecision(_snapshots.GetFrontBuffer());
 							}
 
-							#if _DEBUG
-								std::cout << "SendUpdatesToModelService() -> Finished processing message..." << std::endl;
-							#endif
-
-							//Send this message to model service
-							_instance->SendMessageToModelService(message);
-
-							//Send another update after 10 seconds
-							std::this_thread::sleep_for(std::chrono::milliseconds(10000));
+							//Model service is sent an update every 10 seconds, while a plugin decides on every snapshot
+							std::this_thread::sleep_for(_provider->GetDecisionInterval());
 						}
 						catch (const std::exception& ex)
 						{
-							std::cout << ex.what() << std::endl;
+							KOKEKOKO_LOG_ERROR("{}", ex.what());
 							if (++failures >= 5)
-								throw std::exception("Error Occurred! Exceeeded number of tries to send updates to model service...");
+								throw std::runtime_error("Error Occurred! Exceeeded number of tries to send updates to the provider...");
 						}
 					}
 				}
@@ -427,129 +889,82 @@ namespace KoKeKoKo
 				//Gets a random unit and assigns it to the action
 				bool ExecuteBuildAbility(ABILITY_ID action, UNIT_TYPEID unit = UNIT_TYPEID::TERRAN_SCV, bool redoable = false)
 				{
-					Units units = Observation()->GetUnits(Unit::Alliance::Self, IsUnit(unit));
+					auto units = GetUnitIndex().GetUnits(unit);
 					const Unit* target = nullptr;
 					float random_x_coordinate = GetRandomScalar(), random_y_coordinate = GetRandomScalar();
 
 					//If there should not be 2 or more unit working on the same action
-					if (!redoable)
-					{
-						for (const auto& unit : units)
-						{
-							for (const auto& order : unit->orders)
-							{
-								if (order.ability_id == action)
-									return false; //do nothing
-							}
-						}
-					}
+					if (!redoable && GetOrderRegistry().IsInFlight(action))
+						return false; //do nothing
+
+					if (units.empty())
+						return false;
 
 					target = units.front();
 					if (action == ABILITY_ID::BUILD_REFINERY)
 						Actions()->UnitCommand(target, action, FindNearestOf(target->pos, UNIT_TYPEID::NEUTRAL_VESPENEGEYSER));
 					else
 						Actions()->UnitCommand(target, action, Point2D((target->pos.x + random_x_coordinate) * 15.0f, (target->pos.y + random_y_coordinate) * 15.0f));
+					_orderregistry.Issue(target, action);
 					return true;
 				}
 
 				//Gets a random unit and assigns it to the action
 				bool ExecuteTrainAbility(ABILITY_ID action, UNIT_TYPEID unit, bool redoable = false)
 				{
-					Units units = Observation()->GetUnits(Unit::Alliance::Self, IsUnit(unit));
+					auto units = GetUnitIndex().GetUnits(unit);
 					const Unit* target = nullptr;
 
 					//If there should not be 2 or more unit doing the same action
-					if (!redoable)
-					{
-						for (const auto& unit : units)
-						{
-							for (const auto& order : unit->orders)
-							{
-								if (order.ability_id == action)
-									return false;
-							}
-						}
-					}
+					if (!redoable && GetOrderRegistry().IsInFlight(action))
+						return false;
+
+					if (units.empty())
+						return false;
 
 					target = units.front();
 					Actions()->UnitCommand(target, action);
+					_orderregistry.Issue(target, action);
 					return true;
 				}
 
 				//Gets a random unit and assigns it to the action
 				bool ExecuteResearchAbility(ABILITY_ID action, UNIT_TYPEID unit, bool redoable = false)
 				{
-					Units units = Observation()->GetUnits(Unit::Alliance::Self, IsUnit(unit));
+					auto units = GetUnitIndex().GetUnits(unit);
 					const Unit* target = nullptr;
 
 					//If there should not be 2 or more unit doing the same action
-					if (!redoable)
-					{
-						for (const auto& unit : units)
-						{
-							for (const auto& order : unit->orders)
-							{
-								if (order.ability_id == action)
-									return false;
-							}
-						}
-					}
+					if (!redoable && GetOrderRegistry().IsInFlight(action))
+						return false;
+
+					if (units.empty())
+						return false;
 
 					target = units.front();
 					Actions()->UnitCommand(target, action);
+					_orderregistry.Issue(target, action);
 					return true;
 				}
 
 				bool TryBuildRefinery()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_SUPPLYDEPOT) < 1 && observation->GetMinerals() < 75)
-					{
-						return false;
-					}
-
-					if (CountOf(UNIT_TYPEID::TERRAN_REFINERY) > 0 && observation->GetMinerals() < 75)
-					{
-						return false;
-					}
-
 					return ExecuteBuildAbility(ABILITY_ID::BUILD_REFINERY);
 				}
 
 				//Command Center Units
 				bool TryBuildCommandCenter()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_SUPPLYDEPOT, Unit::Alliance::Self) < 1 && observation->GetMinerals() < 400)
-					{
-						return false;
-					}
-
-					if (CountOf(UNIT_TYPEID::TERRAN_COMMANDCENTER, Unit::Alliance::Self) > 0 && observation->GetMinerals() < 400)
-					{
-						return false;
-					}
-
 					return ExecuteBuildAbility(ABILITY_ID::BUILD_COMMANDCENTER);
 				}
 
 				bool TryCommandCenterMorphOrbitalCommand()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_COMMANDCENTER) > 0 && observation->GetMinerals() < 150)
-					{
-						return false;
-					}
 					return (ExecuteResearchAbility(ABILITY_ID::MORPH_ORBITALCOMMAND, UNIT_TYPEID::TERRAN_COMMANDCENTER));
 				}
 
 				bool TryOrbitalCommandSummonMule()
 				{
-					const ObservationInterface* observation = Observation();
-
 					if (CountOf(UNIT_TYPEID::TERRAN_ORBITALCOMMAND) > 0)
 					{
 						return false;
@@ -559,180 +974,79 @@ namespace KoKeKoKo
 
 				bool TryCommandCenterMorphPlanetaryFortress()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_COMMANDCENTER) > 0 && observation->GetMinerals() < 150 && observation->GetVespene() < 150)
-					{
-						return false;
-					}
 					return (ExecuteResearchAbility(ABILITY_ID::MORPH_PLANETARYFORTRESS, UNIT_TYPEID::TERRAN_COMMANDCENTER));
 				}
 
 				bool TrainSCV()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (observation->GetFoodCap() - observation->GetFoodUsed() < 1 && observation->GetMinerals() < 50)
-					{
-						return false;
-					}
 					return ExecuteTrainAbility(ABILITY_ID::TRAIN_SCV, UNIT_TYPEID::TERRAN_COMMANDCENTER);
 				}
 
 				bool TryBuildSupplyDepot()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (observation->GetFoodUsed() <= observation->GetFoodCap() - 2 && observation->GetMinerals() < 100)
-						return false;
-
 					return ExecuteBuildAbility(ABILITY_ID::BUILD_SUPPLYDEPOT);
 				}
 				
 				//Barracks Units
 				bool TryBuildBarracks()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_SUPPLYDEPOT) < 1 && observation->GetMinerals() < 150)
-					{
-						return false;
-					}
-
-					if (CountOf(UNIT_TYPEID::TERRAN_BARRACKS) > 0 && observation->GetMinerals() < 150)
-					{
-						return false;
-					}
-
 					return ExecuteBuildAbility(ABILITY_ID::BUILD_BARRACKS);
 				}
 
 				bool TrainMarine()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_BARRACKS) > 0 && observation->GetFoodCap() - observation->GetFoodUsed() < 1 && observation->GetMinerals() < 50)
-					{
-						return false;
-					}
 					return ExecuteTrainAbility(ABILITY_ID::TRAIN_MARINE, UNIT_TYPEID::TERRAN_BARRACKS);
 				}
 
 				bool TrainReaper()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_BARRACKS) > 0 && observation->GetFoodCap() - observation->GetFoodUsed() < 1 && observation->GetMinerals() < 50 && observation->GetVespene() < 50)
-					{
-						return false;
-					}
 					return ExecuteTrainAbility(ABILITY_ID::TRAIN_REAPER, UNIT_TYPEID::TERRAN_BARRACKS);
 				}
 
 				bool TrainMarauder()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_BARRACKSTECHLAB) > 0 && observation->GetFoodCap() - observation->GetFoodUsed() < 2 && observation->GetMinerals() < 100 && observation->GetVespene() < 25)
-					{
-						return false;
-					}
 					return ExecuteTrainAbility(ABILITY_ID::TRAIN_MARAUDER, UNIT_TYPEID::TERRAN_BARRACKS);
 				}
 
 				bool TrainGhost()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_BARRACKSTECHLAB) > 0 && CountOf(UNIT_TYPEID::TERRAN_GHOSTACADEMY) > 0 && observation->GetFoodCap() - observation->GetFoodUsed() < 2 && observation->GetMinerals() < 150 && observation->GetVespene() < 125)
-					{
-						return false;
-					}
 					return ExecuteTrainAbility(ABILITY_ID::TRAIN_GHOST, UNIT_TYPEID::TERRAN_BARRACKS);
 				}
 
 				//Barracks Addons
 				bool TryBuildBarracksTechLab()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_BARRACKS) > 0 && observation->GetMinerals() < 50 && observation->GetVespene() < 25)
-					{
-						return false;
-					}
 					return ExecuteResearchAbility(ABILITY_ID::BUILD_TECHLAB, UNIT_TYPEID::TERRAN_BARRACKS);
 				}
 
 				bool TryBarracksTechLabResearchCombatShield()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_BARRACKSTECHLAB) > 0 && observation->GetMinerals() < 100 && observation->GetVespene() < 100)
-					{
-						return false;
-					}
 					return ExecuteResearchAbility(ABILITY_ID::RESEARCH_COMBATSHIELD, UNIT_TYPEID::TERRAN_BARRACKSTECHLAB);
 				}
 
 				bool TryBarracksTechLabResearchStimpack()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_BARRACKSTECHLAB) > 0 && observation->GetMinerals() < 100 && observation->GetVespene() < 100)
-					{
-						return false;
-					}
 					return ExecuteResearchAbility(ABILITY_ID::RESEARCH_STIMPACK, UNIT_TYPEID::TERRAN_BARRACKSTECHLAB);
 				}
 
 				bool TryBarracksTechLabResearchConcussiveShells()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_BARRACKSTECHLAB) > 0 && observation->GetMinerals() < 50 && observation->GetVespene() < 50)
-					{
-						return false;
-					}
 					return ExecuteResearchAbility(ABILITY_ID::RESEARCH_CONCUSSIVESHELLS, UNIT_TYPEID::TERRAN_BARRACKSTECHLAB);
 				}
 
 				bool TryBuildBarracksReactor()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_BARRACKS) > 0 && observation->GetMinerals() < 50 && observation->GetVespene() < 50)
-					{
-						return false;
-					}
 					return ExecuteResearchAbility(ABILITY_ID::BUILD_REACTOR, UNIT_TYPEID::TERRAN_BARRACKS);
 				}
 
 				//Factory Units
 				bool TryBuildFactory()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_SUPPLYDEPOT) < 1 && observation->GetMinerals() < 150 && observation->GetVespene() < 100)
-					{
-						return false;
-					}
-
-					if (CountOf(UNIT_TYPEID::TERRAN_FACTORY) > 0 && observation->GetMinerals() < 150 && observation->GetVespene() < 100)
-					{
-						return false;
-					}
-
 					return ExecuteBuildAbility(ABILITY_ID::BUILD_FACTORY);
 				}
 
 				bool TryTrainHellion()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_FACTORY) > 0 && observation->GetFoodCap() - observation->GetFoodUsed() < 2 && observation->GetMinerals() < 100)
-					{
-						return false;
-					}
 					return ExecuteTrainAbility(ABILITY_ID::TRAIN_HELLION, UNIT_TYPEID::TERRAN_FACTORY);
 				}
 
@@ -743,23 +1057,11 @@ namespace KoKeKoKo
 
 				bool TryTrainWidowMine()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_FACTORYTECHLAB) > 0 && observation->GetFoodCap() - observation->GetFoodUsed() < 2 && observation->GetMinerals() < 75 && observation->GetVespene() < 25)
-					{
-						return false;
-					}
 					return ExecuteTrainAbility(ABILITY_ID::TRAIN_WIDOWMINE, UNIT_TYPEID::TERRAN_FACTORY);
 				}
 
 				bool TryTrainSiegeTank()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_FACTORYTECHLAB) > 0 && observation->GetFoodCap() - observation->GetFoodUsed() < 3 && observation->GetMinerals() < 150 && observation->GetVespene() < 125)
-					{
-						return false;
-					}
 					return ExecuteTrainAbility(ABILITY_ID::TRAIN_SIEGETANK, UNIT_TYPEID::TERRAN_FACTORY);
 				}
 
@@ -775,23 +1077,11 @@ namespace KoKeKoKo
 
 				bool TryTrainCyclone()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_FACTORY) > 0 && observation->GetFoodCap() - observation->GetFoodUsed() < 3 && observation->GetMinerals() < 150 && observation->GetVespene() < 100)
-					{
-						return false;
-					}
 					return ExecuteTrainAbility(ABILITY_ID::TRAIN_CYCLONE, UNIT_TYPEID::TERRAN_FACTORY);
 				}
 
 				bool TryTrainHellbat()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_FACTORY) > 0 && CountOf(UNIT_TYPEID::TERRAN_ARMORY) > 0 && observation->GetFoodCap() - observation->GetFoodUsed() < 2 && observation->GetMinerals() < 100)
-					{
-						return false;
-					}
 					return ExecuteTrainAbility(ABILITY_ID::TRAIN_HELLBAT, UNIT_TYPEID::TERRAN_FACTORY);
 				}
 
@@ -802,82 +1092,39 @@ namespace KoKeKoKo
 
 				bool TryTrainThor()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_FACTORYTECHLAB) > 0 && CountOf(UNIT_TYPEID::TERRAN_ARMORY) > 0 && observation->GetFoodCap() - observation->GetFoodUsed() < 6 && observation->GetMinerals() < 300 && observation->GetVespene() < 200)
-					{
-						return false;
-					}
 					return ExecuteTrainAbility(ABILITY_ID::TRAIN_THOR, UNIT_TYPEID::TERRAN_FACTORY);
 				}
 
 				//Factory Addons
 				bool TryBuildFactoryTechLab()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_FACTORY) > 0 && observation->GetMinerals() < 50 && observation->GetVespene() < 25)
-					{
-						return false;
-					}
 					return ExecuteResearchAbility(ABILITY_ID::BUILD_TECHLAB, UNIT_TYPEID::TERRAN_FACTORY);
 				}
 
 				bool TryFactoryResearchInfernalPreIgniter()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_FACTORYTECHLAB) > 0 && observation->GetMinerals() < 100 && observation->GetVespene() < 100)
-					{
-						return false;
-					}
 					return ExecuteResearchAbility(ABILITY_ID::RESEARCH_INFERNALPREIGNITER, UNIT_TYPEID::TERRAN_FACTORYTECHLAB);
 				}
 
 				bool TryFactoryResearchMagFieldAccelerator()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_FACTORYTECHLAB) > 0 && observation->GetMinerals() < 100 && observation->GetVespene() < 100)
-					{
-						return false;
-					}
 					return ExecuteResearchAbility(ABILITY_ID::RESEARCH_MAGFIELDLAUNCHERS, UNIT_TYPEID::TERRAN_FACTORYTECHLAB);
 				}
 
 				bool TryFactoryResearchDrillingClaws()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_FACTORYTECHLAB) > 0 && observation->GetMinerals() < 75 && observation->GetVespene() < 75)
-					{
-						return false;
-					}
 					return ExecuteResearchAbility(ABILITY_ID::RESEARCH_DRILLINGCLAWS, UNIT_TYPEID::TERRAN_FACTORYTECHLAB);
 				}
 
 				bool TryBuildFactoryReactor()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_FACTORY) > 0 && observation->GetMinerals() < 50 && observation->GetVespene() < 50)
-					{
-						return false;
-					}
 					return ExecuteResearchAbility(ABILITY_ID::BUILD_REACTOR, UNIT_TYPEID::TERRAN_FACTORY);
 				}
 
 				//Starport Units
 				bool TryBuildStarport()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_SUPPLYDEPOT) < 1 || CountOf(UNIT_TYPEID::TERRAN_FACTORY) < 1 && observation->GetMinerals() < 150 && observation->GetVespene() < 100)
-					{
-						return false;
-					}
-
-					if (CountOf(UNIT_TYPEID::TERRAN_STARPORT) > 0 && observation->GetMinerals() < 150 && observation->GetVespene() < 100)
+					if (CountOf(UNIT_TYPEID::TERRAN_SUPPLYDEPOT) < 1 || CountOf(UNIT_TYPEID::TERRAN_FACTORY) < 1)
 					{
 						return false;
 					}
@@ -887,12 +1134,6 @@ namespace KoKeKoKo
 
 				bool  TryTrainViking()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_STARPORT) > 0 && observation->GetFoodCap() - observation->GetFoodUsed() < 2 && observation->GetMinerals() < 150 && observation->GetVespene() < 75)
-					{
-						return false;
-					}
 					return ExecuteTrainAbility(ABILITY_ID::TRAIN_VIKINGFIGHTER, UNIT_TYPEID::TERRAN_STARPORT);
 				}
 
@@ -908,23 +1149,11 @@ namespace KoKeKoKo
 
 				bool TryTrainMedivac()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_STARPORT) > 0 && observation->GetFoodCap() - observation->GetFoodUsed() < 2 && observation->GetMinerals() < 100 && observation->GetVespene() < 100)
-					{
-						return false;
-					}
 					return ExecuteTrainAbility(ABILITY_ID::TRAIN_MEDIVAC, UNIT_TYPEID::TERRAN_STARPORT);
 				}
 
 				bool TryTrainLiberator()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_STARPORT) > 0 && observation->GetFoodCap() - observation->GetFoodUsed() < 3 && observation->GetMinerals() < 150 && observation->GetVespene() < 150)
-					{
-						return false;
-					}
 					return ExecuteTrainAbility(ABILITY_ID::TRAIN_LIBERATOR, UNIT_TYPEID::TERRAN_STARPORT);
 				}
 
@@ -940,19 +1169,11 @@ namespace KoKeKoKo
 
 				bool TryTrainRaven()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_STARPORTTECHLAB) > 0 && observation->GetFoodCap() - observation->GetFoodUsed() < 2 && observation->GetMinerals() < 100 && observation->GetVespene() < 200)
-					{
-						return false;
-					}
 					return ExecuteTrainAbility(ABILITY_ID::TRAIN_RAVEN, UNIT_TYPEID::TERRAN_STARPORT);
 				}
 
 				bool TryRavenSummonPointDefenseDrone()
 				{
-					const ObservationInterface* observation = Observation();
-
 					if (CountOf(UNIT_TYPEID::TERRAN_RAVEN) > 0)
 					{
 						return false;
@@ -962,8 +1183,6 @@ namespace KoKeKoKo
 
 				bool TryRavenSummonAutoTurret()
 				{
-					const ObservationInterface* observation = Observation();
-
 					if (CountOf(UNIT_TYPEID::TERRAN_RAVEN) > 0)
 					{
 						return false;
@@ -973,146 +1192,62 @@ namespace KoKeKoKo
 
 				bool TryTrainBanshee()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_STARPORTTECHLAB) > 0 && observation->GetFoodCap() - observation->GetFoodUsed() < 3 && observation->GetMinerals() < 150 && observation->GetVespene() < 100)
-					{
-						return false;
-					}
 					return ExecuteTrainAbility(ABILITY_ID::TRAIN_BANSHEE, UNIT_TYPEID::TERRAN_STARPORT);
 				}
 
 				bool TryTrainBattlecruiser()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_STARPORTTECHLAB) > 0 && CountOf(UNIT_TYPEID::TERRAN_FUSIONCORE) > 0 && observation->GetFoodCap() - observation->GetFoodUsed() < 6 && observation->GetMinerals() < 400 && observation->GetVespene() < 300)
-					{
-						return false;
-					}
 					return ExecuteTrainAbility(ABILITY_ID::TRAIN_BATTLECRUISER, UNIT_TYPEID::TERRAN_STARPORT);
 				}
 
 				//Starport Addons
 				bool TryBuildStarportTechLab()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_STARPORT) > 0 && observation->GetMinerals() < 50 && observation->GetVespene() < 25)
-					{
-						return false;
-					}
 					return ExecuteResearchAbility(ABILITY_ID::BUILD_TECHLAB, UNIT_TYPEID::TERRAN_STARPORT);
 				}
 
 				bool TryStarportResearchCorvidReactor()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_STARPORTTECHLAB) > 0 && observation->GetMinerals() < 150 && observation->GetVespene() < 150)
-					{
-						return false;
-					}
 					return ExecuteResearchAbility(ABILITY_ID::RESEARCH_RAVENCORVIDREACTOR, UNIT_TYPEID::TERRAN_STARPORTTECHLAB);
 				}
 
 				bool TryStarportResearchCloakingField()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_STARPORTTECHLAB) > 0 && observation->GetMinerals() < 100 && observation->GetVespene() < 100)
-					{
-						return false;
-					}
 					return ExecuteResearchAbility(ABILITY_ID::RESEARCH_BANSHEECLOAKINGFIELD, UNIT_TYPEID::TERRAN_STARPORTTECHLAB);
 				}
 
 				bool TryStarportResearchHyperflightRotors()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_STARPORTTECHLAB) > 0 && observation->GetMinerals() < 150 && observation->GetVespene() < 150)
-					{
-						return false;
-					}
 					return ExecuteResearchAbility(ABILITY_ID::RESEARCH_BANSHEEHYPERFLIGHTROTORS, UNIT_TYPEID::TERRAN_STARPORTTECHLAB);
 				}
 
 				bool TryStarportResearchAdvancedBallistics()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_STARPORTTECHLAB) > 0 && observation->GetMinerals() < 150 && observation->GetVespene() < 150)
-					{
-						return false;
-					}
 					return ExecuteResearchAbility(ABILITY_ID::RESEARCH_ADVANCEDBALLISTICS, UNIT_TYPEID::TERRAN_STARPORTTECHLAB);
 				}
 
 				bool TryStarportResearchRapidReignitionSystem()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_STARPORTTECHLAB) > 0 && observation->GetMinerals() < 100 && observation->GetVespene() < 100)
-					{
-						return false;
-					}
 					return ExecuteResearchAbility(ABILITY_ID::RESEARCH_HIGHCAPACITYFUELTANKS, UNIT_TYPEID::TERRAN_STARPORTTECHLAB);
 				}
 
 				bool TryBuildStarportReactor()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_STARPORT) > 0 && observation->GetMinerals() < 50 && observation->GetVespene() < 50)
-					{
-						return false;
-					}
 					return ExecuteResearchAbility(ABILITY_ID::BUILD_REACTOR, UNIT_TYPEID::TERRAN_STARPORT);
 				}
 
 				bool TryBuildFusionCore()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_SUPPLYDEPOT) < 1 && observation->GetMinerals() < 150 && observation->GetVespene() < 150)
-					{
-						return false;
-					}
-
-					if (CountOf(UNIT_TYPEID::TERRAN_FUSIONCORE) > 1 && observation->GetMinerals() < 150 && observation->GetVespene() < 150)
-					{
-						return false;
-					}
-
 					return ExecuteBuildAbility(ABILITY_ID::BUILD_FUSIONCORE);
 				}
 
 				bool TryFusionCoreResearchResearchWeaponRefit()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_STARPORTTECHLAB) > 0 && observation->GetMinerals() < 150 && observation->GetVespene() < 150)
-					{
-						return false;
-					}
 					return ExecuteResearchAbility(ABILITY_ID::RESEARCH_BATTLECRUISERWEAPONREFIT, UNIT_TYPEID::TERRAN_FUSIONCORE);
 				}
 
 				bool TryBuildArmory()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_SUPPLYDEPOT) < 1 && observation->GetMinerals() < 150 && observation->GetVespene() < 100)
-					{
-						return false;
-					}
-
-					if (CountOf(UNIT_TYPEID::TERRAN_ARMORY) > 0 && observation->GetMinerals() < 150 && observation->GetVespene() < 100)
-					{
-						return false;
-					}
-
 					return ExecuteBuildAbility(ABILITY_ID::BUILD_ARMORY);
 				}
 
@@ -1121,15 +1256,11 @@ namespace KoKeKoKo
 					const ObservationInterface* observation = Observation();
 					for (UpgradeID i : observation->GetUpgrades())
 					{
-						if (observation->GetMinerals() < 100 & observation->GetVespene() < 100)
-						{
-							return false;
-						}
-						else if (i == UPGRADE_ID::TERRANVEHICLEWEAPONSLEVEL1 && observation->GetMinerals() < 175 & observation->GetVespene() < 175)
+						if (i == UPGRADE_ID::TERRANVEHICLEWEAPONSLEVEL1 && (_budget.GetMinerals() < 175 || _budget.GetVespene() < 175))
 						{
 							return false;
 						}
-						else if (i == UPGRADE_ID::TERRANVEHICLEWEAPONSLEVEL2 && observation->GetMinerals() < 250 & observation->GetVespene() < 250)
+						else if (i == UPGRADE_ID::TERRANVEHICLEWEAPONSLEVEL2 && (_budget.GetMinerals() < 250 || _budget.GetVespene() < 250))
 						{
 							return false;
 						}
@@ -1147,15 +1278,11 @@ namespace KoKeKoKo
 					const ObservationInterface* observation = Observation();
 					for (UpgradeID i : observation->GetUpgrades())
 					{
-						if (observation->GetMinerals() < 100 & observation->GetVespene() < 100)
-						{
-							return false;
-						}
-						else if (i == UPGRADE_ID::TERRANSHIPWEAPONSLEVEL1 && observation->GetMinerals() < 175 & observation->GetVespene() < 175)
+						if (i == UPGRADE_ID::TERRANSHIPWEAPONSLEVEL1 && (_budget.GetMinerals() < 175 || _budget.GetVespene() < 175))
 						{
 							return false;
 						}
-						else if (i == UPGRADE_ID::TERRANSHIPWEAPONSLEVEL2 && observation->GetMinerals() < 250 & observation->GetVespene() < 250)
+						else if (i == UPGRADE_ID::TERRANSHIPWEAPONSLEVEL2 && (_budget.GetMinerals() < 250 || _budget.GetVespene() < 250))
 						{
 							return false;
 						}
@@ -1173,15 +1300,11 @@ namespace KoKeKoKo
 					const ObservationInterface* observation = Observation();
 					for (UpgradeID i : observation->GetUpgrades())
 					{
-						if (observation->GetMinerals() < 100 & observation->GetVespene() < 100)
-						{
-							return false;
-						}
-						else if (i == UPGRADE_ID::TERRANVEHICLEANDSHIPARMORSLEVEL1 && observation->GetMinerals() < 175 & observation->GetVespene() < 175)
+						if (i == UPGRADE_ID::TERRANVEHICLEANDSHIPARMORSLEVEL1 && (_budget.GetMinerals() < 175 || _budget.GetVespene() < 175))
 						{
 							return false;
 						}
-						else if (i == UPGRADE_ID::TERRANVEHICLEANDSHIPARMORSLEVEL2 && observation->GetMinerals() < 250 & observation->GetVespene() < 250)
+						else if (i == UPGRADE_ID::TERRANVEHICLEANDSHIPARMORSLEVEL2 && (_budget.GetMinerals() < 250 || _budget.GetVespene() < 250))
 						{
 							return false;
 						}
@@ -1196,31 +1319,12 @@ namespace KoKeKoKo
 
 				bool TryBuildBunker()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_SUPPLYDEPOT) < 1 && observation->GetMinerals() < 150)
-					{
-						return false;
-					}
-
-					if (CountOf(UNIT_TYPEID::TERRAN_BUNKER) > 0 && observation->GetMinerals() < 150)
-					{
-						return false;
-					}
-
 					return ExecuteBuildAbility(ABILITY_ID::BUILD_BUNKER);
 				}
 
 				bool TryBuildEngineeringBay()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_SUPPLYDEPOT) < 1 || CountOf(UNIT_TYPEID::TERRAN_COMMANDCENTER) < 1 && observation->GetMinerals() < 125)
-					{
-						return false;
-					}
-
-					if (CountOf(UNIT_TYPEID::TERRAN_ENGINEERINGBAY) > 0 && observation->GetMinerals() < 125)
+					if (CountOf(UNIT_TYPEID::TERRAN_SUPPLYDEPOT) < 1)
 					{
 						return false;
 					}
@@ -1233,15 +1337,11 @@ namespace KoKeKoKo
 					const ObservationInterface* observation = Observation();
 					for (UpgradeID i : observation->GetUpgrades())
 					{
-						if (observation->GetMinerals() < 100 & observation->GetVespene() < 100)
+						if (i == UPGRADE_ID::TERRANINFANTRYARMORSLEVEL1 && (_budget.GetMinerals() < 175 || _budget.GetVespene() < 175))
 						{
 							return false;
 						}
-						else if (i == UPGRADE_ID::TERRANINFANTRYARMORSLEVEL1 && observation->GetMinerals() < 175 & observation->GetVespene() < 175)
-						{
-							return false;
-						}
-						else if (i == UPGRADE_ID::TERRANINFANTRYARMORSLEVEL2 && observation->GetMinerals() < 250 & observation->GetVespene() < 250)
+						else if (i == UPGRADE_ID::TERRANINFANTRYARMORSLEVEL2 && (_budget.GetMinerals() < 250 || _budget.GetVespene() < 250))
 						{
 							return false;
 						}
@@ -1259,15 +1359,11 @@ namespace KoKeKoKo
 					const ObservationInterface* observation = Observation();
 					for (UpgradeID i : observation->GetUpgrades())
 					{
-						if (observation->GetMinerals() < 100 & observation->GetVespene() < 100)
-						{
-							return false;
-						}
-						else if (i == UPGRADE_ID::TERRANINFANTRYWEAPONSLEVEL1 && observation->GetMinerals() < 175 & observation->GetVespene() < 175)
+						if (i == UPGRADE_ID::TERRANINFANTRYWEAPONSLEVEL1 && (_budget.GetMinerals() < 175 || _budget.GetVespene() < 175))
 						{
 							return false;
 						}
-						else if (i == UPGRADE_ID::TERRANINFANTRYWEAPONSLEVEL2 && observation->GetMinerals() < 250 & observation->GetVespene() < 250)
+						else if (i == UPGRADE_ID::TERRANINFANTRYWEAPONSLEVEL2 && (_budget.GetMinerals() < 250 || _budget.GetVespene() < 250))
 						{
 							return false;
 						}
@@ -1282,53 +1378,22 @@ namespace KoKeKoKo
 
 				bool TryBuildGhostAcademy()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_SUPPLYDEPOT) < 1 && observation->GetMinerals() < 150 && observation->GetVespene() < 50)
-					{
-						return false;
-					}
-
-					if (CountOf(UNIT_TYPEID::TERRAN_GHOSTACADEMY) > 0 && observation->GetMinerals() < 150 && observation->GetVespene() < 50)
-					{
-						return false;
-					}
-
 					return ExecuteBuildAbility(ABILITY_ID::BUILD_GHOSTACADEMY);
 				}
 
 				bool TryGhostAcademyResearchPersonalCloaking()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_STARPORTTECHLAB) > 0 && observation->GetMinerals() < 150 && observation->GetVespene() < 150)
-					{
-						return false;
-					}
 					return ExecuteResearchAbility(ABILITY_ID::RESEARCH_PERSONALCLOAKING, UNIT_TYPEID::TERRAN_GHOSTACADEMY);
 				}
 
 				bool TryGhostAcademyBuildNuke()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_STARPORTTECHLAB) > 0 && observation->GetMinerals() < 100 && observation->GetVespene() < 100)
-					{
-						return false;
-					}
 					return ExecuteResearchAbility(ABILITY_ID::BUILD_NUKE, UNIT_TYPEID::TERRAN_GHOSTACADEMY);
 				}
 
 				bool TryBuildMissileTurret()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_SUPPLYDEPOT) < 1 || CountOf(UNIT_TYPEID::TERRAN_ENGINEERINGBAY) < 1 && observation->GetMinerals() < 100)
-					{
-						return false;
-					}
-
-					if (CountOf(UNIT_TYPEID::TERRAN_MISSILETURRET) > 0 && observation->GetMinerals() < 100)
+					if (CountOf(UNIT_TYPEID::TERRAN_SUPPLYDEPOT) < 1 || CountOf(UNIT_TYPEID::TERRAN_ENGINEERINGBAY) < 1)
 					{
 						return false;
 					}
@@ -1338,14 +1403,7 @@ namespace KoKeKoKo
 
 				bool TryBuildSensorTower()
 				{
-					const ObservationInterface* observation = Observation();
-
-					if (CountOf(UNIT_TYPEID::TERRAN_SUPPLYDEPOT) < 1 || CountOf(UNIT_TYPEID::TERRAN_ENGINEERINGBAY) < 1 && observation->GetMinerals() < 125 && observation->GetVespene() < 100)
-					{
-						return false;
-					}
-
-					if (CountOf(UNIT_TYPEID::TERRAN_SENSORTOWER) > 0 && observation->GetMinerals() < 125 && observation->GetVespene() < 100)
+					if (CountOf(UNIT_TYPEID::TERRAN_SUPPLYDEPOT) < 1 || CountOf(UNIT_TYPEID::TERRAN_ENGINEERINGBAY) < 1)
 					{
 						return false;
 					}
@@ -1354,71 +1412,148 @@ namespace KoKeKoKo
 				}
 
 			public:
-				KoKeKoKoBot()
+				KoKeKoKoBot(ActionProvider* provider) : _actions(MAXIMUM_QUEUEDACTIONS, Types::OverflowPolicy::DropNewest)
 				{
 					//Perform intializations
-					_instance = Model::ModelRepositoryService::StartModelRepositoryService();
+					_provider = provider;
+					_observationinterface = nullptr;
+					_actioninterface = nullptr;
 					_shouldkeepupdating = false;
 					_threads = std::map<std::string, std::thread*>();
-					_actions = std::queue<std::string>();
-					_currentaction = "";
+					_currentaction = Action::NONE;
+					_currentwaitloop = 0;
+					_skippedactions = 0;
+					_currentstamp = DecisionStamp();
+					_orderregistryrebuild = 0;
+					_executedactions = 0;
+					_executingsteps = 0;
+					_maximumexecutedactions = 0;
+					_openingstep = 0;
+					_isopening = false;
+					_openingwaitloop = 0;
+					_openingbook = nullptr;
+					_openingrank = OPENINGBOOK_ALLRANKS;
+					_openingnode = OPENINGBOOK_NONODE;
+					_firstactionmilliseconds = -1;
+					_firstmodelactionmilliseconds = -1;
 				}
 
-				virtual void OnGameStart() final
+				//Follows the openings of a rank in the opening book instead of the generated opening, the book has to stay open for as long as the agent plays
+				void SetOpeningBook(const OpeningBook* book, uint32_t rank)
 				{
-					//We periodically get message and send updates to model service
-					StartSendingUpdatesToModelService();
+					_openingbook = book;
+					_openingrank = rank;
+				}
 
-					#if _DEBUG
-						std::cout << "Finished calling StartSendingUpdatesToModelService()! Proceeding to start the game... Getting the current action...";
-					#endif
+				//Plays against the given observation and actions instead of the ones of the game, such as a replay of the simulation, nullptr goes back to the game
+				//They have to stay alive for as long as the agent plays
+				void SetInterfaces(const ObservationInterface* observation, ActionInterface* actions)
+				{
+					_observationinterface = observation;
+					_actioninterface = actions;
+				}
 
+				//Returns the observation of the game, or the one that stands in for it, every call of the agent goes through here
+				const ObservationInterface* Observation() const
+				{
+					return ((_observationinterface != nullptr) ? _observationinterface : sc2::Agent::Observation());
+				}
 
-					//while there is still no action, we wait for a message
-					while (_currentaction.empty())
-					{
-						#if _DEBUG
-							std::cout << "Current action is still empty! Cannot continue to the game..." << std::endl;
-						#endif
-						_currentaction = GetAnActionFromMessage();
-						if (_currentaction.empty())
-							//Wait for 5 seconds if there is still no message
-							std::this_thread::sleep_for(std::chrono::milliseconds(5000)); 
-					}
+				//Returns the actions of the game, or the ones that stand in for them
+				ActionInterface* Actions()
+				{
+					return ((_actioninterface != nullptr) ? _actioninterface : sc2::Agent::Actions());
+				}
 
-					std::cout << _currentaction << std::endl;
+				//Returns how long the executed actions took from their snapshots to their commands so far
+				const DecisionTrace& GetDecisionTrace() const
+				{
+					return _decisiontrace;
+				}
+
+				//Returns the number of actions of model service that were skipped because they could not be paid for in time
+				uint64_t GetSkippedActionCount() const
+				{
+					return _skippedactions;
+				}
+
+				virtual void OnGameStart() final
+				{
+					KOKEKOKO_PROFILE_THREAD("Game");
+					KOKEKOKO_PROFILE_ZONE("OnGameStart");
+					//A new game may start at the same game loop as the last one
+					_unitindex.Invalidate();
+					//Model service needs a snapshot of the start of the game before it sends the first actions
+					PublishSnapshot();
+
+					//We periodically get message and send updates to model service
+					StartSendingUpdatesToProvider();
+
+					//The game starts right away with the opening, model service takes over once it has sent its first actions
+					_currentaction = Action::NONE;
+					_openingstep = 0;
+					_isopening = true;
+					_openingwaitloop = Observation()->GetGameLoop();
+					_openingnode = (_openingbook != nullptr) ? _openingbook->Find(nullptr, 0) : OPENINGBOOK_NONODE;
+					_gamestarttime = std::chrono::steady_clock::now();
+					_firstactionmilliseconds = -1;
+					_firstmodelactionmilliseconds = -1;
+
+					KOKEKOKO_LOG_DEBUG("Finished calling StartSendingUpdatesToProvider()! Proceeding to start the game with the opening...");
 				}
 
 				virtual void OnStep() final
 				{
-					//If there is action available
-					if (!_currentaction.empty())
-					{
-						ExecuteAbility(_currentaction);
-						_currentaction = "";
-					}
-					else
-						_currentaction = GetAnActionFromMessage();
-						
-					std::cout << _currentaction << std::endl;
+					KOKEKOKO_PROFILE_ZONE("OnStep");
+					//Index the units once for this game loop, every helper below reads from it
+					_unitindex.Update(Observation());
+					PublishSnapshot();
+
+					ExecuteAffordableActions();
 				}
 
 				virtual void OnGameEnd() final
 				{
-					StopSendingUpdatesToModelService();
-					
-					//Dispose the modelrepositoryservice instance
-					_instance->~ModelRepositoryService();
-					_instance = nullptr;
+					StopSendingUpdatesToProvider();
+
+					//Report how much the queues have overflowed during the game
+					_provider->Stop();
+					KOKEKOKO_LOG_INFO("Actions: {} queued, {} executed, {} skipped, {} dropped", _actions.GetPushedCount(), _actions.GetPoppedCount(), _skippedactions, _actions.GetDroppedCount());
+					KOKEKOKO_LOG_INFO("First action: {} ms, first action of model service: {} ms after the game has started", _firstactionmilliseconds, _firstmodelactionmilliseconds);
+					KOKEKOKO_LOG_INFO("Steps: {} executed actions, {} actions per step on average, {} at most", _executingsteps, ((_executingsteps > 0) ? (static_cast<double>(_executedactions) / _executingsteps) : 0.0), _maximumexecutedactions);
+					KOKEKOKO_LOG_INFO("Snapshots: {} published, {} taken by the sender", _snapshots.GetPublishedCount(), _snapshots.GetAcquiredCount());
+					KOKEKOKO_LOG_INFO("Orders: {} issued, {} never observed", _orderregistry.GetIssuedCount(), _orderregistry.GetExpiredCount());
+					KOKEKOKO_LOG_INFO("Log: {} messages dropped", Types::Logger::GetDroppedCount());
+					_decisiontrace.Log();
+					#if KOKEKOKO_PROFILER
+						try
+						{
+							uint64_t zones = Types::Profiler::Write(PROFILE_FILENAME);
+							KOKEKOKO_LOG_INFO("Profile: {} zones written to {}, {} dropped", zones, PROFILE_FILENAME, Types::Profiler::GetDroppedCount());
+						}
+						catch (const std::exception& ex)
+						{
+							KOKEKOKO_LOG_ERROR("{}", ex.what());
+						}
+					#endif
 				}
 
-				virtual void OnUnitCreated() final
+				virtual void OnUnitCreated(const Unit* unit) final
 				{
+					KOKEKOKO_PROFILE_ZONE("OnUnitCreated");
+					const UnitTypes& unit_types = Observation()->GetUnitTypeData();
+					size_t unit_type = static_cast<size_t>(unit->unit_type.ToType());
 
+					//The new unit fulfills the order that produced it
+					if (unit_type < unit_types.size())
+						_orderregistry.OnUnitCreated(static_cast<ABILITY_ID>(static_cast<uint32_t>(unit_types[unit_type].ability_id)));
 				}
 
 				virtual void OnUnitIdle(const Unit* unit) final
 				{
+					KOKEKOKO_PROFILE_ZONE("OnUnitIdle");
+					_orderregistry.OnUnitIdle(unit);
+
 					try
 					{
 						switch (unit->unit_type.ToType())
@@ -1438,12 +1573,13 @@ namespace KoKeKoKo
 					}
 					catch (const std::exception& ex)
 					{
-						std::cout << ex.what() << std::endl;
+						KOKEKOKO_LOG_ERROR("{}", ex.what());
 					}
 				}
 
 				virtual void OnUnitDestroyed(const Unit* unit) final
 				{
+					_orderregistry.OnUnitDestroyed(unit);
 
 				}
 
@@ -1452,339 +1588,329 @@ namespace KoKeKoKo
 
 				}
 
-				//A helper function that finds a nearest entity from a position
-				const Unit* FindNearestOf(Point2D source_position, UNIT_TYPEID target_type)
+				//Returns the units of the current game loop, the index is only rebuilt when the game loop has changed
+				UnitIndex& GetUnitIndex()
 				{
-					Units units = Observation()->GetUnits(IsUnit(target_type));
-					const Unit* target = nullptr;
-					float distance = std::numeric_limits<float>::max(), temporary_distance = 0;
+					_unitindex.Update(Observation());
+					return _unitindex;
+				}
+
+				//Returns the orders of our units, they are only recounted when the unit index has been rebuilt
+				OrderRegistry& GetOrderRegistry()
+				{
+					UnitIndex& unitindex = GetUnitIndex();
 
-					for (const auto& unit : units)
+					if (_orderregistryrebuild != unitindex.GetRebuildCount())
 					{
-						temporary_distance = DistanceSquared2D(unit->pos, source_position);
-						if (temporary_distance < distance)
-						{
-							distance = temporary_distance;
-							target = unit;
-						}
+						KOKEKOKO_PROFILE_ZONE("UpdateOrderRegistry");
+						_orderregistry.Update(Observation(), unitindex.GetAllUnits());
+						_orderregistryrebuild = unitindex.GetRebuildCount();
 					}
 
-					return target;
+					return _orderregistry;
+				}
+
+				//A helper function that finds a nearest entity from a position
+				const Unit* FindNearestOf(Point2D source_position, UNIT_TYPEID target_type)
+				{
+					return GetUnitIndex().FindNearestOf(source_position, target_type);
 				}
 
 				//A helper function that counts entity
 				size_t CountOf(UNIT_TYPEID unit_type, Unit::Alliance alliance = Unit::Alliance::Self)
 				{
-					return Observation()->GetUnits(alliance, IsUnit(unit_type)).size();
+					return GetUnitIndex().CountOf(unit_type, alliance);
 				}
 
-				//Executes a valid action that is within the ability_type of the agent
-				void ExecuteAbility(std::string ability)
+				//Captures the observation of this game loop and publishes it to the other threads
+				void PublishSnapshot()
 				{
-					if (ability.find("BUILD_REFINERY") != std::string::npos)
-					{
-						TryBuildRefinery();
-					}
-					else if (ability.find("BUILD_COMMANDCENTER") != std::string::npos)
-					{
-						TryBuildCommandCenter();
-					}
-					else if (ability.find("MORPH_ORBITALCOMMAND") != std::string::npos)
-					{
-						TryCommandCenterMorphOrbitalCommand();
-					}
-					else if (ability.find("EFFECT_CALLDOWNMULE") != std::string::npos)
-					{
-						TryOrbitalCommandSummonMule();
-					}
-					else if (ability.find("MORPH_PLANETARYFORTRESS") != std::string::npos)
-					{
-						TryCommandCenterMorphPlanetaryFortress();
-					}
-					else if (ability.find("TRAIN_SCV") != std::string::npos)
-					{
-						TrainSCV();
-					}
-					else if (ability.find("BUILD_SUPPLYDEPOT") != std::string::npos)
-					{
-						TryBuildSupplyDepot();
-					}
-					else if (ability.find("BUILD_BARRACKS") != std::string::npos)
-					{
-						TryBuildBarracks();
-					}
-					else if (ability.find("TRAIN_MARINE") != std::string::npos)
-					{
-						TrainMarine();
-					}
-					else if (ability.find("TRAIN_REAPER") != std::string::npos)
-					{
-						TrainReaper();
-					}
-					else if (ability.find("TRAIN_MARAUDER") != std::string::npos)
-					{
-						TrainMarauder();
-					}
-					else if (ability.find("TRAIN_GHOST") != std::string::npos)
-					{
-						TrainGhost();
-					}
-					else if (ability.find("BUILD_BARRACKSTECHLAB") != std::string::npos) //Not on Offical Typeenums
-					{
-						TryBuildBarracksTechLab();
-					}
-					else if (ability.find("RESEARCH_COMBATSHIELD") != std::string::npos)
-					{
-						TryBarracksTechLabResearchCombatShield();
-					}
-					else if (ability.find("RESEARCH_STIMPACK") != std::string::npos)
-					{
-						TryBarracksTechLabResearchStimpack();
-					}
-					else if (ability.find("RESEARCH_CONCUSSIVESHELLS") != std::string::npos)
-					{
-						TryBarracksTechLabResearchConcussiveShells();
-					}
-					else if (ability.find("BUILD_BARRACKSREACTOR") != std::string::npos) //Not on Offical Typeenums
-					{
-						TryBuildBarracksReactor();
-					}
-					else if (ability.find("BUILD_FACTORY") != std::string::npos)
-					{
-						TryBuildFactory();
-					}
-					else if (ability.find("TRAIN_HELLION") != std::string::npos)
-					{
-						TryTrainHellion();
-					}
-					else if (ability.find("MORPH_HELLBAT") != std::string::npos)
-					{
-						TryTransformHellionHellbat();
-					}
-					else if (ability.find("TRAIN_WIDOWMINE") != std::string::npos)
-					{
-						TryTrainWidowMine();
-					}
-					else if (ability.find("TRAIN_SIEGETANK") != std::string::npos)
-					{
-						TryTrainSiegeTank();
-					}
-					else if (ability.find("MORPH_SIEGEMODE") != std::string::npos)
-					{
-						TryTransformSiegeMode();
-					}
-					else if (ability.find("MORPH_UNSIEGE") != std::string::npos)
-					{
-						TryTransformUnsiege();
-					}
-					else if (ability.find("TRAIN_CYCLONE") != std::string::npos)
-					{
-						TryTrainCyclone();
-					}
-					else if (ability.find("TRAIN_HELLBAT") != std::string::npos)
-					{
-						TryTrainHellbat();
-					}
-					else if (ability.find("MORPH_HELLION") != std::string::npos)
-					{
-						TryTransformHellbatHellion();
-					}
-					else if (ability.find("TRAIN_THOR") != std::string::npos)
-					{
-						TryTrainThor();
-					}
-					else if (ability.find("BUILD_FACTORYTECHLAB") != std::string::npos) //Not on Offical Typeenums
-					{
-						TryBuildFactoryTechLab();
-					}
-					else if (ability.find("RESEARCH_INFERNALPREIGNITER") != std::string::npos)
-					{
-						TryFactoryResearchInfernalPreIgniter();
-					}
-					else if (ability.find("RESEARCH_MAGFIELDLAUNCHERS") != std::string::npos)
-					{
-						TryFactoryResearchMagFieldAccelerator();
-					}
-					else if (ability.find("RESEARCH_DRILLINGCLAWS") != std::string::npos)
-					{
-						TryFactoryResearchDrillingClaws();
-					}
-					else if (ability.find("BUILD_FACTORYREACTOR") != std::string::npos) //Not on Offical Typeenums
-					{
-						TryBuildFactoryReactor();
-					}
-					else if (ability.find("BUILD_STARPORT") != std::string::npos)
-					{
-						TryBuildStarport();
-					}
-					else if (ability.find("TRAIN_VIKINGFIGHTER") != std::string::npos)
-					{
-						TryTrainViking();
-					}
-					else if (ability.find("MORPH_VIKINGFIGHTERMODE") != std::string::npos)
-					{
-						TryTransformVikingFighter();
-					}
-					else if (ability.find("MORPH_VIKINGASSAULTMODE") != std::string::npos)
-					{
-						TryTransformVikingAssault();
-					}
-					else if (ability.find("TRAIN_MEDIVAC") != std::string::npos)
-					{
-						TryTrainMedivac();
-					}
-					else if (ability.find("TRAIN_LIBERATOR") != std::string::npos)
-					{
-						TryTrainLiberator();
-					}
-					else if (ability.find("MORPH_LIBERATORAGMODE") != std::string::npos)
-					{
-						TryTransformLiberatorLiberatorAG();
-					}
-					else if (ability.find("MORPH_LIBERATORAAMODE") != std::string::npos)
-					{
-						TryTransformLiberatorAGLiberator();
-					}
-					else if (ability.find("TRAIN_RAVEN") != std::string::npos)
-					{
-						TryTrainRaven();
-					}
-					else if (ability.find("EFFECT_AUTOTURRET") != std::string::npos)
-					{
-						TryRavenSummonAutoTurret();
-					}
-					else if (ability.find("TRAIN_BANSHEE") != std::string::npos)
-					{
-						TryTrainBanshee();
-					}
-					else if (ability.find("TRAIN_BATTLECRUISER") != std::string::npos)
-					{
-						TryTrainBattlecruiser();
-					}
-					else if (ability.find("BUILD_STARPORTREACTOR") != std::string::npos) //Not on Offical Typeenums
-					{
-						TryBuildStarportReactor();
-					}
-					else if (ability.find("BUILD_STARPORTTECHLAB") != std::string::npos) //Not on Offical Typeenums
-					{
-						TryBuildStarportTechLab();
-					}
-					else if (ability.find("RESEARCH_HIGHCAPACITYFUELTANKS") != std::string::npos)
-					{
-						TryStarportResearchRapidReignitionSystem();
-					}
-					else if (ability.find("RESEARCH_RAVENCORVIDREACTOR") != std::string::npos)
-					{
-						TryStarportResearchCorvidReactor();
-					}
-					else if (ability.find("RESEARCH_BANSHEECLOAKINGFIELD") != std::string::npos)
-					{
-						TryStarportResearchCloakingField();
-					}
-					else if (ability.find("RESEARCH_BANSHEEHYPERFLIGHTROTORS") != std::string::npos)
-					{
-						TryStarportResearchHyperflightRotors();
-					}
-					else if (ability.find("RESEARCH_ADVANCEDBALLISTICS") != std::string::npos)
-					{
-						TryStarportResearchAdvancedBallistics();
-					}
-					else if (ability.find("BUILD_FUSIONCORE") != std::string::npos)
-					{
-						TryBuildFusionCore();
-					}
-					else if (ability.find("RESEARCH_BATTLECRUISERWEAPONREFIT") != std::string::npos)
-					{
-						TryFusionCoreResearchResearchWeaponRefit();
-					}
-					else if (ability.find("BUILD_ARMORY") != std::string::npos)
-					{
-						TryBuildArmory();
-					}
-					else if (ability.find("RESEARCH_TERRANVEHICLEWEAPONS") != std::string::npos)
-					{
-						TryArmoryResearchVehicleWeapons();
-					}
-					else if (ability.find("RESEARCH_TERRANSHIPWEAPONS") != std::string::npos)
-					{
-						TryArmoryResearchShipWeapons();
-					}
-					else if (ability.find("RESEARCH_TERRANVEHICLEANDSHIPPLATING") != std::string::npos)
-					{
-						TryArmoryResearchVehicleShipPlating();
-					}
-					else if (ability.find("BUILD_BUNKER") != std::string::npos)
-					{
-						TryBuildBunker();
-					}
-					else if (ability.find("BUILD_ENGINEERINGBAY") != std::string::npos)
-					{
-						TryBuildEngineeringBay();
-					}
-					else if (ability.find("RESEARCH_TERRANINFANTRYWEAPONS") != std::string::npos)
-					{
-						TryEngineeringBayResearchInfantryWeapon();
-					}
-					else if (ability.find("RESEARCH_TERRANINFANTRYARMOR") != std::string::npos)
-					{
-						TryEngineeringBayResearchInfantryArmor();
-					}
-					else if (ability.find("BUILD_GHOSTACADEMY") != std::string::npos)
+					KOKEKOKO_PROFILE_ZONE("PublishSnapshot");
+					_unitindex.Update(Observation());
+					_snapshots.GetBackBuffer().Capture(Observation(), _unitindex);
+					_snapshots.Publish();
+				}
+
+				//Returns the milliseconds since the game has started
+				double GetMillisecondsSinceGameStart() const
+				{
+					return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _gamestarttime).count();
+				}
+
+				//Returns the next action of the opening, the most played next action of the opening book if there is one, or NONE once the opening is over
+				Action GetOpeningAction() const
+				{
+					OpeningBookSuccessor successor = {};
+
+					if (_openingbook == nullptr)
+						return ((_openingstep < OPENING_ACTIONCOUNT) ? OPENING_ACTIONS[_openingstep] : Action::NONE);
+					if (_openingbook->GetSuccessors(_openingnode, _openingrank, &successor, 1) == 0 || successor.games < OPENING_MINIMUMGAMES)
+						return Action::NONE;
+
+					return successor.action;
+				}
+
+				//Executes the next actions of the opening in order for as long as the resources of this step can pay for them, and returns the number of executed actions
+				//An action that cannot be executed yet, such as a second worker while the first is still training, is retried on the next steps until it has waited too long
+				size_t ExecuteOpeningActions()
+				{
+					uint32_t gameloop = Observation()->GetGameLoop();
+					size_t executed = 0;
+
+					while (executed < MAXIMUM_ACTIONSPERSTEP && _isopening)
 					{
-						TryBuildGhostAcademy();
+						Action action = GetOpeningAction();
+						if (action == Action::NONE)
+						{
+							KOKEKOKO_LOG_INFO("Opening: Finished after {} actions", _openingstep);
+							_isopening = false;
+							break;
+						}
+
+						const ActionCost& cost = GetActionCost(action);
+
+						if (!_budget.CanAfford(cost))
+							break;
+
+						if (ExecuteAbility(action))
+						{
+							KOKEKOKO_LOG_INFO("Opening: {}", GetActionName(action));
+							_budget.Reserve(cost);
+							executed++;
+						}
+						else if ((gameloop - _openingwaitloop) <= OPENING_MAXIMUMWAITLOOPS)
+							break;
+						else
+							KOKEKOKO_LOG_INFO("Opening: Skipped {}...", GetActionName(action));
+
+						//A skipped action still moves down the opening book, so the opening goes on like the games that have done it
+						_openingstep++;
+						_openingwaitloop = gameloop;
+						if (_openingbook != nullptr)
+							_openingnode = _openingbook->GetChild(_openingnode, action);
 					}
-					else if (ability.find("RESEARCH_PERSONALCLOAKING") != std::string::npos)
+
+					return executed;
+				}
+
+				//Returns true if the action can be paid for except for its supply, and no supply is on the way that would let it be paid for later
+				bool IsSupplyBlocked(const ActionCost& cost)
+				{
+					if (cost.supply <= _budget.GetSupply() || cost.minerals > _budget.GetMinerals() || cost.vespene > _budget.GetVespene())
+						return false;
+					if (Observation()->GetFoodCap() >= MAXIMUM_FOODCAP)
+						return true;
+
+					return !(GetOrderRegistry().IsInFlight(ABILITY_ID::BUILD_SUPPLYDEPOT) || GetOrderRegistry().IsInFlight(ABILITY_ID::BUILD_COMMANDCENTER));
+				}
+
+				//Executes the actions of model service in order for as long as the resources of this step can pay for them, and returns the number of executed actions
+				//An action that cannot be paid for is retried on the next steps, unless it waits for supply that is not on the way or has waited too long
+				size_t ExecuteQueuedActions()
+				{
+					uint32_t gameloop = Observation()->GetGameLoop();
+					size_t executed = 0;
+
+					while (executed < MAXIMUM_ACTIONSPERSTEP)
 					{
-						TryGhostAcademyResearchPersonalCloaking();
+						if (_currentaction == Action::NONE)
+						{
+							_currentaction = GetAnActionFromMessage();
+							_currentwaitloop = gameloop;
+						}
+						if (_currentaction == Action::NONE)
+							break;
+
+						//Keep the action that cannot be paid for until a later step, so the actions stay in order
+						const ActionCost& cost = GetActionCost(_currentaction);
+						if (!_budget.CanAfford(cost))
+						{
+							if (!IsSupplyBlocked(cost) && (gameloop - _currentwaitloop) <= QUEUED_MAXIMUMWAITLOOPS)
+								break;
+
+							//Skipping it lets the actions behind it go on, such as the supply depot that it has been waiting for
+							KOKEKOKO_LOG_INFO("Skipped {} after waiting {} game loops...", GetActionName(_currentaction), gameloop - _currentwaitloop);
+							_skippedactions++;
+							_currentaction = Action::NONE;
+							continue;
+						}
+
+						KOKEKOKO_LOG_DEBUG("{}", GetActionName(_currentaction));
+						if (ExecuteAbility(_currentaction))
+						{
+							//The command has been issued, so the action has come all the way from its snapshot
+							_decisiontrace.Record(_currentstamp, Observation()->GetGameLoop());
+							_budget.Reserve(cost);
+							executed++;
+						}
+						_currentaction = Action::NONE;
 					}
-					else if (ability.find("BUILD_NUKE") != std::string::npos)
+
+					if (executed > 0 && _firstmodelactionmilliseconds < 0)
 					{
-						TryGhostAcademyBuildNuke();
+						_firstmodelactionmilliseconds = GetMillisecondsSinceGameStart();
+						KOKEKOKO_LOG_INFO("The first action of model service has been executed {} ms after the game has started", _firstmodelactionmilliseconds);
 					}
-					else if (ability.find("BUILD_MISSILETURRET") != std::string::npos)
+
+					return executed;
+				}
+
+				//Executes the opening until model service has sent its first actions, then the actions of model service for the rest of the game
+				//The commands are collected by Actions() and sent together when the step ends, and returns the number of executed actions
+				size_t ExecuteAffordableActions()
+				{
+					KOKEKOKO_PROFILE_ZONE("ExecuteAffordableActions");
+					const ObservationInterface* observation = Observation();
+					size_t executed = 0;
+
+					_budget.Reset(observation->GetMinerals(), observation->GetVespene(), observation->GetFoodCap() - observation->GetFoodUsed());
+					if (_isopening && !_actions.IsEmpty())
 					{
-						TryBuildMissileTurret();
+						KOKEKOKO_LOG_INFO("Opening: {} has taken over after {} actions", _provider->GetName(), _openingstep);
+						_isopening = false;
 					}
-					else if (ability.find("BUILD_SENSORTOWER") != std::string::npos)
+					executed = (_isopening ? ExecuteOpeningActions() : ExecuteQueuedActions());
+
+					if (executed > 0 && _firstactionmilliseconds < 0)
 					{
-						TryBuildSensorTower();
+						_firstactionmilliseconds = GetMillisecondsSinceGameStart();
+						KOKEKOKO_LOG_INFO("The first action has been executed {} ms after the game has started", _firstactionmilliseconds);
 					}
-					else if (ability.find("SURRENDER") != std::string::npos)
+					if (executed > 0)
 					{
-						Debug()->DebugEndGame();
+						_executedactions += executed;
+						_executingsteps++;
+						_maximumexecutedactions = std::max(_maximumexecutedactions, executed);
 					}
+
+					return executed;
 				}
 
-				//Starts to check if there is a message and sends updates to model service
-				void StartSendingUpdatesToModelService()
+				//Ends the game as a loss
+				bool TrySurrender()
 				{
-					StopSendingUpdatesToModelService();
+					Debug()->DebugEndGame();
+					return true;
+				}
+
+				//Executes a valid action that is within the ability_type of the agent through a table of handlers that is built at compile time
+				bool ExecuteAbility(Action action)
+				{
+					typedef bool (KoKeKoKoBot::*ActionHandler)();
+					//The handlers of the actions in the same order as Action
+					static constexpr ActionHandler ACTION_HANDLERS[] =
+					{
+						nullptr, //NONE
+						&KoKeKoKoBot::TryBuildRefinery, //BUILD_REFINERY
+						&KoKeKoKoBot::TryBuildCommandCenter, //BUILD_COMMANDCENTER
+						&KoKeKoKoBot::TryCommandCenterMorphOrbitalCommand, //MORPH_ORBITALCOMMAND
+						&KoKeKoKoBot::TryOrbitalCommandSummonMule, //EFFECT_CALLDOWNMULE
+						&KoKeKoKoBot::TryCommandCenterMorphPlanetaryFortress, //MORPH_PLANETARYFORTRESS
+						&KoKeKoKoBot::TrainSCV, //TRAIN_SCV
+						&KoKeKoKoBot::TryBuildSupplyDepot, //BUILD_SUPPLYDEPOT
+						&KoKeKoKoBot::TryBuildBarracks, //BUILD_BARRACKS
+						&KoKeKoKoBot::TrainMarine, //TRAIN_MARINE
+						&KoKeKoKoBot::TrainReaper, //TRAIN_REAPER
+						&KoKeKoKoBot::TrainMarauder, //TRAIN_MARAUDER
+						&KoKeKoKoBot::TrainGhost, //TRAIN_GHOST
+						&KoKeKoKoBot::TryBuildBarracksTechLab, //BUILD_BARRACKSTECHLAB
+						&KoKeKoKoBot::TryBarracksTechLabResearchCombatShield, //RESEARCH_COMBATSHIELD
+						&KoKeKoKoBot::TryBarracksTechLabResearchStimpack, //RESEARCH_STIMPACK
+						&KoKeKoKoBot::TryBarracksTechLabResearchConcussiveShells, //RESEARCH_CONCUSSIVESHELLS
+						&KoKeKoKoBot::TryBuildBarracksReactor, //BUILD_BARRACKSREACTOR
+						&KoKeKoKoBot::TryBuildFactory, //BUILD_FACTORY
+						&KoKeKoKoBot::TryTrainHellion, //TRAIN_HELLION
+						&KoKeKoKoBot::TryTransformHellionHellbat, //MORPH_HELLBAT
+						&KoKeKoKoBot::TryTrainWidowMine, //TRAIN_WIDOWMINE
+						&KoKeKoKoBot::TryTrainSiegeTank, //TRAIN_SIEGETANK
+						&KoKeKoKoBot::TryTransformSiegeMode, //MORPH_SIEGEMODE
+						&KoKeKoKoBot::TryTransformUnsiege, //MORPH_UNSIEGE
+						&KoKeKoKoBot::TryTrainCyclone, //TRAIN_CYCLONE
+						&KoKeKoKoBot::TryTrainHellbat, //TRAIN_HELLBAT
+						&KoKeKoKoBot::TryTransformHellbatHellion, //MORPH_HELLION
+						&KoKeKoKoBot::TryTrainThor, //TRAIN_THOR
+						&KoKeKoKoBot::TryBuildFactoryTechLab, //BUILD_FACTORYTECHLAB
+						&KoKeKoKoBot::TryFactoryResearchInfernalPreIgniter, //RESEARCH_INFERNALPREIGNITER
+						&KoKeKoKoBot::TryFactoryResearchMagFieldAccelerator, //RESEARCH_MAGFIELDLAUNCHERS
+						&KoKeKoKoBot::TryFactoryResearchDrillingClaws, //RESEARCH_DRILLINGCLAWS
+						&KoKeKoKoBot::TryBuildFactoryReactor, //BUILD_FACTORYREACTOR
+						&KoKeKoKoBot::TryBuildStarport, //BUILD_STARPORT
+						&KoKeKoKoBot::TryTrainViking, //TRAIN_VIKINGFIGHTER
+						&KoKeKoKoBot::TryTransformVikingFighter, //MORPH_VIKINGFIGHTERMODE
+						&KoKeKoKoBot::TryTransformVikingAssault, //MORPH_VIKINGASSAULTMODE
+						&KoKeKoKoBot::TryTrainMedivac, //TRAIN_MEDIVAC
+						&KoKeKoKoBot::TryTrainLiberator, //TRAIN_LIBERATOR
+						&KoKeKoKoBot::TryTransformLiberatorLiberatorAG, //MORPH_LIBERATORAGMODE
+						&KoKeKoKoBot::TryTransformLiberatorAGLiberator, //MORPH_LIBERATORAAMODE
+						&KoKeKoKoBot::TryTrainRaven, //TRAIN_RAVEN
+						&KoKeKoKoBot::TryRavenSummonAutoTurret, //EFFECT_AUTOTURRET
+						&KoKeKoKoBot::TryTrainBanshee, //TRAIN_BANSHEE
+						&KoKeKoKoBot::TryTrainBattlecruiser, //TRAIN_BATTLECRUISER
+						&KoKeKoKoBot::TryBuildStarportReactor, //BUILD_STARPORTREACTOR
+						&KoKeKoKoBot::TryBuildStarportTechLab, //BUILD_STARPORTTECHLAB
+						&KoKeKoKoBot::TryStarportResearchRapidReignitionSystem, //RESEARCH_HIGHCAPACITYFUELTANKS
+						&KoKeKoKoBot::TryStarportResearchCorvidReactor, //RESEARCH_RAVENCORVIDREACTOR
+						&KoKeKoKoBot::TryStarportResearchCloakingField, //RESEARCH_BANSHEECLOAKINGFIELD
+						&KoKeKoKoBot::TryStarportResearchHyperflightRotors, //RESEARCH_BANSHEEHYPERFLIGHTROTORS
+						&KoKeKoKoBot::TryStarportResearchAdvancedBallistics, //RESEARCH_ADVANCEDBALLISTICS
+						&KoKeKoKoBot::TryBuildFusionCore, //BUILD_FUSIONCORE
+						&KoKeKoKoBot::TryFusionCoreResearchResearchWeaponRefit, //RESEARCH_BATTLECRUISERWEAPONREFIT
+						&KoKeKoKoBot::TryBuildArmory, //BUILD_ARMORY
+						&KoKeKoKoBot::TryArmoryResearchVehicleWeapons, //RESEARCH_TERRANVEHICLEWEAPONS
+						&KoKeKoKoBot::TryArmoryResearchShipWeapons, //RESEARCH_TERRANSHIPWEAPONS
+						&KoKeKoKoBot::TryArmoryResearchVehicleShipPlating, //RESEARCH_TERRANVEHICLEANDSHIPPLATING
+						&KoKeKoKoBot::TryBuildBunker, //BUILD_BUNKER
+						&KoKeKoKoBot::TryBuildEngineeringBay, //BUILD_ENGINEERINGBAY
+						&KoKeKoKoBot::TryEngineeringBayResearchInfantryWeapon, //RESEARCH_TERRANINFANTRYWEAPONS
+						&KoKeKoKoBot::TryEngineeringBayResearchInfantryArmor, //RESEARCH_TERRANINFANTRYARMOR
+						&KoKeKoKoBot::TryBuildGhostAcademy, //BUILD_GHOSTACADEMY
+						&KoKeKoKoBot::TryGhostAcademyResearchPersonalCloaking, //RESEARCH_PERSONALCLOAKING
+						&KoKeKoKoBot::TryGhostAcademyBuildNuke, //BUILD_NUKE
+						&KoKeKoKoBot::TryBuildMissileTurret, //BUILD_MISSILETURRET
+						&KoKeKoKoBot::TryBuildSensorTower, //BUILD_SENSORTOWER
+						&KoKeKoKoBot::TrySurrender //SURRENDER
+					};
+					static_assert((sizeof(ACTION_HANDLERS) / sizeof(ACTION_HANDLERS[0])) == ACTION_COUNT, "Every action must have a handler");
+
+					if (action == Action::NONE || static_cast<size_t>(action) >= ACTION_COUNT)
+						return false;
+
+					//Every Try function is timed under the name of its action
+					KOKEKOKO_PROFILE_ZONE(GetActionName(action));
+					return (this->*ACTION_HANDLERS[static_cast<size_t>(action)])();
+				}
+
+				//Starts to receive the decided actions and send updates to the provider
+				void StartSendingUpdatesToProvider()
+				{
+					StopSendingUpdatesToProvider();
 
 					_shouldkeepupdating = true;
-					auto getmessagefrommodelservice = new std::thread(&KoKeKoKo::Agent::KoKeKoKoBot::GetMessageFromModelService, this);
-					_threads.insert(std::make_pair("GetMessageFromModelService", getmessagefrommodelservice));
-					auto sendupdatestomodelservice = new std::thread(&KoKeKoKo::Agent::KoKeKoKoBot::SendUpdatesToModelService, this);
-					_threads.insert(std::make_pair("SendUpdatesToModelService", sendupdatestomodelservice));
+					auto receiveactionsfromprovider = new std::thread(&KoKeKoKo::Agent::KoKeKoKoBot::ReceiveActionsFromProvider, this);
+					_threads.insert(std::make_pair("ReceiveActionsFromProvider", receiveactionsfromprovider));
+					auto sendupdatestoprovider = new std::thread(&KoKeKoKo::Agent::KoKeKoKoBot::SendUpdatesToProvider, this);
+					_threads.insert(std::make_pair("SendUpdatesToProvider", sendupdatestoprovider));
 				}
 
-				//Stops checking messages and sending updates to model service
-				void StopSendingUpdatesToModelService()
+				//Stops receiving the decided actions and sending updates to the provider
+				void StopSendingUpdatesToProvider()
 				{
 					_shouldkeepupdating = false;
+					_provider->NotifyWaiters();
 
-					if (_threads.find("GetMessageFromModelService") != _threads.end())
+					if (_threads.find("ReceiveActionsFromProvider") != _threads.end())
 					{
-						if (_threads["GetMessageFromModelService"]->joinable())
-							_threads["GetMessageFromModelService"]->join();
+						if (_threads["ReceiveActionsFromProvider"]->joinable())
+							_threads["ReceiveActionsFromProvider"]->join();
 
-						_threads.erase("GetMessageFromModelService");
+						_threads.erase("ReceiveActionsFromProvider");
 					}
-					if (_threads.find("SendUpdatesToModelService") != _threads.end())
+					if (_threads.find("SendUpdatesToProvider") != _threads.end())
 					{
-						if (_threads["SendUpdatesToModelService"]->joinable())
-							_threads["SendUpdatesToModelService"]->join();
+						if (_threads["SendUpdatesToProvider"]->joinable())
+							_threads["SendUpdatesToProvider"]->join();
 
-						_threads.erase("SendUpdatesToModelService");
+						_threads.erase("SendUpdatesToProvider");
 					}
 				}				
 		};
@@ -1794,19 +1920,65 @@ namespace KoKeKoKo
 using namespace KoKeKoKo;
 Model::ModelRepositoryService* Model::ModelRepositoryService::_instance = nullptr;
 
+//Define KOKEKOKO_SIMULATION to include the agent in a program that plays it without the game, such as the replay simulation
+#ifndef KOKEKOKO_SIMULATION
 int main(int argc, char* argv[])
 {
+	//The messages of every thread are written by the logger, so that none of them waits for the console
+	Types::Logger::Start(std::cout);
+
 	try
 	{
 		auto coordinator = new sc2::Coordinator();
-		auto kokekokobot = new Agent::KoKeKoKoBot();
-		auto modelrepositoryservice = Model::ModelRepositoryService::StartModelRepositoryService();
+		std::vector<char*> arguments = std::vector<char*>();
+		std::string pluginpath = "", bookpath = "", rank = "";
+		bool isplanning = false;
+		Agent::ActionProvider* provider = nullptr;
+
+		//Take out "--plugin <path>", "--planner", "--book <path>" and "--rank <name>" before the rest of the arguments are passed to the coordinator
+		for (int index = 0; index < argc; index++)
+		{
+			if (std::string(argv[index]) == "--plugin" && (index + 1) < argc)
+				pluginpath = argv[++index];
+			else if (std::string(argv[index]) == "--planner")
+				isplanning = true;
+			else if (std::string(argv[index]) == "--book" && (index + 1) < argc)
+				bookpath = argv[++index];
+			else if (std::string(argv[index]) == "--rank" && (index + 1) < argc)
+				rank = argv[++index];
+			else
+				arguments.push_back(argv[index]);
+		}
+
+		//Decide the actions with the native plugin if there is one, or with the macro planner if it was asked for, otherwise with model service
+		if (!pluginpath.empty())
+			provider = new Agent::PluginActionProvider(pluginpath);
+		else if (isplanning)
+			provider = new Agent::PlannerActionProvider();
+		else
+		{
+			auto modelrepositoryservice = Model::ModelRepositoryService::StartModelRepositoryService();
 
-		//Start accepting messages
-		modelrepositoryservice->StartAcceptingMessages();
+			//Start accepting messages
+			modelrepositoryservice->StartAcceptingMessages();
+			provider = new Agent::ModelServiceActionProvider(modelrepositoryservice);
+		}
+		KOKEKOKO_LOG_INFO("The actions are decided by {}", provider->GetName());
+		auto kokekokobot = new Agent::KoKeKoKoBot(provider);
+
+		//Follow the opening book if there is one, the openings of the given rank or of every rank
+		if (!bookpath.empty())
+		{
+			auto openingbook = new Agent::OpeningBook();
+
+			openingbook->Open(bookpath);
+			uint32_t bookrank = openingbook->FindRank(rank);
+			kokekokobot->SetOpeningBook(openingbook, bookrank);
+			KOKEKOKO_LOG_INFO("The opening follows {} with the openings of {}", bookpath, ((bookrank == Agent::OPENINGBOOK_ALLRANKS) ? "every rank" : openingbook->GetRankName(bookrank)));
+		}
 
 		//Start the game
-		coordinator->LoadSettings(argc, argv);
+		coordinator->LoadSettings(static_cast<int>(arguments.size()), arguments.data());
 		coordinator->SetParticipants({ sc2::CreateParticipant(sc2::Race::Terran, kokekokobot), sc2::CreateComputer(sc2::Race::Terran, sc2::Difficulty::VeryEasy) });
 		coordinator->LaunchStarcraft();
 		coordinator->StartGame(sc2::kMapBelShirVestigeLE);
@@ -1814,14 +1986,16 @@ int main(int argc, char* argv[])
 	}
 	catch (const std::exception& ex)
 	{
-		std::cout << ex.what() << std::endl;
+		KOKEKOKO_LOG_ERROR("{}", ex.what());
 	}
 	catch (...)
 	{
-		std::cout << "An Application error occurred! Stopping the program immediately...";
+		KOKEKOKO_LOG_ERROR("An Application error occurred! Stopping the program immediately...");
 	}
+	Types::Logger::Stop();
 
 	std::cout << "Press enter to continue..." << std::endl;
 	system("PAUSE");
 	return 0;
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file